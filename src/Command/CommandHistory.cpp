@@ -0,0 +1,374 @@
+/*
+Copyright 2021 The Foedag team
+
+GPL License
+
+Copyright (c) 2021 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Command/CommandHistory.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+using namespace FOEDAG;
+
+namespace {
+// Serializes the sessions that share a history file, held while the file is
+// read to its end and an entry is appended or a torn line is cut
+class FileLock {
+ public:
+  explicit FileLock(std::FILE* file) : m_file(file) {
+#ifdef _WIN32
+    OVERLAPPED overlapped{};
+    LockFileEx(handle(), LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD,
+               &overlapped);
+#else
+    while (flock(fileno(m_file), LOCK_EX) != 0 && errno == EINTR) {
+    }
+#endif
+  }
+  ~FileLock() {
+#ifdef _WIN32
+    OVERLAPPED overlapped{};
+    UnlockFileEx(handle(), 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+    flock(fileno(m_file), LOCK_UN);
+#endif
+  }
+
+ private:
+#ifdef _WIN32
+  HANDLE handle() const {
+    return reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file)));
+  }
+#endif
+  std::FILE* m_file{nullptr};
+};
+}  // namespace
+
+// FNV-1a, enough to tell a torn or edited line from a good one
+static uint32_t Checksum(const std::string& data) {
+  uint32_t hash = 2166136261u;
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static std::string Escape(const std::string& str) {
+  std::string result;
+  result.reserve(str.size());
+  for (char c : str) {
+    switch (c) {
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\r':
+        result += "\\r";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        result += c;
+    }
+  }
+  return result;
+}
+
+static bool Unescape(const std::string& str, std::string& result) {
+  result.clear();
+  for (size_t i = 0; i < str.size(); i++) {
+    if (str[i] != '\\') {
+      result += str[i];
+      continue;
+    }
+    if (++i == str.size()) return false;
+    switch (str[i]) {
+      case '\\':
+        result += '\\';
+        break;
+      case 'n':
+        result += '\n';
+        break;
+      case 'r':
+        result += '\r';
+        break;
+      case 't':
+        result += '\t';
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+CommandHistory::CommandHistory(const std::filesystem::path& file)
+    : m_path(file) {}
+
+CommandHistory::~CommandHistory() { Close(); }
+
+bool CommandHistory::Open() {
+  Close();
+  m_error.clear();
+  m_entries.clear();
+  m_offset = 0;
+  m_file = std::fopen(m_path.string().c_str(), "ab");
+  if (!m_file) {
+    m_error = "Can't open history file " + m_path.string() + ": " +
+              std::strerror(errno);
+    return false;
+  }
+  FileLock lock{m_file};
+  if (!ReadTail()) {
+    Close();
+    return false;
+  }
+  // Under the lock a line without newline can only be torn by a crash
+  std::error_code ec;
+  if (m_offset < std::filesystem::file_size(m_path, ec))
+    std::filesystem::resize_file(m_path, m_offset, ec);
+  return true;
+}
+
+bool CommandHistory::ReadTail() {
+  std::ifstream stream(m_path, std::ios::in | std::ios::binary);
+  if (!stream.good()) {
+    m_error = "Can't read history file " + m_path.string();
+    return false;
+  }
+  stream.seekg(static_cast<std::streamoff>(m_offset));
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (stream.eof()) break;  // no newline, torn by a crash
+    m_offset += line.size() + 1;
+    Entry entry;
+    if (!Parse(line, entry)) continue;
+    // Written by a session that didn't read the file to its end first
+    if (!m_entries.empty() && entry.id <= m_entries.back().id)
+      entry.id = m_entries.back().id + 1;
+    m_entries.push_back(std::move(entry));
+  }
+  return true;
+}
+
+void CommandHistory::Close() {
+  if (m_file) {
+    std::fclose(m_file);
+    m_file = nullptr;
+  }
+}
+
+void CommandHistory::SetStateProvider(StateProvider provider) {
+  m_stateProvider = std::move(provider);
+}
+
+std::string CommandHistory::State() const {
+  return m_stateProvider ? m_stateProvider() : std::string{};
+}
+
+CommandHistory::Pending CommandHistory::Start() {
+  Pending pending;
+  pending.nested = m_depth++ > 0;
+  if (pending.nested) return pending;
+  pending.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count();
+  pending.start = std::chrono::steady_clock::now();
+  pending.state = State();
+  return pending;
+}
+
+uint64_t CommandHistory::Finish(const Pending& pending,
+                                const std::string& command, int code) {
+  m_depth--;
+  if (pending.nested) return 0;
+  Entry entry;
+  entry.time = pending.time;
+  entry.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - pending.start)
+                       .count();
+  entry.code = code;
+  entry.state = pending.state;
+  entry.command = command;
+  return Append(std::move(entry));
+}
+
+uint64_t CommandHistory::Append(Entry entry) {
+  if (!m_file) return 0;
+  FileLock lock{m_file};
+  // The entries other sessions appended meanwhile come first
+  if (!ReadTail()) return 0;
+  entry.id = m_entries.empty() ? 1 : m_entries.back().id + 1;
+  // One write per entry so that a crash can only tear the last line
+  const std::string line = Serialize(entry);
+  bool ok = std::fwrite(line.data(), 1, line.size(), m_file) == line.size();
+  ok = ok && std::fflush(m_file) == 0;
+#ifdef _WIN32
+  ok = ok && _commit(_fileno(m_file)) == 0;
+#else
+  ok = ok && fsync(fileno(m_file)) == 0;
+#endif
+  if (!ok) {
+    m_error = "Can't write history file " + m_path.string() + ": " +
+              std::strerror(errno);
+    return 0;
+  }
+  m_offset += line.size();
+  m_entries.push_back(std::move(entry));
+  return m_entries.back().id;
+}
+
+const CommandHistory::Entry* CommandHistory::Find(uint64_t id) const {
+  auto itr = std::lower_bound(
+      m_entries.begin(), m_entries.end(), id,
+      [](const Entry& entry, uint64_t id) { return entry.id < id; });
+  if (itr == m_entries.end() || itr->id != id) return nullptr;
+  return &(*itr);
+}
+
+std::vector<const CommandHistory::Entry*> CommandHistory::Range(
+    uint64_t first, uint64_t last) const {
+  std::vector<const Entry*> entries;
+  auto itr = std::lower_bound(
+      m_entries.begin(), m_entries.end(), first,
+      [](const Entry& entry, uint64_t id) { return entry.id < id; });
+  for (; itr != m_entries.end() && itr->id <= last; ++itr)
+    entries.push_back(&(*itr));
+  return entries;
+}
+
+std::vector<const CommandHistory::Entry*> CommandHistory::Search(
+    const std::string& pattern, size_t limit) const {
+  std::vector<const Entry*> entries;
+  // Matched anywhere in the command
+  const std::string glob = "*" + pattern + "*";
+  for (auto itr = m_entries.rbegin(); itr != m_entries.rend(); ++itr) {
+    if (!Match(glob.c_str(), itr->command.c_str())) continue;
+    entries.push_back(&(*itr));
+    if (entries.size() == limit) break;
+  }
+  return entries;
+}
+
+std::string CommandHistory::Script(const std::vector<const Entry*>& entries) {
+  std::stringstream script;
+  script << "# Replay of the command history";
+  if (!entries.empty()) {
+    script << " " << entries.front()->id << "-" << entries.back()->id
+           << "\n# Project state: " << entries.front()->state;
+  }
+  script << "\n";
+  for (const Entry* entry : entries)
+    if (Replayable(*entry)) script << entry->command << "\n";
+  return script.str();
+}
+
+bool CommandHistory::Replayable(const Entry& entry) {
+  return entry.code == 0 /*TCL_OK*/ &&
+         entry.command.compare(0, 8, "history_") != 0;
+}
+
+std::string CommandHistory::Hash(const std::string& data) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : data) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  char buffer[17];
+  std::snprintf(buffer, sizeof(buffer), "%016llx",
+                static_cast<unsigned long long>(hash));
+  return buffer;
+}
+
+// <checksum> <id>\t<time>\t<duration>\t<code>\t<state>\t<command>\n
+std::string CommandHistory::Serialize(const Entry& entry) {
+  std::stringstream stream;
+  stream << entry.id << '\t' << entry.time << '\t' << entry.duration << '\t'
+         << entry.code << '\t' << Escape(entry.state) << '\t'
+         << Escape(entry.command);
+  const std::string record = stream.str();
+  char checksum[9];
+  std::snprintf(checksum, sizeof(checksum), "%08x", Checksum(record));
+  return std::string{checksum} + ' ' + record + '\n';
+}
+
+bool CommandHistory::Parse(const std::string& line, Entry& entry) {
+  if (line.size() < 10 || line[8] != ' ') return false;
+  const std::string record = line.substr(9);
+  char checksum[9];
+  std::snprintf(checksum, sizeof(checksum), "%08x", Checksum(record));
+  if (line.compare(0, 8, checksum) != 0) return false;
+  std::vector<std::string> fields;
+  size_t start{0};
+  for (int i = 0; i < 5; i++) {
+    const size_t tab = record.find('\t', start);
+    if (tab == std::string::npos) return false;
+    fields.push_back(record.substr(start, tab - start));
+    start = tab + 1;
+  }
+  try {
+    entry.id = std::stoull(fields[0]);
+    entry.time = std::stoll(fields[1]);
+    entry.duration = std::stoull(fields[2]);
+    entry.code = std::stoi(fields[3]);
+  } catch (...) {
+    return false;
+  }
+  return Unescape(fields[4], entry.state) &&
+         Unescape(record.substr(start), entry.command);
+}
+
+// '*', '?' and '\' escapes as Tcl "string match"
+bool CommandHistory::Match(const char* pattern, const char* str) {
+  while (*pattern) {
+    if (*pattern == '*') {
+      while (*pattern == '*') pattern++;
+      if (!*pattern) return true;
+      for (; *str; str++)
+        if (Match(pattern, str)) return true;
+      return false;
+    }
+    if (!*str) return false;
+    if (*pattern == '?') {
+      pattern++;
+      str++;
+      continue;
+    }
+    if (*pattern == '\\' && pattern[1]) pattern++;
+    if (*pattern != *str) return false;
+    pattern++;
+    str++;
+  }
+  return !*str;
+}
@@ -0,0 +1,119 @@
+/*
+Copyright 2021 The Foedag team
+
+GPL License
+
+Copyright (c) 2021 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifndef COMMAND_HISTORY_H
+#define COMMAND_HISTORY_H
+
+namespace FOEDAG {
+
+/*!
+ * \brief The CommandHistory class is a persistent, append-only store of the
+ * executed commands. Each entry is one checksummed line flushed to disk
+ * before Finish() returns, a line torn by a crash is dropped on the next
+ * Open(). The entries of all the sessions are kept in memory ordered by id,
+ * the sessions sharing the file take a lock on it and read what the others
+ * appended before they append themselves.
+ */
+class CommandHistory {
+ public:
+  struct Entry {
+    uint64_t id{0};
+    int64_t time{0};       // start, ms since epoch
+    uint64_t duration{0};  // ms
+    int code{0};           // Tcl return code
+    std::string state;     // project state before the command
+    std::string command;
+  };
+  // Captured when a command starts
+  struct Pending {
+    int64_t time{0};
+    std::chrono::steady_clock::time_point start;
+    std::string state;
+    bool nested{false};
+  };
+  using StateProvider = std::function<std::string()>;
+
+  explicit CommandHistory(const std::filesystem::path& file);
+  ~CommandHistory();
+
+  bool Open();
+  void Close();
+  bool IsOpen() const { return m_file != nullptr; }
+  const std::string& LastError() const { return m_error; }
+  const std::filesystem::path& File() const { return m_path; }
+
+  // The state recorded with each command, empty when not set
+  void SetStateProvider(StateProvider provider);
+  std::string State() const;
+
+  Pending Start();
+  /*!
+   * \brief Finish appends the command started with \p pending. Commands run
+   * by another recorded command are not appended, a replay runs them again.
+   * \return the id of the entry, 0 if it was not written
+   */
+  uint64_t Finish(const Pending& pending, const std::string& command,
+                  int code);
+  uint64_t Append(Entry entry);
+
+  const std::vector<Entry>& Entries() const { return m_entries; }
+  const Entry* Find(uint64_t id) const;
+  // Entries with first <= id <= last
+  std::vector<const Entry*> Range(uint64_t first, uint64_t last) const;
+  // Newest first, glob pattern as Tcl "string match"
+  std::vector<const Entry*> Search(const std::string& pattern,
+                                   size_t limit = 0) const;
+
+  /*!
+   * \brief Script turns entries into a batch script: the failed commands and
+   * the history commands themselves are left out.
+   */
+  static std::string Script(const std::vector<const Entry*>& entries);
+  static bool Replayable(const Entry& entry);
+  static std::string Hash(const std::string& data);
+
+ private:
+  // Reads the complete lines past m_offset
+  bool ReadTail();
+  static std::string Serialize(const Entry& entry);
+  static bool Parse(const std::string& line, Entry& entry);
+  static bool Match(const char* pattern, const char* str);
+
+  std::filesystem::path m_path;
+  std::FILE* m_file{nullptr};
+  uint64_t m_offset{0};  // end of the last complete line read
+  std::string m_error;
+  StateProvider m_stateProvider;
+  int m_depth{0};
+  std::vector<Entry> m_entries;
+};
+
+}  // namespace FOEDAG
+
+#endif
@@ -46,12 +46,25 @@ CommandStack::CommandStack(TclInterpreter *interp, const std::string &logFile,
     m_outputLogger->open();
     (*m_outputLogger) << "# Out log file\n";
     (*m_outputLogger) << "# Created: " << std::ctime(&result) << "\n";
+
+    // Unlike the logs above, the history is kept across the sessions
+    m_history = new CommandHistory(logFile.empty() ? "history.log"
+                                                   : logFile + "_history.log");
+    if (!m_history->Open()) {
+      std::cerr << m_history->LastError() << std::endl;
+      delete m_history;
+      m_history = nullptr;
+    }
   }
 }
 
 bool CommandStack::push_and_exec(Command *cmd) {
   if (m_logger) m_logger->log(cmd->do_cmd());
-  const std::string &result = m_interp->evalCmd(cmd->do_cmd());
+  CommandHistory::Pending pending;
+  if (m_history) pending = m_history->Start();
+  int code{0};
+  const std::string &result = m_interp->evalCmd(cmd->do_cmd(), &code);
+  if (m_history) m_history->Finish(pending, cmd->do_cmd(), code);
   m_cmds.push_back(cmd);
   return (result == "");
 }
@@ -76,5 +89,6 @@ CommandStack::~CommandStack() {
   delete m_logger;
   delete m_perfLogger;
   delete m_outputLogger;
+  delete m_history;
   for (auto cmd : m_cmds) delete cmd;
 }
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <vector>
 
 #include "Command/Command.h"
+#include "Command/CommandHistory.h"
 #include "Command/Logger.h"
 #include "Tcl/TclInterpreter.h"
 
@@ -46,6 +47,8 @@ class CommandStack {
   Logger* CmdLogger() { return m_logger; }
   Logger* PerfLogger() { return m_perfLogger; }
   Logger* OutLogger() { return m_outputLogger; }
+  // Persistent history of the executed commands, nullptr when muted
+  CommandHistory* History() { return m_history; }
 
  private:
   std::vector<Command*> m_cmds;
@@ -53,6 +56,7 @@ class CommandStack {
   Logger* m_logger = nullptr;
   Logger* m_perfLogger = nullptr;
   Logger* m_outputLogger = nullptr;
+  CommandHistory* m_history = nullptr;
 };
 
 }  // namespace FOEDAG
@@ -0,0 +1,553 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "BitstreamStore.h"
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+
+#include "Utils/StringUtils.h"
+
+namespace fs = std::filesystem;
+
+namespace FOEDAG {
+
+static std::string Sha256(const char* data, size_t size) {
+  QCryptographicHash hash{QCryptographicHash::Sha256};
+  // addData() takes an int
+  for (size_t offset = 0; offset < size; offset += INT_MAX / 2) {
+    const size_t chunk = (std::min)(size - offset, size_t{INT_MAX / 2});
+    hash.addData(data + offset, static_cast<int>(chunk));
+  }
+  return hash.result().toHex().toStdString();
+}
+
+static bool ReadFile(const fs::path& file, std::string& data) {
+  std::ifstream stream(file, std::ios::in | std::ios::binary);
+  if (!stream.good()) return false;
+  std::stringstream buffer;
+  buffer << stream.rdbuf();
+  data = buffer.str();
+  return !stream.bad();
+}
+
+// Written aside and renamed. Each write has its own temporary file, so
+// runs archiving the same object at once never write to the same file.
+static bool WriteFile(const fs::path& file, const char* data, size_t size) {
+  static std::atomic<uint64_t> writes{0};
+  static const uint32_t salt = std::random_device{}();
+  std::error_code ec;
+  fs::create_directories(file.parent_path(), ec);
+  const fs::path temp =
+      file.string() + "." +
+      std::to_string(QCoreApplication::applicationPid()) + "." +
+      std::to_string(salt) + "." + std::to_string(writes++) + ".tmp";
+  {
+    std::ofstream stream(temp, std::ios::out | std::ios::binary);
+    stream.write(data, static_cast<std::streamsize>(size));
+    if (!stream.good()) {
+      stream.close();
+      fs::remove(temp, ec);
+      return false;
+    }
+  }
+  fs::rename(temp, file, ec);
+  if (!ec) return true;
+  fs::remove(temp, ec);
+  return false;
+}
+
+// Record values are one line each
+static std::string Escape(const std::string& value) {
+  std::string result;
+  for (char c : value) {
+    if (c == '\\')
+      result += "\\\\";
+    else if (c == '\n')
+      result += "\\n";
+    else
+      result += c;
+  }
+  return result;
+}
+
+static std::string Unescape(const std::string& value) {
+  std::string result;
+  for (size_t i = 0; i < value.size(); i++) {
+    if (value[i] == '\\' && i + 1 < value.size()) {
+      result += (value[++i] == 'n') ? '\n' : value[i];
+    } else {
+      result += value[i];
+    }
+  }
+  return result;
+}
+
+fs::path BitstreamStore::DefaultPath(const fs::path& projectPath) {
+  const char* shared = std::getenv("FOEDAG_BITSTREAM_STORE");
+  if (shared && *shared) return fs::path{shared};
+  return projectPath / DefaultDir;
+}
+
+bool BitstreamStore::Open(const fs::path& dir) {
+  m_dir = dir;
+  m_error.clear();
+  std::error_code ec;
+  fs::create_directories(m_dir / "builds", ec);
+  fs::create_directories(m_dir / "objects", ec);
+  if (ec) {
+    m_error = "Can't create bitstream store " + m_dir.string();
+    return false;
+  }
+  return true;
+}
+
+fs::path BitstreamStore::objectPath(const std::string& object) const {
+  return m_dir / "objects" / object.substr(0, 2) / object;
+}
+
+fs::path BitstreamStore::buildPath(const std::string& id) const {
+  return m_dir / "builds" / id;
+}
+
+std::string BitstreamStore::Id(const Build& build) {
+  std::string text = build.design + '\n' + build.device + '\n';
+  for (const auto& [name, version] : build.tools)
+    text += "tool " + name + ' ' + Escape(version) + '\n';
+  for (const auto& [name, value] : build.options)
+    text += "option " + name + ' ' + Escape(value) + '\n';
+  for (const auto& [path, hash] : build.sources)
+    text += "source " + hash + ' ' + path + '\n';
+  return Sha256(text.data(), text.size());
+}
+
+bool BitstreamStore::HashFile(const fs::path& file, std::string& hash) {
+  std::ifstream stream(file, std::ios::in | std::ios::binary);
+  if (!stream.good()) return false;
+  QCryptographicHash sha{QCryptographicHash::Sha256};
+  std::vector<char> buffer(1 << 20);
+  while (stream) {
+    stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    sha.addData(buffer.data(), static_cast<int>(stream.gcount()));
+  }
+  if (stream.bad()) return false;
+  hash = sha.result().toHex().toStdString();
+  return true;
+}
+
+bool BitstreamStore::writeObject(const std::string& data,
+                                 const std::string& object) {
+  std::error_code ec;
+  // Same content, already stored by an earlier build
+  if (fs::exists(objectPath(object), ec)) return true;
+  if (data.size() > INT_MAX) {
+    m_error = "Output too large to store: " + std::to_string(data.size());
+    return false;
+  }
+  const QByteArray packed =
+      qCompress(reinterpret_cast<const uchar*>(data.data()),
+                static_cast<int>(data.size()));
+  if (!WriteFile(objectPath(object), packed.constData(),
+                 static_cast<size_t>(packed.size()))) {
+    m_error = "Can't write " + objectPath(object).string();
+    return false;
+  }
+  return true;
+}
+
+bool BitstreamStore::Read(const Output& output, std::string& data) {
+  std::string packed;
+  if (!ReadFile(objectPath(output.object), packed)) {
+    m_error = "Missing object " + output.object + " of " + output.name;
+    return false;
+  }
+  const QByteArray unpacked =
+      qUncompress(reinterpret_cast<const uchar*>(packed.data()),
+                  static_cast<int>(packed.size()));
+  if (static_cast<uint64_t>(unpacked.size()) != output.size) {
+    m_error = "Corrupt object " + output.object + " of " + output.name;
+    return false;
+  }
+  data.assign(unpacked.constData(), static_cast<size_t>(unpacked.size()));
+  return true;
+}
+
+bool BitstreamStore::Store(Build& build, const fs::path& runDir,
+                           const std::vector<std::string>& outputs) {
+  build.id = Id(build);
+  if (build.time == 0) build.time = std::time(nullptr);
+  build.outputs.clear();
+  for (const auto& name : outputs) {
+    std::string data;
+    std::error_code ec;
+    if (!fs::is_regular_file(runDir / name, ec)) continue;
+    if (!ReadFile(runDir / name, data)) {
+      m_error = "Can't read " + (runDir / name).string();
+      return false;
+    }
+    Output output{name, Sha256(data.data(), data.size()), data.size()};
+    if (!writeObject(data, output.object)) return false;
+    build.outputs.push_back(output);
+  }
+  if (build.outputs.empty()) {
+    m_error = "No bitstream output found in " + runDir.string();
+    return false;
+  }
+  return writeBuild(build);
+}
+
+bool BitstreamStore::Restore(const Build& build, const fs::path& runDir) {
+  for (const auto& output : build.outputs) {
+    std::string data;
+    if (!Read(output, data)) return false;
+    if (!WriteFile(runDir / output.name, data.data(), data.size())) {
+      m_error = "Can't write " + (runDir / output.name).string();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BitstreamStore::Contains(const std::string& id) const {
+  std::error_code ec;
+  return !id.empty() && fs::is_regular_file(buildPath(id), ec);
+}
+
+bool BitstreamStore::writeBuild(const Build& build) {
+  std::stringstream record;
+  record << "# bitstream build 1\n";
+  record << "id " << build.id << '\n';
+  record << "time " << build.time << '\n';
+  record << "design " << Escape(build.design) << '\n';
+  record << "device " << Escape(build.device) << '\n';
+  for (const auto& [name, version] : build.tools)
+    record << "tool " << name << ' ' << Escape(version) << '\n';
+  for (const auto& [name, value] : build.options)
+    record << "option " << name << ' ' << Escape(value) << '\n';
+  for (const auto& [path, hash] : build.sources)
+    record << "source " << hash << ' ' << Escape(path) << '\n';
+  for (const auto& output : build.outputs)
+    record << "output " << output.object << ' ' << output.size << ' '
+           << Escape(output.name) << '\n';
+  const std::string text = record.str();
+  if (!WriteFile(buildPath(build.id), text.data(), text.size())) {
+    m_error = "Can't write " + buildPath(build.id).string();
+    return false;
+  }
+  return true;
+}
+
+bool BitstreamStore::readBuild(const fs::path& file, Build& build) {
+  std::ifstream stream(file);
+  std::string line;
+  if (!std::getline(stream, line) || line != "# bitstream build 1")
+    return false;
+  build = Build{};
+  // "<key> <first> <rest>"
+  auto split = [](const std::string& text) {
+    const size_t space = text.find(' ');
+    if (space == std::string::npos) return std::make_pair(text, std::string{});
+    return std::make_pair(text.substr(0, space), text.substr(space + 1));
+  };
+  while (std::getline(stream, line)) {
+    auto [key, value] = split(line);
+    if (key == "id") {
+      build.id = value;
+    } else if (key == "time") {
+      build.time = std::strtoll(value.c_str(), nullptr, 10);
+    } else if (key == "design") {
+      build.design = Unescape(value);
+    } else if (key == "device") {
+      build.device = Unescape(value);
+    } else if (key == "tool") {
+      auto [name, version] = split(value);
+      build.tools.emplace_back(name, Unescape(version));
+    } else if (key == "option") {
+      auto [name, option] = split(value);
+      build.options.emplace_back(name, Unescape(option));
+    } else if (key == "source") {
+      auto [hash, path] = split(value);
+      build.sources.emplace_back(Unescape(path), hash);
+    } else if (key == "output") {
+      auto [object, rest] = split(value);
+      auto [size, name] = split(rest);
+      build.outputs.push_back(
+          {Unescape(name), object, std::strtoull(size.c_str(), nullptr, 10)});
+    }
+  }
+  return !build.id.empty();
+}
+
+bool BitstreamStore::Find(const std::string& id, Build& build) {
+  if (Contains(id)) return readBuild(buildPath(id), build);
+  std::vector<fs::path> matches;
+  std::error_code ec;
+  for (fs::directory_iterator itr{m_dir / "builds", ec}, end;
+       !ec && itr != end; itr.increment(ec)) {
+    if (!id.empty() && StringUtils::startsWith(
+                           itr->path().filename().string(), id))
+      matches.push_back(itr->path());
+  }
+  if (matches.size() != 1) {
+    m_error = (matches.empty() ? "Unknown bitstream build: "
+                               : "Ambiguous bitstream build: ") +
+              id;
+    return false;
+  }
+  if (!readBuild(matches.front(), build)) {
+    m_error = "Corrupt bitstream build record " + matches.front().string();
+    return false;
+  }
+  return true;
+}
+
+std::vector<BitstreamStore::Build> BitstreamStore::Builds() const {
+  std::vector<Build> builds;
+  std::error_code ec;
+  for (fs::directory_iterator itr{m_dir / "builds", ec}, end;
+       !ec && itr != end; itr.increment(ec)) {
+    Build build;
+    if (readBuild(itr->path(), build)) builds.push_back(std::move(build));
+  }
+  std::sort(builds.begin(), builds.end(), [](const Build& a, const Build& b) {
+    return a.time != b.time ? a.time < b.time : a.id < b.id;
+  });
+  return builds;
+}
+
+namespace {
+// Configuration bits packed 64 per word, grouped in regions (tiles or frame
+// addresses) in file order
+struct Bits {
+  struct Region {
+    std::string name;
+    std::vector<uint64_t> words;
+    uint64_t size{0};
+  };
+  std::vector<Region> regions;
+  std::unordered_map<std::string, size_t> index;
+
+  Region& region(std::string_view name) {
+    auto [itr, added] = index.emplace(std::string{name}, regions.size());
+    if (added) regions.push_back({std::string{name}});
+    return regions[itr->second];
+  }
+  static void append(Region& region, char bit) {
+    if (region.size % 64 == 0) region.words.push_back(0);
+    if (bit == '1') region.words.back() |= uint64_t{1} << (region.size % 64);
+    region.size++;
+  }
+  uint64_t size() const {
+    uint64_t size{0};
+    for (const auto& region : regions) size += region.size;
+    return size;
+  }
+};
+
+bool IsSpace(char c) { return std::isspace(static_cast<unsigned char>(c)); }
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && IsSpace(text.front())) text.remove_prefix(1);
+  while (!text.empty() && IsSpace(text.back())) text.remove_suffix(1);
+  return text;
+}
+
+template <typename Func>
+void ForEachLine(const std::string& data, Func func) {
+  std::string_view text{data};
+  while (!text.empty()) {
+    const size_t end = text.find('\n');
+    func(Trim(text.substr(0, end)));
+    if (end == std::string_view::npos) break;
+    text.remove_prefix(end + 1);
+  }
+}
+
+std::string_view Attribute(std::string_view line, std::string_view name) {
+  const size_t pos = line.find(std::string{name} + "=\"");
+  if (pos == std::string_view::npos) return {};
+  const size_t begin = pos + name.size() + 2;
+  const size_t end = line.find('"', begin);
+  if (end == std::string_view::npos) return {};
+  return line.substr(begin, end - begin);
+}
+
+// OpenFPGA plain text fabric bitstream: a configuration chain has the bits
+// alone on each line, frame and memory bank lines are "<address> <data>"
+Bits ParsePlainText(const std::string& data) {
+  Bits bits;
+  ForEachLine(data, [&bits](std::string_view line) {
+    if (line.empty() || line.substr(0, 2) == "//") return;
+    const size_t space = line.find_first_of(" \t");
+    std::string_view address;
+    if (space != std::string_view::npos) {
+      address = line.substr(0, space);
+      line = Trim(line.substr(space));
+    }
+    Bits::Region& region = bits.region(address);
+    for (char c : line) Bits::append(region, c);
+  });
+  return bits;
+}
+
+// OpenFPGA architecture bitstream, the tiles are the blocks of level 1
+Bits ParseArchitecture(const std::string& data) {
+  Bits bits;
+  Bits::Region* tile{nullptr};
+  ForEachLine(data, [&bits, &tile](std::string_view line) {
+    if (line.substr(0, 16) == "<bitstream_block") {
+      const std::string_view level = Attribute(line, "hierarchy_level");
+      if (level == "0" || level == "1")
+        tile = &bits.region(Attribute(line, "name"));
+    } else if (line.substr(0, 5) == "<bit " && tile) {
+      const std::string_view value = Attribute(line, "value");
+      Bits::append(*tile, value.empty() ? '0' : value.front());
+    }
+  });
+  return bits;
+}
+
+uint64_t Count(uint64_t word) { return std::bitset<64>(word).count(); }
+
+void AddOffsets(BitstreamStore::Difference& diff, uint64_t base,
+                uint64_t word) {
+  for (int bit = 0; word && diff.offsets.size() < BitstreamStore::MaxOffsets;
+       bit++, word >>= 1)
+    if (word & 1) diff.offsets.push_back(base + bit);
+}
+
+void Compare(const Bits& a, const Bits& b, BitstreamStore::Difference& diff) {
+  diff.sizeA = a.size();
+  diff.sizeB = b.size();
+  const Bits::Region empty;
+  uint64_t base{0};  // offset of the region in a
+  auto compare = [&](const Bits::Region& ra, const Bits::Region& rb) {
+    const uint64_t common = (std::min)(ra.size, rb.size);
+    uint64_t differing = (std::max)(ra.size, rb.size) - common;
+    for (uint64_t word = 0; word * 64 < common; word++) {
+      uint64_t x = ra.words[word] ^ rb.words[word];
+      if (common - word * 64 < 64) x &= (uint64_t{1} << (common % 64)) - 1;
+      if (!x) continue;
+      differing += Count(x);
+      AddOffsets(diff, base + word * 64, x);
+    }
+    diff.differing += differing;
+    if (differing && !(ra.name.empty() && rb.name.empty()))
+      diff.regions.emplace_back(ra.name.empty() ? rb.name : ra.name,
+                                differing);
+  };
+  for (const auto& region : a.regions) {
+    auto itr = b.index.find(region.name);
+    compare(region, itr == b.index.end() ? empty : b.regions[itr->second]);
+    base += region.size;
+  }
+  for (const auto& region : b.regions)
+    if (!a.index.count(region.name)) compare(empty, region);
+}
+
+void CompareBytes(const std::string& a, const std::string& b,
+                  BitstreamStore::Difference& diff) {
+  diff.sizeA = a.size();
+  diff.sizeB = b.size();
+  const size_t common = (std::min)(a.size(), b.size());
+  diff.differing = (std::max)(a.size(), b.size()) - common;
+  for (size_t offset = 0; offset < common; offset += 8) {
+    const size_t size = (std::min)(size_t{8}, common - offset);
+    if (std::memcmp(a.data() + offset, b.data() + offset, size) == 0) continue;
+    for (size_t i = offset; i < offset + size; i++) {
+      if (a[i] == b[i]) continue;
+      diff.differing++;
+      if (diff.offsets.size() < BitstreamStore::MaxOffsets)
+        diff.offsets.push_back(i);
+    }
+  }
+}
+}  // namespace
+
+BitstreamStore::Difference BitstreamStore::DiffData(const std::string& name,
+                                                    const std::string& a,
+                                                    const std::string& b) {
+  Difference diff;
+  diff.output = name;
+  const std::string extension =
+      StringUtils::toLower(fs::path{name}.extension().string());
+  auto architecture = [](const std::string& data) {
+    return data.find("<bitstream_block") != std::string::npos;
+  };
+  if (extension == ".bit") {
+    Compare(ParsePlainText(a), ParsePlainText(b), diff);
+  } else if (extension == ".xml" && (architecture(a) || architecture(b))) {
+    Compare(ParseArchitecture(a), ParseArchitecture(b), diff);
+  } else {
+    CompareBytes(a, b, diff);
+  }
+  diff.identical = diff.differing == 0;
+  return diff;
+}
+
+bool BitstreamStore::Diff(const Build& a, const Build& b,
+                          std::vector<Difference>& differences) {
+  differences.clear();
+  auto find = [](const Build& build, const std::string& name) {
+    return std::find_if(
+        build.outputs.begin(), build.outputs.end(),
+        [&name](const Output& output) { return output.name == name; });
+  };
+  std::vector<std::string> names;
+  for (const auto& output : a.outputs) names.push_back(output.name);
+  for (const auto& output : b.outputs)
+    if (find(a, output.name) == a.outputs.end()) names.push_back(output.name);
+
+  for (const auto& name : names) {
+    auto outputA = find(a, name);
+    auto outputB = find(b, name);
+    const bool inA = outputA != a.outputs.end();
+    const bool inB = outputB != b.outputs.end();
+    // Same hash, same content: neither is read
+    if (inA && inB && outputA->object == outputB->object) {
+      Difference diff;
+      diff.output = name;
+      diff.identical = true;
+      differences.push_back(diff);
+      continue;
+    }
+    std::string dataA, dataB;
+    if (inA && !Read(*outputA, dataA)) return false;
+    if (inB && !Read(*outputB, dataB)) return false;
+    differences.push_back(DiffData(name, dataA, dataB));
+  }
+  return true;
+}
+
+}  // namespace FOEDAG
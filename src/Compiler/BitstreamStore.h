@@ -0,0 +1,126 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The BitstreamStore class archives the outputs of bitstream
+ * generation. Every output is compressed and stored once under the SHA-256
+ * of its content. A build record lists the outputs of a build with its
+ * provenance: tool versions, options and source hashes. The build id is the
+ * hash of that provenance, so an unchanged build maps to the same id.
+ */
+class BitstreamStore {
+ public:
+  using Fields = std::vector<std::pair<std::string, std::string>>;
+  struct Output {
+    std::string name;  // relative to the run directory
+    std::string object;
+    uint64_t size{0};
+  };
+  struct Build {
+    std::string id;
+    int64_t time{0};
+    std::string design;
+    std::string device;
+    Fields tools;    // name, version
+    Fields options;  // name, value
+    Fields sources;  // path, SHA-256
+    std::vector<Output> outputs;
+  };
+  struct Difference {
+    std::string output;
+    bool identical{false};
+    // Configuration bits, or bytes for the outputs that aren't bitstreams
+    uint64_t sizeA{0};
+    uint64_t sizeB{0};
+    uint64_t differing{0};
+    // Offsets of the first differing bits
+    std::vector<uint64_t> offsets;
+    // Tiles (or frame addresses) with differing bits, in file order
+    std::vector<std::pair<std::string, uint64_t>> regions;
+  };
+
+  static constexpr const char* DefaultDir{"bitstream_store"};
+  static constexpr size_t MaxOffsets{64};
+
+  /*!
+   * \brief DefaultPath returns the store of a project. Setting
+   * FOEDAG_BITSTREAM_STORE shares one store between projects.
+   */
+  static std::filesystem::path DefaultPath(
+      const std::filesystem::path& projectPath);
+
+  bool Open(const std::filesystem::path& dir);
+  const std::filesystem::path& Dir() const { return m_dir; }
+  const std::string& LastError() const { return m_error; }
+
+  // Hash of everything but the time and the outputs
+  static std::string Id(const Build& build);
+  static bool HashFile(const std::filesystem::path& file, std::string& hash);
+
+  /*!
+   * \brief Store archives the \p outputs found in \p runDir and records the
+   * build under Id(build). Outputs that are missing are skipped.
+   */
+  bool Store(Build& build, const std::filesystem::path& runDir,
+             const std::vector<std::string>& outputs);
+  // Writes the outputs of a build back to \p runDir
+  bool Restore(const Build& build, const std::filesystem::path& runDir);
+  bool Contains(const std::string& id) const;
+
+  // Full id or unique prefix
+  bool Find(const std::string& id, Build& build);
+  // Oldest first
+  std::vector<Build> Builds() const;
+  bool Read(const Output& output, std::string& data);
+
+  /*!
+   * \brief Diff compares the outputs of two builds. Plain text bitstreams
+   * are compared bit by bit, per frame address when the file has some.
+   * Architecture bitstreams (XML) are compared per tile. Other outputs are
+   * compared byte by byte. Outputs with the same hash are reported identical
+   * without being read.
+   */
+  bool Diff(const Build& a, const Build& b,
+            std::vector<Difference>& differences);
+  static Difference DiffData(const std::string& name, const std::string& a,
+                             const std::string& b);
+
+ private:
+  std::filesystem::path objectPath(const std::string& object) const;
+  std::filesystem::path buildPath(const std::string& id) const;
+  bool writeObject(const std::string& data, const std::string& object);
+  bool writeBuild(const Build& build);
+  static bool readBuild(const std::filesystem::path& file, Build& build);
+
+  std::filesystem::path m_dir;
+  std::string m_error;
+};
+
+}  // namespace FOEDAG
@@ -36,16 +36,26 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QDebug>
 #include <QDir>
 #include <QProcess>
+#include <algorithm>
 #include <charconv>
 #include <chrono>
+#include <cstdlib>
 #include <ctime>
 #include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
 #include <sstream>
 #include <thread>
 
 #include "Compiler.h"
+#include "Compiler/BitstreamStore.h"
 #include "Compiler/Constraints.h"
+#include "Compiler/DesignHierarchy.h"
+#include "Compiler/FlowJobs.h"
+#include "Compiler/QorDatabase.h"
 #include "Compiler/TclInterpreterHandler.h"
+#include "Compiler/TimingPathDatabase.h"
 #include "Compiler/WorkerThread.h"
 #include "CompilerDefines.h"
 #include "IPGenerate/IPCatalogBuilder.h"
@@ -56,16 +66,98 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "MainWindow/main_window.h"
 #include "NewProject/ProjectManager/project_manager.h"
 #include "ProjNavigator/tcl_command_integration.h"
+#include "Simulation/WaveformReader.h"
 #include "TaskManager.h"
 #include "Utils/FileUtils.h"
 #include "Utils/ProcessUtils.h"
 #include "Utils/StringUtils.h"
 
 extern FOEDAG::Session* GlobalSession;
+
+namespace {
+// Starts the tool as the leader of its own process group, with the resource
+// limits of the running stage
+class GroupProcess : public QProcess {
+ public:
+  explicit GroupProcess(const FOEDAG::ResourceLimits& limits)
+      : m_limits(limits) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    setChildProcessModifier(
+        [this]() { FOEDAG::ProcessUtils::SetupChild(m_limits); });
+#endif
+  }
+
+ protected:
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+  void setupChildProcess() override {
+    FOEDAG::ProcessUtils::SetupChild(m_limits);
+  }
+#endif
+
+ private:
+  const FOEDAG::ResourceLimits m_limits;
+};
+}  // namespace
+
 using namespace FOEDAG;
 using Time = std::chrono::high_resolution_clock;
 using ms = std::chrono::milliseconds;
 
+static int64_t NowMs() {
+  return std::chrono::duration_cast<ms>(Time::now().time_since_epoch())
+      .count();
+}
+
+// Host memory a tool launch is accounted for when it has no history
+static constexpr unsigned int DefaultJobMemoryMb{1024};
+
+static CommandHistory* SessionHistory(Compiler* compiler) {
+  Session* session = compiler->GetSession();
+  if (!session || !session->CmdStack()) return nullptr;
+  return session->CmdStack()->History();
+}
+
+// ?<first>? ?<last>? arguments of the history commands, all by default
+static bool HistoryRange(Tcl_Interp* interp, int argc, const char* argv[],
+                         int index, uint64_t& first, uint64_t& last) {
+  first = 1;
+  last = UINT64_MAX;
+  Tcl_WideInt value{0};
+  if (index < argc) {
+    if (Tcl_GetWideInt(interp, argv[index], &value) != TCL_OK) return false;
+    first = value;
+    last = value;
+  }
+  if (index + 1 < argc) {
+    if (Tcl_GetWideInt(interp, argv[index + 1], &value) != TCL_OK)
+      return false;
+    last = value;
+  }
+  return true;
+}
+
+namespace {
+// End of a flow job, queued to the thread of the interpreter
+struct FlowJobEvent {
+  Tcl_Event header;  // must be first, Tcl frees the event through it
+  Compiler* compiler;
+  uint32_t id;
+};
+}  // namespace
+
+// Names of the flow stages in the QoR database, progress and limits
+static const std::map<Compiler::Action, const char*> QorStages{
+    {Compiler::Action::IPGen, "ipgenerate"},
+    {Compiler::Action::Analyze, "analyze"},
+    {Compiler::Action::Synthesis, "synthesize"},
+    {Compiler::Action::Pack, "packing"},
+    {Compiler::Action::Global, "global_placement"},
+    {Compiler::Action::Detailed, "place"},
+    {Compiler::Action::Routing, "route"},
+    {Compiler::Action::STA, "sta"},
+    {Compiler::Action::Power, "power"},
+    {Compiler::Action::Bitstream, "bitstream"}};
+
 extern const char* foedag_version_number;
 extern const char* foedag_git_hash;
 extern const char* foedag_build_type;
@@ -103,6 +195,13 @@ void Compiler::Help(std::ostream* out) {
             "a dummy compiler"
          << std::endl;
   (*out) << "   --mute           : Mutes stdout in batch mode" << std::endl;
+  (*out) << "   --profile-startup: Prints the startup time of each phase"
+         << std::endl;
+  (*out) << "   --server <socket>: Runs Tcl jobs sent to the unix socket, "
+            "--script is sourced once before serving"
+         << std::endl;
+  (*out) << "   --connect <socket>: Runs --script or --cmd on the server"
+         << std::endl;
   (*out) << "Tcl commands:" << std::endl;
   (*out) << "   help                       : This help" << std::endl;
   (*out) << "   create_design <name> ?-type <project type>? : Creates a design "
@@ -188,17 +287,105 @@ void Compiler::Help(std::ostream* out) {
   (*out) << "   route ?clean?" << std::endl;
   (*out) << "   sta ?clean?" << std::endl;
   (*out) << "   power ?clean?" << std::endl;
-  (*out) << "   bitstream ?clean?" << std::endl;
+  (*out) << "   bitstream ?clean? ?restore?" << std::endl;
+  (*out) << "   <flow command> ... -async ?-command <script>? : Runs the "
+            "stage in the background and returns a job id, <script> is called "
+            "with the id and the status when the job ends"
+         << std::endl;
+  (*out) << "   job_status ?<id>?          : Status of a job (queued, running, "
+            "ok, failed, cancelled), or {id name status} of all jobs"
+         << std::endl;
+  (*out) << "   job_wait ?-timeout <ms>? ?<id>...? : Waits for the jobs (all "
+            "by default) and returns their status"
+         << std::endl;
+  (*out) << "   job_cancel <id> | -all     : Cancels a queued job or stops "
+            "the running one"
+         << std::endl;
+  (*out) << "   history_find <pattern> ?-limit <count>? : Returns {id date "
+            "duration_ms code command} of the recorded commands matching "
+            "<pattern>, newest first"
+         << std::endl;
+  (*out) << "   history_export <file> ?<first>? ?<last>? : Writes the "
+            "successful commands of the history as a batch script"
+         << std::endl;
+  (*out) << "   history_replay ?<first>? ?<last>? : Runs the successful "
+            "commands of the history again"
+         << std::endl;
   (*out) << "   simulate <level> ?<simulator>? : Simulates the design and "
             "testbench"
          << std::endl;
-  (*out) << "            <level> : rtl, gate, pnr. rtl: RTL simulation, gate: "
-            "post-synthesis simulation, pnr: post-pnr simulation"
+  (*out) << "            <level> : rtl, gate, pnr, regression. rtl: RTL "
+            "simulation, gate: post-synthesis simulation, pnr: post-pnr "
+            "simulation, regression: RTL model built once, run for every "
+            "simulation_variant"
          << std::endl;
   (*out) << "            <simulator> : verilator, vcs, questa, icarus, ghdl, "
             "xcelium"
          << std::endl;
   writeWaveHelp(out, 3, 24);  // 24 is the col count of the : in the line above
+  (*out) << "   report_paths ?-n <count>? ?-slack_lt <ns>? ?-slack_gt <ns>? "
+            "?-from <pattern>? ?-to <pattern>? ?-clock <pattern>? "
+            "?-setup|-hold? ?-file <report>?"
+         << std::endl;
+  (*out) << "                              : Returns {id slack startpoint "
+            "endpoint start_clock end_clock check} of the worst timing paths "
+            "(100 by default)"
+         << std::endl;
+  (*out) << "   report_paths -path <id>    : Returns the {point incr time} "
+            "nodes of a path"
+         << std::endl;
+  (*out) << "   hierarchy tops             : Returns the top modules of the "
+            "analyzed design"
+         << std::endl;
+  (*out) << "   hierarchy children ?<path>?: Returns {instance module file "
+            "line} of the instances under an instance path (top.u_core)"
+         << std::endl;
+  (*out) << "   hierarchy ports <path>     : Returns {name direction msb lsb} "
+            "of the ports of the module of an instance"
+         << std::endl;
+  (*out) << "   hierarchy source ?-instance? <path>" << std::endl;
+  (*out) << "                              : Returns {file line} of the "
+            "module definition (or of the instantiation)"
+         << std::endl;
+  (*out) << "   hierarchy find ?-n <count>? ?-module? <pattern>" << std::endl;
+  (*out) << "                              : Returns the instance paths (or "
+            "the instances of the modules) matching a pattern"
+         << std::endl;
+  (*out) << "   qor run ?<name>?           : Labels the run the next stages "
+            "record their QoR metrics under"
+         << std::endl;
+  (*out) << "   qor runs                   : Lists the recorded runs"
+         << std::endl;
+  (*out) << "   qor compare ?<runA> <runB>? ?-strict? : Compares the stage "
+            "metrics of two runs (the last two by default), -strict fails on "
+            "a regression"
+         << std::endl;
+  (*out) << "   qor trend <stage> <metric> : {run value} history of a metric"
+         << std::endl;
+  (*out) << "   qor threshold <metric> ?<percent>? : Regression threshold, "
+            "* for all metrics, default 5%"
+         << std::endl;
+  (*out) << "   stage_limits ?<stage>|*? ?-memory <MB>? ?-cpus <list>? ?-nice "
+            "<n>? ?-ionice <class>[:<level>]? ?-timeout <sec>?"
+         << std::endl;
+  (*out) << "                              : Resource limits of the tools "
+            "run by a stage (* for all stages), 0 removes a limit"
+         << std::endl;
+  (*out) << "   host_admission ?-dir <path>? ?-capacity <MB>? | -off"
+         << std::endl;
+  (*out) << "                              : Queues tool "
+            "launches until their expected memory fits, shared by the runs "
+            "using <path>"
+         << std::endl;
+  (*out) << "   bitstream_archive list | provenance <build> : Archived "
+            "bitstream builds, tools, options and sources of a build"
+         << std::endl;
+  (*out) << "   bitstream_archive diff ?<buildA> <buildB>? : Configuration "
+            "bits and tiles that differ (the last two builds by default)"
+         << std::endl;
+  (*out) << "   bitstream_archive restore <build> ?<dir>? : Writes the "
+            "outputs of a build back"
+         << std::endl;
   (*out) << "-------------------------" << std::endl;
 }
 
@@ -223,10 +410,29 @@ void Compiler::SetTclInterpreterHandler(
 }
 
 Compiler::~Compiler() {
+  if (m_flowJobs) {
+    // The running job uses the members freed below: stop it and wait for
+    // the flow thread first
+    std::vector<uint32_t> ids;
+    for (const auto& job : m_flowJobs->Jobs())
+      if (!FlowJobs::IsFinished(job.status)) ids.push_back(job.id);
+    CancelFlowJobs(ids);
+    delete m_flowJobs;
+    m_flowJobs = nullptr;
+    // Ends of job not serviced yet
+    Tcl_DeleteEvents(
+        [](Tcl_Event* event, ClientData clientData) -> int {
+          return event->proc == &Compiler::FlowJobEnded &&
+                 ((FlowJobEvent*)event)->compiler == clientData;
+        },
+        this);
+  }
   delete m_taskManager;
   delete m_tclCmdIntegration;
   delete m_IPGenerator;
   delete m_simulator;
+  for (auto& [file, paths] : m_timingPaths) delete paths;
+  delete m_hierarchy;
 }
 
 void Compiler::Message(const std::string& message) {
@@ -838,7 +1044,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       }
       return compiler->Compile(Action::IPGen) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("ipgenerate", ipgenerate, this, 0);
+    RegisterFlowCmd(interp, "ipgenerate", ipgenerate);
 
     auto simulate = [](void* clientData, Tcl_Interp* interp, int argc,
                        const char* argv[]) -> int {
@@ -868,7 +1074,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
         } else if (arg == "xcelium") {
           sim_tool = Simulator::SimulatorType::Xcelium;
         } else if (arg == "rtl" || arg == "gate" || arg == "pnr" ||
-                   arg == "bitstream") {
+                   arg == "bitstream" || arg == "regression") {
           sim_type = arg;
         } else {
           wave_file = arg;
@@ -891,11 +1097,14 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
         } else if (sim_type == "bitstream") {
           status = compiler->GetSimulator()->Simulate(
               Simulator::SimulationType::Bitstream, sim_tool, wave_file);
+        } else if (sim_type == "regression") {
+          status = compiler->GetSimulator()->Simulate(
+              Simulator::SimulationType::Regression, sim_tool, wave_file);
         }
       }
       return (status) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("simulate", simulate, this, 0);
+    RegisterFlowCmd(interp, "simulate", simulate);
 
     auto analyze = [](void* clientData, Tcl_Interp* interp, int argc,
                       const char* argv[]) -> int {
@@ -910,7 +1119,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       }
       return compiler->Compile(Action::Analyze) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("analyze", analyze, this, 0);
+    RegisterFlowCmd(interp, "analyze", analyze);
 
     auto synthesize = [](void* clientData, Tcl_Interp* interp, int argc,
                          const char* argv[]) -> int {
@@ -933,8 +1142,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       }
       return compiler->Compile(Action::Synthesis) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("synthesize", synthesize, this, 0);
-    interp->registerCmd("synth", synthesize, this, 0);
+    RegisterFlowCmd(interp, "synthesize", synthesize);
+    RegisterFlowCmd(interp, "synth", synthesize);
 
     auto packing = [](void* clientData, Tcl_Interp* interp, int argc,
                       const char* argv[]) -> int {
@@ -949,7 +1158,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       }
       return compiler->Compile(Action::Pack) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("packing", packing, this, 0);
+    RegisterFlowCmd(interp, "packing", packing);
 
     auto globalplacement = [](void* clientData, Tcl_Interp* interp, int argc,
                               const char* argv[]) -> int {
@@ -964,8 +1173,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       }
       return compiler->Compile(Action::Global) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("global_placement", globalplacement, this, 0);
-    interp->registerCmd("globp", globalplacement, this, 0);
+    RegisterFlowCmd(interp, "global_placement", globalplacement);
+    RegisterFlowCmd(interp, "globp", globalplacement);
 
     auto placement = [](void* clientData, Tcl_Interp* interp, int argc,
                         const char* argv[]) -> int {
@@ -980,8 +1189,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       }
       return compiler->Compile(Action::Detailed) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("detailed_placement", placement, this, 0);
-    interp->registerCmd("place", placement, this, 0);
+    RegisterFlowCmd(interp, "detailed_placement", placement);
+    RegisterFlowCmd(interp, "place", placement);
 
     auto pin_loc_assign_method = [](void* clientData, Tcl_Interp* interp,
                                     int argc, const char* argv[]) -> int {
@@ -1027,7 +1236,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       }
       return compiler->Compile(Action::Routing) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("route", route, this, 0);
+    RegisterFlowCmd(interp, "route", route);
 
     auto sta = [](void* clientData, Tcl_Interp* interp, int argc,
                   const char* argv[]) -> int {
@@ -1046,7 +1255,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       }
       return compiler->Compile(Action::STA) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("sta", sta, this, 0);
+    RegisterFlowCmd(interp, "sta", sta);
 
     auto power = [](void* clientData, Tcl_Interp* interp, int argc,
                     const char* argv[]) -> int {
@@ -1061,7 +1270,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       }
       return compiler->Compile(Action::Power) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("power", power, this, 0);
+    RegisterFlowCmd(interp, "power", power);
 
     auto bitstream = [](void* clientData, Tcl_Interp* interp, int argc,
                         const char* argv[]) -> int {
@@ -1072,13 +1281,15 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           compiler->BitsOpt(Compiler::BitstreamOpt::Force);
         } else if (arg == "clean") {
           compiler->BitsOpt(Compiler::BitstreamOpt::Clean);
+        } else if (arg == "restore") {
+          compiler->BitsOpt(Compiler::BitstreamOpt::Restore);
         } else {
           compiler->ErrorMessage("Unknown bitstream option: " + arg);
         }
       }
       return compiler->Compile(Action::Bitstream) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("bitstream", bitstream, this, 0);
+    RegisterFlowCmd(interp, "bitstream", bitstream);
 
     auto stop = [](void* clientData, Tcl_Interp* interp, int argc,
                    const char* argv[]) -> int {
@@ -1118,7 +1329,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           new WorkerThread("ip_th", Action::IPGen, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("ipgenerate", ipgenerate, this, 0);
+    RegisterFlowCmd(interp, "ipgenerate", ipgenerate);
 
     auto analyze = [](void* clientData, Tcl_Interp* interp, int argc,
                       const char* argv[]) -> int {
@@ -1135,7 +1346,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           new WorkerThread("analyze_th", Action::Analyze, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("analyze", analyze, this, 0);
+    RegisterFlowCmd(interp, "analyze", analyze);
 
     auto simulate = [](void* clientData, Tcl_Interp* interp, int argc,
                        const char* argv[]) -> int {
@@ -1165,7 +1376,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
         } else if (arg == "xcelium") {
           sim_tool = Simulator::SimulatorType::Xcelium;
         } else if (arg == "rtl" || arg == "gate" || arg == "pnr" ||
-                   arg == "bitstream") {
+                   arg == "bitstream" || arg == "regression") {
           sim_type = arg;
         } else {
           wave_file = arg;
@@ -1197,11 +1408,16 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
               "simulate_rtl_th", Action::SimulateBitstream, compiler);
           status = wthread->start();
           if (!status) return TCL_ERROR;
+        } else if (sim_type == "regression") {
+          WorkerThread* wthread = new WorkerThread(
+              "simulate_regression_th", Action::SimulateRegression, compiler);
+          status = wthread->start();
+          if (!status) return TCL_ERROR;
         }
       }
       return (status) ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("simulate", simulate, this, 0);
+    RegisterFlowCmd(interp, "simulate", simulate);
 
     auto synthesize = [](void* clientData, Tcl_Interp* interp, int argc,
                          const char* argv[]) -> int {
@@ -1250,8 +1466,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           new WorkerThread("synth_th", Action::Synthesis, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("synthesize", synthesize, this, 0);
-    interp->registerCmd("synth", synthesize, this, 0);
+    RegisterFlowCmd(interp, "synthesize", synthesize);
+    RegisterFlowCmd(interp, "synth", synthesize);
 
     auto packing = [](void* clientData, Tcl_Interp* interp, int argc,
                       const char* argv[]) -> int {
@@ -1268,7 +1484,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           new WorkerThread("pack_th", Action::Pack, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("packing", packing, this, 0);
+    RegisterFlowCmd(interp, "packing", packing);
 
     auto globalplacement = [](void* clientData, Tcl_Interp* interp, int argc,
                               const char* argv[]) -> int {
@@ -1285,8 +1501,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           new WorkerThread("glob_th", Action::Global, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("global_placement", globalplacement, this, 0);
-    interp->registerCmd("globp", globalplacement, this, 0);
+    RegisterFlowCmd(interp, "global_placement", globalplacement);
+    RegisterFlowCmd(interp, "globp", globalplacement);
 
     auto placement = [](void* clientData, Tcl_Interp* interp, int argc,
                         const char* argv[]) -> int {
@@ -1303,8 +1519,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           new WorkerThread("place_th", Action::Detailed, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("detailed_placement", placement, this, 0);
-    interp->registerCmd("place", placement, this, 0);
+    RegisterFlowCmd(interp, "detailed_placement", placement);
+    RegisterFlowCmd(interp, "place", placement);
 
     auto pin_loc_assign_method = [](void* clientData, Tcl_Interp* interp,
                                     int argc, const char* argv[]) -> int {
@@ -1352,7 +1568,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           new WorkerThread("route_th", Action::Routing, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("route", route, this, 0);
+    RegisterFlowCmd(interp, "route", route);
 
     auto sta = [](void* clientData, Tcl_Interp* interp, int argc,
                   const char* argv[]) -> int {
@@ -1372,7 +1588,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
       WorkerThread* wthread = new WorkerThread("sta_th", Action::STA, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("sta", sta, this, 0);
+    RegisterFlowCmd(interp, "sta", sta);
 
     auto power = [](void* clientData, Tcl_Interp* interp, int argc,
                     const char* argv[]) -> int {
@@ -1389,7 +1605,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           new WorkerThread("power_th", Action::Power, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("power", power, this, 0);
+    RegisterFlowCmd(interp, "power", power);
 
     auto bitstream = [](void* clientData, Tcl_Interp* interp, int argc,
                         const char* argv[]) -> int {
@@ -1400,6 +1616,8 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           compiler->BitsOpt(Compiler::BitstreamOpt::Force);
         } else if (arg == "clean") {
           compiler->BitsOpt(Compiler::BitstreamOpt::Clean);
+        } else if (arg == "restore") {
+          compiler->BitsOpt(Compiler::BitstreamOpt::Restore);
         } else {
           compiler->ErrorMessage("Unknown bitstream option: " + arg);
         }
@@ -1408,7 +1626,7 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
           new WorkerThread("bitstream_th", Action::Bitstream, compiler);
       return wthread->start() ? TCL_OK : TCL_ERROR;
     };
-    interp->registerCmd("bitstream", bitstream, this, 0);
+    RegisterFlowCmd(interp, "bitstream", bitstream);
 
     auto stop = [](void* clientData, Tcl_Interp* interp, int argc,
                    const char* argv[]) -> int {
@@ -1602,9 +1820,1058 @@ bool Compiler::RegisterCommands(TclInterpreter* interp, bool batchMode) {
   };
   interp->registerCmd("wave_refresh", wave_refresh, this, nullptr);
 
+  // Native waveform queries, no GTKWave process involved
+  auto wave_value = [](void* clientData, Tcl_Interp* interp, int argc,
+                       const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    std::string file;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      if (arg == "-file" && i + 1 < argc)
+        file = argv[++i];
+      else
+        args.push_back(arg);
+    }
+    if (args.size() != 2) {
+      Tcl_AppendResult(
+          interp, "Expected Syntax: wave_value <signal> <time> ?-file <file>?",
+          nullptr);
+      return TCL_ERROR;
+    }
+    std::string error;
+    WaveformReader* reader = compiler->GetWaveformReader(file, error);
+    if (!reader) {
+      Tcl_AppendResult(interp, error.c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    uint64_t time{0};
+    if (!reader->ParseTime(args[1], time)) {
+      Tcl_AppendResult(interp, ("Invalid time: " + args[1]).c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    std::string value;
+    if (!reader->ValueAt(args[0], time, value)) {
+      Tcl_AppendResult(interp, ("Unknown signal: " + args[0]).c_str(),
+                       nullptr);
+      return TCL_ERROR;
+    }
+    Tcl_AppendResult(interp, value.c_str(), nullptr);
+    return TCL_OK;
+  };
+  interp->registerCmd("wave_value", wave_value, this, nullptr);
+
+  auto wave_transitions = [](void* clientData, Tcl_Interp* interp, int argc,
+                             const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    std::string file, from, to, signal;
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      if (arg == "-file" && i + 1 < argc)
+        file = argv[++i];
+      else if (arg == "-from" && i + 1 < argc)
+        from = argv[++i];
+      else if (arg == "-to" && i + 1 < argc)
+        to = argv[++i];
+      else
+        signal = arg;
+    }
+    if (signal.empty()) {
+      Tcl_AppendResult(interp,
+                       "Expected Syntax: wave_transitions <signal> ?-from "
+                       "<time>? ?-to <time>? ?-file <file>?",
+                       nullptr);
+      return TCL_ERROR;
+    }
+    std::string error;
+    WaveformReader* reader = compiler->GetWaveformReader(file, error);
+    if (!reader) {
+      Tcl_AppendResult(interp, error.c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    uint64_t fromTime{0}, toTime{UINT64_MAX};
+    if ((!from.empty() && !reader->ParseTime(from, fromTime)) ||
+        (!to.empty() && !reader->ParseTime(to, toTime))) {
+      Tcl_AppendResult(interp, "Invalid time range", nullptr);
+      return TCL_ERROR;
+    }
+    if (!reader->HasSignal(signal)) {
+      Tcl_AppendResult(interp, ("Unknown signal: " + signal).c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    for (const auto& tr : reader->Transitions(signal, fromTime, toTime)) {
+      std::string pair = std::to_string(tr.time) + " " + tr.value;
+      Tcl_AppendElement(interp, pair.c_str());
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("wave_transitions", wave_transitions, this, nullptr);
+
+  auto wave_diff = [](void* clientData, Tcl_Interp* interp, int argc,
+                      const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    if (argc < 3) {
+      Tcl_AppendResult(
+          interp, "Expected Syntax: wave_diff <fileA> <fileB> ?<signal>...?",
+          nullptr);
+      return TCL_ERROR;
+    }
+    std::string error;
+    WaveformReader* a = compiler->GetWaveformReader(argv[1], error);
+    WaveformReader* b = a ? compiler->GetWaveformReader(argv[2], error)
+                          : nullptr;
+    if (!a || !b) {
+      Tcl_AppendResult(interp, error.c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    std::vector<std::string> signals;
+    for (int i = 3; i < argc; i++) signals.push_back(argv[i]);
+    for (const auto& diff : WaveformReader::Diff(*a, *b, signals)) {
+      std::string entry = diff.signal + " " + std::to_string(diff.time) +
+                          " {" + diff.valueA + "} {" + diff.valueB + "}";
+      Tcl_AppendElement(interp, entry.c_str());
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("wave_diff", wave_diff, this, nullptr);
+
+  auto qor = [](void* clientData, Tcl_Interp* interp, int argc,
+                const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    const std::string usage{
+        "Expected Syntax: qor run ?<name>? | runs | compare ?<runA> <runB>? "
+        "?-strict? | trend <stage> <metric> | threshold <metric> "
+        "?<percent>?"};
+    std::string sub = (argc > 1) ? argv[1] : "";
+    ProjectManager* projManager = compiler->ProjManager();
+    if (!projManager || projManager->projectPath().empty()) {
+      Tcl_AppendResult(interp, "No project is open", nullptr);
+      return TCL_ERROR;
+    }
+    QorDatabase db;
+    db.Open(QorDatabase::DefaultPath(projManager->projectPath()));
+    if (sub == "run") {
+      if (argc > 2) {
+        // The label applies to the stages recorded from now on
+        compiler->m_qorRun = argv[2];
+        compiler->m_qorLastAction = Action::NoAction;
+      }
+      Tcl_AppendResult(interp, compiler->m_qorRun.c_str(), nullptr);
+      return TCL_OK;
+    }
+    if (sub == "runs") {
+      for (const auto& run : db.Runs())
+        Tcl_AppendElement(interp, run.c_str());
+      return TCL_OK;
+    }
+    if (sub == "compare") {
+      bool strict{false};
+      std::vector<std::string> runs;
+      for (int i = 2; i < argc; i++) {
+        if (std::string{argv[i]} == "-strict")
+          strict = true;
+        else
+          runs.push_back(argv[i]);
+      }
+      if (runs.empty()) {
+        runs = db.Runs();
+        if (runs.size() > 2) runs.erase(runs.begin(), runs.end() - 2);
+      }
+      if (runs.size() != 2) {
+        Tcl_AppendResult(interp, "Two runs are needed to compare", nullptr);
+        return TCL_ERROR;
+      }
+      int regressions{0};
+      std::ostream* out = compiler->GetOutStream();
+      (*out) << "QoR " << runs[0] << " -> " << runs[1] << std::endl;
+      for (const auto& delta : db.Compare(runs[0], runs[1])) {
+        std::stringstream line;
+        line << "  " << std::left << std::setw(18) << delta.stage
+             << std::setw(14) << delta.metric << std::right << std::setw(12)
+             << delta.valueA << std::setw(12) << delta.valueB
+             << std::setw(9) << std::fixed << std::setprecision(1)
+             << delta.percent << "%";
+        if (delta.regression) {
+          line << "  REGRESSION (threshold " << db.Threshold(delta.metric)
+               << "%)";
+          regressions++;
+        }
+        (*out) << line.str() << std::endl;
+        std::stringstream element;
+        element << delta.stage << " " << delta.metric << " " << delta.valueA
+                << " " << delta.valueB << " " << delta.percent << " "
+                << delta.regression;
+        Tcl_AppendElement(interp, element.str().c_str());
+      }
+      if (strict && regressions) {
+        Tcl_ResetResult(interp);
+        Tcl_AppendResult(
+            interp,
+            (std::to_string(regressions) + " QoR regression(s)").c_str(),
+            nullptr);
+        return TCL_ERROR;
+      }
+      return TCL_OK;
+    }
+    if (sub == "trend" && argc == 4) {
+      for (const auto& [run, value] : db.Trend(argv[2], argv[3])) {
+        std::stringstream element;
+        element << run << " " << value;
+        Tcl_AppendElement(interp, element.str().c_str());
+      }
+      return TCL_OK;
+    }
+    if (sub == "threshold" && (argc == 3 || argc == 4)) {
+      if (argc == 4) {
+        char* end = nullptr;
+        const double percent = std::strtod(argv[3], &end);
+        if (end == argv[3] || *end != '\0') {
+          Tcl_AppendResult(interp, "Invalid percentage", nullptr);
+          return TCL_ERROR;
+        }
+        if (!db.SetThreshold(argv[2], percent)) {
+          Tcl_AppendResult(interp, db.LastError().c_str(), nullptr);
+          return TCL_ERROR;
+        }
+      }
+      Tcl_AppendResult(interp, std::to_string(db.Threshold(argv[2])).c_str(),
+                       nullptr);
+      return TCL_OK;
+    }
+    Tcl_AppendResult(interp, usage.c_str(), nullptr);
+    return TCL_ERROR;
+  };
+  interp->registerCmd("qor", qor, this, nullptr);
+
+  auto bitstream_archive = [](void* clientData, Tcl_Interp* interp, int argc,
+                              const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    const std::string usage{
+        "Expected Syntax: bitstream_archive list | provenance <build> | diff "
+        "?<buildA> <buildB>? | restore <build> ?<dir>?"};
+    std::string sub = (argc > 1) ? argv[1] : "";
+    ProjectManager* projManager = compiler->ProjManager();
+    if (!projManager || projManager->projectPath().empty()) {
+      Tcl_AppendResult(interp, "No project is open", nullptr);
+      return TCL_ERROR;
+    }
+    BitstreamStore store;
+    if (!store.Open(BitstreamStore::DefaultPath(projManager->projectPath()))) {
+      Tcl_AppendResult(interp, store.LastError().c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    std::ostream* out = compiler->GetOutStream();
+    auto find = [&store, interp](const char* id,
+                                 BitstreamStore::Build& build) {
+      if (store.Find(id, build)) return true;
+      Tcl_AppendResult(interp, store.LastError().c_str(), nullptr);
+      return false;
+    };
+    if (sub == "list") {
+      for (const auto& build : store.Builds()) {
+        const std::time_t time = build.time;
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S",
+                      std::localtime(&time));
+        (*out) << build.id.substr(0, 12) << "  " << stamp << "  "
+               << build.design << "  " << build.device << std::endl;
+        Tcl_AppendElement(interp, build.id.c_str());
+      }
+      return TCL_OK;
+    }
+    if (sub == "provenance" && argc == 3) {
+      BitstreamStore::Build build;
+      if (!find(argv[2], build)) return TCL_ERROR;
+      (*out) << "Build  " << build.id << std::endl;
+      (*out) << "Design " << build.design << " on " << build.device
+             << std::endl;
+      for (const auto& [name, version] : build.tools)
+        (*out) << "Tool   " << name << " " << version << std::endl;
+      // Options may be whole scripts, only their first line is shown
+      for (const auto& [name, value] : build.options)
+        (*out) << "Option " << name << " "
+               << value.substr(0, value.find('\n')) << std::endl;
+      for (const auto& [path, hash] : build.sources)
+        (*out) << "Source " << hash.substr(0, 12) << " " << path << std::endl;
+      for (const auto& output : build.outputs)
+        (*out) << "Output " << output.object.substr(0, 12) << " "
+               << output.name << " (" << output.size << " bytes)"
+               << std::endl;
+      return TCL_OK;
+    }
+    if (sub == "diff" && (argc == 2 || argc == 4)) {
+      BitstreamStore::Build a, b;
+      if (argc == 4) {
+        if (!find(argv[2], a) || !find(argv[3], b)) return TCL_ERROR;
+      } else {
+        auto builds = store.Builds();
+        if (builds.size() < 2) {
+          Tcl_AppendResult(interp, "Two builds are needed to compare",
+                           nullptr);
+          return TCL_ERROR;
+        }
+        a = builds[builds.size() - 2];
+        b = builds.back();
+      }
+      std::vector<BitstreamStore::Difference> differences;
+      if (!store.Diff(a, b, differences)) {
+        Tcl_AppendResult(interp, store.LastError().c_str(), nullptr);
+        return TCL_ERROR;
+      }
+      (*out) << "Bitstream " << a.id.substr(0, 12) << " -> "
+             << b.id.substr(0, 12) << std::endl;
+      for (const auto& diff : differences) {
+        std::stringstream element;
+        element << diff.output << " " << diff.differing;
+        if (diff.identical) {
+          (*out) << "  " << diff.output << ": identical" << std::endl;
+          Tcl_AppendElement(interp, element.str().c_str());
+          continue;
+        }
+        (*out) << "  " << diff.output << ": " << diff.differing
+               << " differing (" << diff.sizeA << " -> " << diff.sizeB << ")"
+               << std::endl;
+        for (const auto& [region, count] : diff.regions) {
+          (*out) << "    " << region << ": " << count << std::endl;
+          element << " " << region << " " << count;
+        }
+        if (!diff.offsets.empty()) {
+          (*out) << "    first at:";
+          for (auto offset : diff.offsets) (*out) << " " << offset;
+          (*out) << std::endl;
+        }
+        Tcl_AppendElement(interp, element.str().c_str());
+      }
+      return TCL_OK;
+    }
+    if (sub == "restore" && (argc == 3 || argc == 4)) {
+      BitstreamStore::Build build;
+      if (!find(argv[2], build)) return TCL_ERROR;
+      const std::filesystem::path dir =
+          (argc == 4) ? std::filesystem::path{argv[3]}
+                      : std::filesystem::path{projManager->projectPath()};
+      if (!store.Restore(build, dir)) {
+        Tcl_AppendResult(interp, store.LastError().c_str(), nullptr);
+        return TCL_ERROR;
+      }
+      return TCL_OK;
+    }
+    Tcl_AppendResult(interp, usage.c_str(), nullptr);
+    return TCL_ERROR;
+  };
+  interp->registerCmd("bitstream_archive", bitstream_archive, this, nullptr);
+
+  auto stage_limits = [](void* clientData, Tcl_Interp* interp, int argc,
+                         const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    if (argc == 1) {
+      for (const auto& [stage, limits] : compiler->m_stageLimits) {
+        const std::string element = stage + " {" + limits.ToString() + "}";
+        Tcl_AppendElement(interp, element.c_str());
+      }
+      return TCL_OK;
+    }
+    const std::string stage{argv[1]};
+    bool known{stage == "*"};
+    for (const auto& [action, name] : QorStages) known |= (stage == name);
+    if (!known) {
+      Tcl_AppendResult(interp, ("Unknown stage " + stage).c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    auto itr = compiler->m_stageLimits.find(stage);
+    ResourceLimits limits =
+        (itr != compiler->m_stageLimits.end()) ? itr->second : ResourceLimits{};
+    std::string error;
+    const std::vector<std::string> options(argv + 2, argv + argc);
+    if (!limits.Parse(options, error)) {
+      Tcl_AppendResult(interp, error.c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    compiler->StageLimits(stage, limits);
+    Tcl_AppendResult(interp, limits.ToString().c_str(), nullptr);
+    return TCL_OK;
+  };
+  interp->registerCmd("stage_limits", stage_limits, this, nullptr);
+
+  // Runs sharing the directory named by the environment share the host
+  if (const char* dir = std::getenv(HostAdmission::DirVariable)) {
+    if (!m_admission.Configure(dir, 0))
+      ErrorMessage(m_admission.LastError());
+  }
+  auto host_admission = [](void* clientData, Tcl_Interp* interp, int argc,
+                           const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    HostAdmission& admission = compiler->m_admission;
+    std::filesystem::path dir = admission.Dir();
+    unsigned int capacity = admission.Capacity();
+    for (int i = 1; i < argc; i++) {
+      const std::string option{argv[i]};
+      if (option == "-off") {
+        dir.clear();
+      } else if (option == "-dir" && i + 1 < argc) {
+        dir = argv[++i];
+      } else if (option == "-capacity" && i + 1 < argc) {
+        int value{0};
+        if (Tcl_GetInt(interp, argv[++i], &value) != TCL_OK) return TCL_ERROR;
+        if (value <= 0) {
+          Tcl_AppendResult(interp,
+                           "host_admission: -capacity must be a positive "
+                           "number of MB",
+                           nullptr);
+          return TCL_ERROR;
+        }
+        capacity = static_cast<unsigned int>(value);
+      } else {
+        Tcl_AppendResult(interp,
+                         "Expected Syntax: host_admission ?-dir <path>? "
+                         "?-capacity <MB>? | -off",
+                         nullptr);
+        return TCL_ERROR;
+      }
+    }
+    if (argc > 1 && !admission.Configure(dir, capacity)) {
+      Tcl_AppendResult(interp, admission.LastError().c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    if (admission.IsEnabled()) {
+      unsigned int used{0};
+      for (const auto& job : admission.Jobs()) used += job.weightMb;
+      Tcl_AppendElement(interp, admission.Dir().string().c_str());
+      Tcl_AppendElement(interp, std::to_string(admission.Capacity()).c_str());
+      Tcl_AppendElement(interp, std::to_string(used).c_str());
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("host_admission", host_admission, this, nullptr);
+
+  auto report_paths = [](void* clientData, Tcl_Interp* interp, int argc,
+                         const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    TimingPathDatabase::Query query;
+    query.limit = 100;
+    std::string file;
+    bool hold{false};
+    int path{-1};
+    auto number = [](const char* text, double& value) {
+      char* end = nullptr;
+      value = std::strtod(text, &end);
+      return end != text && *end == '\0';
+    };
+    for (int i = 1; i < argc; i++) {
+      const std::string arg = argv[i];
+      const bool hasValue = i + 1 < argc;
+      double value{0};
+      if (arg == "-n" && hasValue && number(argv[++i], value) && value >= 0) {
+        query.limit = static_cast<size_t>(value);
+      } else if (arg == "-slack_lt" && hasValue && number(argv[++i], value)) {
+        query.slackLt = value;
+      } else if (arg == "-slack_gt" && hasValue && number(argv[++i], value)) {
+        query.slackGt = value;
+      } else if (arg == "-from" && hasValue) {
+        query.from = argv[++i];
+      } else if (arg == "-to" && hasValue) {
+        query.to = argv[++i];
+      } else if (arg == "-clock" && hasValue) {
+        query.clock = argv[++i];
+      } else if (arg == "-setup" || arg == "-hold") {
+        hold = arg == "-hold";
+        query.anyCheck = false;
+        query.check = hold ? TimingPathDatabase::Check::Hold
+                           : TimingPathDatabase::Check::Setup;
+      } else if (arg == "-file" && hasValue) {
+        file = argv[++i];
+      } else if (arg == "-path" && hasValue && number(argv[++i], value) &&
+                 value >= 0) {
+        path = static_cast<int>(value);
+      } else {
+        Tcl_AppendResult(
+            interp,
+            "Expected Syntax: report_paths ?-n <count>? ?-slack_lt <ns>? "
+            "?-slack_gt <ns>? ?-from <pattern>? ?-to <pattern>? ?-clock "
+            "<pattern>? ?-setup|-hold? ?-file <report>? | -path <id>",
+            nullptr);
+        return TCL_ERROR;
+      }
+    }
+    std::string error;
+    TimingPathDatabase* paths = compiler->GetTimingPaths(file, hold, error);
+    if (!paths) {
+      Tcl_AppendResult(interp, error.c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    if (path >= 0) {
+      if (static_cast<size_t>(path) >= paths->Size()) {
+        Tcl_AppendResult(interp, "Invalid path id", nullptr);
+        return TCL_ERROR;
+      }
+      for (const auto& node : paths->Nodes(path)) {
+        std::stringstream element;
+        element << "{" << node.point << "} " << node.incr << " " << node.time;
+        Tcl_AppendElement(interp, element.str().c_str());
+      }
+      return TCL_OK;
+    }
+    for (uint32_t id : paths->Find(query)) {
+      const auto& p = paths->At(id);
+      std::stringstream element;
+      element << id << " " << p.slack << " {" << paths->Name(p.startpoint)
+              << "} {" << paths->Name(p.endpoint) << "} {"
+              << paths->Name(p.startClock) << "} {"
+              << paths->Name(p.endClock) << "} "
+              << (p.check == TimingPathDatabase::Check::Hold ? "hold"
+                                                              : "setup");
+      Tcl_AppendElement(interp, element.str().c_str());
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("report_paths", report_paths, this, nullptr);
+
+  auto hierarchy = [](void* clientData, Tcl_Interp* interp, int argc,
+                      const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    const std::string syntax =
+        "Expected Syntax: hierarchy tops | children ?<path>? | ports <path> "
+        "| source ?-instance? <path> | find ?-n <count>? ?-module? <pattern>";
+    const std::string sub = argc > 1 ? argv[1] : std::string{};
+    std::vector<std::string> args(argv + (std::min)(argc, 2), argv + argc);
+    bool instanceSource{false};
+    bool byModule{false};
+    size_t limit{100};
+    for (auto itr = args.begin(); itr != args.end();) {
+      if (sub == "source" && *itr == "-instance") {
+        instanceSource = true;
+      } else if (sub == "find" && *itr == "-module") {
+        byModule = true;
+      } else if (sub == "find" && *itr == "-n" && itr + 1 != args.end()) {
+        itr = args.erase(itr);
+        limit = std::strtoul(itr->c_str(), nullptr, 10);
+      } else {
+        ++itr;
+        continue;
+      }
+      itr = args.erase(itr);
+    }
+    const bool valid = (sub == "tops" && args.empty()) ||
+                       (sub == "children" && args.size() <= 1) ||
+                       ((sub == "ports" || sub == "source" || sub == "find") &&
+                        args.size() == 1);
+    if (!valid) {
+      Tcl_AppendResult(interp, syntax.c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    std::string error;
+    DesignHierarchy* hier = compiler->GetDesignHierarchy(error);
+    if (!hier) {
+      Tcl_AppendResult(interp, error.c_str(), nullptr);
+      return TCL_ERROR;
+    }
+    if (sub == "tops") {
+      for (uint32_t top : hier->Tops()) {
+        const std::string name{hier->Name(hier->GetModule(top).name)};
+        Tcl_AppendElement(interp, name.c_str());
+      }
+      return TCL_OK;
+    }
+    if (sub == "find") {
+      for (const auto& path : hier->Find(args.front(), limit, byModule))
+        Tcl_AppendElement(interp, path.c_str());
+      return TCL_OK;
+    }
+    auto element = [hier](std::string_view name, uint32_t module,
+                          uint32_t file, uint32_t line) {
+      std::stringstream stream;
+      stream << "{" << name << "} {" << hier->Name(hier->GetModule(module).name)
+             << "} {" << hier->Name(file) << "} " << line;
+      return stream.str();
+    };
+    if (sub == "children" && args.empty()) {
+      for (uint32_t top : hier->Tops()) {
+        const auto& module = hier->GetModule(top);
+        Tcl_AppendElement(
+            interp,
+            element(hier->Name(module.name), top, module.file, module.line)
+                .c_str());
+      }
+      return TCL_OK;
+    }
+    uint32_t module{0};
+    const DesignHierarchy::Instance* instance{nullptr};
+    if (!hier->Resolve(args.front(), module, &instance)) {
+      Tcl_AppendResult(interp, "Unknown instance: ", args.front().c_str(),
+                       nullptr);
+      return TCL_ERROR;
+    }
+    const auto& definition = hier->GetModule(module);
+    if (sub == "children") {
+      const auto* instances = hier->Instances(definition);
+      for (uint32_t i = 0; i < definition.instanceCount; i++) {
+        const auto& child = instances[i];
+        Tcl_AppendElement(interp, element(hier->Name(child.name), child.module,
+                                          child.file, child.line)
+                                      .c_str());
+      }
+    } else if (sub == "ports") {
+      const auto* ports = hier->Ports(definition);
+      for (uint32_t i = 0; i < definition.portCount; i++) {
+        std::stringstream stream;
+        stream << "{" << hier->Name(ports[i].name) << "} "
+               << DesignHierarchy::DirectionName(ports[i].direction) << " "
+               << ports[i].msb << " " << ports[i].lsb;
+        Tcl_AppendElement(interp, stream.str().c_str());
+      }
+    } else {
+      // source
+      const bool useInstance = instanceSource && instance;
+      const std::string file{
+          hier->Name(useInstance ? instance->file : definition.file)};
+      const uint32_t line = useInstance ? instance->line : definition.line;
+      Tcl_AppendElement(interp, file.c_str());
+      Tcl_AppendElement(interp, std::to_string(line).c_str());
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("hierarchy", hierarchy, this, nullptr);
+
+  auto job_status = [](void* clientData, Tcl_Interp* interp, int argc,
+                       const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    if (argc > 2) {
+      compiler->ErrorMessage("Expected Syntax: job_status ?<id>?");
+      return TCL_ERROR;
+    }
+    std::vector<FlowJobs::Job> jobs;
+    if (compiler->m_flowJobs) jobs = compiler->m_flowJobs->Jobs();
+    if (argc == 2) {
+      auto itr = std::find_if(jobs.begin(), jobs.end(), [argv](auto& job) {
+        return std::to_string(job.id) == argv[1];
+      });
+      if (itr == jobs.end()) {
+        compiler->ErrorMessage(std::string{"Unknown job: "} + argv[1]);
+        return TCL_ERROR;
+      }
+      Tcl_AppendResult(interp, FlowJobs::StatusName(itr->status), nullptr);
+      return TCL_OK;
+    }
+    for (const auto& job : jobs) {
+      const std::string element = std::to_string(job.id) + " " + job.name +
+                                  " " + FlowJobs::StatusName(job.status);
+      Tcl_AppendElement(interp, element.c_str());
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("job_status", job_status, this, nullptr);
+
+  auto job_wait = [](void* clientData, Tcl_Interp* interp, int argc,
+                     const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    int timeout{-1};
+    std::vector<uint32_t> ids;
+    for (int i = 1; i < argc; i++) {
+      const std::string arg = argv[i];
+      if (arg == "-timeout" && i + 1 < argc) {
+        if (Tcl_GetInt(interp, argv[++i], &timeout) != TCL_OK) return TCL_ERROR;
+        continue;
+      }
+      int id{0};
+      FlowJobs::Job job;
+      if (Tcl_GetInt(interp, argv[i], &id) != TCL_OK) {
+        compiler->ErrorMessage(
+            "Expected Syntax: job_wait ?-timeout <ms>? ?<id>...?");
+        return TCL_ERROR;
+      }
+      if (!compiler->m_flowJobs || !compiler->m_flowJobs->Find(id, job)) {
+        compiler->ErrorMessage("Unknown job: " + arg);
+        return TCL_ERROR;
+      }
+      ids.push_back(id);
+    }
+    if (!compiler->m_flowJobs) return TCL_OK;
+    if (ids.empty()) {
+      for (const auto& job : compiler->m_flowJobs->Jobs())
+        ids.push_back(job.id);
+    }
+    compiler->WaitFlowJobs(ids, timeout);
+    Tcl_ResetResult(interp);
+    for (uint32_t id : ids) {
+      FlowJobs::Job job;
+      compiler->m_flowJobs->Find(id, job);
+      Tcl_AppendElement(interp, FlowJobs::StatusName(job.status));
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("job_wait", job_wait, this, nullptr);
+
+  auto job_cancel = [](void* clientData, Tcl_Interp* interp, int argc,
+                       const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    if (argc != 2) {
+      compiler->ErrorMessage("Expected Syntax: job_cancel <id> | -all");
+      return TCL_ERROR;
+    }
+    std::vector<uint32_t> ids;
+    const std::string arg = argv[1];
+    if (compiler->m_flowJobs) {
+      for (const auto& job : compiler->m_flowJobs->Jobs())
+        if (arg == "-all" || std::to_string(job.id) == arg)
+          ids.push_back(job.id);
+    }
+    if (ids.empty() && arg != "-all") {
+      compiler->ErrorMessage("Unknown job: " + arg);
+      return TCL_ERROR;
+    }
+    compiler->CancelFlowJobs(ids);
+    return TCL_OK;
+  };
+  interp->registerCmd("job_cancel", job_cancel, this, nullptr);
+
+  auto history_find = [](void* clientData, Tcl_Interp* interp, int argc,
+                         const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    int limit{0};
+    if (argc == 4 && std::string{argv[2]} == "-limit") {
+      if (Tcl_GetInt(interp, argv[3], &limit) != TCL_OK) return TCL_ERROR;
+    } else if (argc != 2) {
+      compiler->ErrorMessage(
+          "Expected Syntax: history_find <pattern> ?-limit <count>?");
+      return TCL_ERROR;
+    }
+    CommandHistory* history = SessionHistory(compiler);
+    if (!history) return TCL_OK;
+    Tcl_Obj* result = Tcl_NewListObj(0, nullptr);
+    for (const auto* entry : history->Search(argv[1], (std::max)(limit, 0))) {
+      const std::time_t time = entry->time / 1000;
+      char date[32];
+      std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S",
+                    std::localtime(&time));
+      Tcl_Obj* element = Tcl_NewListObj(0, nullptr);
+      Tcl_ListObjAppendElement(interp, element,
+                               Tcl_NewWideIntObj(entry->id));
+      Tcl_ListObjAppendElement(interp, element, Tcl_NewStringObj(date, -1));
+      Tcl_ListObjAppendElement(interp, element,
+                               Tcl_NewWideIntObj(entry->duration));
+      Tcl_ListObjAppendElement(interp, element, Tcl_NewIntObj(entry->code));
+      Tcl_ListObjAppendElement(
+          interp, element, Tcl_NewStringObj(entry->command.c_str(), -1));
+      Tcl_ListObjAppendElement(interp, result, element);
+    }
+    Tcl_SetObjResult(interp, result);
+    return TCL_OK;
+  };
+  interp->registerCmd("history_find", history_find, this, nullptr);
+
+  auto history_export = [](void* clientData, Tcl_Interp* interp, int argc,
+                           const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    uint64_t first{0}, last{0};
+    if (argc < 2 || argc > 4 ||
+        !HistoryRange(interp, argc, argv, 2, first, last)) {
+      compiler->ErrorMessage(
+          "Expected Syntax: history_export <file> ?<first>? ?<last>?");
+      return TCL_ERROR;
+    }
+    CommandHistory* history = SessionHistory(compiler);
+    if (!history) {
+      compiler->ErrorMessage("No command history in this session");
+      return TCL_ERROR;
+    }
+    std::ofstream file(argv[1]);
+    file << CommandHistory::Script(history->Range(first, last));
+    if (!file.good()) {
+      compiler->ErrorMessage(std::string{"Can't write "} + argv[1]);
+      return TCL_ERROR;
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("history_export", history_export, this, nullptr);
+
+  auto history_replay = [](void* clientData, Tcl_Interp* interp, int argc,
+                           const char* argv[]) -> int {
+    Compiler* compiler = (Compiler*)clientData;
+    uint64_t first{0}, last{0};
+    if (argc > 3 || !HistoryRange(interp, argc, argv, 1, first, last)) {
+      compiler->ErrorMessage(
+          "Expected Syntax: history_replay ?<first>? ?<last>?");
+      return TCL_ERROR;
+    }
+    CommandHistory* history = SessionHistory(compiler);
+    if (!history) {
+      compiler->ErrorMessage("No command history in this session");
+      return TCL_ERROR;
+    }
+    // The replayed commands run nested in history_replay, only the
+    // history_replay command itself is recorded
+    std::vector<CommandHistory::Entry> entries;
+    for (const auto* entry : history->Range(first, last))
+      if (CommandHistory::Replayable(*entry)) entries.push_back(*entry);
+    if (!entries.empty() && entries.front().state != history->State()) {
+      compiler->Message(
+          "WARNING: The project differs from the one the commands were "
+          "recorded with");
+    }
+    for (const auto& entry : entries) {
+      const int code =
+          Tcl_EvalEx(interp, entry.command.c_str(), -1, TCL_EVAL_GLOBAL);
+      if (code != TCL_OK) return code;
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("history_replay", history_replay, this, nullptr);
+
+  // The project file content stands for the project state
+  if (CommandHistory* history = SessionHistory(this)) {
+    history->SetStateProvider([this]() -> std::string {
+      if (!m_projManager) return {};
+      const std::filesystem::path project =
+          std::filesystem::path{m_projManager->getProjectPath().toStdString()} /
+          (m_projManager->getProjectName().toStdString() +
+           PROJECT_FILE_FORMAT);
+      if (!FileUtils::FileExists(project)) return {};
+      return CommandHistory::Hash(FileUtils::GetFileContent(project));
+    });
+  }
+
   return true;
 }
 
+WaveformReader* Compiler::GetWaveformReader(const std::string& file,
+                                            std::string& error) {
+  std::filesystem::path path = file.empty() ? m_waveformFile : file;
+  if (path.empty()) {
+    error = "No waveform file specified";
+    return nullptr;
+  }
+  // Simulations dump their waveforms into the project directory
+  if (!path.is_absolute() && !FileUtils::FileExists(path) && m_projManager &&
+      !m_projManager->projectPath().empty())
+    path = std::filesystem::path(m_projManager->projectPath()) / path;
+  if (!FileUtils::FileExists(path)) {
+    error = "Waveform file not found: " + path.string();
+    return nullptr;
+  }
+  path = FileUtils::GetFullPath(path);
+
+  std::filesystem::path vcd = path;
+  if (StringUtils::toLower(path.extension().string()) == ".fst") {
+    // FST is converted once with the GTKWave tool set, the VCD is then
+    // indexed like any other dump
+    vcd = path.string() + ".vcd";
+    if (!FileUtils::IsUptoDate(path.string(), vcd.string())) {
+      std::filesystem::path fst2vcd;
+      if (GlobalSession && GlobalSession->Context())
+        fst2vcd = GlobalSession->Context()->BinaryPath() / "gtkwave" / "bin" /
+                  "fst2vcd";
+      if (!FileUtils::FileExists(fst2vcd))
+        fst2vcd = FileUtils::LocateExecFile("fst2vcd");
+      if (fst2vcd.empty()) {
+        error = "fst2vcd not found, can't read " + path.string();
+        return nullptr;
+      }
+      std::ostringstream out;
+      int status = FileUtils::ExecuteSystemCommand(
+          fst2vcd.string() + " -f " + path.string() + " -o " + vcd.string(),
+          &out);
+      if (status != 0) {
+        error = "Failed to convert " + path.string() + ": " + out.str();
+        return nullptr;
+      }
+    }
+  }
+
+  auto itr = m_waveformReaders.find(path.string());
+  if (itr != m_waveformReaders.end()) {
+    if (itr->second->Stamp() == FileUtils::Stamp(vcd))
+      return itr->second.get();
+    m_waveformReaders.erase(itr);
+  }
+  auto reader = std::make_unique<WaveformReader>();
+  if (!reader->Open(vcd)) {
+    error = reader->LastError();
+    return nullptr;
+  }
+  return m_waveformReaders.emplace(path.string(), std::move(reader))
+      .first->second.get();
+}
+
+TimingPathDatabase* Compiler::GetTimingPaths(const std::string& file,
+                                             bool hold, std::string& error) {
+  std::filesystem::path path = file;
+  const std::filesystem::path projectPath =
+      m_projManager ? m_projManager->projectPath() : std::string{};
+  if (path.empty()) {
+    // VPR writes one report per check, OpenSTA a single one
+    path = projectPath / (hold ? TIMING_HOLD_REPORT : TIMING_SETUP_REPORT);
+    if (!FileUtils::FileExists(path))
+      path = projectPath / OPENSTA_TIMING_REPORT;
+  } else if (!path.is_absolute() && !FileUtils::FileExists(path)) {
+    path = projectPath / path;
+  }
+  if (!FileUtils::FileExists(path)) {
+    error = "Timing report not found: " + path.string();
+    return nullptr;
+  }
+  path = FileUtils::GetFullPath(path);
+
+  auto itr = m_timingPaths.find(path.string());
+  if (itr != m_timingPaths.end()) {
+    if (itr->second->Mtime() == FileUtils::Mtime(path)) return itr->second;
+    delete itr->second;
+    m_timingPaths.erase(itr);
+  }
+  TimingPathDatabase* paths = new TimingPathDatabase;
+  if (!paths->Open(path)) {
+    error = paths->LastError();
+    delete paths;
+    return nullptr;
+  }
+  m_timingPaths.emplace(path.string(), paths);
+  return paths;
+}
+
+DesignHierarchy* Compiler::GetDesignHierarchy(std::string& error) {
+  const std::filesystem::path projectPath =
+      m_projManager ? m_projManager->projectPath() : std::string{};
+  const std::filesystem::path index = projectPath / HIER_INDEX;
+  if (!DesignHierarchy::Update(projectPath / HIER_INFO, index, error))
+    return nullptr;
+  if (m_hierarchy && m_hierarchy->File() == index &&
+      m_hierarchy->Stamp() == FileUtils::Stamp(index))
+    return m_hierarchy;
+  delete m_hierarchy;
+  m_hierarchy = new DesignHierarchy;
+  if (!m_hierarchy->Open(index)) {
+    error = m_hierarchy->LastError();
+    delete m_hierarchy;
+    m_hierarchy = nullptr;
+  }
+  return m_hierarchy;
+}
+
+void Compiler::RegisterFlowCmd(TclInterpreter* interp,
+                               const std::string& name, Tcl_CmdProc proc) {
+  struct FlowCmd {
+    Compiler* compiler;
+    Tcl_CmdProc* proc;
+    std::string name;
+  };
+  auto flowCmd = [](void* clientData, Tcl_Interp* interp, int argc,
+                    const char* argv[]) -> int {
+    FlowCmd* cmd = (FlowCmd*)clientData;
+    Compiler* compiler = cmd->compiler;
+    bool async{false};
+    std::string callback;
+    std::vector<std::string> args;
+    for (int i = 0; i < argc; i++) {
+      const std::string arg = argv[i];
+      if (i > 0 && arg == "-async") {
+        async = true;
+      } else if (i > 0 && arg == "-command" && i + 1 < argc) {
+        async = true;
+        callback = argv[++i];
+      } else {
+        args.push_back(arg);
+      }
+    }
+    const bool busy = compiler->m_flowJobs && compiler->m_flowJobs->Busy();
+    if (!async && !busy) return cmd->proc(compiler, interp, argc, argv);
+
+    // The options are parsed when the job starts, on the flow thread
+    auto body = [cmd, args]() {
+      std::vector<const char*> argv;
+      for (const auto& arg : args) argv.push_back(arg.c_str());
+      return cmd->proc(cmd->compiler, nullptr, static_cast<int>(argv.size()),
+                       argv.data()) == TCL_OK;
+    };
+    const uint32_t id =
+        compiler->SubmitFlowJob(interp, cmd->name, body, callback);
+    if (!async) {
+      // Keeps its place behind the jobs started before
+      compiler->WaitFlowJobs({id}, -1);
+      FlowJobs::Job job;
+      compiler->m_flowJobs->Find(id, job);
+      return job.status == FlowJobs::Status::Succeeded ? TCL_OK : TCL_ERROR;
+    }
+    Tcl_SetObjResult(interp, Tcl_NewIntObj(static_cast<int>(id)));
+    return TCL_OK;
+  };
+  interp->registerCmd(name, flowCmd, new FlowCmd{this, proc, name},
+                      [](void* clientData) { delete (FlowCmd*)clientData; });
+}
+
+uint32_t Compiler::SubmitFlowJob(Tcl_Interp* interp, const std::string& name,
+                                 const std::function<bool()>& body,
+                                 const std::string& callback) {
+  if (!m_flowJobs) {
+    m_tclThread = Tcl_GetCurrentThread();
+    m_flowJobs = new FlowJobs{[this](uint32_t id, FlowJobs::Status) {
+      FlowJobEvent* event = (FlowJobEvent*)ckalloc(sizeof(FlowJobEvent));
+      event->header.proc = &Compiler::FlowJobEnded;
+      event->compiler = this;
+      event->id = id;
+      Tcl_ThreadQueueEvent(m_tclThread, &event->header, TCL_QUEUE_TAIL);
+      Tcl_ThreadAlert(m_tclThread);
+    }};
+  }
+  // Registered before the end of the job can be serviced, on this thread
+  const uint32_t id = m_flowJobs->Submit(name, body);
+  if (!callback.empty()) m_flowJobCallbacks[id] = {interp, callback};
+  return id;
+}
+
+int Compiler::FlowJobEnded(Tcl_Event* event, int flags) {
+  if (!(flags & TCL_FILE_EVENTS)) return 0;
+  FlowJobEvent* jobEvent = (FlowJobEvent*)event;
+  Compiler* compiler = jobEvent->compiler;
+  compiler->m_flowJobsEnded.insert(jobEvent->id);
+  auto itr = compiler->m_flowJobCallbacks.find(jobEvent->id);
+  if (itr == compiler->m_flowJobCallbacks.end()) return 1;
+  auto [interp, script] = itr->second;
+  compiler->m_flowJobCallbacks.erase(itr);
+
+  FlowJobs::Job job;
+  compiler->m_flowJobs->Find(jobEvent->id, job);
+  const std::string command = script + " " + std::to_string(job.id) + " " +
+                              FlowJobs::StatusName(job.status);
+  // Serviced from job_wait, vwait or update: keeps their result
+  Tcl_Preserve(interp);
+  Tcl_InterpState state = Tcl_SaveInterpState(interp, TCL_OK);
+  const int code = Tcl_EvalEx(interp, command.c_str(), -1, TCL_EVAL_GLOBAL);
+  if (code != TCL_OK) Tcl_BackgroundException(interp, code);
+  Tcl_RestoreInterpState(interp, state);
+  Tcl_Release(interp);
+  return 1;
+}
+
+bool Compiler::WaitFlowJobs(const std::vector<uint32_t>& ids, int timeout) {
+  bool expired{false};
+  Tcl_TimerToken timer{nullptr};
+  if (timeout >= 0) {
+    timer = Tcl_CreateTimerHandler(
+        timeout, [](ClientData clientData) { *(bool*)clientData = true; },
+        &expired);
+  }
+  auto ended = [this, &ids]() {
+    return std::all_of(ids.begin(), ids.end(), [this](uint32_t id) {
+      return m_flowJobsEnded.count(id) != 0;
+    });
+  };
+  // Also runs the completion callbacks and, in the GUI, the Qt events
+  while (!ended() && !expired) Tcl_DoOneEvent(TCL_ALL_EVENTS);
+  if (!expired) Tcl_DeleteTimerHandler(timer);
+  return !expired;
+}
+
+void Compiler::CancelFlowJobs(const std::vector<uint32_t>& ids) {
+  if (!m_flowJobs) return;
+  // Queued jobs first, the running one would start the next when stopped
+  bool stop{false};
+  for (uint32_t id : ids) {
+    FlowJobs::Status prior;
+    if (m_flowJobs->Cancel(id, prior) && prior == FlowJobs::Status::Running)
+      stop = true;
+  }
+  if (stop) Stop();
+}
+
 // This will send a given command to the gtkwave wish interface over stdin
 void Compiler::GTKWaveSendCmd(const std::string& gtkWaveCmd,
                               bool raiseGtkWindow /* true */) {
@@ -1805,9 +3072,9 @@ void Compiler::writeWaveHelp(std::ostream* out, int frontSpacePadCount,
                              int descColumn) {
   std::vector<std::pair<std::string, std::string>> helpEntries = {
       {"wave_*",
-       "All wave commands will launch a GTKWave process if one hasn't been "
-       "launched already. Subsequent commands will be sent to the launched "
-       "process."},
+       "All wave commands except wave_value, wave_transitions and wave_diff "
+       "will launch a GTKWave process if one hasn't been launched already. "
+       "Subsequent commands will be sent to the launched process."},
       {"wave_cmd ...",
        "Sends given tcl commands to GTKWave process. See GTKWave docs for "
        "gtkwave:: commands."},
@@ -1818,30 +3085,217 @@ void Compiler::writeWaveHelp(std::ostream* out, int frontSpacePadCount,
       {"wave_time <time>",
        "Set the current GTKWave view port start time to <time>. Times "
        "units "
-       "can be specified, without a space. Ex: wave_time 100ps."}};
+       "can be specified, without a space. Ex: wave_time 100ps."},
+      {"wave_value <signal> <time> ?-file <file>?",
+       "Returns the value of <signal> at <time> without GTKWave. Defaults "
+       "to the last simulation waveform file."},
+      {"wave_transitions <signal> ?-from <t>? ?-to <t>? ?-file <file>?",
+       "Returns the list of {time value} changes of <signal>."},
+      {"wave_diff <fileA> <fileB> ?<signal>...?",
+       "Returns {signal time valueA valueB} for the first mismatch of each "
+       "common signal."}};
 
   writeHelp(out, helpEntries, frontSpacePadCount, descColumn);
 }
 
 bool Compiler::Compile(Action action) {
   uint task{toTaskId(static_cast<int>(action), this)};
-  m_stop = false;
+  // job_cancel may have stopped the job before it got here, the request
+  // stays with the job and not with m_stop
+  m_stop = FlowJobs::OnFlowThread() && m_flowJobs &&
+           m_flowJobs->CancelRequested();
+  if (m_stop) return false;
   bool res{false};
   if (task != TaskManager::invalid_id && m_taskManager) {
     m_taskManager->task(task)->setStatus(TaskStatus::InProgress);
   }
+  const bool qorStage{IsQorStage(action)};
+  auto stage = QorStages.find(action);
+  m_runningStage = (stage != QorStages.end()) ? stage->second : "";
+  m_stagePeakMemory = m_stagePeakResident = 0;
+  m_stageToolTime = m_stageFirstTool = m_stageLastTool = 0;
+  if (qorStage) StartProgress(action);
+  auto start = Time::now();
+  m_stageStart = NowMs();
   res = RunCompileTask(action);
+  if (res && qorStage) {
+    RecordQor(action,
+              std::chrono::duration_cast<ms>(Time::now() - start).count());
+  }
+  if (qorStage) {
+    m_progress.StageFinished();
+    ReportProgress(true);
+  }
   if (task != TaskManager::invalid_id && m_taskManager) {
     m_taskManager->task(task)->setStatus(res ? TaskStatus::Success
                                              : TaskStatus::Fail);
   }
+  m_runningStage.clear();
   return res;
 }
 
+bool Compiler::IsQorStage(Action action) const {
+  // Clean requests and viewers produce nothing worth recording
+  switch (action) {
+    case Action::IPGen:
+      return m_ipGenerateOpt == IPGenerateOpt::None;
+    case Action::Analyze:
+      return m_analysisOpt != DesignAnalysisOpt::Clean;
+    case Action::Synthesis:
+      return m_synthOpt != SynthesisOpt::Clean;
+    case Action::Pack:
+      return m_packingOpt != PackingOpt::Clean;
+    case Action::Global:
+      return m_globalPlacementOpt != GlobalPlacementOpt::Clean;
+    case Action::Detailed:
+      return m_placementOpt != PlacementOpt::Clean;
+    case Action::Routing:
+      return m_routingOpt != RoutingOpt::Clean;
+    case Action::STA:
+      return m_staOpt != STAOpt::Clean && m_staOpt != STAOpt::View;
+    case Action::Power:
+      return m_powerOpt != PowerOpt::Clean;
+    case Action::Bitstream:
+      return m_bitstreamOpt != BitstreamOpt::Clean;
+    default:
+      return false;
+  }
+}
+
+std::string Compiler::StageLog(Action action) const { return {}; }
+
+static std::string NewQorRun(const std::vector<std::string>& runs) {
+  std::time_t now = std::time(nullptr);
+  char stamp[32];
+  std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+  std::string run{stamp};
+  for (int i = 2; std::find(runs.begin(), runs.end(), run) != runs.end(); i++)
+    run = std::string{stamp} + "-" + std::to_string(i);
+  return run;
+}
+
+void Compiler::RecordQor(Action action, int64_t runtime) {
+  if (!m_projManager || m_projManager->projectPath().empty()) return;
+  QorDatabase db;
+  db.Open(QorDatabase::DefaultPath(m_projManager->projectPath()));
+  // Running a stage again, or an earlier one, starts a new run
+  if (m_qorRun.empty() || action <= m_qorLastAction)
+    m_qorRun = NewQorRun(db.Runs());
+  m_qorLastAction = action;
+
+  QorDatabase::Record record{m_qorRun, std::time(nullptr),
+                             QorStages.at(action)};
+  record.design = m_projManager->projectName();
+  record.metrics["runtime_ms"] = runtime;
+  if (m_stagePeakMemory) record.metrics["peak_mem_kb"] = m_stagePeakMemory;
+  if (m_stagePeakResident)
+    record.metrics["peak_rss_kb"] = m_stagePeakResident;
+  if (m_stageFirstTool) {
+    // Time spent in the tools and in FOEDAG before and after them
+    record.metrics["_tool_ms"] = m_stageToolTime;
+    record.metrics["_setup_ms"] = m_stageFirstTool - m_stageStart;
+    record.metrics["_wrapup_ms"] = NowMs() - m_stageLastTool;
+  }
+  if (m_progress.Markers())
+    record.metrics[ProgressEstimator::MarkersMetric] = m_progress.Markers();
+  const std::string log = StageLog(action);
+  if (!log.empty()) {
+    std::ifstream stream(
+        std::filesystem::path{m_projManager->projectPath()} / log);
+    if (stream.good()) QorDatabase::ParseLog(stream, record.metrics);
+  }
+  if (!db.Append(record))
+    Message("QoR metrics not recorded: " + db.LastError());
+}
+
+void Compiler::PlanProgress(const std::vector<std::string>& stages) {
+  if (m_projManager && !m_projManager->projectPath().empty()) {
+    QorDatabase db;
+    db.Open(QorDatabase::DefaultPath(m_projManager->projectPath()));
+    m_progress.Learn(db, m_projManager->projectName());
+  }
+  m_progress.Plan(stages);
+}
+
+void Compiler::StartProgress(Action action) {
+  const std::string stage{QorStages.at(action)};
+  if (!m_progress.IsPlanned(stage)) {
+    // Not announced by a script, plan what the task manager has queued
+    std::vector<std::string> stages;
+    if (m_taskManager) {
+      for (uint id : m_taskManager->pendingTasks()) {
+        for (const auto& [queued, name] : QorStages)
+          if (toTaskId(static_cast<int>(queued), this) == id)
+            stages.push_back(name);
+      }
+    }
+    if (std::find(stages.begin(), stages.end(), stage) == stages.end())
+      stages.insert(stages.begin(), stage);
+    PlanProgress(stages);
+  }
+  m_progress.StageStarted(stage);
+  ReportProgress(true);
+}
+
+void Compiler::ReportProgress(bool force) {
+  const int64_t now = NowMs();
+  if (!force && now - m_progressReported < 1000) return;
+  m_progressReported = now;
+  const std::string status = m_progress.Status();
+  if (m_taskManager)
+    m_taskManager->setEstimate(static_cast<int>(m_progress.Percent()),
+                               QString::fromStdString(status));
+  // The GUI shows the estimate in the status bar, batch runs get a line at
+  // stage boundaries and once a minute in between
+  const bool batch{!GlobalSession || !GlobalSession->MainWindow()};
+  if (batch && (force || now - m_progressPrinted >= 60000)) {
+    m_progressPrinted = now;
+    (*m_out) << "Progress: " << status << std::endl;
+  }
+}
+
 void Compiler::Stop() {
   m_stop = true;
   ErrorMessage("Compilation was interrupted by user");
-  if (m_process) m_process->terminate();
+  if (m_process) {
+    // The tool and whatever it started, e.g. yosys-abc or make jobs
+    if (!ProcessUtils::SignalGroup(m_process->processId(), false))
+      m_process->terminate();
+  }
+}
+
+unsigned int Compiler::PredictedMemoryMb(const std::string& stage,
+                                         const ResourceLimits& limits) const {
+  // Largest resident peak of the last runs, the stage can't go past its own
+  // limit
+  double peakKb{0};
+  if (m_projManager && !m_projManager->projectPath().empty() &&
+      !stage.empty()) {
+    QorDatabase db;
+    db.Open(QorDatabase::DefaultPath(m_projManager->projectPath()));
+    auto trend = db.Trend(stage, "peak_rss_kb");
+    const size_t runs = std::min<size_t>(trend.size(), 3);
+    for (auto itr = trend.end() - runs; itr != trend.end(); ++itr)
+      peakKb = std::max(peakKb, itr->second);
+  }
+  unsigned int weight =
+      peakKb ? static_cast<unsigned int>(peakKb / 1024) : DefaultJobMemoryMb;
+  if (limits.memoryMb) weight = std::min(weight, limits.memoryMb);
+  return weight;
+}
+
+ResourceLimits Compiler::StageLimits(const std::string& stage) const {
+  auto itr = m_stageLimits.find(stage);
+  if (itr == m_stageLimits.end()) itr = m_stageLimits.find("*");
+  return (itr != m_stageLimits.end()) ? itr->second : ResourceLimits{};
+}
+
+void Compiler::StageLimits(const std::string& stage,
+                           const ResourceLimits& limits) {
+  if (limits.IsEmpty())
+    m_stageLimits.erase(stage);
+  else
+    m_stageLimits[stage] = limits;
 }
 
 bool Compiler::Analyze() {
@@ -2012,6 +3466,10 @@ bool Compiler::RunCompileTask(Action action) {
       return GetSimulator()->Simulate(Simulator::SimulationType::Bitstream,
                                       GetSimulator()->GetSimulatorType(),
                                       m_waveformFile);
+    case Action::SimulateRegression:
+      return GetSimulator()->Simulate(Simulator::SimulationType::Regression,
+                                      GetSimulator()->GetSimulatorType(),
+                                      m_waveformFile);
     default:
       break;
   }
@@ -2346,11 +3804,28 @@ int Compiler::ExecuteAndMonitorSystemCommand(const std::string& command,
   auto start = Time::now();
   PERF_LOG("Command: " + command);
   (*m_out) << "Command: " << command << std::endl;
+  const ResourceLimits limits = StageLimits(m_runningStage);
+  uint64_t ticket{0};
+  if (m_admission.IsEnabled()) {
+    // Wait until the host has room for what the tool is expected to use
+    const unsigned int weight = PredictedMemoryMb(m_runningStage, limits);
+    ticket = m_admission.Acquire(
+        weight, [this]() { return m_stop; },
+        [this, weight](unsigned int used) {
+          Message("Waiting for host memory: " + std::to_string(weight) +
+                  " MB needed, " + std::to_string(used) + " of " +
+                  std::to_string(m_admission.Capacity()) + " MB in use");
+        });
+    if (!ticket) {
+      if (!m_stop) ErrorMessage(m_admission.LastError());
+      return -1;
+    }
+  }
   auto path = std::filesystem::current_path();                  // getting path
   std::filesystem::current_path(m_projManager->projectPath());  // setting path
   // new QProcess must be created here to avoid issues related to creating
   // QObjects in different threads
-  m_process = new QProcess;
+  m_process = new GroupProcess{limits};
   QStringList env = QProcess::systemEnvironment();
   if (!m_environmentVariableMap.empty()) {
     for (std::map<std::string, std::string>::iterator itr =
@@ -2369,6 +3844,8 @@ int Compiler::ExecuteAndMonitorSystemCommand(const std::string& command,
                        QByteArray bufout = m_process->readAllStandardOutput();
                        ofs.write(bufout, bytes);
                        m_out->write(bufout, bytes);
+                       m_progress.Output(bufout, bytes);
+                       ReportProgress(false);
                      });
     QObject::connect(m_process, &QProcess::readyReadStandardError,
                      [this, &ofs]() {
@@ -2379,8 +3856,10 @@ int Compiler::ExecuteAndMonitorSystemCommand(const std::string& command,
                      });
   } else {
     QObject::connect(m_process, &QProcess::readyReadStandardOutput, [this]() {
-      m_out->write(m_process->readAllStandardOutput(),
-                   m_process->bytesAvailable());
+      QByteArray data = m_process->readAllStandardOutput();
+      m_out->write(data, data.size());
+      m_progress.Output(data, data.size());
+      ReportProgress(false);
     });
     QObject::connect(m_process, &QProcess::readyReadStandardError, [this]() {
       QByteArray data = m_process->readAllStandardError();
@@ -2388,19 +3867,49 @@ int Compiler::ExecuteAndMonitorSystemCommand(const std::string& command,
     });
   }
   ProcessUtils utils;
-  QObject::connect(m_process, &QProcess::started,
-                   [&utils, this]() { utils.Start(m_process->processId()); });
+  utils.MemoryLimit(limits.memoryMb * 1024);
+  int64_t group{0};
+  QObject::connect(m_process, &QProcess::started, [&utils, &group, this]() {
+    group = m_process->processId();
+    utils.Start(group);
+  });
 
   QString cmd{command.c_str()};
   QStringList args = cmd.split(" ");
   QString program = args.first();
   args.pop_front();  // remove program
+  const int64_t launch = NowMs();
+  if (!m_stageFirstTool) m_stageFirstTool = launch;
   m_process->start(program, args);
   std::filesystem::current_path(path);
-  m_process->waitForFinished(-1);
+  const int timeout = (limits.timeoutSec)
+                          ? std::min<int64_t>(limits.timeoutSec * 1000LL,
+                                              std::numeric_limits<int>::max())
+                          : -1;
+  const bool timedOut{!m_process->waitForFinished(timeout) &&
+                      m_process->state() != QProcess::NotRunning};
+  if (timedOut) {
+    if (!ProcessUtils::SignalGroup(group, true)) m_process->kill();
+    m_process->waitForFinished(-1);
+  }
+  m_stageLastTool = NowMs();
+  m_stageToolTime += m_stageLastTool - launch;
   utils.Stop();
+  // Nothing the tool started may outlive it
+  ProcessUtils::SignalGroup(group, true);
+  m_admission.Release(ticket);
+  const std::string stage{m_runningStage.empty() ? "The command"
+                                                 : "Stage " + m_runningStage};
+  if (timedOut)
+    ErrorMessage(stage + " exceeded its time limit of " +
+                 std::to_string(limits.timeoutSec) + " s and was stopped");
+  if (utils.MemoryLimitHit())
+    ErrorMessage(stage + " exceeded its memory limit of " +
+                 std::to_string(limits.memoryMb) + " MB and was stopped");
   // DEBUG: (*m_out) << "Changed path to: " << (path).string() << std::endl;
   uint max_utiliation{utils.Utilization()};
+  m_stagePeakMemory = std::max(m_stagePeakMemory, max_utiliation);
+  m_stagePeakResident = std::max(m_stagePeakResident, utils.GroupPeak());
   auto status = m_process->exitStatus();
   auto exitCode = m_process->exitCode();
   delete m_process;
@@ -2421,6 +3930,139 @@ int Compiler::ExecuteAndMonitorSystemCommand(const std::string& command,
   return (status == QProcess::NormalExit) ? exitCode : -1;
 }
 
+std::vector<Compiler::ToolResult> Compiler::ExecuteAndMonitorSystemCommands(
+    const std::vector<ToolCommand>& commands, uint32_t jobs) {
+  struct Launch {
+    GroupProcess* process{nullptr};
+    std::unique_ptr<ProcessUtils> utils;
+    int64_t group{0};
+    uint64_t ticket{0};
+    int64_t start{0};
+  };
+  std::vector<ToolResult> results(commands.size());
+  std::vector<Launch> launches(commands.size());
+  const ResourceLimits limits = StageLimits(m_runningStage);
+  const std::string stage{m_runningStage.empty() ? "The command"
+                                                 : "Stage " + m_runningStage};
+  const QString workingDir =
+      QString::fromStdString(m_projManager->projectPath());
+  QStringList env = QProcess::systemEnvironment();
+  for (const auto& [name, value] : m_environmentVariableMap)
+    env << QString::fromStdString(name + "=" + value);
+  jobs = std::max<uint32_t>(jobs, 1);
+  const int64_t batchStart = NowMs();
+  size_t next{0};
+  uint32_t running{0};
+
+  // Ends the tools that exited, overran their time limit or were stopped
+  auto reap = [&]() {
+    bool ended{false};
+    for (size_t i = 0; i < next; i++) {
+      Launch& launch = launches[i];
+      if (!launch.process) continue;
+      const bool overran =
+          limits.timeoutSec &&
+          NowMs() - launch.start >= limits.timeoutSec * 1000LL;
+      if (m_stop || overran) {
+        if (!ProcessUtils::SignalGroup(launch.group, true))
+          launch.process->kill();
+        launch.process->waitForFinished(-1);
+      } else {
+        launch.process->waitForFinished(0);
+      }
+      if (launch.process->state() != QProcess::NotRunning) continue;
+      launch.utils->Stop();
+      // Nothing the tool started may outlive it
+      ProcessUtils::SignalGroup(launch.group, true);
+      m_admission.Release(launch.ticket);
+      results[i].durationMs = NowMs() - launch.start;
+      if (launch.process->exitStatus() == QProcess::NormalExit)
+        results[i].exitCode = launch.process->exitCode();
+      if (overran)
+        ErrorMessage(stage + " exceeded its time limit of " +
+                     std::to_string(limits.timeoutSec) + " s and was stopped");
+      if (launch.utils->MemoryLimitHit())
+        ErrorMessage(stage + " exceeded its memory limit of " +
+                     std::to_string(limits.memoryMb) + " MB and was stopped");
+      m_stagePeakMemory =
+          std::max(m_stagePeakMemory, launch.utils->Utilization());
+      m_stagePeakResident =
+          std::max(m_stagePeakResident, launch.utils->GroupPeak());
+      delete launch.process;
+      launch.process = nullptr;
+      launch.utils.reset();
+      running--;
+      ended = true;
+    }
+    return ended;
+  };
+
+  while (running || (!m_stop && next < commands.size())) {
+    while (!m_stop && running < jobs && next < commands.size()) {
+      const ToolCommand& tool = commands[next];
+      Launch& launch = launches[next];
+      PERF_LOG("Command: " + tool.command);
+      if (m_admission.IsEnabled()) {
+        // The tools of this batch that end make room as well
+        bool reaped{false};
+        const unsigned int weight = PredictedMemoryMb(m_runningStage, limits);
+        launch.ticket = m_admission.Acquire(
+            weight,
+            [&]() {
+              reaped = reap();
+              return m_stop || reaped;
+            },
+            [this, weight](unsigned int used) {
+              Message("Waiting for host memory: " + std::to_string(weight) +
+                      " MB needed, " + std::to_string(used) + " of " +
+                      std::to_string(m_admission.Capacity()) + " MB in use");
+            });
+        if (!launch.ticket) {
+          if (m_stop || reaped) continue;
+          ErrorMessage(m_admission.LastError());
+          next++;
+          continue;
+        }
+      }
+      next++;
+      QStringList args =
+          QProcess::splitCommand(QString::fromStdString(tool.command));
+      launch.process = new GroupProcess{limits};
+      launch.process->setWorkingDirectory(workingDir);
+      launch.process->setEnvironment(env);
+      launch.process->setProcessChannelMode(QProcess::MergedChannels);
+      if (!tool.logFile.empty())
+        launch.process->setStandardOutputFile(
+            QString::fromStdString(tool.logFile));
+      launch.start = NowMs();
+      if (!m_stageFirstTool) m_stageFirstTool = launch.start;
+      if (!args.isEmpty()) {
+        const QString program = args.takeFirst();
+        launch.process->start(program, args);
+      }
+      // A tool that can't start must not be reported as stopped
+      if (launch.process->program().isEmpty() ||
+          !launch.process->waitForStarted(-1)) {
+        ErrorMessage("Can't start " + tool.command + ": " +
+                     launch.process->errorString().toStdString());
+        m_admission.Release(launch.ticket);
+        delete launch.process;
+        launch.process = nullptr;
+        continue;
+      }
+      launch.group = launch.process->processId();
+      launch.utils = std::make_unique<ProcessUtils>();
+      launch.utils->MemoryLimit(limits.memoryMb * 1024);
+      launch.utils->Start(launch.group);
+      running++;
+    }
+    if (!reap()) std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
+  m_stageLastTool = NowMs();
+  m_stageToolTime += m_stageLastTool - batchStart;
+  return results;
+}
+
 std::string Compiler::ReplaceAll(std::string_view str, std::string_view from,
                                  std::string_view to) {
   size_t start_pos = 0;
@@ -21,17 +21,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef COMPILER_H
 #define COMPILER_H
 
+#include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "Command/Command.h"
 #include "Command/CommandStack.h"
+#include "Compiler/ProgressEstimator.h"
 #include "IPGenerate/IPGenerator.h"
 #include "Main/CommandLine.h"
 #include "Simulation/Simulator.h"
 #include "Tcl/TclInterpreter.h"
+#include "Utils/HostAdmission.h"
+#include "Utils/ProcessUtils.h"
 
 class QProcess;
 
@@ -43,6 +49,10 @@ class Session;
 class DesignManager;
 class TclCommandIntegration;
 class Constraints;
+class WaveformReader;
+class TimingPathDatabase;
+class DesignHierarchy;
+class FlowJobs;
 
 class Compiler {
   friend Simulator;
@@ -65,7 +75,8 @@ class Compiler {
     SimulateRTL,
     SimulateGate,
     SimulatePNR,
-    SimulateBitstream
+    SimulateBitstream,
+    SimulateRegression
   };
   enum class State {
     None,
@@ -91,7 +102,7 @@ class Compiler {
   enum class RoutingOpt { None, Clean };
   enum class PowerOpt { None, Clean };
   enum class STAOpt { None, Clean, View, Opensta };
-  enum class BitstreamOpt { DefaultBitsOpt, Force, Clean };
+  enum class BitstreamOpt { DefaultBitsOpt, Force, Clean, Restore };
 
   // Most common use case, create the compiler in your main
   Compiler() = default;
@@ -208,6 +219,41 @@ class Compiler {
   QProcess* GetGTKWaveProcess();
   void GTKWaveSendCmd(const std::string& gtkWaveCmd,
                       bool raiseGtkWindow = true);
+  /*!
+   * \brief GetWaveformReader returns an indexed in-process reader for the
+   * given VCD/FST file (the simulation waveform file if empty). The index is
+   * built on first use and rebuilt only when the file changes.
+   */
+  WaveformReader* GetWaveformReader(const std::string& file,
+                                    std::string& error);
+
+  /*!
+   * \brief GetTimingPaths returns the path index of the given timing report,
+   * by default the setup (or hold) report of the last timing analysis. The
+   * index is rebuilt only when the report changes.
+   */
+  TimingPathDatabase* GetTimingPaths(const std::string& file, bool hold,
+                                     std::string& error);
+
+  /*!
+   * \brief GetDesignHierarchy returns the elaborated hierarchy written by the
+   * last analysis. The index is rebuilt if the analysis output is newer.
+   */
+  DesignHierarchy* GetDesignHierarchy(std::string& error);
+
+  /*!
+   * \brief PlanProgress announces the stages the flow is about to run, so
+   * that the progress and ETA cover the whole flow rather than each stage.
+   */
+  void PlanProgress(const std::vector<std::string>& stages);
+
+  /*!
+   * \brief StageLimits bounds the resources of the tools run by \a stage
+   * ("synthesize", "route"...). The limits of "*" apply to the stages
+   * without limits of their own.
+   */
+  void StageLimits(const std::string& stage, const ResourceLimits& limits);
+  ResourceLimits StageLimits(const std::string& stage) const;
 
  protected:
   /* Methods that can be customized for each new compiler flow */
@@ -241,6 +287,55 @@ class Compiler {
                               const std::string value);
   virtual int ExecuteAndMonitorSystemCommand(const std::string& command,
                                              const std::string logFile = "");
+  struct ToolCommand {
+    std::string command;  // quoted arguments may hold spaces
+    std::string logFile;  // output and errors
+  };
+  struct ToolResult {
+    int exitCode{-1};  // -1 if it didn't start, crashed or was stopped
+    int64_t durationMs{0};
+  };
+  /*!
+   * \brief ExecuteAndMonitorSystemCommands runs \a commands, \a jobs at a
+   * time. Each one is launched as ExecuteAndMonitorSystemCommand() does it:
+   * after host admission, in its own process group, within the limits of the
+   * running stage, and stopped by Stop().
+   */
+  std::vector<ToolResult> ExecuteAndMonitorSystemCommands(
+      const std::vector<ToolCommand>& commands, uint32_t jobs);
+
+  /*!
+   * \brief StageLog returns the log of \a action, relative to the project
+   * path, that holds the QoR metrics of the stage. Empty if there is none.
+   */
+  virtual std::string StageLog(Action action) const;
+  bool IsQorStage(Action action) const;
+  void RecordQor(Action action, int64_t runtime);
+  /*!
+   * \brief PredictedMemoryMb returns the memory the tools of \a stage are
+   * expected to use, from the resident peaks recorded by the previous runs.
+   */
+  unsigned int PredictedMemoryMb(const std::string& stage,
+                                 const ResourceLimits& limits) const;
+  void StartProgress(Action action);
+
+  /*!
+   * \brief RegisterFlowCmd registers a flow command that also accepts
+   * -async and -command <script>. When run as a job \a proc is called on the
+   * flow thread with a null interpreter.
+   */
+  void RegisterFlowCmd(TclInterpreter* interp, const std::string& name,
+                       Tcl_CmdProc proc);
+  uint32_t SubmitFlowJob(Tcl_Interp* interp, const std::string& name,
+                         const std::function<bool()>& body,
+                         const std::string& callback);
+  // Services the interpreter events until the jobs ended or the timeout
+  // (ms, negative for none) expired. False on timeout.
+  bool WaitFlowJobs(const std::vector<uint32_t>& ids, int timeout);
+  // Drops the queued jobs of \a ids and stops the running one
+  void CancelFlowJobs(const std::vector<uint32_t>& ids);
+  static int FlowJobEnded(Tcl_Event* event, int flags);
+  void ReportProgress(bool force);
   std::string ReplaceAll(std::string_view str, std::string_view from,
                          std::string_view to);
   virtual std::pair<bool, std::string> IsDeviceSizeCorrect(
@@ -315,6 +410,49 @@ class Compiler {
 
   // GTKWave
   QProcess* m_gtkwave_process = nullptr;
+
+  // Native waveform readers, keyed by resolved file path
+  std::map<std::string, std::unique_ptr<WaveformReader>> m_waveformReaders;
+
+  // Timing report path indexes, keyed by report path
+  std::map<std::string, TimingPathDatabase*> m_timingPaths;
+
+  // Design hierarchy of the last analysis
+  DesignHierarchy* m_hierarchy{nullptr};
+
+  // Asynchronous flow commands: jobs, thread of the interpreter that owns
+  // them, completion callbacks and jobs whose end was serviced
+  FlowJobs* m_flowJobs{nullptr};
+  Tcl_ThreadId m_tclThread{nullptr};
+  std::map<uint32_t, std::pair<Tcl_Interp*, std::string>> m_flowJobCallbacks;
+  std::set<uint32_t> m_flowJobsEnded;
+
+  // QoR metrics: current run id, last recorded stage of the run, peak
+  // virtual memory of the commands launched by the running stage and peak
+  // resident memory of their process groups (kiB)
+  std::string m_qorRun;
+  Action m_qorLastAction{Action::NoAction};
+  uint m_stagePeakMemory{0};
+  uint m_stagePeakResident{0};
+  // Stage start, first tool launch and last tool exit (ms since epoch) and
+  // the time spent in the tools
+  int64_t m_stageStart{0};
+  int64_t m_stageFirstTool{0};
+  int64_t m_stageLastTool{0};
+  int64_t m_stageToolTime{0};
+
+  // Flow progress estimate and when it was last sent to the task manager
+  // and printed (ms since epoch)
+  ProgressEstimator m_progress;
+  int64_t m_progressReported{0};
+  int64_t m_progressPrinted{0};
+
+  // Resource limits per stage and the stage being run, if any
+  std::map<std::string, ResourceLimits> m_stageLimits;
+  std::string m_runningStage;
+
+  // Queues tool launches while other runs use the memory of the host
+  HostAdmission m_admission;
 };
 
 }  // namespace FOEDAG
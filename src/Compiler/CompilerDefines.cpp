@@ -110,6 +110,7 @@ uint FOEDAG::toTaskId(int action, const Compiler *const compiler) {
       return IP_GENERATE;
     case Compiler::Action::NoAction:
     case Compiler::Action::Batch:
+    case Compiler::Action::SimulateRegression:
       return TaskManager::invalid_id;
     case Compiler::Action::SimulateRTL:
       return SIMULATE_RTL;
@@ -102,6 +102,11 @@ static constexpr const char *ROUTING_LOG{"routing.rpt"};
 static constexpr const char *SYNTHESIS_LOG{"synthesis.rpt"};
 static constexpr const char *PLACEMENT_LOG{"placement.rpt"};
 static constexpr const char *PLACEMENT_TIMING_LOG{"post_place_timing.rpt"};
+static constexpr const char *TIMING_SETUP_REPORT{"report_timing.setup.rpt"};
+static constexpr const char *TIMING_HOLD_REPORT{"report_timing.hold.rpt"};
+static constexpr const char *OPENSTA_TIMING_REPORT{"opensta_timing.rpt"};
+static constexpr const char *HIER_INFO{"hier_info.json"};
+static constexpr const char *HIER_INDEX{"hier_info.idx"};
 
 /*!
  * \brief prepareCompilerView
@@ -33,6 +33,7 @@
 #include <QDomDocument>
 #include <QFile>
 #include <QTextStream>
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <sstream>
@@ -40,7 +41,9 @@
 
 #include "Compiler/CompilerOpenFPGA.h"
 #include "Compiler/Constraints.h"
+#include "Compiler/DesignHierarchy.h"
 #include "Log.h"
+#include "NewProject/ProjectManager/config.h"
 #include "NewProject/ProjectManager/project_manager.h"
 #include "Utils/FileUtils.h"
 #include "Utils/StringUtils.h"
@@ -88,6 +91,13 @@ void CompilerOpenFPGA::Help(std::ostream* out) {
             "a dummy compiler"
          << std::endl;
   (*out) << "   --mute           : Mutes stdout in batch mode" << std::endl;
+  (*out) << "   --profile-startup: Prints the startup time of each phase"
+         << std::endl;
+  (*out) << "   --server <socket>: Runs Tcl jobs sent to the unix socket, "
+            "--script is sourced once before serving"
+         << std::endl;
+  (*out) << "   --connect <socket>: Runs --script or --cmd on the server"
+         << std::endl;
   (*out) << "   --verific        : Uses Verific parser" << std::endl;
   (*out) << "Tcl commands:" << std::endl;
   (*out) << "   help                       : This help" << std::endl;
@@ -218,11 +228,16 @@ void CompilerOpenFPGA::Help(std::ostream* out) {
          << std::endl;
   (*out) << "   power ?clean?              : Power estimator" << std::endl;
   (*out) << "   bitstream ?clean?          : Bitstream generation" << std::endl;
+  (*out) << "   bitstream restore          : Restores the archived build of "
+            "the same sources, options and tools instead of running OpenFPGA"
+         << std::endl;
   (*out) << "   simulate <level> ?<simulator>? : Simulates the design and "
             "testbench"
          << std::endl;
-  (*out) << "            <level> : rtl, gate, pnr. rtl: RTL simulation, gate: "
-            "post-synthesis simulation, pnr: post-pnr simulation"
+  (*out) << "            <level> : rtl, gate, pnr, regression. rtl: RTL "
+            "simulation, gate: post-synthesis simulation, pnr: post-pnr "
+            "simulation, regression: RTL model built once, run for every "
+            "simulation_variant"
          << std::endl;
   (*out) << "            <simulator> : verilator, vcs, questa, icarus, ghdl, "
             "xcelium"
@@ -237,6 +252,50 @@ void CompilerOpenFPGA::Help(std::ostream* out) {
   (*out)
       << "                      <phase> : compilation, elaboration, simulation"
       << std::endl;
+  (*out) << "   simulation_build_options ?-jobs <n>? ?-objcache <cmd>? "
+            "?-cache on|off?"
+         << std::endl;
+  (*out) << "                                Model build parallelism, "
+            "compiler cache and reuse of unchanged models"
+         << std::endl;
+  (*out) << "   simulation_variant <name> ?<options>? | -seeds <count> "
+            "?<options>? | -clear"
+         << std::endl;
+  (*out) << "                                Runtime variants executed by "
+            "simulate regression"
+         << std::endl;
+  (*out) << "   qor run ?<name>? | runs    : Labels/lists the runs QoR "
+            "metrics are recorded under"
+         << std::endl;
+  (*out) << "   qor compare ?<runA> <runB>? ?-strict? : Compares the stage "
+            "metrics of two runs, flags regressions past the thresholds"
+         << std::endl;
+  (*out) << "   qor trend <stage> <metric> : {run value} history of a metric"
+         << std::endl;
+  (*out) << "   qor threshold <metric> ?<percent>? : Regression threshold, "
+            "* for all metrics, default 5%"
+         << std::endl;
+  (*out) << "   stage_limits ?<stage>|*? ?-memory <MB>? ?-cpus <list>? ?-nice "
+            "<n>? ?-ionice <class>[:<level>]? ?-timeout <sec>?"
+         << std::endl;
+  (*out) << "                                Resource limits of the tools "
+            "run by a stage, 0 removes a limit"
+         << std::endl;
+  (*out) << "   host_admission ?-dir <path>? ?-capacity <MB>? | -off"
+         << std::endl;
+  (*out) << "                                Queues tool "
+            "launches until their expected memory fits, shared by the runs "
+            "using <path>"
+         << std::endl;
+  (*out) << "   bitstream_archive list | provenance <build> : Archived "
+            "bitstream builds, tools, options and sources of a build"
+         << std::endl;
+  (*out) << "   bitstream_archive diff ?<buildA> <buildB>? : Configuration "
+            "bits and tiles that differ (the last two builds by default)"
+         << std::endl;
+  (*out) << "   bitstream_archive restore <build> ?<dir>? : Writes the "
+            "outputs of a build back"
+         << std::endl;
   (*out) << "----------------------------------" << std::endl;
 }
 
@@ -958,8 +1017,10 @@ bool CompilerOpenFPGA::Analyze() {
     m_state = State::IPGenerated;
     AnalyzeOpt(DesignAnalysisOpt::None);
     // Remove generated json files
-    std::filesystem::remove(
-        std::filesystem::path(ProjManager()->projectPath()) / "port_info.json");
+    const std::filesystem::path projectPath = ProjManager()->projectPath();
+    std::filesystem::remove(projectPath / "port_info.json");
+    std::filesystem::remove(projectPath / HIER_INFO);
+    std::filesystem::remove(projectPath / HIER_INDEX);
     return true;
   }
   if (!ProjManager()->HasDesign() && !CreateDesign("noname")) return false;
@@ -1027,9 +1088,24 @@ bool CompilerOpenFPGA::Analyze() {
   }
 
   printTopModules(output_path, m_out);
+  IndexHierarchy();
   return true;
 }
 
+void CompilerOpenFPGA::IndexHierarchy() {
+  // Index the elaborated hierarchy once, browsing only reads the index
+  const std::filesystem::path projectPath = ProjManager()->projectPath();
+  const std::filesystem::path hierInfo = projectPath / HIER_INFO;
+  if (!FileUtils::FileExists(hierInfo)) return;
+  std::string error;
+  if (!DesignHierarchy::Build(hierInfo, projectPath / HIER_INDEX, error)) {
+    ErrorMessage(error);
+    return;
+  }
+  delete m_hierarchy;
+  m_hierarchy = nullptr;
+}
+
 bool CompilerOpenFPGA::Synthesize() {
   if (SynthOpt() == SynthesisOpt::Clean) {
     Message("Cleaning synthesis results for " + ProjManager()->projectName());
@@ -1893,6 +1969,25 @@ bool CompilerOpenFPGA::Route() {
   return true;
 }
 
+std::string CompilerOpenFPGA::StageLog(Action action) const {
+  switch (action) {
+    case Action::Synthesis:
+      return SYNTHESIS_LOG;
+    case Action::Pack:
+      return "packing.rpt";
+    case Action::Detailed:
+      return PLACEMENT_LOG;
+    case Action::Routing:
+      return ROUTING_LOG;
+    case Action::STA:
+      return "timing_analysis.rpt";
+    case Action::Power:
+      return "power_analysis.rpt";
+    default:
+      return {};
+  }
+}
+
 bool CompilerOpenFPGA::TimingAnalysis() {
   if (!ProjManager()->HasDesign()) {
     ErrorMessage("No design specified");
@@ -2005,7 +2100,10 @@ bool CompilerOpenFPGA::TimingAnalysis() {
     ofs.close();
   }
 
-  status = ExecuteAndMonitorSystemCommand(taCommand);
+  // Keep the OpenSTA paths for report_paths and the timing reports
+  status = ExecuteAndMonitorSystemCommand(
+      taCommand, TimingAnalysisOpt() == STAOpt::Opensta ? OPENSTA_TIMING_REPORT
+                                                        : std::string{});
   if (status) {
     ErrorMessage("Design " + ProjManager()->projectName() +
                  " timing analysis failed");
@@ -2226,6 +2324,53 @@ std::string CompilerOpenFPGA::FinishOpenFPGAScript(const std::string& script) {
   return result;
 }
 
+extern const char* foedag_version_number;
+extern const char* foedag_git_hash;
+
+// Outputs of the default script, custom scripts may add the architecture
+// bitstream
+static const std::vector<std::string> BitstreamOutputs{
+    "fabric_bitstream.bit", "fabric_independent_bitstream.xml",
+    "PinMapping.xml"};
+
+BitstreamStore::Build CompilerOpenFPGA::BitstreamBuild(
+    const std::string& script) {
+  BitstreamStore::Build build;
+  build.design = ProjManager()->projectName();
+  build.device = ProjManager()->getTargetDevice();
+  build.tools.emplace_back(
+      "foedag", std::string{foedag_version_number} + " " + foedag_git_hash);
+  // OpenFPGA has no cheap version query, its binary stands for it
+  std::error_code ec;
+  const std::filesystem::path& openFpga = m_openFpgaExecutablePath;
+  const auto size = std::filesystem::file_size(openFpga, ec);
+  build.tools.emplace_back(
+      "openfpga", openFpga.string() + " " + std::to_string(ec ? 0 : size) +
+                      " " + std::to_string(FileUtils::Mtime(openFpga)));
+  // The script holds all the options
+  build.options.emplace_back("openfpga_script", script);
+
+  // Every token of the script that names an existing file is a source
+  const std::filesystem::path projectPath = ProjManager()->projectPath();
+  std::vector<std::string> tokens;
+  StringUtils::tokenize(script, " \t\n", tokens);
+  std::sort(tokens.begin(), tokens.end());
+  tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+  for (const auto& token : tokens) {
+    std::filesystem::path path = token;
+    if (std::find(BitstreamOutputs.begin(), BitstreamOutputs.end(), token) !=
+        BitstreamOutputs.end())
+      continue;
+    if (!path.is_absolute()) path = projectPath / path;
+    std::string hash;
+    if (std::filesystem::is_regular_file(path, ec) &&
+        BitstreamStore::HashFile(path, hash))
+      build.sources.emplace_back(token, hash);
+  }
+  build.id = BitstreamStore::Id(build);
+  return build;
+}
+
 bool CompilerOpenFPGA::GenerateBitstream() {
   if (!ProjManager()->HasDesign()) {
     ErrorMessage("No design specified");
@@ -2249,6 +2394,9 @@ bool CompilerOpenFPGA::GenerateBitstream() {
         std::string("fabric_independent_bitstream.xml"));
     return true;
   }
+  // Only for this run, an archived build is never picked up silently
+  const bool restore = BitsOpt() == BitstreamOpt::Restore;
+  if (restore) BitsOpt(BitstreamOpt::DefaultBitsOpt);
   if (!ProjManager()->getTargetDevice().empty()) {
     if (!LicenseDevice(ProjManager()->getTargetDevice())) {
       ErrorMessage(
@@ -2318,6 +2466,25 @@ bool CompilerOpenFPGA::GenerateBitstream() {
     return false;
   }
 
+  // Every build is archived. With "bitstream restore", the outputs of an
+  // archived build of the same sources, options and tools are restored
+  // instead of running OpenFPGA again.
+  const std::filesystem::path projectPath = ProjManager()->projectPath();
+  BitstreamStore store;
+  const bool archive = store.Open(BitstreamStore::DefaultPath(projectPath));
+  BitstreamStore::Build build = BitstreamBuild(script);
+  BitstreamStore::Build archived;
+  if (restore && archive && store.Contains(build.id) &&
+      store.Find(build.id, archived) && store.Restore(archived, projectPath)) {
+    m_state = State::BistreamGenerated;
+    (*m_out) << "Design " << ProjManager()->projectName()
+             << " bitstream is restored from build "
+             << build.id.substr(0, 12) << std::endl;
+    return true;
+  }
+  if (restore)
+    Message("No archived build " + build.id.substr(0, 12) + " to restore");
+
   std::ofstream ofs(
       (std::filesystem::path(ProjManager()->projectPath()) /
        std::string(ProjManager()->projectName() + "_bitstream.cmd"))
@@ -2334,6 +2501,10 @@ bool CompilerOpenFPGA::GenerateBitstream() {
 
   (*m_out) << "Design " << ProjManager()->projectName()
            << " bitstream is generated" << std::endl;
+  if (archive && store.Store(build, projectPath, BitstreamOutputs))
+    Message("Bitstream archived as build " + build.id.substr(0, 12));
+  else
+    Message("Bitstream not archived: " + store.LastError());
   return true;
 }
 
@@ -2342,131 +2513,111 @@ bool CompilerOpenFPGA::LoadDeviceData(const std::string& deviceName) {
   std::filesystem::path datapath = GetSession()->Context()->DataPath();
   std::filesystem::path devicefile =
       datapath / std::string("etc") / std::string("device.xml");
-  QFile file(devicefile.string().c_str());
-  if (!file.open(QFile::ReadOnly)) {
+  // Shared with the device planner, parsed once per change of the file
+  Config* config = Config::Instance();
+  const int res =
+      config->InitConfig(QString::fromStdString(devicefile.string()));
+  if (res == -1) {
     ErrorMessage("Cannot open device file: " + devicefile.string());
     return false;
-  }
-
-  QDomDocument doc;
-  if (!doc.setContent(&file)) {
-    file.close();
+  } else if (res != 0) {
     ErrorMessage("Incorrect device file: " + devicefile.string());
     return false;
   }
-  file.close();
 
-  QDomElement docElement = doc.documentElement();
-  QDomNode node = docElement.firstChild();
-  bool foundDevice = false;
-  while (!node.isNull()) {
-    if (node.isElement()) {
-      QDomElement e = node.toElement();
-
-      std::string name = e.attribute("name").toStdString();
-      if (name == deviceName) {
-        foundDevice = true;
-        QDomNodeList list = e.childNodes();
-        for (int i = 0; i < list.count(); i++) {
-          QDomNode n = list.at(i);
-          if (!n.isNull() && n.isElement()) {
-            if (n.nodeName() == "internal") {
-              std::string file_type =
-                  n.toElement().attribute("type").toStdString();
-              std::string file = n.toElement().attribute("file").toStdString();
-              std::string name = n.toElement().attribute("name").toStdString();
-              std::string num = n.toElement().attribute("num").toStdString();
-              std::filesystem::path fullPath;
-              if (FileUtils::FileExists(file)) {
-                fullPath = file;  // Absolute path
-              } else {
-                fullPath = datapath / std::string("etc") /
-                           std::string("devices") / file;
-              }
-              if (!FileUtils::FileExists(fullPath.string())) {
-                ErrorMessage(
-                    "Invalid device config file: " + fullPath.string() + "\n");
-                status = false;
-              }
-              if (file_type == "vpr_arch") {
-                ArchitectureFile(fullPath.string());
-              } else if (file_type == "openfpga_arch") {
-                OpenFpgaArchitectureFile(fullPath.string());
-              } else if (file_type == "bitstream_settings") {
-                OpenFpgaBitstreamSettingFile(fullPath.string());
-              } else if (file_type == "sim_settings") {
-                OpenFpgaSimSettingFile(fullPath.string());
-              } else if (file_type == "repack_settings") {
-                OpenFpgaRepackConstraintsFile(fullPath.string());
-              } else if (file_type == "fabric_key") {
-                OpenFpgaFabricKeyFile(fullPath.string());
-              } else if (file_type == "pinmap_xml") {
-                OpenFpgaPinmapXMLFile(fullPath.string());
-              } else if (file_type == "pb_pin_fixup") {
-                PbPinFixup(name);
-              } else if (file_type == "pinmap_csv") {
-                OpenFpgaPinmapCSVFile(fullPath);
-              } else if (file_type == "plugin_lib") {
-                YosysPluginLibName(name);
-              } else if (file_type == "plugin_func") {
-                YosysPluginName(name);
-              } else if (file_type == "technology") {
-                YosysMapTechnology(name);
-              } else if (file_type == "synth_type") {
-                if (name == "QL")
-                  SynthType(SynthesisType::QL);
-                else if (name == "RS")
-                  SynthType(SynthesisType::RS);
-                else if (name == "Yosys")
-                  SynthType(SynthesisType::Yosys);
-                else {
-                  ErrorMessage("Invalid synthesis type: " + name + "\n");
-                  status = false;
-                }
-              } else if (file_type == "synth_opts") {
-                PerDeviceSynthOptions(name);
-              } else if (file_type == "vpr_opts") {
-                PerDevicePnROptions(name);
-              } else if (file_type == "device_size") {
-                DeviceSize(name);
-              } else if (file_type == "lut_size") {
-                LutSize(std::strtoul(num.c_str(), nullptr, 10));
-              } else if (file_type == "channel_width") {
-                ChannelWidth(std::strtoul(num.c_str(), nullptr, 10));
-              } else if (file_type == "bitstream_enabled") {
-                if (num == "true") {
-                  BitstreamEnabled(true);
-                } else if (num == "false") {
-                  BitstreamEnabled(false);
-                } else {
-                  ErrorMessage("Invalid bitstream_enabled num (true, false): " +
-                               num + "\n");
-                  status = false;
-                }
-              } else if (file_type == "pin_constraint_enabled") {
-                if (num == "true") {
-                  PinConstraintEnabled(true);
-                } else if (num == "false") {
-                  PinConstraintEnabled(false);
-                } else {
-                  ErrorMessage(
-                      "Invalid pin_constraint_enabled num (true, false): " +
-                      num + "\n");
-                  status = false;
-                }
-              } else {
-                ErrorMessage("Invalid device config type: " + file_type + "\n");
-                status = false;
-              }
-            }
-          }
+  // Holds the catalog even if the planner reloads it meanwhile
+  const auto catalog = config->catalog();
+  const std::vector<int> devices =
+      catalog->DevicesNamed(QString::fromStdString(deviceName));
+  for (int device : devices) {
+    for (const auto& internal : catalog->GetDevice(device).internals) {
+      const std::string& file_type = internal.type;
+      const std::string& file = internal.file;
+      const std::string& name = internal.name;
+      const std::string& num = internal.num;
+      std::filesystem::path fullPath;
+      if (FileUtils::FileExists(file)) {
+        fullPath = file;  // Absolute path
+      } else {
+        fullPath =
+            datapath / std::string("etc") / std::string("devices") / file;
+      }
+      if (!FileUtils::FileExists(fullPath.string())) {
+        ErrorMessage("Invalid device config file: " + fullPath.string() + "\n");
+        status = false;
+      }
+      if (file_type == "vpr_arch") {
+        ArchitectureFile(fullPath.string());
+      } else if (file_type == "openfpga_arch") {
+        OpenFpgaArchitectureFile(fullPath.string());
+      } else if (file_type == "bitstream_settings") {
+        OpenFpgaBitstreamSettingFile(fullPath.string());
+      } else if (file_type == "sim_settings") {
+        OpenFpgaSimSettingFile(fullPath.string());
+      } else if (file_type == "repack_settings") {
+        OpenFpgaRepackConstraintsFile(fullPath.string());
+      } else if (file_type == "fabric_key") {
+        OpenFpgaFabricKeyFile(fullPath.string());
+      } else if (file_type == "pinmap_xml") {
+        OpenFpgaPinmapXMLFile(fullPath.string());
+      } else if (file_type == "pb_pin_fixup") {
+        PbPinFixup(name);
+      } else if (file_type == "pinmap_csv") {
+        OpenFpgaPinmapCSVFile(fullPath);
+      } else if (file_type == "plugin_lib") {
+        YosysPluginLibName(name);
+      } else if (file_type == "plugin_func") {
+        YosysPluginName(name);
+      } else if (file_type == "technology") {
+        YosysMapTechnology(name);
+      } else if (file_type == "synth_type") {
+        if (name == "QL")
+          SynthType(SynthesisType::QL);
+        else if (name == "RS")
+          SynthType(SynthesisType::RS);
+        else if (name == "Yosys")
+          SynthType(SynthesisType::Yosys);
+        else {
+          ErrorMessage("Invalid synthesis type: " + name + "\n");
+          status = false;
+        }
+      } else if (file_type == "synth_opts") {
+        PerDeviceSynthOptions(name);
+      } else if (file_type == "vpr_opts") {
+        PerDevicePnROptions(name);
+      } else if (file_type == "device_size") {
+        DeviceSize(name);
+      } else if (file_type == "lut_size") {
+        LutSize(std::strtoul(num.c_str(), nullptr, 10));
+      } else if (file_type == "channel_width") {
+        ChannelWidth(std::strtoul(num.c_str(), nullptr, 10));
+      } else if (file_type == "bitstream_enabled") {
+        if (num == "true") {
+          BitstreamEnabled(true);
+        } else if (num == "false") {
+          BitstreamEnabled(false);
+        } else {
+          ErrorMessage("Invalid bitstream_enabled num (true, false): " + num +
+                       "\n");
+          status = false;
         }
+      } else if (file_type == "pin_constraint_enabled") {
+        if (num == "true") {
+          PinConstraintEnabled(true);
+        } else if (num == "false") {
+          PinConstraintEnabled(false);
+        } else {
+          ErrorMessage("Invalid pin_constraint_enabled num (true, false): " +
+                       num + "\n");
+          status = false;
+        }
+      } else {
+        ErrorMessage("Invalid device config type: " + file_type + "\n");
+        status = false;
       }
     }
-
-    node = node.nextSibling();
   }
-  if (!foundDevice) {
+  if (devices.empty()) {
     ErrorMessage("Incorrect device: " + deviceName + "\n");
     status = false;
   }
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <string>
 #include <vector>
 
+#include "Compiler/BitstreamStore.h"
 #include "Compiler/Compiler.h"
 
 #ifndef COMPILER_OPENFPGA_H
@@ -123,6 +124,7 @@ class CompilerOpenFPGA : public Compiler {
   virtual bool TimingAnalysis();
   virtual bool PowerAnalysis();
   virtual bool GenerateBitstream();
+  std::string StageLog(Action action) const override;
   virtual bool LoadDeviceData(const std::string& deviceName);
   virtual bool LicenseDevice(const std::string& deviceName);
   virtual bool DesignChanged(const std::string& synth_script,
@@ -132,8 +134,11 @@ class CompilerOpenFPGA : public Compiler {
   virtual std::string FinishSynthesisScript(const std::string& script);
   virtual std::string InitAnalyzeScript();
   virtual std::string FinishAnalyzeScript(const std::string& script);
+  void IndexHierarchy();
   virtual std::string InitOpenFPGAScript();
   virtual std::string FinishOpenFPGAScript(const std::string& script);
+  // Provenance of a bitstream generated with \a script, see BitstreamStore
+  BitstreamStore::Build BitstreamBuild(const std::string& script);
   virtual bool RegisterCommands(TclInterpreter* interp, bool batchMode);
   virtual std::pair<bool, std::string> IsDeviceSizeCorrect(
       const std::string& size) const;
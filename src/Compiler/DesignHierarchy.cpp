@@ -0,0 +1,438 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "DesignHierarchy.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "Compiler/TimingPathDatabase.h"
+#include "Utils/FileUtils.h"
+#include "Utils/StringUtils.h"
+#include "nlohmann_json/json.hpp"
+
+using json = nlohmann::ordered_json;
+
+namespace FOEDAG {
+
+namespace {
+constexpr char Magic[4]{'F', 'H', 'I', 'X'};
+constexpr uint32_t Version{1};
+
+struct Header {
+  char magic[4];
+  uint32_t version;
+  uint32_t names;
+  uint32_t modules;
+  uint32_t ports;
+  uint32_t instances;
+  uint32_t tops;
+};
+
+// Strings or numbers, the analyzer writes both for ids and lines
+std::string Text(const json& object, const char* key) {
+  auto itr = object.find(key);
+  if (itr == object.end()) return {};
+  if (itr->is_string()) return itr->get<std::string>();
+  if (itr->is_number()) return std::to_string(itr->get<int64_t>());
+  return {};
+}
+
+int32_t Number(const json& object, const char* key) {
+  return static_cast<int32_t>(std::atol(Text(object, key).c_str()));
+}
+
+DesignHierarchy::Direction ToDirection(const std::string& text) {
+  const std::string direction = StringUtils::toLower(text);
+  if (direction == "input") return DesignHierarchy::Direction::Input;
+  if (direction == "output") return DesignHierarchy::Direction::Output;
+  if (direction == "inout") return DesignHierarchy::Direction::Inout;
+  return DesignHierarchy::Direction::Unknown;
+}
+
+class Builder {
+ public:
+  explicit Builder(const json& root) : m_root(root) {
+    auto fileIds = root.find("fileIDs");
+    if (fileIds != root.end() && fileIds->is_object())
+      for (const auto& [id, file] : fileIds->items())
+        if (file.is_string()) m_files.emplace(id, file.get<std::string>());
+  }
+
+  void Run() {
+    auto modules = m_root.find("modules");
+    if (modules != m_root.end() && modules->is_object())
+      for (const auto& [name, module] : modules->items())
+        define(name, module);
+    std::vector<std::string> tops;
+    auto tree = m_root.find("hierTree");
+    if (tree != m_root.end() && tree->is_array()) {
+      for (const auto& top : *tree) {
+        std::string name = Text(top, "topModule");
+        if (name.empty()) name = Text(top, "module");
+        if (name.empty()) continue;
+        tops.push_back(name);
+        defineTree(name, top);
+      }
+    }
+    // Modules first so that the instances of a module are contiguous
+    for (size_t i = 0; i < m_definitions.size(); i++) addModule(i);
+    for (size_t i = 0; i < m_definitions.size(); i++) addInstances(i);
+    for (const auto& name : tops) m_tops.push_back(moduleId(name));
+  }
+
+  bool Write(const std::filesystem::path& index, std::string& error) const {
+    Header header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.names = static_cast<uint32_t>(m_names.size());
+    header.modules = static_cast<uint32_t>(m_modules.size());
+    header.ports = static_cast<uint32_t>(m_ports.size());
+    header.instances = static_cast<uint32_t>(m_instances.size());
+    header.tops = static_cast<uint32_t>(m_tops.size());
+
+    // Written aside and renamed so that readers never see a partial index
+    std::filesystem::path tmp = index;
+    tmp += ".tmp";
+    {
+      std::ofstream stream(tmp, std::ios::out | std::ios::binary);
+      auto write = [&stream](const auto& items) {
+        stream.write(reinterpret_cast<const char*>(items.data()),
+                     items.size() * sizeof(items[0]));
+      };
+      stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      write(m_names);
+      write(m_modules);
+      write(m_ports);
+      write(m_instances);
+      write(m_tops);
+      if (!stream.good()) {
+        error = "Can't write hierarchy index " + tmp.string();
+        return false;
+      }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, index, ec);
+    if (ec) {
+      error = "Can't write hierarchy index " + index.string();
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  void define(const std::string& name, const json& module) {
+    if (m_definitionIds.count(name)) return;
+    m_definitionIds.emplace(name, static_cast<uint32_t>(m_definitions.size()));
+    m_definitions.push_back({name, &module});
+  }
+
+  // hierTree may carry the whole instance tree without a "modules" table,
+  // an instance with children then defines its module
+  void defineTree(const std::string& name, const json& node) {
+    if (!m_definitionIds.count(name)) define(name, node);
+    auto children = node.find("moduleInsts");
+    if (children == node.end() || !children->is_array()) return;
+    for (const auto& child : *children) {
+      const std::string module = Text(child, "module");
+      if (module.empty()) continue;
+      if (child.contains("moduleInsts") || child.contains("ports"))
+        defineTree(module, child);
+    }
+  }
+
+  uint32_t add(const std::string& name) {
+    auto itr = m_ids.find(name);
+    if (itr != m_ids.end()) return itr->second;
+    const uint32_t id = static_cast<uint32_t>(m_names.size());
+    m_names.append(name).push_back('\0');
+    m_ids.emplace(name, id);
+    return id;
+  }
+
+  uint32_t addFile(const std::string& file) {
+    auto itr = m_files.find(file);
+    return add(itr == m_files.end() ? file : itr->second);
+  }
+
+  // Undefined modules (black boxes, primitives) get an empty module
+  uint32_t moduleId(const std::string& name) {
+    auto itr = m_definitionIds.find(name);
+    if (itr != m_definitionIds.end()) return itr->second;
+    const uint32_t id = static_cast<uint32_t>(m_modules.size());
+    DesignHierarchy::Module module;
+    module.name = add(name);
+    module.firstPort = static_cast<uint32_t>(m_ports.size());
+    module.firstInstance = static_cast<uint32_t>(m_instances.size());
+    m_modules.push_back(module);
+    m_definitionIds.emplace(name, id);
+    return id;
+  }
+
+  void addModule(size_t index) {
+    const auto& [name, node] = m_definitions[index];
+    DesignHierarchy::Module module;
+    module.name = add(name);
+    module.file = addFile(Text(*node, "file"));
+    module.line = static_cast<uint32_t>(std::max(0, Number(*node, "line")));
+    module.firstPort = static_cast<uint32_t>(m_ports.size());
+    auto ports = node->find("ports");
+    if (ports != node->end() && ports->is_array()) {
+      for (const auto& p : *ports) {
+        DesignHierarchy::Port port;
+        port.name = add(Text(p, "name"));
+        port.direction = ToDirection(Text(p, "direction"));
+        auto range = p.find("range");
+        if (range != p.end() && range->is_object()) {
+          port.msb = Number(*range, "msb");
+          port.lsb = Number(*range, "lsb");
+        }
+        m_ports.push_back(port);
+      }
+    }
+    module.portCount = static_cast<uint32_t>(m_ports.size()) - module.firstPort;
+    m_modules.push_back(module);
+  }
+
+  void addInstances(size_t index) {
+    const auto& [name, node] = m_definitions[index];
+    const uint32_t firstInstance = static_cast<uint32_t>(m_instances.size());
+    auto children = node->find("moduleInsts");
+    if (children != node->end() && children->is_array()) {
+      for (const auto& child : *children) {
+        const std::string module = Text(child, "module");
+        if (module.empty()) continue;
+        DesignHierarchy::Instance instance;
+        instance.name = add(Text(child, "instName"));
+        instance.module = moduleId(module);
+        // An instance is usually in the file of its parent module
+        const std::string file = Text(child, "file");
+        instance.file = file.empty() ? m_modules[index].file : addFile(file);
+        instance.line =
+            static_cast<uint32_t>(std::max(0, Number(child, "line")));
+        m_instances.push_back(instance);
+      }
+    }
+    m_modules[index].firstInstance = firstInstance;
+    m_modules[index].instanceCount =
+        static_cast<uint32_t>(m_instances.size()) - firstInstance;
+  }
+
+  const json& m_root;
+  std::unordered_map<std::string, std::string> m_files;
+  std::vector<std::pair<std::string, const json*>> m_definitions;
+  std::unordered_map<std::string, uint32_t> m_definitionIds;
+  std::unordered_map<std::string, uint32_t> m_ids;
+  std::string m_names;
+  std::vector<DesignHierarchy::Module> m_modules;
+  std::vector<DesignHierarchy::Port> m_ports;
+  std::vector<DesignHierarchy::Instance> m_instances;
+  std::vector<uint32_t> m_tops;
+};
+}  // namespace
+
+bool DesignHierarchy::Build(const std::filesystem::path& hierInfo,
+                            const std::filesystem::path& index,
+                            std::string& error) {
+  std::ifstream stream(hierInfo);
+  if (!stream.good()) {
+    error = "Can't open " + hierInfo.string();
+    return false;
+  }
+  json root = json::parse(stream, nullptr, false);
+  if (root.is_discarded() || !root.is_object()) {
+    error = "Invalid hierarchy file " + hierInfo.string();
+    return false;
+  }
+  Builder builder{root};
+  builder.Run();
+  return builder.Write(index, error);
+}
+
+bool DesignHierarchy::Update(const std::filesystem::path& hierInfo,
+                             const std::filesystem::path& index,
+                             std::string& error) {
+  if (!FileUtils::FileExists(hierInfo)) {
+    error = "Design hierarchy not found: " + hierInfo.string() +
+            ", run analysis first";
+    return false;
+  }
+  // At the file system resolution, an analysis rerun within the second the
+  // index was built in must rebuild it
+  std::error_code indexError, infoError;
+  const auto indexTime = std::filesystem::last_write_time(index, indexError);
+  const auto infoTime = std::filesystem::last_write_time(hierInfo, infoError);
+  if (!indexError && !infoError && indexTime > infoTime) return true;
+  return Build(hierInfo, index, error);
+}
+
+void DesignHierarchy::clear() {
+  m_open = false;
+  m_error.clear();
+  m_moduleByName.clear();
+  m_names.clear();
+  m_modules.clear();
+  m_ports.clear();
+  m_instances.clear();
+  m_tops.clear();
+}
+
+bool DesignHierarchy::Open(const std::filesystem::path& index) {
+  clear();
+  m_file = index;
+  std::ifstream stream(index, std::ios::in | std::ios::binary);
+  Header header;
+  if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+      header.version != Version) {
+    m_error = "Invalid hierarchy index " + index.string();
+    return false;
+  }
+  auto read = [&stream](auto& items, uint32_t size) {
+    items.resize(size);
+    stream.read(reinterpret_cast<char*>(items.data()),
+                items.size() * sizeof(items[0]));
+  };
+  read(m_names, header.names);
+  read(m_modules, header.modules);
+  read(m_ports, header.ports);
+  read(m_instances, header.instances);
+  read(m_tops, header.tops);
+  if (!stream.good() || !valid()) {
+    clear();
+    m_error = "Corrupted hierarchy index " + index.string();
+    return false;
+  }
+  for (uint32_t i = 0; i < m_modules.size(); i++)
+    m_moduleByName.emplace(Name(m_modules[i].name), i);
+  m_stamp = FileUtils::Stamp(index);
+  m_open = true;
+  return true;
+}
+
+bool DesignHierarchy::valid() const {
+  if (!m_names.empty() && m_names.back() != '\0') return false;
+  auto name = [this](uint32_t id) { return id < m_names.size(); };
+  const size_t modules = m_modules.size();
+  for (const auto& module : m_modules) {
+    if (!name(module.name) || !name(module.file) ||
+        uint64_t{module.firstPort} + module.portCount > m_ports.size() ||
+        uint64_t{module.firstInstance} + module.instanceCount >
+            m_instances.size())
+      return false;
+  }
+  for (const auto& port : m_ports)
+    if (!name(port.name)) return false;
+  for (const auto& instance : m_instances)
+    if (!name(instance.name) || !name(instance.file) ||
+        instance.module >= modules)
+      return false;
+  for (uint32_t top : m_tops)
+    if (top >= modules) return false;
+  return m_names.empty() == m_modules.empty();
+}
+
+int DesignHierarchy::FindModule(std::string_view name) const {
+  auto itr = m_moduleByName.find(name);
+  return itr == m_moduleByName.end() ? -1 : static_cast<int>(itr->second);
+}
+
+bool DesignHierarchy::Resolve(std::string_view path, uint32_t& module,
+                              const Instance** instance) const {
+  if (instance) *instance = nullptr;
+  size_t dot = path.find('.');
+  const int top = FindModule(path.substr(0, dot));
+  if (top < 0 || std::find(m_tops.begin(), m_tops.end(),
+                           static_cast<uint32_t>(top)) == m_tops.end())
+    return false;
+  module = static_cast<uint32_t>(top);
+  while (dot != std::string_view::npos) {
+    path.remove_prefix(dot + 1);
+    dot = path.find('.');
+    const std::string_view name = path.substr(0, dot);
+    const Module& parent = m_modules[module];
+    const Instance* first = Instances(parent);
+    const Instance* last = first + parent.instanceCount;
+    auto itr = std::find_if(first, last, [this, name](const Instance& i) {
+      return Name(i.name) == name;
+    });
+    if (itr == last) return false;
+    module = itr->module;
+    if (instance) *instance = itr;
+  }
+  return true;
+}
+
+std::vector<std::string> DesignHierarchy::Find(std::string_view pattern,
+                                               size_t limit,
+                                               bool byModule) const {
+  std::vector<std::string> result;
+  std::vector<uint32_t> stack;
+  for (uint32_t top : m_tops) {
+    if (result.size() >= limit) break;
+    std::string path{Name(m_modules[top].name)};
+    // the path of a top is its module name
+    if (TimingPathDatabase::Match(pattern, path)) result.push_back(path);
+    find(top, path, pattern, byModule, limit, stack, result);
+  }
+  return result;
+}
+
+void DesignHierarchy::find(uint32_t module, std::string& path,
+                           std::string_view pattern, bool byModule,
+                           size_t limit, std::vector<uint32_t>& stack,
+                           std::vector<std::string>& result) const {
+  // A module instantiating itself (directly or not) is not elaborated, the
+  // guard only protects against a malformed file
+  if (std::find(stack.begin(), stack.end(), module) != stack.end()) return;
+  stack.push_back(module);
+  const Module& parent = m_modules[module];
+  const Instance* instances = Instances(parent);
+  const size_t length = path.size();
+  for (uint32_t i = 0; i < parent.instanceCount; i++) {
+    if (result.size() >= limit) break;
+    const Instance& instance = instances[i];
+    path.append(".").append(Name(instance.name));
+    const std::string_view text =
+        byModule ? Name(m_modules[instance.module].name) : path;
+    if (TimingPathDatabase::Match(pattern, text)) result.push_back(path);
+    find(instance.module, path, pattern, byModule, limit, stack, result);
+    path.resize(length);
+  }
+  stack.pop_back();
+}
+
+std::string_view DesignHierarchy::DirectionName(Direction direction) {
+  switch (direction) {
+    case Direction::Input:
+      return "input";
+    case Direction::Output:
+      return "output";
+    case Direction::Inout:
+      return "inout";
+    default:
+      break;
+  }
+  return "unknown";
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,143 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The DesignHierarchy class is the elaborated module/instance tree of
+ * the design written by the analysis stage (hier_info.json).
+ *
+ * Build() converts the json once into a compact index file: a string pool
+ * and fixed size module, port and instance records. Modules are stored once
+ * with their child instances, the instance tree is walked on demand, so the
+ * index stays small even when a module is instantiated many times.
+ */
+class DesignHierarchy {
+ public:
+  enum class Direction : uint8_t { Input, Output, Inout, Unknown };
+  struct Port {
+    uint32_t name{0};  // see Name()
+    Direction direction{Direction::Unknown};
+    int32_t msb{0};
+    int32_t lsb{0};
+  };
+  struct Instance {
+    uint32_t name{0};
+    uint32_t module{0};  // module index
+    uint32_t file{0};    // file name, see Name()
+    uint32_t line{0};
+  };
+  struct Module {
+    uint32_t name{0};
+    uint32_t file{0};
+    uint32_t line{0};
+    uint32_t firstPort{0};
+    uint32_t portCount{0};
+    uint32_t firstInstance{0};
+    uint32_t instanceCount{0};
+  };
+
+  /*!
+   * \brief Build writes the index of \a hierInfo to \a index.
+   * \return false on error, see \a error
+   */
+  static bool Build(const std::filesystem::path& hierInfo,
+                    const std::filesystem::path& index, std::string& error);
+  /*!
+   * \brief Update builds the index if it is missing or older than
+   * \a hierInfo.
+   */
+  static bool Update(const std::filesystem::path& hierInfo,
+                     const std::filesystem::path& index, std::string& error);
+
+  /*!
+   * \brief Open loads an index written by Build().
+   * \return false on error, see LastError()
+   */
+  bool Open(const std::filesystem::path& index);
+  bool IsOpen() const { return m_open; }
+  const std::string& LastError() const { return m_error; }
+  const std::filesystem::path& File() const { return m_file; }
+  // FileUtils::Stamp() of the index when it was opened
+  const std::string& Stamp() const { return m_stamp; }
+
+  std::string_view Name(uint32_t id) const { return m_names.c_str() + id; }
+  // Module indexes of the top modules
+  const std::vector<uint32_t>& Tops() const { return m_tops; }
+  const Module& GetModule(uint32_t index) const { return m_modules[index]; }
+  size_t ModuleCount() const { return m_modules.size(); }
+  const Port* Ports(const Module& module) const {
+    return m_ports.data() + module.firstPort;
+  }
+  const Instance* Instances(const Module& module) const {
+    return m_instances.data() + module.firstInstance;
+  }
+  // Module index of the given name, -1 if unknown
+  int FindModule(std::string_view name) const;
+
+  /*!
+   * \brief Resolve walks an instance path ("top.u_core.u_alu") down from its
+   * top module. On success \a module is the module of the last instance and
+   * \a instance the last instance (nullptr for a top module). A path must
+   * start at a top module, "core.u_alu" fails even if core is a module.
+   */
+  bool Resolve(std::string_view path, uint32_t& module,
+               const Instance** instance = nullptr) const;
+
+  /*!
+   * \brief Find returns at most \a limit instance paths, in depth first
+   * order, whose path (or module name if \a byModule) matches \a pattern
+   * (glob, * and ?).
+   */
+  std::vector<std::string> Find(std::string_view pattern, size_t limit,
+                                bool byModule = false) const;
+
+  static std::string_view DirectionName(Direction direction);
+
+ private:
+  void clear();
+  bool valid() const;
+  void find(uint32_t module, std::string& path, std::string_view pattern,
+            bool byModule, size_t limit, std::vector<uint32_t>& stack,
+            std::vector<std::string>& result) const;
+
+  bool m_open{false};
+  std::string m_error;
+  std::filesystem::path m_file;
+  std::string m_stamp;
+  // Names and file paths, '\0' separated, a name id is its offset
+  std::string m_names;
+  std::vector<Module> m_modules;
+  std::vector<Port> m_ports;
+  std::vector<Instance> m_instances;
+  std::vector<uint32_t> m_tops;
+  std::unordered_map<std::string_view, uint32_t> m_moduleByName;
+};
+
+}  // namespace FOEDAG
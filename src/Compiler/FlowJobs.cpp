@@ -0,0 +1,156 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "FlowJobs.h"
+
+namespace FOEDAG {
+
+static thread_local bool FlowThread{false};
+
+FlowJobs::FlowJobs(const Done& done) : m_done(done) {
+  m_thread = std::thread{&FlowJobs::run, this};
+}
+
+FlowJobs::~FlowJobs() {
+  std::vector<uint32_t> cancelled;
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_quit = true;
+    for (const auto& [id, body] : m_queue) {
+      m_jobs[id].status = Status::Cancelled;
+      cancelled.push_back(id);
+    }
+    m_queue.clear();
+  }
+  m_wakeUp.notify_one();
+  m_thread.join();
+  if (m_done)
+    for (uint32_t id : cancelled) m_done(id, Status::Cancelled);
+}
+
+uint32_t FlowJobs::Submit(const std::string& name, const Body& body) {
+  uint32_t id{0};
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    id = m_nextId++;
+    m_jobs.emplace(id, Job{id, name, Status::Queued});
+    m_queue.emplace_back(id, body);
+  }
+  m_wakeUp.notify_one();
+  return id;
+}
+
+bool FlowJobs::Cancel(uint32_t id, Status& status) {
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    auto itr = m_jobs.find(id);
+    if (itr == m_jobs.end()) return false;
+    status = itr->second.status;
+    if (status == Status::Running) {
+      m_cancelRunning = true;
+      return true;
+    }
+    if (status != Status::Queued) return true;
+    for (auto job = m_queue.begin(); job != m_queue.end(); ++job) {
+      if (job->first == id) {
+        m_queue.erase(job);
+        break;
+      }
+    }
+    itr->second.status = Status::Cancelled;
+  }
+  if (m_done) m_done(id, Status::Cancelled);
+  return true;
+}
+
+bool FlowJobs::CancelRequested() const {
+  std::unique_lock<std::mutex> lock{m_mutex};
+  return m_running != 0 && m_cancelRunning;
+}
+
+bool FlowJobs::Find(uint32_t id, Job& job) const {
+  std::unique_lock<std::mutex> lock{m_mutex};
+  auto itr = m_jobs.find(id);
+  if (itr == m_jobs.end()) return false;
+  job = itr->second;
+  return true;
+}
+
+std::vector<FlowJobs::Job> FlowJobs::Jobs() const {
+  std::unique_lock<std::mutex> lock{m_mutex};
+  std::vector<Job> jobs;
+  jobs.reserve(m_jobs.size());
+  for (const auto& [id, job] : m_jobs) jobs.push_back(job);
+  return jobs;
+}
+
+bool FlowJobs::Busy() const {
+  std::unique_lock<std::mutex> lock{m_mutex};
+  return m_running != 0 || !m_queue.empty();
+}
+
+bool FlowJobs::IsFinished(Status status) {
+  return status != Status::Queued && status != Status::Running;
+}
+
+const char* FlowJobs::StatusName(Status status) {
+  switch (status) {
+    case Status::Queued:
+      return "queued";
+    case Status::Running:
+      return "running";
+    case Status::Succeeded:
+      return "ok";
+    case Status::Failed:
+      return "failed";
+    case Status::Cancelled:
+      return "cancelled";
+  }
+  return "";
+}
+
+bool FlowJobs::OnFlowThread() { return FlowThread; }
+
+void FlowJobs::run() {
+  FlowThread = true;
+  std::unique_lock<std::mutex> lock{m_mutex};
+  while (true) {
+    m_wakeUp.wait(lock, [this]() { return m_quit || !m_queue.empty(); });
+    if (m_queue.empty()) break;  // quit
+    auto [id, body] = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_running = id;
+    m_cancelRunning = false;
+    m_jobs[id].status = Status::Running;
+    lock.unlock();
+    const bool ok = body();
+    lock.lock();
+    const Status status = m_cancelRunning ? Status::Cancelled
+                          : ok            ? Status::Succeeded
+                                          : Status::Failed;
+    m_jobs[id].status = status;
+    m_running = 0;
+    lock.unlock();
+    if (m_done) m_done(id, status);
+    lock.lock();
+  }
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,96 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The FlowJobs class runs flow commands submitted asynchronously
+ * (synth -async...) on a flow thread, in submission order since the
+ * Compiler runs one stage at a time. The interpreter keeps running the
+ * script and is told about each end of job through \a done.
+ */
+class FlowJobs {
+ public:
+  enum class Status { Queued, Running, Succeeded, Failed, Cancelled };
+  struct Job {
+    uint32_t id{0};
+    std::string name;
+    Status status{Status::Queued};
+  };
+  using Body = std::function<bool()>;
+  // Called once per job when it ends, from the flow thread or, for a queued
+  // job cancelled, from the thread calling Cancel()
+  using Done = std::function<void(uint32_t id, Status status)>;
+
+  explicit FlowJobs(const Done& done = {});
+  // Cancels the queued jobs and waits for the running one
+  ~FlowJobs();
+
+  uint32_t Submit(const std::string& name, const Body& body);
+
+  /*!
+   * \brief Cancel drops a queued job. A running job is only marked, the
+   * caller stops it (Compiler::Stop) and it ends as cancelled.
+   * \return the status of the job before the request, false if unknown
+   */
+  bool Cancel(uint32_t id, Status& status);
+
+  // True once the running job was cancelled, its body polls it
+  bool CancelRequested() const;
+
+  bool Find(uint32_t id, Job& job) const;
+  // All jobs, in submission order
+  std::vector<Job> Jobs() const;
+  // Queued or running jobs
+  bool Busy() const;
+
+  static bool IsFinished(Status status);
+  static const char* StatusName(Status status);
+  // True on the flow thread, where the jobs must run synchronously
+  static bool OnFlowThread();
+
+ private:
+  void run();
+
+  Done m_done;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_wakeUp;
+  std::thread m_thread;
+  bool m_quit{false};
+  uint32_t m_nextId{1};
+  std::map<uint32_t, Job> m_jobs;
+  std::deque<std::pair<uint32_t, Body>> m_queue;
+  uint32_t m_running{0};
+  bool m_cancelRunning{false};
+};
+
+}  // namespace FOEDAG
@@ -0,0 +1,267 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "ProgressEstimator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+
+#include "QorDatabase.h"
+#include "Utils/StringUtils.h"
+
+namespace FOEDAG {
+
+// Relative stage cost used until a stage has history
+static const std::map<std::string, double> DefaultWeights{
+    {"ipgenerate", 1},
+    {"analyze", 2},
+    {"synthesize", 20},
+    {"packing", 10},
+    {"global_placement", 5},
+    {"place", 25},
+    {"route", 30},
+    {"sta", 5},
+    {"power", 3},
+    {"bitstream", 5}};
+static constexpr double DefaultWeight{5};
+// Runs the expected values are the median of
+static constexpr size_t HistoryDepth{5};
+
+static double DefaultWeightOf(const std::string& stage) {
+  auto itr = DefaultWeights.find(stage);
+  return (itr != DefaultWeights.end()) ? itr->second : DefaultWeight;
+}
+
+static double Median(std::vector<double> values) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  const size_t middle = values.size() / 2;
+  if (values.size() % 2) return values[middle];
+  return (values[middle - 1] + values[middle]) / 2;
+}
+
+static bool IsNumber(const std::string& token) {
+  char* end = nullptr;
+  std::strtod(token.c_str(), &end);
+  return !token.empty() && *end == '\0';
+}
+
+ProgressEstimator::ProgressEstimator() {
+  m_now = []() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  };
+}
+
+void ProgressEstimator::Learn(const QorDatabase& db,
+                              const std::string& design) {
+  std::map<std::string, std::vector<double>> durations, markers;
+  for (const auto& record : db.Records()) {
+    // Records of a database shared by several designs are told apart
+    if (!design.empty() && !record.design.empty() && record.design != design)
+      continue;
+    auto itr = record.metrics.find("runtime_ms");
+    if (itr != record.metrics.end())
+      durations[record.stage].push_back(itr->second);
+    itr = record.metrics.find(MarkersMetric);
+    if (itr != record.metrics.end())
+      markers[record.stage].push_back(itr->second);
+  }
+  auto lastRuns = [](std::vector<double>& values) {
+    if (values.size() > HistoryDepth)
+      values.erase(values.begin(), values.end() - HistoryDepth);
+    return Median(values);
+  };
+  m_history.clear();
+  for (auto& [stage, values] : durations)
+    m_history[stage].ms = lastRuns(values);
+  for (auto& [stage, values] : markers)
+    m_history[stage].markers = lastRuns(values);
+}
+
+void ProgressEstimator::Plan(const std::vector<std::string>& stages) {
+  m_plan = stages;
+  m_next = 0;
+  m_stage.clear();
+  m_markers = 0;
+}
+
+bool ProgressEstimator::IsPlanned(const std::string& stage) const {
+  return std::find(m_plan.begin() + std::min(m_next, m_plan.size()),
+                   m_plan.end(), stage) != m_plan.end();
+}
+
+void ProgressEstimator::StageStarted(const std::string& stage) {
+  auto itr = std::find(m_plan.begin() + std::min(m_next, m_plan.size()),
+                       m_plan.end(), stage);
+  if (itr == m_plan.end()) {
+    m_plan.push_back(stage);
+    itr = m_plan.end() - 1;
+  }
+  m_next = std::distance(m_plan.begin(), itr);  // skipped stages are done
+  m_stage = stage;
+  m_stageStart = m_now();
+  m_markers = 0;
+  m_carry.clear();
+}
+
+void ProgressEstimator::StageFinished() {
+  if (m_stage.empty()) return;
+  m_next++;
+  m_stage.clear();
+}
+
+void ProgressEstimator::Output(const char* data, size_t size) {
+  if (m_stage.empty()) return;
+  const char* end = data + size;
+  while (data < end) {
+    const char* newline = std::find(data, end, '\n');
+    m_carry.append(data, newline);
+    if (newline == end) break;
+    line(m_carry);
+    m_carry.clear();
+    data = newline + 1;
+  }
+}
+
+void ProgressEstimator::line(const std::string& text) {
+  if (IsMarker(m_stage, text)) m_markers++;
+}
+
+bool ProgressEstimator::IsMarker(const std::string& stage,
+                                 const std::string& line) {
+  if (stage == "synthesize" || stage == "analyze") {
+    // Yosys: "2.3. Executing PROC pass (convert processes to netlists)."
+    return !line.empty() && std::isdigit((unsigned char)line.front()) &&
+           line.find(". Executing ") != std::string::npos &&
+           line.find(" pass") != std::string::npos;
+  }
+  if (stage == "packing" || stage == "global_placement" || stage == "place" ||
+      stage == "route") {
+    // A row of the VPR annealing or router iteration table starts with the
+    // step number, followed by the numbers of the step
+    std::istringstream stream{line};
+    std::string token;
+    if (!(stream >> token) ||
+        !std::all_of(token.begin(), token.end(),
+                     [](char c) { return std::isdigit((unsigned char)c); }))
+      return false;
+    int numbers = 0;
+    while (stream >> token) numbers += IsNumber(token);
+    return numbers >= 4;
+  }
+  return false;
+}
+
+double ProgressEstimator::expectedMs(const std::string& stage) const {
+  auto itr = m_history.find(stage);
+  if (itr != m_history.end() && itr->second.ms > 0) return itr->second.ms;
+  // Scale the default weights to the stages that have history
+  double history = 0, weights = 0;
+  for (const auto& [name, expected] : m_history) {
+    if (expected.ms <= 0) continue;
+    history += expected.ms;
+    weights += DefaultWeightOf(name);
+  }
+  const double unit = (weights > 0) ? history / weights : 1000;
+  return DefaultWeightOf(stage) * unit;
+}
+
+double ProgressEstimator::stageFraction() const {
+  if (m_stage.empty()) return 0;
+  auto itr = m_history.find(m_stage);
+  if (itr != m_history.end() && itr->second.markers > 0 && m_markers > 0)
+    return std::min(m_markers / itr->second.markers, 0.99);
+  const double elapsed = static_cast<double>(m_now() - m_stageStart);
+  return std::min(elapsed / expectedMs(m_stage), 0.99);
+}
+
+double ProgressEstimator::StagePercent() const {
+  return stageFraction() * 100.0;
+}
+
+double ProgressEstimator::Percent() const {
+  double total = 0, done = 0;
+  for (size_t i = 0; i < m_plan.size(); i++) {
+    const double expected = expectedMs(m_plan[i]);
+    total += expected;
+    if (i < m_next)
+      done += expected;
+    else if (i == m_next && !m_stage.empty())
+      done += expected * stageFraction();
+  }
+  return (total > 0) ? done / total * 100.0 : 0;
+}
+
+int64_t ProgressEstimator::EtaMs() const {
+  bool history = false;
+  for (const auto& [stage, expected] : m_history) history |= expected.ms > 0;
+  if (!history) return -1;
+  double remaining = 0;
+  size_t pending = m_next;
+  if (!m_stage.empty()) {
+    const double elapsed = static_cast<double>(m_now() - m_stageStart);
+    const double fraction = stageFraction();
+    auto itr = m_history.find(m_stage);
+    const bool markers = itr != m_history.end() && itr->second.markers > 0 &&
+                         m_markers > 0;
+    // Extrapolate from the markers, they also follow a stage that runs
+    // longer than it used to
+    if (markers)
+      remaining += elapsed * (1 - fraction) / fraction;
+    else
+      remaining += std::max(expectedMs(m_stage) - elapsed, 0.0);
+    pending++;
+  }
+  for (size_t i = pending; i < m_plan.size(); i++)
+    remaining += expectedMs(m_plan[i]);
+  return static_cast<int64_t>(remaining);
+}
+
+std::string ProgressEstimator::Status() const {
+  std::ostringstream status;
+  status.setf(std::ios::fixed);
+  status.precision(0);
+  if (!m_stage.empty())
+    status << m_stage << " " << StagePercent() << "%, ";
+  status << "total " << Percent() << "%";
+  const int64_t eta = EtaMs();
+  if (eta >= 0) status << ", ETA " << FormatDuration(eta);
+  return status.str();
+}
+
+std::string ProgressEstimator::FormatDuration(int64_t ms) {
+  const int64_t seconds = (ms + 500) / 1000;
+  std::ostringstream text;
+  if (seconds < 60) {
+    text << seconds << "s";
+  } else if (seconds < 3600) {
+    text << seconds / 60 << "m " << seconds % 60 << "s";
+  } else {
+    text << seconds / 3600 << "h " << (seconds % 3600) / 60 << "m";
+  }
+  return text.str();
+}
+
+}  // namespace FOEDAG
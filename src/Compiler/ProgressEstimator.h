@@ -0,0 +1,94 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace FOEDAG {
+
+class QorDatabase;
+
+/*!
+ * \brief The ProgressEstimator class estimates the progress and the remaining
+ * time of a flow. Stage durations and the number of progress markers the
+ * tools print (Yosys passes, VPR annealing and router iterations) are learnt
+ * from the previous runs recorded in the QoR database.
+ */
+class ProgressEstimator {
+ public:
+  using Clock = std::function<int64_t()>;  // milliseconds
+  // QoR metric the marker count of a stage is recorded as
+  static constexpr const char* MarkersMetric{"_markers"};
+
+  ProgressEstimator();
+  void SetClock(const Clock& clock) { m_now = clock; }
+
+  /*!
+   * \brief Learn takes the median of the last runs of \a design as the
+   * expected duration and marker count of each stage.
+   */
+  void Learn(const QorDatabase& db, const std::string& design);
+
+  // Planned stages, in execution order
+  void Plan(const std::vector<std::string>& stages);
+  bool IsPlanned(const std::string& stage) const;
+  void StageStarted(const std::string& stage);
+  void StageFinished();
+
+  // Tool output of the running stage, in chunks of any size
+  void Output(const char* data, size_t size);
+  size_t Markers() const { return m_markers; }
+
+  // Whole plan, 0..100
+  double Percent() const;
+  double StagePercent() const;
+  // Remaining time in ms, -1 when there is no history to tell
+  int64_t EtaMs() const;
+  const std::string& Stage() const { return m_stage; }
+  std::string Status() const;
+
+  static bool IsMarker(const std::string& stage, const std::string& line);
+  static std::string FormatDuration(int64_t ms);
+
+ private:
+  struct Expected {
+    double ms{0};
+    double markers{0};
+  };
+  double expectedMs(const std::string& stage) const;
+  double stageFraction() const;
+  void line(const std::string& text);
+
+  Clock m_now;
+  std::map<std::string, Expected> m_history;
+  std::vector<std::string> m_plan;
+  size_t m_next{0};  // index in m_plan of the next stage to run
+  std::string m_stage;
+  int64_t m_stageStart{0};
+  size_t m_markers{0};
+  std::string m_carry;
+};
+
+}  // namespace FOEDAG
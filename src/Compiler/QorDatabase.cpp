@@ -0,0 +1,244 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "QorDatabase.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "Utils/StringUtils.h"
+#include "nlohmann_json/json.hpp"
+
+using json = nlohmann::ordered_json;
+
+namespace FOEDAG {
+
+// Parses the number following \a key in \a line
+static bool ValueAfter(const std::string& line, const std::string& key,
+                       double& value) {
+  auto pos = line.find(key);
+  if (pos == std::string::npos) return false;
+  const char* begin = line.c_str() + pos + key.size();
+  char* end = nullptr;
+  value = std::strtod(begin, &end);
+  return end != begin;
+}
+
+std::filesystem::path QorDatabase::DefaultPath(
+    const std::filesystem::path& projectPath) {
+  const char* shared = std::getenv("FOEDAG_QOR_DIR");
+  if (shared && *shared) return std::filesystem::path{shared} / DefaultFile;
+  return projectPath / DefaultFile;
+}
+
+bool QorDatabase::Open(const std::filesystem::path& file) {
+  m_file = file;
+  m_error.clear();
+  m_records.clear();
+  m_thresholds.clear();
+  std::ifstream stream(file);
+  if (!stream.good()) return true;  // nothing recorded yet
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (line.empty()) continue;
+    auto object = json::parse(line, nullptr, false);
+    if (object.is_discarded() || !object.is_object()) continue;
+    if (object.contains("threshold")) {
+      m_thresholds[object.value("threshold", "")] =
+          object.value("percent", DefaultThreshold);
+      continue;
+    }
+    Record record;
+    record.run = object.value("run", "");
+    record.time = object.value("time", int64_t{0});
+    record.stage = object.value("stage", "");
+    record.design = object.value("design", "");
+    auto metrics = object.find("metrics");
+    if (metrics != object.end() && metrics->is_object()) {
+      for (const auto& [name, value] : metrics->items())
+        if (value.is_number()) record.metrics[name] = value.get<double>();
+    }
+    if (!record.run.empty() && !record.stage.empty())
+      m_records.push_back(std::move(record));
+  }
+  return true;
+}
+
+bool QorDatabase::write(const std::string& line) {
+  if (m_file.has_parent_path()) {
+    std::error_code ec;
+    std::filesystem::create_directories(m_file.parent_path(), ec);
+  }
+  // Terminate the torn line of an interrupted writer so that it doesn't
+  // swallow this record
+  std::string text = line + "\n";
+  std::ifstream last(m_file, std::ios::in | std::ios::binary);
+  if (last.seekg(-1, std::ios::end) && last.get() != '\n') text.insert(0, "\n");
+  last.close();
+  // A single write of a whole line keeps concurrent appends line atomic
+  std::ofstream stream(m_file, std::ios::out | std::ios::app);
+  if (!stream.good()) {
+    m_error = "Can't write QoR database " + m_file.string();
+    return false;
+  }
+  stream << text;
+  stream.flush();
+  return stream.good();
+}
+
+bool QorDatabase::Append(const Record& record) {
+  json metrics = json::object();
+  for (const auto& [name, value] : record.metrics) metrics[name] = value;
+  json object{{"run", record.run},
+              {"time", record.time},
+              {"stage", record.stage},
+              {"metrics", metrics}};
+  if (!record.design.empty()) object["design"] = record.design;
+  if (!write(object.dump())) return false;
+  m_records.push_back(record);
+  return true;
+}
+
+bool QorDatabase::SetThreshold(const std::string& metric, double percent) {
+  json object{{"threshold", metric}, {"percent", percent}};
+  if (!write(object.dump())) return false;
+  m_thresholds[metric] = percent;
+  return true;
+}
+
+double QorDatabase::Threshold(const std::string& metric) const {
+  auto itr = m_thresholds.find(metric);
+  if (itr != m_thresholds.end()) return itr->second;
+  itr = m_thresholds.find("*");
+  return (itr != m_thresholds.end()) ? itr->second : DefaultThreshold;
+}
+
+std::vector<std::string> QorDatabase::Runs() const {
+  std::vector<std::string> runs;
+  for (const auto& record : m_records) {
+    if (std::find(runs.begin(), runs.end(), record.run) == runs.end())
+      runs.push_back(record.run);
+  }
+  return runs;
+}
+
+std::map<std::string, QorDatabase::Metrics> QorDatabase::RunMetrics(
+    const std::string& run) const {
+  std::map<std::string, Metrics> stages;
+  for (const auto& record : m_records) {
+    if (record.run != run) continue;
+    Metrics& metrics = stages[record.stage];
+    for (const auto& [name, value] : record.metrics) metrics[name] = value;
+  }
+  return stages;
+}
+
+bool QorDatabase::HigherIsBetter(const std::string& metric) {
+  return StringUtils::startsWith(metric, "fmax");
+}
+
+std::vector<QorDatabase::Delta> QorDatabase::Compare(
+    const std::string& runA, const std::string& runB) const {
+  std::vector<Delta> deltas;
+  const auto stagesA = RunMetrics(runA);
+  const auto stagesB = RunMetrics(runB);
+  for (const auto& [stage, metricsA] : stagesA) {
+    auto stageB = stagesB.find(stage);
+    if (stageB == stagesB.end()) continue;
+    for (const auto& [metric, valueA] : metricsA) {
+      if (StringUtils::startsWith(metric, "_")) continue;
+      auto itr = stageB->second.find(metric);
+      if (itr == stageB->second.end()) continue;
+      Delta delta{stage, metric, valueA, itr->second};
+      if (valueA != 0)
+        delta.percent = (delta.valueB - valueA) / std::fabs(valueA) * 100.0;
+      else if (delta.valueB != 0)
+        delta.percent = delta.valueB > 0 ? 100.0 : -100.0;
+      const double worse =
+          HigherIsBetter(metric) ? -delta.percent : delta.percent;
+      delta.regression = worse > Threshold(metric);
+      deltas.push_back(delta);
+    }
+  }
+  return deltas;
+}
+
+std::vector<std::pair<std::string, double>> QorDatabase::Trend(
+    const std::string& stage, const std::string& metric) const {
+  std::vector<std::pair<std::string, double>> trend;
+  for (const auto& record : m_records) {
+    if (record.stage != stage) continue;
+    auto itr = record.metrics.find(metric);
+    if (itr == record.metrics.end()) continue;
+    if (!trend.empty() && trend.back().first == record.run)
+      trend.back().second = itr->second;  // stage re-run in the same run
+    else
+      trend.emplace_back(record.run, itr->second);
+  }
+  return trend;
+}
+
+void QorDatabase::ParseLog(std::istream& stream, Metrics& metrics) {
+  std::string line;
+  bool cells = false;  // inside the cell list of a Yosys statistics block
+  double luts = 0, ffs = 0;
+  double value = 0;
+  while (std::getline(stream, line)) {
+    if (cells) {
+      std::istringstream cell{line};
+      std::string name;
+      double count = 0;
+      if (!(cell >> name >> count)) {
+        cells = false;
+        metrics["luts"] = luts;
+        metrics["ffs"] = ffs;
+        continue;
+      }
+      name = StringUtils::toLower(name);
+      if (name.find("lut") != std::string::npos)
+        luts += count;
+      else if (name.find("dff") != std::string::npos)
+        ffs += count;
+      continue;
+    }
+    if (ValueAfter(line, "Number of cells:", value)) {
+      metrics["cells"] = value;
+      cells = true;
+      luts = ffs = 0;
+    } else if (line.find("critical path") != std::string::npos) {
+      // VPR: Final critical path delay (least slack): 5.1 ns, Fmax: 196 MHz
+      if (ValueAfter(line, "):", value) || ValueAfter(line, "path:", value))
+        metrics["cpd_ns"] = value;
+      if (ValueAfter(line, "Fmax:", value)) metrics["fmax_mhz"] = value;
+    } else if (ValueAfter(line, "Total wirelength:", value)) {
+      metrics["wirelength"] = value;
+    }
+  }
+  if (cells) {
+    metrics["luts"] = luts;
+    metrics["ffs"] = ffs;
+  }
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,120 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The QorDatabase class is an append-only store of per-stage QoR and
+ * runtime metrics. Every record is one JSON line so that several flows may
+ * share the same file and an interrupted write only loses its own line.
+ */
+class QorDatabase {
+ public:
+  using Metrics = std::map<std::string, double>;
+  struct Record {
+    std::string run;
+    int64_t time{0};
+    std::string stage;
+    Metrics metrics;
+    std::string design;  // to tell designs apart in a shared database
+  };
+  struct Delta {
+    std::string stage;
+    std::string metric;
+    double valueA{0};
+    double valueB{0};
+    double percent{0};  // (B - A) / |A| * 100
+    bool regression{false};
+  };
+
+  static constexpr const char* DefaultFile{"qor_metrics.jsonl"};
+  // Regression threshold in percent for metrics without an explicit one
+  static constexpr double DefaultThreshold{5.0};
+
+  /*!
+   * \brief DefaultPath returns the database file of a project. Setting
+   * FOEDAG_QOR_DIR shares one database between projects and checkouts.
+   */
+  static std::filesystem::path DefaultPath(
+      const std::filesystem::path& projectPath);
+
+  /*!
+   * \brief Open loads all records of \a file. A missing file is an empty
+   * database, lines that can't be parsed are skipped.
+   */
+  bool Open(const std::filesystem::path& file);
+  const std::filesystem::path& File() const { return m_file; }
+  const std::string& LastError() const { return m_error; }
+
+  bool Append(const Record& record);
+  const std::vector<Record>& Records() const { return m_records; }
+
+  bool SetThreshold(const std::string& metric, double percent);
+  double Threshold(const std::string& metric) const;
+  const std::map<std::string, double>& Thresholds() const {
+    return m_thresholds;
+  }
+
+  // Run ids in the order they were first recorded
+  std::vector<std::string> Runs() const;
+  // Metrics of each stage of \a run, a re-run stage overrides older records
+  std::map<std::string, Metrics> RunMetrics(const std::string& run) const;
+
+  /*!
+   * \brief Compare returns the deltas of all metrics recorded for the same
+   * stage in both runs. A delta is a regression when it is worse than the
+   * threshold of its metric. Internal metrics, named with a leading '_', are
+   * not compared.
+   */
+  std::vector<Delta> Compare(const std::string& runA,
+                             const std::string& runB) const;
+  // {run, value} of a stage metric for every run that recorded it
+  std::vector<std::pair<std::string, double>> Trend(
+      const std::string& stage, const std::string& metric) const;
+
+  static bool HigherIsBetter(const std::string& metric);
+
+  /*!
+   * \brief ParseLog extracts the QoR metrics Yosys and VPR print in their
+   * logs: luts, ffs, cells, cpd_ns, fmax_mhz and wirelength. Later values
+   * override earlier ones.
+   */
+  static void ParseLog(std::istream& stream, Metrics& metrics);
+
+ private:
+  bool write(const std::string& line);
+
+  std::filesystem::path m_file;
+  std::string m_error;
+  std::vector<Record> m_records;
+  std::map<std::string, double> m_thresholds;
+};
+
+}  // namespace FOEDAG
@@ -23,6 +23,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QStringList>
 #include <QVector>
 
+class QAbstractItemModel;
+class QObject;
+
 namespace FOEDAG {
 
 /* Given interface represents a report for the compilation task.
@@ -42,5 +45,11 @@ class ITaskReport {
   virtual const TableData &getData() const = 0;
   // Returns report name
   virtual const QString &getName() const = 0;
+  // Reports too large for a table widget return a model instead of data. The
+  // view only fetches the rows it shows. The model is owned by \a parent,
+  // or by the caller when there is none.
+  virtual QAbstractItemModel *createModel(QObject *parent) const {
+    return nullptr;
+  }
 };
 }  // namespace FOEDAG
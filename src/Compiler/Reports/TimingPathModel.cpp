@@ -0,0 +1,112 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "TimingPathModel.h"
+
+#include <QBrush>
+
+#include "Compiler/TimingPathDatabase.h"
+
+namespace FOEDAG {
+
+TimingPathModel::TimingPathModel(
+    std::shared_ptr<const TimingPathDatabase> paths,
+    std::vector<uint32_t> &&rows, QObject *parent)
+    : QAbstractTableModel(parent),
+      m_paths(std::move(paths)),
+      m_rows(std::move(rows)) {}
+
+int TimingPathModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
+}
+
+int TimingPathModel::columnCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : Check + 1;
+}
+
+QVariant TimingPathModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= rowCount()) return {};
+  const uint32_t id = m_rows[index.row()];
+  const auto &path = m_paths->At(id);
+  auto name = [this](uint32_t name) {
+    auto view = m_paths->Name(name);
+    return QString::fromUtf8(view.data(), static_cast<int>(view.size()));
+  };
+  switch (role) {
+    case Qt::DisplayRole:
+      switch (index.column()) {
+        case Slack:
+          return QString::number(path.slack, 'f', 3);
+        case Startpoint:
+          return name(path.startpoint);
+        case Endpoint:
+          return name(path.endpoint);
+        case StartClock:
+          return name(path.startClock);
+        case EndClock:
+          return name(path.endClock);
+        case Check:
+          return path.check == TimingPathDatabase::Check::Hold
+                     ? QString("hold")
+                     : QString("setup");
+      }
+      break;
+    case Qt::ForegroundRole:
+      if (index.column() == Slack && path.slack < 0) return QBrush(Qt::red);
+      break;
+    case Qt::ToolTipRole:
+      // Read back from the report, only for the row under the mouse
+      return nodes(id);
+  }
+  return {};
+}
+
+QVariant TimingPathModel::headerData(int section, Qt::Orientation orientation,
+                                     int role) const {
+  if (role != Qt::DisplayRole || orientation != Qt::Horizontal) return {};
+  switch (section) {
+    case Slack:
+      return tr("Slack");
+    case Startpoint:
+      return tr("Startpoint");
+    case Endpoint:
+      return tr("Endpoint");
+    case StartClock:
+      return tr("Start clock");
+    case EndClock:
+      return tr("End clock");
+    case Check:
+      return tr("Check");
+  }
+  return {};
+}
+
+QString TimingPathModel::nodes(uint32_t path) const {
+  QStringList lines;
+  for (const auto &node : m_paths->Nodes(path)) {
+    lines << QString("%1\t%2\t%3")
+                 .arg(QString::number(node.incr, 'f', 3),
+                      QString::number(node.time, 'f', 3),
+                      QString::fromStdString(node.point));
+  }
+  return lines.join("\n");
+}
+
+}  // namespace FOEDAG
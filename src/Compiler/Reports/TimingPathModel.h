@@ -0,0 +1,57 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <QAbstractTableModel>
+#include <memory>
+#include <vector>
+
+namespace FOEDAG {
+
+class TimingPathDatabase;
+
+/* Table of timing paths. Rows are formatted when the view asks for them so
+ * that reports with hundreds of thousands of paths open immediately.
+ */
+class TimingPathModel : public QAbstractTableModel {
+  Q_OBJECT
+
+ public:
+  enum Column { Slack, Startpoint, Endpoint, StartClock, EndClock, Check };
+
+  TimingPathModel(std::shared_ptr<const TimingPathDatabase> paths,
+                  std::vector<uint32_t> &&rows, QObject *parent = nullptr);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+
+ private:
+  QString nodes(uint32_t path) const;
+
+  std::shared_ptr<const TimingPathDatabase> m_paths;
+  std::vector<uint32_t> m_rows;  // path indexes, worst slack first
+};
+
+}  // namespace FOEDAG
@@ -0,0 +1,128 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "TimingReportManager.h"
+
+#include "Compiler/QorDatabase.h"
+#include "Compiler/TimingPathDatabase.h"
+#include "CompilerDefines.h"
+#include "NewProject/ProjectManager/project.h"
+#include "TableReport.h"
+#include "TimingPathModel.h"
+#include "Utils/FileUtils.h"
+
+namespace {
+static constexpr const char *QOR_REPORT_NAME{"QoR Compare Report"};
+static constexpr const char *SETUP_REPORT_NAME{"Setup Paths Report"};
+static constexpr const char *HOLD_REPORT_NAME{"Hold Paths Report"};
+}  // namespace
+
+namespace FOEDAG {
+
+namespace {
+class TimingPathReport final : public ITaskReport {
+ public:
+  TimingPathReport(std::shared_ptr<const TimingPathDatabase> paths,
+                   std::vector<uint32_t> &&rows, const QString &name)
+      : m_paths{std::move(paths)}, m_rows{std::move(rows)}, m_name{name} {}
+
+ private:
+  const LineValues &getColumns() const override { return m_columns; }
+  const TableData &getData() const override { return m_data; }
+  const QString &getName() const override { return m_name; }
+  QAbstractItemModel *createModel(QObject *parent) const override {
+    return new TimingPathModel(m_paths, std::vector<uint32_t>{m_rows},
+                               parent);
+  }
+
+  std::shared_ptr<const TimingPathDatabase> m_paths;
+  std::vector<uint32_t> m_rows;
+  QString m_name;
+  LineValues m_columns;
+  TableData m_data;
+};
+}  // namespace
+
+QStringList TimingReportManager::getAvailableReportIds() const {
+  return {QString(SETUP_REPORT_NAME), QString(HOLD_REPORT_NAME),
+          QString(QOR_REPORT_NAME)};
+}
+
+QMap<size_t, QString> TimingReportManager::getMessages() { return {}; }
+
+std::unique_ptr<ITaskReport> TimingReportManager::createReport(
+    const QString &reportId) {
+  auto report = reportId == QString(QOR_REPORT_NAME)
+                    ? createQorReport()
+                    : createPathsReport(reportId);
+  if (report) emit reportCreated(reportId);
+  return report;
+}
+
+std::unique_ptr<ITaskReport> TimingReportManager::createPathsReport(
+    const QString &reportId) {
+  const bool hold = reportId == QString(HOLD_REPORT_NAME);
+  const std::filesystem::path projectPath =
+      Project::Instance()->projectPath().toStdString();
+  // VPR writes one report per check, OpenSTA a single one
+  auto file = projectPath / (hold ? TIMING_HOLD_REPORT : TIMING_SETUP_REPORT);
+  if (!FileUtils::FileExists(file)) file = projectPath / OPENSTA_TIMING_REPORT;
+
+  auto paths = std::make_shared<TimingPathDatabase>();
+  if (!paths->Open(file)) return nullptr;
+  TimingPathDatabase::Query query;
+  query.anyCheck = false;
+  query.check = hold ? TimingPathDatabase::Check::Hold
+                     : TimingPathDatabase::Check::Setup;
+  auto rows = paths->Find(query);
+  return std::make_unique<TimingPathReport>(std::move(paths), std::move(rows),
+                                            reportId);
+}
+
+std::unique_ptr<ITaskReport> TimingReportManager::createQorReport() {
+  QorDatabase db;
+  db.Open(QorDatabase::DefaultPath(
+      Project::Instance()->projectPath().toStdString()));
+  auto runs = db.Runs();
+  if (runs.empty()) return nullptr;
+  // A single run is compared with itself so that its metrics are still shown
+  const std::string runA = runs.size() > 1 ? runs[runs.size() - 2] : runs[0];
+  const std::string runB = runs.back();
+
+  auto data = ITaskReport::TableData{};
+  for (const auto &delta : db.Compare(runA, runB)) {
+    data.push_back({QString::fromStdString(delta.stage),
+                    QString::fromStdString(delta.metric),
+                    QString::number(delta.valueA),
+                    QString::number(delta.valueB),
+                    QString::number(delta.percent, 'f', 1),
+                    delta.regression ? QString("REGRESSION") : QString()});
+  }
+  auto columns = QStringList{"Stage",
+                             "Metric",
+                             QString::fromStdString(runA),
+                             QString::fromStdString(runB),
+                             "Delta %",
+                             "Status"};
+  return std::make_unique<TableReport>(std::move(columns), std::move(data),
+                                       QOR_REPORT_NAME);
+}
+
+}  // namespace FOEDAG
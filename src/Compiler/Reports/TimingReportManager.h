@@ -0,0 +1,40 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "AbstractReportManager.h"
+
+namespace FOEDAG {
+
+/* Reports of the timing analysis task: the setup and hold paths of the VPR
+ * or OpenSTA timing reports and the QoR metrics of the last two runs
+ * recorded in the QoR database, side by side.
+ */
+class TimingReportManager final : public AbstractReportManager {
+  QStringList getAvailableReportIds() const override;
+  std::unique_ptr<ITaskReport> createReport(const QString &reportId) override;
+  QMap<size_t, QString> getMessages() override;
+
+  std::unique_ptr<ITaskReport> createQorReport();
+  std::unique_ptr<ITaskReport> createPathsReport(const QString &reportId);
+};
+
+}  // namespace FOEDAG
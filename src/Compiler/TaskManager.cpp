@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Reports/PlacementReportManager.h"
 #include "Reports/RoutingReportManager.h"
 #include "Reports/SynthesisReportManager.h"
+#include "Reports/TimingReportManager.h"
 
 namespace FOEDAG {
 
@@ -149,6 +150,11 @@ TaskManager::TaskManager(QObject *parent) : QObject{parent} {
           this, &TaskManager::taskReportCreated);
   m_reportManagerRegistry.registerReportManager(
       ROUTING, std::move(routingReportManager));
+  auto timingReportManager = std::make_shared<TimingReportManager>();
+  connect(timingReportManager.get(), &AbstractReportManager::reportCreated,
+          this, &TaskManager::taskReportCreated);
+  m_reportManagerRegistry.registerReportManager(
+      TIMING_SIGN_OFF, std::move(timingReportManager));
 }
 
 TaskManager::~TaskManager() { qDeleteAll(m_tasks); }
@@ -218,6 +224,16 @@ void TaskManager::bindTaskCommand(uint id, const std::function<void()> &cmd) {
 
 void TaskManager::setTaskCount(int count) { m_taskCount = count; }
 
+QVector<uint> TaskManager::pendingTasks() const {
+  QVector<uint> ids;
+  for (auto t : m_runStack) ids.append(taskId(t));
+  return ids;
+}
+
+void TaskManager::setEstimate(int percent, const QString &msg) {
+  emit estimate(percent, msg);
+}
+
 void TaskManager::runNext() {
   Task *t = qobject_cast<Task *>(sender());
   if (t) {
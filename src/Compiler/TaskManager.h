@@ -87,6 +87,17 @@ class TaskManager : public QObject {
 
   void setTaskCount(int count);
 
+  /*!
+   * \brief pendingTasks
+   * \return ids of the running task and of the tasks queued after it.
+   */
+  QVector<uint> pendingTasks() const;
+
+  /*!
+   * \brief setEstimate. Publish the estimated progress of the flow.
+   */
+  void setEstimate(int percent, const QString &msg);
+
   const TaskReportManagerRegistry &getReportManagerRegistry() const;
  signals:
   /*!
@@ -106,6 +117,11 @@ class TaskManager : public QObject {
    * emits whenever current task done and send current progress and max steps.
    */
   void progress(int progress, int max, const QString &msg = {});
+  /*!
+   * \brief estimate
+   * emits while the flow runs with its estimated progress, 0..100.
+   */
+  void estimate(int percent, const QString &msg);
 
   void taskReportCreated(QString reportName);
 
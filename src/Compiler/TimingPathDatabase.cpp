@@ -0,0 +1,304 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "TimingPathDatabase.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "Utils/FileUtils.h"
+#include "Utils/StringUtils.h"
+
+namespace FOEDAG {
+
+static std::string_view Trim(std::string_view text) {
+  while (!text.empty() && std::isspace((unsigned char)text.front()))
+    text.remove_prefix(1);
+  while (!text.empty() && std::isspace((unsigned char)text.back()))
+    text.remove_suffix(1);
+  return text;
+}
+
+static bool StartsWith(std::string_view text, std::string_view start) {
+  return text.substr(0, start.size()) == start;
+}
+
+static bool ToNumber(std::string_view token, double& value) {
+  char buffer[64];
+  if (token.empty() || token.size() >= sizeof(buffer)) return false;
+  std::memcpy(buffer, token.data(), token.size());
+  buffer[token.size()] = '\0';
+  char* end = nullptr;
+  value = std::strtod(buffer, &end);
+  return end == buffer + token.size();
+}
+
+static std::vector<std::string_view> Tokens(std::string_view line) {
+  std::vector<std::string_view> tokens;
+  size_t pos = 0;
+  while (pos < line.size()) {
+    while (pos < line.size() && std::isspace((unsigned char)line[pos])) pos++;
+    size_t end = pos;
+    while (end < line.size() && !std::isspace((unsigned char)line[end])) end++;
+    if (end > pos) tokens.push_back(line.substr(pos, end - pos));
+    pos = end;
+  }
+  return tokens;
+}
+
+// "name (type clocked by clk)" -> name, clk
+static void SplitPoint(std::string_view text, std::string_view& name,
+                       std::string_view& clock) {
+  text = Trim(text);
+  auto paren = text.find(" (");
+  name = Trim(text.substr(0, paren));
+  clock = {};
+  auto clocked = text.find("clocked by ");
+  if (clocked == std::string_view::npos) return;
+  clock = text.substr(clocked + 11);
+  auto end = clock.find_first_of(") ");
+  clock = clock.substr(0, end);
+}
+
+void TimingPathDatabase::clear() {
+  m_open = false;
+  m_error.clear();
+  m_paths.clear();
+  m_bySlack.clear();
+  m_names.assign(1, '\0');  // id 0 is "no name"
+  m_clocks.clear();
+  m_inPath = false;
+}
+
+uint32_t TimingPathDatabase::add(std::string_view name) {
+  if (name.empty()) return 0;
+  const uint32_t id = static_cast<uint32_t>(m_names.size());
+  m_names.append(name);
+  m_names.push_back('\0');
+  return id;
+}
+
+uint32_t TimingPathDatabase::addClock(std::string_view name) {
+  if (name.empty()) return 0;
+  auto itr = m_clocks.find(std::string{name});
+  if (itr != m_clocks.end()) return itr->second;
+  const uint32_t id = add(name);
+  m_clocks.emplace(name, id);
+  return id;
+}
+
+bool TimingPathDatabase::Open(const std::filesystem::path& file) {
+  clear();
+  m_file = file;
+  std::ifstream stream(file, std::ios::in | std::ios::binary);
+  if (!stream.good()) {
+    m_error = "Can't open timing report " + file.string();
+    return false;
+  }
+  m_mtime = FileUtils::Mtime(file);
+  const std::string name = StringUtils::toLower(file.filename().string());
+  m_defaultCheck = (name.find("hold") != std::string::npos) ? Check::Hold
+                                                            : Check::Setup;
+
+  // Reports easily reach hundreds of MB, scan them in large blocks and never
+  // keep more than one block and the tail of its last line
+  std::vector<char> buffer(4 << 20);
+  std::string carry;
+  uint64_t offset = 0;  // of the first byte of 'carry'
+  while (stream) {
+    stream.read(buffer.data(), buffer.size());
+    const size_t count = static_cast<size_t>(stream.gcount());
+    if (count == 0) break;
+    const char* data = buffer.data();
+    const char* end = data + count;
+    const char* lineBegin = data;
+    while (const char* newline = static_cast<const char*>(
+               std::memchr(lineBegin, '\n', end - lineBegin))) {
+      std::string_view line{lineBegin, size_t(newline - lineBegin)};
+      if (!carry.empty()) {
+        carry.append(line);
+        parseLine(carry, offset);
+        offset += carry.size() + 1;
+        carry.clear();
+      } else {
+        parseLine(line, offset);
+        offset += line.size() + 1;
+      }
+      lineBegin = newline + 1;
+    }
+    carry.append(lineBegin, end - lineBegin);
+  }
+  if (!carry.empty()) parseLine(carry, offset);
+
+  m_bySlack.resize(m_paths.size());
+  for (uint32_t i = 0; i < m_paths.size(); i++) m_bySlack[i] = i;
+  std::stable_sort(m_bySlack.begin(), m_bySlack.end(),
+                   [this](uint32_t a, uint32_t b) {
+                     return m_paths[a].slack < m_paths[b].slack;
+                   });
+  m_open = true;
+  return true;
+}
+
+void TimingPathDatabase::parseLine(std::string_view line, uint64_t offset) {
+  // Most lines are path points, decide on the first character before doing
+  // any other work
+  size_t first = 0;
+  while (first < line.size() && line[first] == ' ') first++;
+  if (first == line.size()) return;
+  const char c = line[first];
+  if (c != 'S' && c != 'E' && c != 'P' && c != 's' && c != '-' &&
+      !std::isdigit((unsigned char)c))
+    return;
+  line = Trim(line);
+  if (c == 'S' && StartsWith(line, "Startpoint")) {
+    std::string_view name, clock;
+    SplitPoint(line.substr(line.find(':') + 1), name, clock);
+    m_current = Path{};
+    m_current.offset = offset;
+    m_current.check = m_defaultCheck;
+    m_current.startpoint = add(name);
+    m_current.startClock = addClock(clock);
+    m_inPath = true;
+    return;
+  }
+  if (!m_inPath) return;
+  if (c == 'E' && StartsWith(line, "Endpoint")) {
+    auto colon = line.find(':');
+    if (colon == std::string_view::npos) return;
+    std::string_view name, clock;
+    SplitPoint(line.substr(colon + 1), name, clock);
+    m_current.endpoint = add(name);
+    m_current.endClock = addClock(clock);
+  } else if (c == 'P' && StartsWith(line, "Path Type")) {
+    auto type = Trim(line.substr(line.find(':') + 1));
+    if (type == "hold" || type == "min")
+      m_current.check = Check::Hold;
+    else if (type == "setup" || type == "max")
+      m_current.check = Check::Setup;
+  } else if (c == 's' || c == '-' || std::isdigit((unsigned char)c)) {
+    // VPR: "slack (MET)   0.123", OpenSTA: "0.12   slack (MET)"
+    if (line.find("slack") == std::string_view::npos) return;
+    auto tokens = Tokens(line);
+    double slack = 0;
+    for (auto itr = tokens.rbegin(); itr != tokens.rend(); ++itr) {
+      if (ToNumber(*itr, slack)) {
+        finishPath(slack);
+        return;
+      }
+    }
+  }
+}
+
+void TimingPathDatabase::finishPath(double slack) {
+  m_current.slack = slack;
+  m_paths.push_back(m_current);
+  m_inPath = false;
+}
+
+std::vector<uint32_t> TimingPathDatabase::Find(const Query& query) const {
+  std::vector<uint32_t> result;
+  auto first = std::upper_bound(
+      m_bySlack.begin(), m_bySlack.end(), query.slackGt,
+      [this](double slack, uint32_t index) {
+        return slack < m_paths[index].slack;
+      });
+  for (auto itr = first; itr != m_bySlack.end(); ++itr) {
+    if (result.size() >= query.limit) break;
+    const Path& path = m_paths[*itr];
+    if (path.slack >= query.slackLt) break;  // sorted, nothing else matches
+    if (!query.anyCheck && path.check != query.check) continue;
+    if (!query.from.empty() && !Match(query.from, Name(path.startpoint)))
+      continue;
+    if (!query.to.empty() && !Match(query.to, Name(path.endpoint)))
+      continue;
+    if (!query.clock.empty() && !Match(query.clock, Name(path.startClock)) &&
+        !Match(query.clock, Name(path.endClock)))
+      continue;
+    result.push_back(*itr);
+  }
+  return result;
+}
+
+std::vector<TimingPathDatabase::Node> TimingPathDatabase::Nodes(
+    size_t index) const {
+  std::vector<Node> nodes;
+  if (index >= m_paths.size()) return nodes;
+  std::ifstream stream(m_file, std::ios::in | std::ios::binary);
+  stream.seekg(m_paths[index].offset);
+  std::string buffer;
+  bool points = false;  // past the column header of the path
+  while (std::getline(stream, buffer)) {
+    std::string_view line = Trim(buffer);
+    if (line.find("data arrival time") != std::string_view::npos) break;
+    if (StartsWith(line, "---")) {
+      points = true;
+      continue;
+    }
+    if (!points || line.empty()) continue;
+    auto tokens = Tokens(line);
+    if (tokens.size() < 3) continue;
+    Node node;
+    if (ToNumber(tokens[0], node.incr) && ToNumber(tokens[1], node.time)) {
+      // OpenSTA: incr time [^|v] description
+      size_t first = 2;
+      if (tokens[first] == "^" || tokens[first] == "v") first++;
+      if (first >= tokens.size()) continue;
+      const char* begin = tokens[first].data();
+      node.point = line.substr(begin - line.data());
+    } else if (ToNumber(tokens[tokens.size() - 2], node.incr) &&
+               ToNumber(tokens.back(), node.time)) {
+      // VPR: point incr time
+      const char* end = tokens[tokens.size() - 2].data();
+      node.point = std::string{Trim({line.data(), size_t(end - line.data())})};
+    } else {
+      continue;
+    }
+    nodes.push_back(std::move(node));
+  }
+  return nodes;
+}
+
+bool TimingPathDatabase::Match(std::string_view pattern,
+                               std::string_view text) {
+  size_t p = 0, t = 0;
+  size_t star = std::string_view::npos, retry = 0;
+  while (t < text.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+      p++;
+      t++;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      retry = t;
+    } else if (star != std::string_view::npos) {
+      p = star + 1;
+      t = ++retry;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') p++;
+  return p == pattern.size();
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,120 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The TimingPathDatabase class streams a VPR (report_timing.*.rpt) or
+ * OpenSTA (report_checks) timing report once and keeps a compact index of
+ * its paths: end points, clocks, check type and slack. The nodes of a path
+ * are only read back from the report when asked for.
+ */
+class TimingPathDatabase {
+ public:
+  enum class Check : uint8_t { Setup, Hold };
+  struct Path {
+    uint64_t offset{0};  // of the path in the report
+    double slack{0};
+    // Names, see Name()
+    uint32_t startpoint{0};
+    uint32_t endpoint{0};
+    uint32_t startClock{0};
+    uint32_t endClock{0};
+    Check check{Check::Setup};
+  };
+  struct Node {
+    std::string point;
+    double incr{0};
+    double time{0};
+  };
+  struct Query {
+    size_t limit{std::numeric_limits<size_t>::max()};
+    // Exclusive slack bounds
+    double slackLt{std::numeric_limits<double>::infinity()};
+    double slackGt{-std::numeric_limits<double>::infinity()};
+    // Glob patterns (* and ?), empty matches everything
+    std::string from;
+    std::string to;
+    std::string clock;  // start or end clock
+    bool anyCheck{true};
+    Check check{Check::Setup};
+  };
+
+  /*!
+   * \brief Open indexes all paths of the report.
+   * \return false on error, see LastError()
+   */
+  bool Open(const std::filesystem::path& file);
+  bool IsOpen() const { return m_open; }
+  const std::string& LastError() const { return m_error; }
+  const std::filesystem::path& File() const { return m_file; }
+  time_t Mtime() const { return m_mtime; }
+
+  // Paths in report order
+  size_t Size() const { return m_paths.size(); }
+  const Path& At(size_t index) const { return m_paths[index]; }
+  std::string_view Name(uint32_t id) const { return m_names.c_str() + id; }
+
+  /*!
+   * \brief Find returns the indexes of the paths matching \a query, worst
+   * slack first.
+   */
+  std::vector<uint32_t> Find(const Query& query) const;
+
+  // Points of the data arrival path of path \a index
+  std::vector<Node> Nodes(size_t index) const;
+
+  static bool Match(std::string_view pattern, std::string_view text);
+
+ private:
+  void clear();
+  void parseLine(std::string_view line, uint64_t offset);
+  void finishPath(double slack);
+  uint32_t add(std::string_view name);
+  uint32_t addClock(std::string_view name);
+
+  bool m_open{false};
+  std::string m_error;
+  std::filesystem::path m_file;
+  time_t m_mtime{0};
+  Check m_defaultCheck{Check::Setup};
+  std::vector<Path> m_paths;
+  std::vector<uint32_t> m_bySlack;
+  // All names, '\0' separated, a name id is its offset. Points are nearly
+  // all unique and simply appended, only clocks are shared
+  std::string m_names;
+  std::unordered_map<std::string, uint32_t> m_clocks;
+  // Path being parsed
+  Path m_current;
+  bool m_inPath{false};
+};
+
+}  // namespace FOEDAG
@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QEventLoop>
 
+#include "Compiler/FlowJobs.h"
 #include "MainWindow/Session.h"
 
 using namespace FOEDAG;
@@ -38,6 +39,8 @@ WorkerThread::WorkerThread(const std::string& threadName,
 WorkerThread::~WorkerThread() { delete m_thread; }
 
 bool WorkerThread::start() {
+  // Job of an -async command, the console stays available meanwhile
+  if (FlowJobs::OnFlowThread()) return m_compiler->Compile(m_action);
   bool result = true;
   m_compiler->start();
   QEventLoop* eventLoop{nullptr};
@@ -40,6 +40,7 @@ TclConsoleWidget::TclConsoleWidget(TclInterp *interp,
             [this]() { setState(State::IN_PROGRESS); });
     m_console->setErrorStream(&m_errorBuffer->getStream());
     registerCommands(interp);
+    loadHistory();
   }
   setPrompt("# ");
   setTabAllowed(false);
@@ -290,6 +291,20 @@ void TclConsoleWidget::registerCommands(TclInterp *interp) {
   Tcl_CreateCommand(interp, "unknown", unknown, nullptr, nullptr);
 }
 
+// Commands of the previous sessions for the arrow keys and the search
+void TclConsoleWidget::loadHistory() {
+  static constexpr size_t MaxCommands{1000};
+  if (!GlobalSession || !GlobalSession->CmdStack()) return;
+  CommandHistory *cmdHistory = GlobalSession->CmdStack()->History();
+  if (!cmdHistory) return;
+  const auto &entries = cmdHistory->Entries();
+  const size_t first =
+      entries.size() > MaxCommands ? entries.size() - MaxCommands : 0;
+  for (size_t i = first; i < entries.size(); i++)
+    history.append(QString::fromStdString(entries[i].command));
+  historyIndex = history.size();
+}
+
 bool TclConsoleWidget::hasPrompt() const {
   auto lastBlock = document()->lastBlock();
   return !lastBlock.text().isEmpty();
@@ -76,6 +76,7 @@ class TclConsoleWidget : public QConsole {
   void setState(const State &state);
   void handleLink(const QPoint &p);
   void registerCommands(TclInterp *interp);
+  void loadHistory();
   bool hasPrompt() const;
   bool handleCommandFromHistory(const QString &command,
                                 QString &commandFromHist);
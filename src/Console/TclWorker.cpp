@@ -139,7 +139,13 @@ TclWorker::TclWorker(TclInterp *interpreter, std::ostream &out,
 void TclWorker::runCommand(const QString &command) {
   init(false);
 
+  CommandHistory *history = (GlobalSession && GlobalSession->CmdStack())
+                                ? GlobalSession->CmdStack()->History()
+                                : nullptr;
+  CommandHistory::Pending pending;
+  if (history) pending = history->Start();
   int returnCode = TclEval(m_interpreter, qPrintable(command));
+  if (history) history->Finish(pending, command.toStdString(), returnCode);
   if (returnCode == TCL_ERROR) {
     Tcl_Obj *options = Tcl_GetReturnOptions(m_interpreter, returnCode);
     Tcl_Obj *key = Tcl_NewStringObj("-errorinfo", -1);
@@ -119,6 +119,10 @@ VLNV FOEDAG::getIpInfoFromPath(std::filesystem::path path) {
 // ip catalog. This will cache the return value the first time it's not empty
 std::filesystem::path IPCatalog::getPythonPath() {
   static std::filesystem::path s_pythonPath{};
+  if (const char* toolsPath = std::getenv("FOEDAG_TOOLS_PATH")) {
+    std::filesystem::path python = std::filesystem::path(toolsPath) / "python";
+    if (FileUtils::FileExists(python)) return python;
+  }
   if (s_pythonPath.empty()) {
     std::filesystem::path searchPath =
         GlobalSession->Context()->DataPath() / "../envs/litex";
@@ -91,6 +91,21 @@ void CommandLine::processArgs() {
       m_version = true;
     } else if (token == "--mute") {
       m_mute = true;
+    } else if (token == "--profile-startup") {
+      m_profileStartup = true;
+    } else if (token == "--server") {
+      i++;
+      if (i < m_argc) {
+        m_serverSocket = m_argv[i];
+        m_withQt = false;
+      } else
+        ErrorAndExit("Specify a socket file!");
+    } else if (token == "--connect") {
+      i++;
+      if (i < m_argc)
+        m_connectSocket = m_argv[i];
+      else
+        ErrorAndExit("Specify a socket file!");
     } else {
       std::cout << "ERROR Unknown command line option: " << m_argv[i]
                 << std::endl;
@@ -67,6 +67,9 @@ class CommandLine {
   void ErrorAndExit(const std::string& message);
   bool FileExists(const std::filesystem::path& name);
   bool Mute() const { return m_mute; }
+  bool ProfileStartup() const { return m_profileStartup; }
+  const std::string& ServerSocket() const { return m_serverSocket; }
+  const std::string& ConnectSocket() const { return m_connectSocket; }
 
  protected:
   int m_argc = 0;
@@ -83,6 +86,9 @@ class CommandLine {
   bool m_version = false;
   bool m_useVerific = false;
   bool m_mute = false;
+  bool m_profileStartup = false;
+  std::string m_serverSocket;
+  std::string m_connectSocket;
 };
 
 }  // namespace FOEDAG
@@ -37,6 +37,7 @@ extern "C" {
 #include <QDir>
 #include <QGuiApplication>
 #include <QLabel>
+#include <QTimer>
 //#include <QQmlApplicationEngine>
 //#include <QQmlContext>
 #include <filesystem>
@@ -52,6 +53,9 @@ extern "C" {
 #include "Console/TclWorker.h"
 #include "FoedagStyle.h"
 #include "Main/Foedag.h"
+#include "Main/JobServer.h"
+#include "Main/StartupProfiler.h"
+#include "Main/TclSimpleParser.h"
 #include "Main/ToolContext.h"
 #include "MainWindow/Session.h"
 #include "MainWindow/main_window.h"
@@ -74,6 +78,18 @@ FOEDAG::Session* GlobalSession;
 
 using namespace FOEDAG;
 
+// --profile-startup, the Tcl init callbacks can't capture so it's global
+static StartupProfiler Profiler;
+
+static void reportStartupProfile() {
+  if (!Profiler.Enabled()) return;
+  std::ostringstream report;
+  Profiler.Report(report);
+  std::cerr << report.str();
+  Logger* perfLogger = GlobalSession->CmdStack()->PerfLogger();
+  if (perfLogger) (*perfLogger) << report.str();
+}
+
 FOEDAG::GUI_TYPE Foedag::getGuiType(const bool& withQt, const bool& withQml) {
   if (!withQt) return FOEDAG::GUI_TYPE::GT_NONE;
   if (withQml)
@@ -174,17 +190,21 @@ Foedag::Foedag(FOEDAG::CommandLine* cmdLine, MainWindowBuilder* mainWinBuilder,
 
 Foedag::~Foedag() { delete m_tclChannelHandler; }
 
-bool Foedag::initGui() {
+int Foedag::initGui() {
   // Gui mode with Qt Widgets
   int argc = m_cmdLine->Argc();
   QApplication app(argc, m_cmdLine->Argv());
   QApplication::setStyle(new FoedagStyle(app.style()));
+  Profiler.Mark("application");
   FOEDAG::TclInterpreter* interpreter =
       new FOEDAG::TclInterpreter(m_cmdLine->Argv()[0]);
+  Profiler.Mark("interpreter");
   FOEDAG::CommandStack* commands =
       new FOEDAG::CommandStack(interpreter, m_context->ExecutableName());
+  Profiler.Mark("command stack");
 
   loadTclInitFile(commands, m_context->ExecutableName());
+  Profiler.Mark("init files");
 
   Config::Instance()->dataPath(m_context->DataPath());
   QWidget* mainWin = nullptr;
@@ -196,11 +216,13 @@ bool Foedag::initGui() {
     mainWin = m_mainWinBuilder(GlobalSession);
     GlobalSession->MainWindow(mainWin);
   }
+  Profiler.Mark("main window");
 
   registerBasicGuiCommands(GlobalSession);
   if (m_registerTclFunc) {
     m_registerTclFunc(GlobalSession->MainWindow(), GlobalSession);
   }
+  Profiler.Mark("tcl commands");
 
   QtTclNotify::QtTclNotifier::setup();  // Registers notifier with Tcl
 
@@ -232,6 +254,14 @@ bool Foedag::initGui() {
       Tcl_EvalEx(interp, proc.c_str(), -1, 0);
     } else {
       Tcl_EvalEx(interp, "gui_start", -1, 0);
+      Profiler.Mark("gui_start");
+    }
+    if (Profiler.Enabled()) {
+      // first event loop iteration, the window is painted and ready for input
+      QTimer::singleShot(0, []() {
+        Profiler.Mark("event loop");
+        reportStartupProfile();
+      });
     }
     return 0;
   };
@@ -248,7 +278,7 @@ bool Foedag::initGui() {
   return 0;
 }
 
-bool Foedag::initQmlGui() {
+int Foedag::initQmlGui() {
   // Gui mode with QML
   /*
   int argc = m_cmdLine->Argc();
@@ -335,16 +365,19 @@ bool Foedag::initQmlGui() {
   return 0;
 }
 
-bool Foedag::init(GUI_TYPE guiType) {
+int Foedag::init(GUI_TYPE guiType) {
   if (m_cmdLine->PrintHelp()) {
     m_compiler->Help(&std::cout);
-    return false;
+    return 0;
   }
   if (m_cmdLine->PrintVersion()) {
     m_compiler->Version(&std::cout);
-    return false;
+    return 0;
   }
-  bool result;
+  // --connect, the job runs in the server process
+  if (!m_cmdLine->ConnectSocket().empty()) return submitJob();
+  if (m_cmdLine->ProfileStartup()) Profiler.Start();
+  int result{0};
   switch (guiType) {
     case GUI_TYPE::GT_NONE:
       result = initBatch();
@@ -361,18 +394,21 @@ bool Foedag::init(GUI_TYPE guiType) {
   return result;
 }
 
-bool Foedag::initBatch() {
+int Foedag::initBatch() {
   // Batch mode
   FOEDAG::TclInterpreter* interpreter =
       new FOEDAG::TclInterpreter(m_cmdLine->Argv()[0]);
+  Profiler.Mark("interpreter");
   const bool mute{m_cmdLine->Mute() && !m_cmdLine->Script().empty()};
   FOEDAG::CommandStack* commands =
       new FOEDAG::CommandStack(interpreter, m_context->ExecutableName(), mute);
+  Profiler.Mark("command stack");
   GlobalSession =
       new FOEDAG::Session(m_mainWin, interpreter, commands, m_cmdLine,
                           m_context, m_compiler, m_settings);
 
   loadTclInitFile(commands, m_context->ExecutableName());
+  Profiler.Mark("init files");
 
   GlobalSession->setGuiType(GUI_TYPE::GT_NONE);
   m_compiler->setGuiTclSync(
@@ -401,14 +437,63 @@ bool Foedag::initBatch() {
                                                 std::cout, &std::cerr, true);
   }
 
+  Profiler.Mark("project loader");
+
   registerBasicBatchCommands(GlobalSession);
   if (m_registerTclFunc) {
     m_registerTclFunc(nullptr, GlobalSession);
   }
+  Profiler.Mark("tcl commands");
+
+  // --server <socket>
+  if (!m_cmdLine->ServerSocket().empty()) {
+    // --script loads everything the jobs share before the first fork
+    if (!m_cmdLine->Script().empty()) {
+      int res = Tcl_EvalFile(interpreter->getInterp(),
+                             m_cmdLine->Script().c_str());
+      if (res != TCL_OK) {
+        Tcl_EvalEx(interpreter->getInterp(), "puts $errorInfo", -1, 0);
+        delete GlobalSession;
+        return res;
+      }
+    }
+    JobServer server{m_cmdLine->ServerSocket()};
+    if (!server.Listen()) {
+      std::cerr << "ERROR: " << server.LastError() << std::endl;
+      delete GlobalSession;
+      return 1;
+    }
+    std::cout << "Listening on " << m_cmdLine->ServerSocket() << std::endl;
+    reportStartupProfile();
+    auto runJob = [interpreter](const std::string& script) -> int {
+      Tcl_Interp* interp = interpreter->getInterp();
+      int res = Tcl_EvalEx(interp, script.c_str(), -1, 0);
+      if (res != TCL_OK) {
+        GlobalSession->ReturnStatus(res);
+        Tcl_EvalEx(interp, "puts $errorInfo", -1, 0);
+      }
+      GlobalSession->ProjectFileLoader()->Save();
+      Tcl_EvalEx(interp, "flush stdout; flush stderr", -1, 0);
+      return GlobalSession->ReturnStatus();
+    };
+    int returnStatus = server.Serve(runJob);
+    if (returnStatus != 0)
+      std::cerr << "ERROR: " << server.LastError() << std::endl;
+    delete GlobalSession;
+    return returnStatus;
+  }
+
   // Tcl_AppInit
   auto tcl_init = [](Tcl_Interp* interp) -> int {
+    Profiler.Mark("tcl init");
+    reportStartupProfile();
     // --script <script>
     if (!GlobalSession->CmdLine()->Script().empty()) {
+      if (Compiler* compiler = GlobalSession->GetCompiler()) {
+        TclSimpleParser tclParser;
+        if (tclParser.parse(GlobalSession->CmdLine()->Script()).first)
+          compiler->PlanProgress(tclParser.stages());
+      }
       int res =
           Tcl_EvalFile(interp, GlobalSession->CmdLine()->Script().c_str());
       if (res != TCL_OK) {
@@ -444,3 +529,24 @@ bool Foedag::initBatch() {
   delete GlobalSession;
   return returnStatus;
 }
+
+int Foedag::submitJob() {
+  std::string script = m_cmdLine->TclCmd();
+  if (!m_cmdLine->Script().empty()) {
+    std::filesystem::path path = std::filesystem::absolute(m_cmdLine->Script());
+    script = "source {" + path.string() + "}";
+  }
+  if (script.empty()) {
+    std::cerr << "ERROR: --connect requires --script or --cmd" << std::endl;
+    return 1;
+  }
+  std::string error;
+  int status = JobServer::Submit(m_cmdLine->ConnectSocket(),
+                                 std::filesystem::current_path().string(),
+                                 script, std::cout, std::cerr, &error);
+  if (status == -1) {
+    std::cerr << "ERROR: " << error << std::endl;
+    return 1;
+  }
+  return status;
+}
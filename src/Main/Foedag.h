@@ -51,15 +51,17 @@ class Foedag {
          ToolContext* context = nullptr);
   virtual ~Foedag();
 
-  bool init(GUI_TYPE guiType);
+  // Returns the exit status of the process
+  int init(GUI_TYPE guiType);
 
  private:
-  bool initQmlGui();
+  int initQmlGui();
 
  public:
   static FOEDAG::GUI_TYPE getGuiType(const bool& withQt, const bool& withQml);
-  bool initGui();
-  bool initBatch();
+  int initGui();
+  int initBatch();
+  int submitJob();
   const ToolContext* Context() { return m_context; }
 
  protected:
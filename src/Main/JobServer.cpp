@@ -0,0 +1,479 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "JobServer.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace FOEDAG {
+
+#ifndef _WIN32
+
+static constexpr char StdoutFrame{'o'};
+static constexpr char StderrFrame{'e'};
+static constexpr char ExitFrame{'x'};
+// Time a client has to send its whole request
+static constexpr std::chrono::seconds RequestTimeout{10};
+// Write end of the self-pipe of the serving JobServer
+static volatile sig_atomic_t ChildPipe{-1};
+
+static void ChildExited(int) {
+  const int saved = errno;
+  const char byte{0};
+  // Full pipe: a wake up is pending already
+  [[maybe_unused]] const ssize_t written = ::write(ChildPipe, &byte, 1);
+  errno = saved;
+}
+
+static bool WriteAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+}
+
+static bool ReadAll(int fd, char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t count = ::read(fd, data, size);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) return false;
+    data += count;
+    size -= count;
+  }
+  return true;
+}
+
+static bool WriteFrame(int fd, char type, const char* data, uint32_t size) {
+  const unsigned char header[5] = {
+      static_cast<unsigned char>(type), static_cast<unsigned char>(size >> 24),
+      static_cast<unsigned char>(size >> 16),
+      static_cast<unsigned char>(size >> 8), static_cast<unsigned char>(size)};
+  return WriteAll(fd, reinterpret_cast<const char*>(header), sizeof(header)) &&
+         WriteAll(fd, data, size);
+}
+
+static bool MakeAddress(const std::string& path, sockaddr_un& address,
+                        std::string& error) {
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+    error = "Invalid socket path: " + path;
+    return false;
+  }
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+  return true;
+}
+
+static int Connect(const std::string& path, std::string& error) {
+  sockaddr_un address;
+  if (!MakeAddress(path, address, error)) return -1;
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    error = std::strerror(errno);
+    return -1;
+  }
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) !=
+      0) {
+    error = "Can't connect to " + path + ": " + std::strerror(errno);
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static bool SendRequest(int fd, const std::string& request) {
+  const bool sent = WriteAll(fd, request.data(), request.size());
+  ::shutdown(fd, SHUT_WR);
+  return sent;
+}
+
+JobServer::JobServer(const std::string& socketPath, int maxJobs)
+    : m_socketPath(socketPath), m_maxJobs(maxJobs) {
+  if (m_maxJobs <= 0)
+    m_maxJobs = std::max(1u, std::thread::hardware_concurrency());
+}
+
+JobServer::~JobServer() {
+  if (m_fd != -1) {
+    ::close(m_fd);
+    ::unlink(m_socketPath.c_str());
+  }
+}
+
+bool JobServer::Listen() {
+  sockaddr_un address;
+  if (!MakeAddress(m_socketPath, address, m_error)) return false;
+  std::string error;
+  const int other = Connect(m_socketPath, error);
+  if (other != -1) {
+    ::close(other);
+    m_error = "Server is already running on " + m_socketPath;
+    return false;
+  }
+  ::unlink(m_socketPath.c_str());  // stale socket of a killed server
+  m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (m_fd < 0 ||
+      ::bind(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) !=
+          0 ||
+      ::listen(m_fd, SOMAXCONN) != 0) {
+    m_error = "Can't listen on " + m_socketPath + ": " + std::strerror(errno);
+    if (m_fd != -1) ::close(m_fd);
+    m_fd = -1;
+    return false;
+  }
+  return true;
+}
+
+static void Reject(int client, const std::string& error) {
+  WriteFrame(client, StderrFrame, error.data(), error.size());
+  WriteFrame(client, ExitFrame, "1", 1);
+  ::close(client);
+}
+
+int JobServer::Serve(const Runner& runner) {
+  if (m_fd == -1 && !Listen()) return 1;
+  // a client that goes away must not kill the server or its jobs
+  ::signal(SIGPIPE, SIG_IGN);
+  // The jobs that end wake the poll below instead of being waited for
+  if (::pipe(m_childPipe) != 0) {
+    m_error = std::string{"pipe failed: "} + std::strerror(errno);
+    return 1;
+  }
+  for (int fd : m_childPipe) {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  ChildPipe = m_childPipe[1];
+  struct sigaction action {};
+  struct sigaction previous {};
+  action.sa_handler = ChildExited;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+  ::sigaction(SIGCHLD, &action, &previous);
+  // One poll over the listening socket, the self-pipe and every request
+  // being read, so that neither a slow client nor a full job slot holds the
+  // others
+  std::vector<pollfd> fds;
+  char buffer[4096];
+  bool serving{true};
+  while (serving) {
+    fds.assign(1, {m_fd, POLLIN, 0});
+    fds.push_back({m_childPipe[0], POLLIN, 0});
+    for (const auto& [client, request] : m_pending)
+      fds.push_back({client, POLLIN, 0});
+    const int timeout = m_pending.empty() ? -1 : 1000;
+    if (::poll(fds.data(), fds.size(), timeout) < 0) {
+      if (errno == EINTR) continue;
+      m_error = std::string{"poll failed: "} + std::strerror(errno);
+      break;
+    }
+    if (fds[1].revents & POLLIN) {
+      while (::read(m_childPipe[0], buffer, sizeof(buffer)) > 0) {
+      }
+      startJobs(runner);
+    }
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 2; i < fds.size() && serving; i++) {
+      const int client = fds[i].fd;
+      auto itr = m_pending.find(client);
+      bool complete{false};
+      if (fds[i].revents != 0) {
+        const ssize_t count = ::read(client, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) continue;
+        if (count > 0)
+          itr->second.text.append(buffer, count);
+        else
+          complete = true;
+      }
+      if (complete) {
+        const std::string request = std::move(itr->second.text);
+        m_pending.erase(itr);
+        serving = dispatch(client, request, runner);
+      } else if (now > itr->second.deadline) {
+        m_pending.erase(itr);
+        Reject(client, "Request timed out\n");
+      }
+    }
+    if (serving && (fds[0].revents & POLLIN)) {
+      const int client = ::accept(m_fd, nullptr, nullptr);
+      if (client >= 0) {
+        m_pending[client] = {{}, now + RequestTimeout};
+      } else if (errno != EINTR && errno != ECONNABORTED) {
+        m_error = std::string{"accept failed: "} + std::strerror(errno);
+        break;
+      }
+    }
+  }
+  for (const auto& [client, request] : m_pending) ::close(client);
+  m_pending.clear();
+  // The jobs requested before the shutdown still run
+  while (m_running > 0 || !m_queued.empty()) {
+    startJobs(runner);
+    if (m_running > 0) reapJobs(true);
+  }
+  ::sigaction(SIGCHLD, &previous, nullptr);
+  ChildPipe = -1;
+  for (int& fd : m_childPipe) {
+    ::close(fd);
+    fd = -1;
+  }
+  return serving ? 1 : 0;
+}
+
+bool JobServer::dispatch(int client, const std::string& request,
+                         const Runner& runner) {
+  const size_t eol = request.find('\n');
+  const std::string command = request.substr(0, eol);
+  if (command == "shutdown") {
+    ::close(client);
+    return false;
+  }
+  if (command.rfind("run ", 0) != 0 || eol == std::string::npos) {
+    Reject(client, "Invalid request\n");
+    return true;
+  }
+  m_queued.emplace_back(client, request);
+  startJobs(runner);
+  return true;
+}
+
+void JobServer::startJobs(const Runner& runner) {
+  reapJobs(false);
+  while (m_running < m_maxJobs && !m_queued.empty()) {
+    const int client = m_queued.front().first;
+    const std::string request = std::move(m_queued.front().second);
+    m_queued.pop_front();
+    const size_t eol = request.find('\n');
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+    const pid_t pid = ::fork();
+    if (pid == 0) {
+      closeInChild();
+      runJob(client, request.substr(4, eol - 4), request.substr(eol + 1),
+             runner);
+      ::_exit(0);
+    }
+    if (pid < 0) {
+      Reject(client, std::string{"Can't start the job: "} +
+                         std::strerror(errno) + "\n");
+      continue;
+    }
+    ::close(client);
+    m_running++;
+  }
+}
+
+void JobServer::closeInChild() {
+  ::close(m_fd);
+  // the other clients get their answer from the server, not from the job
+  for (const auto& [other, pending] : m_pending) ::close(other);
+  for (const auto& [other, request] : m_queued) ::close(other);
+  // the job waits for its own children
+  ::signal(SIGCHLD, SIG_DFL);
+  for (int fd : m_childPipe) ::close(fd);
+}
+
+void JobServer::reapJobs(bool wait) {
+  int status{0};
+  pid_t pid{0};
+  while (m_running > 0 && (pid = ::waitpid(-1, &status, wait ? 0 : WNOHANG))) {
+    if (pid < 0) {
+      if (errno == EINTR) continue;
+      m_running = 0;  // no children left
+      return;
+    }
+    m_running--;
+    if (wait) return;
+  }
+}
+
+void JobServer::runJob(int client, const std::string& workDir,
+                       const std::string& script, const Runner& runner) {
+  int out[2], err[2];
+  if (::pipe(out) != 0 || ::pipe(err) != 0) {
+    const std::string error = std::string{"pipe: "} + std::strerror(errno);
+    WriteFrame(client, StderrFrame, error.data(), error.size());
+    WriteFrame(client, ExitFrame, "1", 1);
+    return;
+  }
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    ::close(client);
+    ::close(out[0]);
+    ::close(err[0]);
+    ::dup2(out[1], STDOUT_FILENO);
+    ::dup2(err[1], STDERR_FILENO);
+    ::close(out[1]);
+    ::close(err[1]);
+    int status{1};
+    if (::chdir(workDir.c_str()) != 0)
+      std::cerr << "Can't change directory to " << workDir << ": "
+                << std::strerror(errno) << std::endl;
+    else
+      status = runner(script);
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+    ::_exit(status);
+  }
+  ::close(out[1]);
+  ::close(err[1]);
+  // stream both pipes to the client as they come
+  pollfd fds[2] = {{out[0], POLLIN, 0}, {err[0], POLLIN, 0}};
+  const char types[2] = {StdoutFrame, StderrFrame};
+  int open = 2;
+  char buffer[4096];
+  while (pid > 0 && open > 0) {
+    if (::poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    for (int i = 0; i < 2; i++) {
+      if (fds[i].fd < 0 || fds[i].revents == 0) continue;
+      const ssize_t count = ::read(fds[i].fd, buffer, sizeof(buffer));
+      if (count < 0 && errno == EINTR) continue;
+      if (count <= 0) {
+        ::close(fds[i].fd);
+        fds[i].fd = -1;
+        open--;
+        continue;
+      }
+      WriteFrame(client, types[i], buffer, count);
+    }
+  }
+  int status{0};
+  int exitCode{1};
+  if (pid > 0) {
+    while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    if (WIFEXITED(status))
+      exitCode = WEXITSTATUS(status);
+    else if (WIFSIGNALED(status))
+      exitCode = 128 + WTERMSIG(status);
+  }
+  const std::string exit = std::to_string(exitCode);
+  WriteFrame(client, ExitFrame, exit.data(), exit.size());
+  ::close(client);
+}
+
+int JobServer::Submit(const std::string& socketPath, const std::string& workDir,
+                      const std::string& script, std::ostream& out,
+                      std::ostream& err, std::string* error) {
+  std::string message;
+  const int fd = Connect(socketPath, message);
+  if (fd == -1 || !SendRequest(fd, "run " + workDir + "\n" + script)) {
+    if (error) *error = message.empty() ? "Can't send the job" : message;
+    if (fd != -1) ::close(fd);
+    return -1;
+  }
+  int status{-1};
+  unsigned char header[5];
+  std::string payload;
+  while (ReadAll(fd, reinterpret_cast<char*>(header), sizeof(header))) {
+    const uint32_t size = (uint32_t{header[1]} << 24) |
+                          (uint32_t{header[2]} << 16) |
+                          (uint32_t{header[3]} << 8) | uint32_t{header[4]};
+    payload.resize(size);
+    if (!ReadAll(fd, &payload[0], size)) break;
+    if (header[0] == StdoutFrame) {
+      out << payload << std::flush;
+    } else if (header[0] == StderrFrame) {
+      err << payload << std::flush;
+    } else if (header[0] == ExitFrame) {
+      status = std::atoi(payload.c_str());
+      break;
+    }
+  }
+  ::close(fd);
+  if (status == -1 && error) *error = "Connection to the server was lost";
+  return status;
+}
+
+bool JobServer::Shutdown(const std::string& socketPath) {
+  std::string error;
+  const int fd = Connect(socketPath, error);
+  if (fd == -1) return false;
+  const bool sent = SendRequest(fd, "shutdown\n");
+  ::close(fd);
+  return sent;
+}
+
+#else
+
+JobServer::JobServer(const std::string& socketPath, int maxJobs)
+    : m_socketPath(socketPath), m_maxJobs(maxJobs) {}
+
+JobServer::~JobServer() {}
+
+bool JobServer::Listen() {
+  m_error = "Server mode is not supported on this platform";
+  return false;
+}
+
+int JobServer::Serve(const Runner&) { return Listen() ? 0 : 1; }
+
+bool JobServer::dispatch(int, const std::string&, const Runner&) {
+  return false;
+}
+
+void JobServer::startJobs(const Runner&) {}
+
+void JobServer::closeInChild() {}
+
+void JobServer::runJob(int, const std::string&, const std::string&,
+                       const Runner&) {}
+
+void JobServer::reapJobs(bool) {}
+
+int JobServer::Submit(const std::string&, const std::string&,
+                      const std::string&, std::ostream&, std::ostream&,
+                      std::string* error) {
+  if (error) *error = "Server mode is not supported on this platform";
+  return -1;
+}
+
+bool JobServer::Shutdown(const std::string&) { return false; }
+
+#endif
+
+}  // namespace FOEDAG
@@ -0,0 +1,97 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The JobServer class keeps one warm process listening on a unix
+ * socket (--server). Each job is run in a forked copy of the server, so it
+ * gets its own interpreter state and working directory and sees everything
+ * the server loaded before serving. Stdout, stderr and the exit status of
+ * the job are streamed back to the client (--connect).
+ *
+ * Request: "run <working dir>\n<tcl script>" or "shutdown\n", the client
+ * closes its write side to end the request. Requests are read side by side,
+ * a client that doesn't end its request in time is dropped. Jobs beyond the
+ * maximum wait in a queue and start as running ones end, which a SIGCHLD
+ * self-pipe in the poll set reports.
+ * Response: frames of one type byte ('o' stdout, 'e' stderr, 'x' exit
+ * status), 4 bytes big-endian payload length and the payload.
+ */
+class JobServer {
+ public:
+  using Runner = std::function<int(const std::string& script)>;
+
+  explicit JobServer(const std::string& socketPath, int maxJobs = 0);
+  ~JobServer();
+
+  bool Listen();
+  // Runs jobs until a shutdown request is received
+  int Serve(const Runner& runner);
+  const std::string& LastError() const { return m_error; }
+
+  /*!
+   * \brief Submit sends the script to the server and waits for its end.
+   * \return exit status of the job or -1 if the server can't be reached
+   */
+  static int Submit(const std::string& socketPath, const std::string& workDir,
+                    const std::string& script, std::ostream& out,
+                    std::ostream& err, std::string* error = nullptr);
+  static bool Shutdown(const std::string& socketPath);
+
+ private:
+  // false for a shutdown request
+  bool dispatch(int client, const std::string& request, const Runner& runner);
+  // Forks the queued jobs while there are free slots
+  void startJobs(const Runner& runner);
+  void runJob(int client, const std::string& workDir,
+              const std::string& script, const Runner& runner);
+  void reapJobs(bool wait);
+  // Releases in a forked job what belongs to the server
+  void closeInChild();
+
+  struct Request {
+    std::string text;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  std::string m_socketPath;
+  std::string m_error;
+  int m_fd{-1};
+  int m_maxJobs{0};
+  int m_running{0};
+  // Requests being read, by client socket
+  std::map<int, Request> m_pending;
+  // Complete run requests waiting for a free slot
+  std::deque<std::pair<int, std::string>> m_queued;
+  // Written by the SIGCHLD handler, read end polled by Serve()
+  int m_childPipe[2]{-1, -1};
+};
+
+}  // namespace FOEDAG
@@ -22,6 +22,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Settings.h"
 
 #include <QFile>
+#include <QFileInfo>
+#include <functional>
 #include <iostream>
 
 #include "Foedag.h"
@@ -38,20 +40,85 @@ auto SETTINGS_DBG_PRINT = [](std::string printStr) {
   }
 };
 
+// json pointer reference token, see RFC 6901
+static std::string EscapePointerToken(const std::string& key) {
+  std::string token;
+  token.reserve(key.size());
+  for (char c : key) {
+    if (c == '~')
+      token += "~0";
+    else if (c == '/')
+      token += "~1";
+    else
+      token += c;
+  }
+  return token;
+}
+
 Settings::Settings() { FOEDAG::initTclArgFns(); }
 
 void Settings::clear() {
   m_json.clear();
+  m_appliedArgs.clear();
+  invalidate();
   SETTINGS_DBG_PRINT("Settings: Cleared\n");
 }
 
-void Settings::loadSettings(const QStringList& jsonFiles) {
-  for (const QString& filepath : jsonFiles) {
-    loadJsonFile(filepath);
+void Settings::loadSettings(const QStringList& jsonFiles,
+                            const QString& snapshotFile /* QString() */) {
+  // snapshot holds the merge result only, it can't be used on top of other
+  // settings
+  const bool useSnapshot = !snapshotFile.isEmpty() && m_json.empty();
+  if (!useSnapshot || !loadSnapshot(snapshotFile, jsonFiles)) {
+    for (const QString& filepath : jsonFiles) {
+      loadJsonFile(filepath);
+    }
+    if (useSnapshot) saveSnapshot(snapshotFile, jsonFiles);
   }
   applyTclVars();
 }
 
+// Identifies the content of the json files without reading them
+json Settings::filesStamp(const QStringList& jsonFiles) {
+  json stamp = json::array();
+  for (const QString& filePath : jsonFiles) {
+    QFileInfo info{filePath};
+    stamp.push_back({filePath.toStdString(), info.size(),
+                     info.lastModified().toMSecsSinceEpoch()});
+  }
+  return stamp;
+}
+
+bool Settings::loadSnapshot(const QString& snapshotFile,
+                            const QStringList& jsonFiles) {
+  QFile file{snapshotFile};
+  if (!file.open(QIODevice::ReadOnly)) return false;
+  const QByteArray content = file.readAll();
+  try {
+    json snapshot = json::parse(content.constBegin(), content.constEnd());
+    if (snapshot.value("files", json{}) != filesStamp(jsonFiles)) return false;
+    m_json = std::move(snapshot["settings"]);
+  } catch (json::exception&) {
+    return false;  // outdated format or broken file, merge again
+  }
+  invalidate();
+  SETTINGS_DBG_PRINT("Settings: Loaded snapshot " +
+                     snapshotFile.toStdString() + "\n");
+  return true;
+}
+
+bool Settings::saveSnapshot(const QString& snapshotFile,
+                            const QStringList& jsonFiles) const {
+  QFile file{snapshotFile};
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+  json snapshot;
+  snapshot["files"] = filesStamp(jsonFiles);
+  snapshot["settings"] = m_json;
+  const std::string content = snapshot.dump();
+  return file.write(content.data(), content.size()) ==
+         static_cast<qint64>(content.size());
+}
+
 QString Settings::getJsonStr(const json& object) {
   return QString::fromStdString(object.dump());
 }
@@ -151,14 +218,16 @@ void Settings::loadJsonFile(json* jsonObject, const QString& filePath) {
   if (jsonFile.exists() &&
       jsonFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
     // Read/parse json from file and update the passed jsonObject w/ new vals
-    QString jsonStr = jsonFile.readAll();
+    const QByteArray jsonStr = jsonFile.readAll();
 
     SETTINGS_DBG_PRINT("Settings: Loading " + filePath.toStdString() + "\n\t" +
                        jsonStr.toStdString() + "\n");
 
+    if (jsonObject == &m_json) invalidate();
     try {
       // Merge the json
-      jsonObject->update(json::parse(jsonStr.toStdString()), true);
+      jsonObject->update(json::parse(jsonStr.constBegin(), jsonStr.constEnd()),
+                         true);
     } catch (json::parse_error& e) {
       // output exception information
       std::cerr << "Json Error: " << e.what() << '\n'
@@ -171,41 +240,67 @@ void Settings::loadJsonFile(json* jsonObject, const QString& filePath) {
   }
 }
 
+// Builds the list of setting categories with a single walk of the json. Paths
+// are kept as json pointer strings so they stay valid while values change.
+const std::vector<Settings::Category>& Settings::categories() {
+  if (m_categoriesValid) return m_categories;
+  m_categories.clear();
+  std::string path;
+  std::function<void(const json&)> visit = [&](const json& obj) {
+    if (obj.is_object()) {
+      auto meta = obj.find("_META_");
+      if (meta != obj.end() && meta->value("isSetting", false)) {
+        m_categories.push_back(
+            {path, meta->value("tclArgKey", ""), meta->value("hidden", true)});
+      }
+      for (auto it = obj.begin(); it != obj.end(); ++it) {
+        const size_t size = path.size();
+        path += '/' + EscapePointerToken(it.key());
+        visit(it.value());
+        path.resize(size);
+      }
+    } else if (obj.is_array()) {
+      for (size_t i = 0; i < obj.size(); i++) {
+        const size_t size = path.size();
+        path += '/' + std::to_string(i);
+        visit(obj.at(i));
+        path.resize(size);
+      }
+    }
+  };
+  visit(m_json);
+  m_categoriesValid = true;
+  return m_categories;
+}
+
 // This will find any settings categories that have tclArgKey defined in their
 // _META_ object, collect any default or user set values, and apply those values
-// using the tcl setter associated with tclArgKey
+// using the tcl setter associated with tclArgKey. A setter is only called when
+// its arguments differ from the ones it got last time or when the backend
+// values were changed since then (e.g. by a tcl command).
 void Settings::applyTclVars() {
-  // Get json ptr paths to all settings objects
-  QStringList paths = getSettingsJsonPtrPaths();
-
-  json& topJson = getJson();
-
-  // Step through each settings path and load tcl vars if possible
-  for (QString path : paths) {
-    // Get the json stored at this path
-    json::json_pointer jsonPtr(path.toStdString());
-    json& settingsJson = topJson.at(jsonPtr);
-
-    // Look for a tclArgeKey
-    QString tclArgKey;
-    if (settingsJson.contains("_META_")) {
-      tclArgKey =
-          QString::fromStdString(settingsJson["_META_"].value("tclArgKey", ""));
-    }
-
+  for (const Category& category : categories()) {
     // If this setting has a tclArgKey use it to lookup the related setter and
     // apply and
-    if (!tclArgKey.isEmpty()) {
-      auto [setter, getter] = FOEDAG::getTclArgFns(tclArgKey);
-      if (setter != nullptr) {
-        setter(getTclArgString(settingsJson).toStdString());
-      } else {
-        SETTINGS_DBG_PRINT("Settings: getTclArgFns for key \"" +
-                           tclArgKey.toStdString() +
-                           "\" returned a null setter function pointer. Back "
-                           "end tcl values will not be set.\n");
-      }
+    if (category.tclArgKey.empty()) continue;
+    auto [setter, getter] =
+        FOEDAG::getTclArgFns(QString::fromStdString(category.tclArgKey));
+    if (setter == nullptr) {
+      SETTINGS_DBG_PRINT("Settings: getTclArgFns for key \"" +
+                         category.tclArgKey +
+                         "\" returned a null setter function pointer. Back "
+                         "end tcl values will not be set.\n");
+      continue;
+    }
+    json& settingsJson = m_json.at(json::json_pointer(category.path));
+    const std::string args = getTclArgString(settingsJson).toStdString();
+    auto applied = m_appliedArgs.find(category.tclArgKey);
+    if (applied != m_appliedArgs.end() && applied->second.args == args &&
+        (getter == nullptr || getter() == applied->second.state)) {
+      continue;
     }
+    setter(args);
+    m_appliedArgs[category.tclArgKey] = {args, getter ? getter() : args};
   }
 }
 
@@ -214,7 +309,12 @@ void Settings::applyTclVars() {
 // object) and return a QStringList of nlohman json ptrs to those objects
 QStringList Settings::getSettingsJsonPtrPaths(
     bool includeHiddenSettings /*true*/) {
-  return Settings::getSettingsJsonPtrPaths(getJson(), includeHiddenSettings);
+  QStringList jsonPaths;
+  for (const Category& category : categories()) {
+    if (includeHiddenSettings || !category.hidden)
+      jsonPaths << QString::fromStdString(category.path);
+  }
+  return jsonPaths;
 }
 
 // This will step through the given json finding any settings categories (an
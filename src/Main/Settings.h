@@ -24,6 +24,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <QJsonObject>
 #include <QJsonValue>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "nlohmann_json/json.hpp"
 // Per https://json.nlohmann.me/features/object_order/
@@ -42,10 +45,38 @@ class Settings {
  private:
   json m_json;
 
+  // Setting category (object with _META_.isSetting) found in m_json
+  struct Category {
+    std::string path;  // json pointer
+    std::string tclArgKey;
+    bool hidden;
+  };
+  // Tcl args given to the setter and what the getter reported back after
+  struct AppliedArgs {
+    std::string args;
+    std::string state;
+  };
+  std::vector<Category> m_categories;
+  bool m_categoriesValid{false};
+  std::map<std::string, AppliedArgs> m_appliedArgs;
+
+  const std::vector<Category>& categories();
+  void invalidate() { m_categoriesValid = false; }
+  static json filesStamp(const QStringList& jsonFiles);
+
  public:
   Settings();
   void clear();
-  void loadSettings(const QStringList& jsonFiles);
+  /*!
+   * \brief loadSettings merges the json files and applies the tcl values.
+   * When \a snapshotFile is given, the merged json is saved there and read
+   * back on the next load as long as none of the files changed.
+   */
+  void loadSettings(const QStringList& jsonFiles,
+                    const QString& snapshotFile = QString());
+  bool loadSnapshot(const QString& snapshotFile, const QStringList& jsonFiles);
+  bool saveSnapshot(const QString& snapshotFile,
+                    const QStringList& jsonFiles) const;
   QString getJsonStr(const json& object);
   QString getJsonStr();
   static QString getLookupValue(
@@ -66,7 +97,11 @@ class Settings {
                                              bool includeHiddenSettings = true);
   static QString getTclArgString(json& jsonData);
 
-  json& getJson() { return m_json; }
+  // Category index is rebuilt after the json was handed out for editing
+  json& getJson() {
+    invalidate();
+    return m_json;
+  }
 };
 
 }  // namespace FOEDAG
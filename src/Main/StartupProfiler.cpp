@@ -0,0 +1,71 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "StartupProfiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace FOEDAG {
+
+static double ToMs(StartupProfiler::Clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void StartupProfiler::Start() {
+  m_enabled = true;
+  m_phases.clear();
+  m_start = m_last = Clock::now();
+}
+
+void StartupProfiler::Mark(const char* phase) {
+  if (!m_enabled) return;
+  const Clock::time_point now = Clock::now();
+  m_phases.push_back({phase, now - m_last});
+  m_last = now;
+}
+
+StartupProfiler::Clock::duration StartupProfiler::Total() const {
+  return m_last - m_start;
+}
+
+void StartupProfiler::Report(std::ostream& out) const {
+  if (!m_enabled) return;
+  size_t width = 5;
+  for (const auto& phase : m_phases) width = std::max(width, phase.name.size());
+  // format locally, 'out' flags are left untouched
+  std::ostringstream report;
+  report << std::fixed << std::setprecision(1);
+  report << "Startup profile:" << std::endl;
+  report << "  " << std::left << std::setw(width) << "Phase" << std::right
+         << std::setw(12) << "Time (ms)" << std::setw(12) << "Total (ms)"
+         << std::endl;
+  Clock::duration total{};
+  for (const auto& phase : m_phases) {
+    total += phase.duration;
+    report << "  " << std::left << std::setw(width) << phase.name << std::right
+           << std::setw(12) << ToMs(phase.duration) << std::setw(12)
+           << ToMs(total) << std::endl;
+  }
+  out << report.str();
+}
+
+}  // namespace FOEDAG
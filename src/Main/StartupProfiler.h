@@ -0,0 +1,57 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The StartupProfiler class measures the startup phases when the tool
+ * is started with --profile-startup. Every Mark() closes the current phase.
+ * When profiling is not enabled Mark() only checks a flag.
+ */
+class StartupProfiler {
+ public:
+  using Clock = std::chrono::steady_clock;
+  struct Phase {
+    std::string name;
+    Clock::duration duration;
+  };
+
+  void Start();
+  bool Enabled() const { return m_enabled; }
+  void Mark(const char* phase);
+  Clock::duration Total() const;
+  const std::vector<Phase>& Phases() const { return m_phases; }
+  void Report(std::ostream& out) const;
+
+ private:
+  bool m_enabled{false};
+  Clock::time_point m_start;
+  Clock::time_point m_last;
+  std::vector<Phase> m_phases;
+};
+
+}  // namespace FOEDAG
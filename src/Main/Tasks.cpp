@@ -22,6 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "Tasks.h"
 
 #include <QHeaderView>
+#include <QTableView>
 #include <QTableWidget>
 #include <QTableWidgetItem>
 
@@ -40,7 +41,26 @@ using namespace FOEDAG;
 #define TASKS_DEBUG false
 
 namespace {
+void openReportModelView(const QString& name, QAbstractItemModel* model) {
+  auto reportsView = new QTableView();
+  model->setParent(reportsView);
+  reportsView->setModel(model);
+  reportsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  reportsView->setSelectionBehavior(QAbstractItemView::SelectRows);
+  // Fixed row heights keep the view from measuring every row
+  reportsView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  reportsView->resizeColumnsToContents();
+
+  auto tabWidget = TextEditorForm::Instance()->GetTabWidget();
+  tabWidget->addTab(reportsView, name);
+  tabWidget->setCurrentWidget(reportsView);
+}
+
 void openReportView(const ITaskReport& report) {
+  if (auto model = report.createModel(nullptr)) {
+    openReportModelView(report.getName(), model);
+    return;
+  }
   auto reportsView = new QTableWidget();
 
   // Fill columns
@@ -21,31 +21,51 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "TclSimpleParser.h"
 
 #include <QFile>
+#include <QRegularExpression>
 #include <QString>
+#include <algorithm>
+#include <map>
 
 namespace FOEDAG {
 
+// Flow commands and the stage they run
+static const std::map<QString, std::string> FlowCommands{
+    {"ipgenerate", "ipgenerate"},
+    {"analyze", "analyze"},
+    {"synth", "synthesize"},
+    {"synthesize", "synthesize"},
+    {"packing", "packing"},
+    {"globp", "global_placement"},
+    {"global_placement", "global_placement"},
+    {"place", "place"},
+    {"route", "route"},
+    {"sta", "sta"},
+    {"power", "power"},
+    {"bitstream", "bitstream"}};
+
 std::pair<bool, std::string> TclSimpleParser::parse(
     const std::string &tclFile) {
+  m_stages.clear();
   QFile file{QString::fromStdString(tclFile)};
   if (!file.open(QFile::ReadOnly))
     return std::make_pair(false, "Fail to open file " + tclFile);
   const QString content = file.readAll();
 
-  int counter{0};
-  if (content.contains("ipgenerate")) counter++;
-  if (content.contains("analyze")) counter++;
-  if (content.contains("synth") || content.contains("synthesize")) counter++;
-  if (content.contains("packing")) counter++;
-  if (content.contains("globp") || content.contains("global_placement"))
-    counter++;
-  if (content.contains("place")) counter++;
-  if (content.contains("route")) counter++;
-  if (content.contains("sta")) counter++;
-  if (content.contains("power")) counter++;
-  if (content.contains("bitstream")) counter++;
-
-  return std::make_pair(true, std::to_string(counter));
+  // Only the command word of each line counts, so that e.g. "place" in
+  // "global_placement" or "sta" in a comment is not mistaken for a stage
+  static const QRegularExpression separator{"[\\n;]"};
+  static const QRegularExpression space{"\\s+"};
+  for (const auto &line : content.split(separator)) {
+    const QString command = line.trimmed().section(space, 0, 0);
+    if (command.isEmpty() || command.startsWith('#')) continue;
+    auto itr = FlowCommands.find(command);
+    if (itr == FlowCommands.end()) continue;
+    if (std::find(m_stages.begin(), m_stages.end(), itr->second) ==
+        m_stages.end())
+      m_stages.push_back(itr->second);
+  }
+
+  return std::make_pair(true, std::to_string(m_stages.size()));
 }
 
 }  // namespace FOEDAG
@@ -21,13 +21,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace FOEDAG {
 
 class TclSimpleParser {
  public:
   TclSimpleParser() = default;
+  /*!
+   * \brief parse looks for the flow commands of the script.
+   * \return on success, the number of flow stages the script runs
+   */
   std::pair<bool, std::string> parse(const std::string &tclFile);
+  // Flow stages found by parse(), in the order they first appear
+  const std::vector<std::string> &stages() const { return m_stages; }
+
+ private:
+  std::vector<std::string> m_stages;
 };
 
 }  // namespace FOEDAG
@@ -19,6 +19,8 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstdlib>
+
 #include "Compiler/CompilerOpenFPGA.h"
 #include "Main/CommandLine.h"
 #include "Main/Foedag.h"
@@ -55,6 +57,10 @@ int main(int argc, char** argv) {
   FOEDAG::Foedag* foedag = new FOEDAG::Foedag(
       cmd, mainWindowBuilder, registerAllFoedagCommands, compiler, settings);
   std::filesystem::path binpath = foedag->Context()->BinaryPath();
+  // Lets the flow run with other tool builds or with the stand-ins of
+  // bin/mock_tools
+  if (const char* toolsPath = std::getenv("FOEDAG_TOOLS_PATH"))
+    binpath = toolsPath;
   std::filesystem::path datapath = foedag->Context()->DataPath();
   if (opcompiler) {
     std::filesystem::path analyzePath = binpath / "analyze";
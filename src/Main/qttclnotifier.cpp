@@ -19,12 +19,15 @@
 
 #include "qttclnotifier.hpp"
 
+#include <QAbstractEventDispatcher>
 #include <QCoreApplication>
 
 using namespace QtTclNotify;
 
 // Tell Tcl to replace its default notifier with ours
 void QtTclNotifier::setup() {
+  // Created here, on the GUI thread, AlertNotifier may be called from others
+  getInstance();
   Tcl_NotifierProcs notifier;
   notifier.createFileHandlerProc = CreateFileHandler;
   notifier.deleteFileHandlerProc = DeleteFileHandler;
@@ -37,51 +40,27 @@ void QtTclNotifier::setup() {
   Tcl_SetNotifier(&notifier);
 }
 
-// Store the requested callback and establish one or more QSocketNotifier
-// objects to link the activity to it
+// Store the requested callback in the handler of the file descriptor, whose
+// QSocketNotifier objects link the activity to it. Tcl registers the same
+// descriptor again each time the fileevent mask changes, the handler and its
+// notifiers are reused.
 void QtTclNotifier::CreateFileHandler(int fd, int mask, Tcl_FileProc* proc,
                                       ClientData clientData) {
-  // find any existing handler and deactivate it
-  HandlerMap::iterator old_handler_it = getInstance()->m_handlers.find(fd);
-  if (old_handler_it != getInstance()->m_handlers.end()) {
-    // schedule QtTclFileHandler QObject for deletion (and disconnection), along
-    // with its QSocketNotifiers, when control returns to event loop
-    old_handler_it->second->deleteLater();
-    // remove from map
-    getInstance()->m_handlers.erase(old_handler_it);
+  HandlerMap& handlers = getInstance()->m_handlers;
+  HandlerMap::iterator handler_it = handlers.find(fd);
+  if (handler_it == handlers.end()) {
+    handler_it =
+        handlers.emplace(fd, new QtTclFileHandler(getInstance(), fd)).first;
   }
-
-  QtTclFileHandler* hdlr =
-      new QtTclFileHandler(getInstance(), proc, clientData, mask);
-  if (mask & TCL_READABLE) {
-    // create read activity socket notifier as a child of the handler (so will
-    // be destroyed at the same time)
-    QSocketNotifier* rdntf =
-        new QSocketNotifier(fd, QSocketNotifier::Read, hdlr);
-    QObject::connect(rdntf, &QSocketNotifier::activated, getInstance(),
-                     &QtTclNotifier::readReady);
-  }
-  if (mask & TCL_WRITABLE) {
-    QSocketNotifier* wrntf =
-        new QSocketNotifier(fd, QSocketNotifier::Write, hdlr);
-    QObject::connect(wrntf, &QSocketNotifier::activated, getInstance(),
-                     &QtTclNotifier::writeReady);
-  }
-  if (mask & TCL_EXCEPTION) {
-    QSocketNotifier* exntf =
-        new QSocketNotifier(fd, QSocketNotifier::Exception, hdlr);
-    QObject::connect(exntf, &QSocketNotifier::activated, getInstance(),
-                     &QtTclNotifier::exception);
-  }
-  getInstance()->m_handlers.insert(std::make_pair(fd, hdlr));
+  handler_it->second->set(proc, clientData, mask);
 }
 
-// remove the handler for the given file descriptor and cancel its notifications
+// cancel the notifications for the given file descriptor, the handler is kept
+// for the next registration
 void QtTclNotifier::DeleteFileHandler(int fd) {
-  HandlerMap::iterator old_handler_it = getInstance()->m_handlers.find(fd);
-  if (old_handler_it != getInstance()->m_handlers.end()) {
-    old_handler_it->second->deleteLater();
-    getInstance()->m_handlers.erase(old_handler_it);
+  HandlerMap::iterator handler_it = getInstance()->m_handlers.find(fd);
+  if (handler_it != getInstance()->m_handlers.end()) {
+    handler_it->second->set(nullptr, nullptr, 0);
   }
   // Note: Tcl seems to call this thing with invalid fd's sometimes.  I had a
   // debug message for that, but got tired of seeing it fire all the time.
@@ -107,38 +86,70 @@ void QtTclNotifier::exception(int fd) { perform_callback<TCL_EXCEPTION>(fd); }
 
 // arrange for Tcl_ServiceAll to be executed after the specified time
 void QtTclNotifier::SetTimer(Tcl_Time const* timePtr) {
-  if (getInstance()->m_timer->isActive()) {
-    getInstance()->m_timer->stop();
+  QtTclNotifier* notifier = getInstance();
+  if (!timePtr) {
+    notifier->m_deadline = -1;
+    if (notifier->m_timer->isActive()) notifier->m_timer->stop();
+    return;
   }
-  if (timePtr) {
-    getInstance()->m_timer->start(timePtr->sec * 1000 + timePtr->usec / 1000);
+  const qint64 msec = timePtr->sec * 1000 + timePtr->usec / 1000;
+  if (msec <= 0) {
+    // Tcl has work now, no need for a timer
+    notifier->m_deadline = -1;
+    if (notifier->m_timer->isActive()) notifier->m_timer->stop();
+    notifier->scheduleService();
+    return;
   }
+  notifier->setDeadline(msec);
+}
+
+// (Re)starts the timer unless it already expires at that time. Tcl sets the
+// timer after each event it services, most of the time to the same deadline.
+void QtTclNotifier::setDeadline(qint64 msec) {
+  const qint64 deadline = m_clock.elapsed() + msec;
+  // Tcl rounds the remaining time down to the ms
+  if (m_timer->isActive() && deadline >= m_deadline &&
+      deadline - m_deadline <= 1)
+    return;
+  m_deadline = deadline;
+  m_timer->start(static_cast<int>(msec));
 }
 
 // What to do after the requested interval passes - always Tcl_ServiceAll()
-void QtTclNotifier::handle_timer() { Tcl_ServiceAll(); }
+void QtTclNotifier::handle_timer() {
+  m_deadline = -1;
+  Tcl_ServiceAll();
+}
+
+// Posted by scheduleService, once for any number of requests
+void QtTclNotifier::service() {
+  m_servicePending = false;
+  Tcl_ServiceAll();
+}
+
+void QtTclNotifier::scheduleService() {
+  if (!m_servicePending.exchange(true))
+    QMetaObject::invokeMethod(this, "service", Qt::QueuedConnection);
+}
 
 // If events are available process them, and otherwise wait up to a specified
 // interval for one to occur
 int QtTclNotifier::WaitForEvent(Tcl_Time const* timePtr) {
   // following tclXtNotify.c here.  Hope the analogies hold.
-  int timeout;
+  QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance();
+  if (!dispatcher) return 0;  // not a Qt thread
   if (timePtr) {
-    timeout = timePtr->sec * 1000 + timePtr->usec / 1000;
-    if (timeout == 0) {
-      if (!QCoreApplication::hasPendingEvents()) {
-        // timeout 0 means "do not block". There are no events, so return
-        // without processing
-        return 0;
-      }
-    } else {
-      // there are no events now, but maybe there will be some after we sleep
-      // the specified interval
-      SetTimer(timePtr);
+    const qint64 timeout = timePtr->sec * 1000 + timePtr->usec / 1000;
+    if (timeout <= 0) {
+      // timeout 0 means "do not block", process what is there if anything
+      return dispatcher->processEvents(QEventLoop::AllEvents) ? 1 : 0;
     }
+    // there are no events now, but maybe there will be some after we sleep
+    // the specified interval
+    getInstance()->setDeadline(timeout);
   }
   // block if necessary until we have some events
-  QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+  dispatcher->processEvents(QEventLoop::WaitForMoreEvents);
   return 1;
 }
 
@@ -156,8 +167,18 @@ QtTclNotifier* QtTclNotifier::m_notifier = nullptr;
 QtTclNotifier::QtTclNotifier() {
   m_timer = new QTimer(this);
   m_timer->setSingleShot(true);
+  // Tcl timers are in ms, the default coarse timer may be late by 5%
+  m_timer->setTimerType(Qt::PreciseTimer);
   QObject::connect(m_timer, &QTimer::timeout, this,
                    &QtTclNotifier::handle_timer);
+  m_clock.start();
+}
+
+// Called by Tcl_ThreadAlert, possibly from a compile worker thread, after an
+// event was queued for the GUI thread: wakes up the Qt event loop and has the
+// event serviced there. Alerts pending service are merged.
+void QtTclNotifier::AlertNotifier(ClientData) {
+  if (m_notifier) m_notifier->scheduleService();
 }
 
 // STUB METHODS
@@ -166,12 +187,44 @@ QtTclNotifier::QtTclNotifier() {
 // This could be helpful for multi-thread support, though. TBD
 void* QtTclNotifier::InitNotifier() { return 0; }
 void QtTclNotifier::FinalizeNotifier(ClientData) {}
-void QtTclNotifier::AlertNotifier(ClientData) {}
 
 // Can't find any examples of how this should work.  Unix implementation is
 // empty
 void QtTclNotifier::ServiceModeHook(int) {}
 
+// Enables the notifiers of the requested activities, creating them on first
+// use, and disables the others
+void QtTclFileHandler::set(Tcl_FileProc* proc, ClientData clientData,
+                           int mask) {
+  m_proc = proc;
+  m_clientData = clientData;
+  m_mask = mask;
+  enable(QSocketNotifier::Read, mask & TCL_READABLE);
+  enable(QSocketNotifier::Write, mask & TCL_WRITABLE);
+  enable(QSocketNotifier::Exception, mask & TCL_EXCEPTION);
+}
+
+void QtTclFileHandler::enable(QSocketNotifier::Type type, bool enabled) {
+  QSocketNotifier*& notifier = m_notifiers[type];
+  if (!notifier) {
+    if (!enabled) return;
+    // create the activity socket notifier as a child of the handler (so will
+    // be destroyed at the same time)
+    notifier = new QSocketNotifier(m_fd, type, this);
+    QtTclNotifier* tclNotifier = QtTclNotifier::getInstance();
+    if (type == QSocketNotifier::Read)
+      QObject::connect(notifier, &QSocketNotifier::activated, tclNotifier,
+                       &QtTclNotifier::readReady);
+    else if (type == QSocketNotifier::Write)
+      QObject::connect(notifier, &QSocketNotifier::activated, tclNotifier,
+                       &QtTclNotifier::writeReady);
+    else
+      QObject::connect(notifier, &QSocketNotifier::activated, tclNotifier,
+                       &QtTclNotifier::exception);
+  }
+  if (notifier->isEnabled() != enabled) notifier->setEnabled(enabled);
+}
+
 // only one method for QtTclFileHandler - executing the callback (with type
 // check)
 void QtTclFileHandler::perform_callback(int type,
@@ -18,8 +18,10 @@
 #if !defined(EDASKEL_QT_TCL_NOTIFIER)
 #define EDASKEL_QT_TCL_NOTIFIER
 
+#include <QElapsedTimer>
 #include <QSocketNotifier>
 #include <QTimer>
+#include <atomic>
 #include <map>
 #include <tcl.h>
 
@@ -36,6 +38,11 @@ namespace QtTclNotify {
 
   class QtTclFileHandler;   // forward ref
   // Singleton class.  Static methods to work with Tcl callbacks, non-static for Qt signal/slot mechanism
+  //
+  // Tcl keeps its own timer list and only hands the notifier the next deadline, the single timer is only
+  // restarted when that deadline moves.  "As soon as possible" requests (zero timeout, alerts from other
+  // threads) are coalesced into one posted call of Tcl_ServiceAll.  File handlers and their socket notifiers
+  // are kept per file descriptor and only enabled/disabled when Tcl changes the registration.
   class QtTclNotifier : public QObject {
     Q_OBJECT
       public:
@@ -48,7 +55,7 @@ namespace QtTclNotify {
     static void DeleteFileHandler(int fd);
     static void* InitNotifier();
     static void FinalizeNotifier(ClientData clientData);
-    static void AlertNotifier(ClientData clientData);
+    static void AlertNotifier(ClientData clientData);   // thread safe
     static void ServiceModeHook(int mode);
 
     static QtTclNotifier* getInstance();
@@ -60,13 +67,19 @@ namespace QtTclNotify {
     void writeReady(int fd);
     void exception(int fd);
     void handle_timer();
+    void service();
   private:
     QtTclNotifier();    // singleton
     ~QtTclNotifier() = default;
 
     template<int TclActivityType> static void perform_callback(int fd);
+    void setDeadline(qint64 msec);
+    void scheduleService();
     HandlerMap m_handlers;
     QTimer* m_timer;                    // for implementing Tcl_SetTimer
+    qint64 m_deadline{-1};              // of m_timer, in ms of m_clock
+    QElapsedTimer m_clock;
+    std::atomic<bool> m_servicePending{false};
     static QtTclNotifier* m_notifier;   // pointer to the single instance we allow
 
   };
@@ -74,15 +87,21 @@ namespace QtTclNotify {
   // QtTclFileHandler objects aggregate the activity mask/callback function/client data for a given file descriptor
   // it will also "own" (in a Qt sense - object hierarchy) the QSocketNotifiers created for it
   // This way they will get destroyed when the parent does and I won't have to clean them up
+  // A handler outlives its Tcl registration, it is disabled and reused when the descriptor is registered again
   class QtTclFileHandler : public QObject {
     Q_OBJECT
   public:
-    QtTclFileHandler(QObject * parent, Tcl_FileProc* proc, ClientData clientData, int mask) : QObject(parent), m_proc(proc), m_clientData(clientData), m_mask(mask) {}
+    QtTclFileHandler(QObject * parent, int fd) : QObject(parent), m_fd(fd) {}
+    // Registers the callback, mask 0 disables the handler
+    void set(Tcl_FileProc* proc, ClientData clientData, int mask);
     void perform_callback(int type, int fd);
   private:
-    Tcl_FileProc* m_proc;      // function to call
-    ClientData m_clientData;   // extra data to supply
-    int m_mask;                // types of activity supported
+    void enable(QSocketNotifier::Type type, bool enabled);
+    int m_fd;
+    Tcl_FileProc* m_proc{nullptr};      // function to call
+    ClientData m_clientData{nullptr};   // extra data to supply
+    int m_mask{0};                      // types of activity supported
+    QSocketNotifier* m_notifiers[3]{};  // read, write, exception, created on first use
   };
 
 }
@@ -60,6 +60,7 @@ void Session::windowShow() {
           else
             counter = std::stoi(msg);
           m_compiler->GetTaskManager()->setTaskCount(counter);
+          m_compiler->PlanProgress(tclParser.stages());
           if (topLevel) {
             topLevel->ProgressVisible(true);
           }
@@ -857,6 +857,8 @@ void MainWindow::ReShowWindow(QString strProject) {
   textEditor->setObjectName("textEditor");
   connect(sourcesForm, SIGNAL(OpenFile(QString)), textEditor,
           SLOT(SlotOpenFile(QString)));
+  connect(sourcesForm, &SourcesForm::OpenFileWithLine, textEditor,
+          &TextEditor::SlotOpenFileWithLine);
   connect(textEditor, SIGNAL(CurrentFileChanged(QString)), sourcesForm,
           SLOT(SetCurrentFileItem(QString)));
   connect(textEditor, &TextEditor::FileChanged, this,
@@ -932,6 +934,7 @@ void MainWindow::ReShowWindow(QString strProject) {
           m_progressBar->setMaximum(max);
           m_progressBar->setValue(val);
         }
+        m_progressBar->setFormat("%v/%m");
         m_progressBar->show();
         m_progressWidgetLbl->setText("<strong>STATUS</strong> " + statusMsg);
         m_progressWidgetLbl->setVisible(!statusMsg.isEmpty());
@@ -941,10 +944,24 @@ void MainWindow::ReShowWindow(QString strProject) {
         statusBar()->showMessage(statusMsg);
       });
 
+  connect(m_taskManager, &TaskManager::estimate, this,
+          [this](int percent, const QString& statusMsg) {
+            m_progressBar->setMaximum(100);
+            m_progressBar->setValue(percent);
+            m_progressBar->setFormat("%p%");
+            m_progressBar->show();
+            m_progressWidgetLbl->setText("<strong>STATUS</strong> " +
+                                         statusMsg);
+            m_progressWidgetLbl->setVisible(!statusMsg.isEmpty());
+            statusBar()->showMessage(statusMsg);
+          });
+
   connect(m_taskManager, &TaskManager::done, this, [this]() {
     if (!m_progressVisible) m_progressBar->hide();
     m_compiler->finish();
     showReportsTab();
+    // analysis may have written a new design hierarchy
+    if (sourcesForm) sourcesForm->UpdateDesignHierarchy();
   });
 
   connect(m_taskManager, &TaskManager::started, this,
@@ -1013,10 +1030,15 @@ void MainWindow::reloadSettings() {
     addFilesFromDir(settingsDir);
 
     // Add any json files from the [projectName].settings folder
-    addFilesFromDir(Settings::getUserSettingsPath());
-
-    // Load and merge all our json files
-    settings->loadSettings(settingsFiles);
+    const QString userSettingsPath = Settings::getUserSettingsPath();
+    addFilesFromDir(userSettingsPath);
+
+    // Load and merge all our json files, a project keeps the merged result
+    // next to its settings folder
+    QString snapshot;
+    if (!userSettingsPath.isEmpty())
+      snapshot = userSettingsPath.chopped(1) + ".snapshot";
+    settings->loadSettings(settingsFiles, snapshot);
   }
 }
 
@@ -1,10 +1,13 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#include <QMap>
+#include <QDateTime>
 #include <QObject>
-#include <QSet>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+
+#include "device_catalog.h"
 
 namespace FOEDAG {
 
@@ -14,7 +17,11 @@ class Config : public QObject {
  public:
   static Config *Instance();
 
+  // Loads the device catalog, nothing is done if the file didn't change. A
+  // failed load keeps the previous catalog.
   int InitConfig(const QString &devicexml);
+  // Snapshot of the current catalog, never modified by later loads
+  std::shared_ptr<const DeviceCatalog> catalog() const;
   QStringList getDeviceItem() const;
   QStringList getSerieslist() const;
   QStringList getFamilylist(const QString &series) const;
@@ -26,12 +33,13 @@ class Config : public QObject {
   std::filesystem::path dataPath() { return m_dataPath; }
 
  private:
+  // Shared by the GUI and the Tcl thread, guards the three members below
+  mutable std::mutex m_mutex;
   QString m_device_xml = "";
-  QStringList m_lsit_device_item;
-  QMap<QString, QMap<QString, QStringList>> m_map_device;
-  QMap<QString, QStringList> m_map_device_info;
+  QDateTime m_device_xml_modified;
+  std::shared_ptr<const DeviceCatalog> m_catalog{
+      std::make_shared<DeviceCatalog>()};
 
-  void MakeDeviceMap(QString series, QString family, QString package);
   std::filesystem::path m_dataPath;
 };
 }  // namespace FOEDAG
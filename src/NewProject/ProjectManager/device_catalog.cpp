@@ -0,0 +1,305 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "device_catalog.h"
+
+#include <QFile>
+#include <QXmlStreamReader>
+#include <algorithm>
+#include <numeric>
+
+using namespace FOEDAG;
+
+int DeviceCatalog::Load(const QString &file) {
+  Clear();
+  QFile device_xml(file);
+  if (!device_xml.open(QFile::ReadOnly)) {
+    m_error = QString("Cannot open device file: %1").arg(file);
+    return -1;
+  }
+
+  QHash<QString, int> resourceIds;
+  bool inDevice{false};
+  QXmlStreamReader reader(&device_xml);
+  while (!reader.atEnd()) {
+    reader.readNext();
+    if (reader.isEndElement() && reader.name() == QLatin1String("device")) {
+      inDevice = false;
+      continue;
+    }
+    if (!reader.isStartElement()) continue;
+    const QXmlStreamAttributes attributes = reader.attributes();
+    if (reader.name() == QLatin1String("device")) {
+      Device device;
+      device.name = attributes.value("name").toString();
+      device.pinCount = attributes.value("pin_count").toString();
+      device.speedGrade = attributes.value("speedgrade").toString();
+      device.coreVoltage = attributes.value("core_voltage").toString();
+      device.series = intern(attributes.value("series").toString());
+      device.family = intern(attributes.value("family").toString());
+      device.package = intern(attributes.value("package").toString());
+      m_devices.push_back(std::move(device));
+      inDevice = true;
+    } else if (inDevice && reader.name() == QLatin1String("resource")) {
+      const QString type = attributes.value("type").toString();
+      auto itr = resourceIds.find(type);
+      if (itr == resourceIds.end()) {
+        itr = resourceIds.insert(type,
+                                 static_cast<int>(m_resourceTypes.size()));
+        m_resourceTypes.append(type);
+      }
+      auto &resources = m_devices.back().resources;
+      if (static_cast<int>(resources.size()) <= itr.value())
+        resources.resize(itr.value() + 1, -1);
+      resources[itr.value()] = attributes.value("num").toInt();
+    } else if (inDevice && reader.name() == QLatin1String("internal")) {
+      m_devices.back().internals.push_back(
+          {attributes.value("type").toString().toStdString(),
+           attributes.value("file").toString().toStdString(),
+           attributes.value("name").toString().toStdString(),
+           attributes.value("num").toString().toStdString()});
+    }
+  }
+  if (reader.hasError()) {
+    const QString error = QString("Incorrect device file: %1 (line %2: %3)")
+                              .arg(file)
+                              .arg(reader.lineNumber())
+                              .arg(reader.errorString());
+    Clear();
+    m_error = error;
+    return -2;
+  }
+
+  std::vector<int> sorted(m_devices.size());
+  std::iota(sorted.begin(), sorted.end(), 0);
+  std::stable_sort(sorted.begin(), sorted.end(), [this](int a, int b) {
+    return m_devices[a].name < m_devices[b].name;
+  });
+  for (int index : sorted) {
+    Device &device = m_devices[index];
+    device.resources.resize(m_resourceTypes.size(), -1);
+    m_byName[device.name].push_back(index);
+    m_index[key(-1)].push_back(index);
+    m_index[key(device.series)].push_back(index);
+    m_index[key(device.series, device.family)].push_back(index);
+    m_index[key(device.series, device.family, device.package)].push_back(
+        index);
+  }
+  for (const Device &device : m_devices) {
+    auto &families = m_families[device.series];
+    if (std::find(families.begin(), families.end(), device.family) ==
+        families.end())
+      families.push_back(device.family);
+    auto &packages = m_packages[key(device.series, device.family)];
+    if (std::find(packages.begin(), packages.end(), device.package) ==
+        packages.end())
+      packages.push_back(device.package);
+  }
+  return 0;
+}
+
+void DeviceCatalog::Clear() {
+  m_error.clear();
+  m_devices.clear();
+  m_resourceTypes.clear();
+  m_strings.clear();
+  m_stringIds.clear();
+  m_byName.clear();
+  m_families.clear();
+  m_packages.clear();
+  m_index.clear();
+}
+
+std::vector<int> DeviceCatalog::DevicesNamed(const QString &name) const {
+  return m_byName.value(name);
+}
+
+QStringList DeviceCatalog::Columns() const {
+  QStringList columns{"name", "pin_count", "speedgrade", "core_voltage"};
+  columns.append(m_resourceTypes);
+  columns << "series"
+          << "family"
+          << "package";
+  return columns;
+}
+
+int DeviceCatalog::ColumnCount() const { return PackageColumn() + 1; }
+
+QString DeviceCatalog::Data(int device, int column) const {
+  const Device &d = m_devices[device];
+  switch (column) {
+    case Name:
+      return d.name;
+    case PinCount:
+      return d.pinCount;
+    case SpeedGrade:
+      return d.speedGrade;
+    case CoreVoltage:
+      return d.coreVoltage;
+  }
+  if (column < SeriesColumn()) {
+    const int num = d.resources[column - FirstResource];
+    return num < 0 ? QString{} : QString::number(num);
+  }
+  if (column == SeriesColumn()) return m_strings[d.series];
+  if (column == FamilyColumn()) return m_strings[d.family];
+  if (column == PackageColumn()) return m_strings[d.package];
+  return {};
+}
+
+QStringList DeviceCatalog::Row(int device) const {
+  QStringList row;
+  for (int column = 0; column < ColumnCount(); column++)
+    row.append(Data(device, column));
+  return row;
+}
+
+QStringList DeviceCatalog::Series() const {
+  QStringList series;
+  for (const auto &[id, families] : m_families) series.append(m_strings[id]);
+  series.sort();
+  return series;
+}
+
+QStringList DeviceCatalog::Families(const QString &series) const {
+  QStringList families;
+  auto itr = m_families.find(StringId(series));
+  if (itr == m_families.end()) return families;
+  for (int id : itr->second) families.append(m_strings[id]);
+  families.sort();
+  return families;
+}
+
+QStringList DeviceCatalog::Packages(const QString &series,
+                                    const QString &family) const {
+  QStringList packages;
+  const int seriesId = StringId(series);
+  const int familyId = StringId(family);
+  if (seriesId < 0 || familyId < 0) return packages;
+  auto itr = m_packages.find(key(seriesId, familyId));
+  if (itr == m_packages.end()) return packages;
+  for (int id : itr->second) packages.append(m_strings[id]);
+  return packages;
+}
+
+std::vector<int> DeviceCatalog::Devices(const QString &series,
+                                        const QString &family,
+                                        const QString &package) const {
+  const int seriesId = series.isEmpty() ? -1 : StringId(series);
+  const int familyId = family.isEmpty() ? -1 : StringId(family);
+  const int packageId = package.isEmpty() ? -1 : StringId(package);
+  if ((!series.isEmpty() && seriesId < 0) ||
+      (!family.isEmpty() && familyId < 0) ||
+      (!package.isEmpty() && packageId < 0))
+    return {};
+  // The index is keyed by series, series/family and series/family/package
+  if ((familyId < 0 || seriesId >= 0) && (packageId < 0 || familyId >= 0)) {
+    auto itr = m_index.find(key(seriesId, familyId, packageId));
+    return itr == m_index.end() ? std::vector<int>{} : itr->second;
+  }
+  std::vector<int> devices;
+  auto itr = m_index.find(key(-1));
+  if (itr == m_index.end()) return devices;
+  for (int index : itr->second) {
+    const Device &device = m_devices[index];
+    if ((seriesId < 0 || device.series == seriesId) &&
+        (familyId < 0 || device.family == familyId) &&
+        (packageId < 0 || device.package == packageId))
+      devices.push_back(index);
+  }
+  return devices;
+}
+
+int DeviceCatalog::intern(const QString &str) {
+  auto itr = m_stringIds.find(str);
+  if (itr != m_stringIds.end()) return itr.value();
+  const int id = static_cast<int>(m_strings.size());
+  m_strings.append(str);
+  m_stringIds.insert(str, id);
+  return id;
+}
+
+// Ids are below 2^21, -1 stands for any
+uint64_t DeviceCatalog::key(int series, int family, int package) {
+  return (static_cast<uint64_t>(series + 1) << 42) |
+         (static_cast<uint64_t>(family + 1) << 21) |
+         static_cast<uint64_t>(package + 1);
+}
+
+DeviceFilter::DeviceFilter(std::shared_ptr<const DeviceCatalog> catalog)
+    : m_catalog(std::move(catalog)) {
+  rebuild();
+}
+
+void DeviceFilter::SetFilter(int column, const QString &text) {
+  auto itr = m_filters.find(column);
+  const QString previous = itr == m_filters.end() ? QString{} : itr->second;
+  if (text.isEmpty()) {
+    if (itr == m_filters.end()) return;
+    m_filters.erase(itr);
+    rebuild();
+    return;
+  }
+  m_filters[column] = text;
+  const bool exact = column >= m_catalog->SeriesColumn();
+  // A new filter or a longer substring can only remove devices
+  if (previous.isEmpty() ||
+      (!exact && text.contains(previous, Qt::CaseInsensitive))) {
+    m_devices.erase(std::remove_if(m_devices.begin(), m_devices.end(),
+                                   [this](int device) {
+                                     return !matches(device);
+                                   }),
+                    m_devices.end());
+  } else {
+    rebuild();
+  }
+}
+
+void DeviceFilter::Reset() {
+  m_filters.clear();
+  rebuild();
+}
+
+bool DeviceFilter::matches(int device) const {
+  for (const auto &[column, text] : m_filters) {
+    const QString data = m_catalog->Data(device, column);
+    if (column >= m_catalog->SeriesColumn()) {
+      if (data != text) return false;
+    } else if (!data.contains(text, Qt::CaseInsensitive)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void DeviceFilter::rebuild() {
+  auto value = [this](int column) {
+    auto itr = m_filters.find(column);
+    return itr == m_filters.end() ? QString{} : itr->second;
+  };
+  // Narrowed by the index first
+  m_devices = m_catalog->Devices(value(m_catalog->SeriesColumn()),
+                                 value(m_catalog->FamilyColumn()),
+                                 value(m_catalog->PackageColumn()));
+  m_devices.erase(
+      std::remove_if(m_devices.begin(), m_devices.end(),
+                     [this](int device) { return !matches(device); }),
+      m_devices.end());
+}
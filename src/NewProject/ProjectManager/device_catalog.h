@@ -0,0 +1,144 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef DEVICE_CATALOG_H
+#define DEVICE_CATALOG_H
+
+#include <QHash>
+#include <QStringList>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The DeviceCatalog class holds the devices of device.xml. It is
+ * streamed once, the series/family/package strings and the resource types
+ * are interned and indexed so that the planner and the compiler look devices
+ * up without scanning the list.
+ */
+class DeviceCatalog {
+ public:
+  enum Column { Name, PinCount, SpeedGrade, CoreVoltage, FirstResource };
+  // Extra data of the compiler for the device (<internal .../>)
+  struct Internal {
+    std::string type;
+    std::string file;
+    std::string name;
+    std::string num;
+  };
+  struct Device {
+    QString name;
+    QString pinCount;
+    QString speedGrade;
+    QString coreVoltage;
+    int series{0};
+    int family{0};
+    int package{0};
+    // Indexed by resource type, -1 when the device doesn't list it
+    std::vector<int> resources;
+    std::vector<Internal> internals;
+  };
+
+  /*!
+   * \brief Load replaces the catalog with the content of \p file.
+   * \return 0 on success, -1 if the file can't be read, -2 if it is invalid
+   */
+  int Load(const QString &file);
+  void Clear();
+  const QString &LastError() const { return m_error; }
+
+  int Size() const { return static_cast<int>(m_devices.size()); }
+  const Device &GetDevice(int index) const { return m_devices[index]; }
+  // All the devices with this name, several packages may share it
+  std::vector<int> DevicesNamed(const QString &name) const;
+
+  // name, pin_count, speedgrade, core_voltage, resources, series, family,
+  // package
+  QStringList Columns() const;
+  int ColumnCount() const;
+  int SeriesColumn() const {
+    return FirstResource + static_cast<int>(m_resourceTypes.size());
+  }
+  int FamilyColumn() const { return SeriesColumn() + 1; }
+  int PackageColumn() const { return SeriesColumn() + 2; }
+  QString Data(int device, int column) const;
+  QStringList Row(int device) const;
+  const QString &String(int id) const { return m_strings[id]; }
+  // -1 if the string is not used by any device
+  int StringId(const QString &str) const { return m_stringIds.value(str, -1); }
+
+  // Sorted as the combo boxes show them
+  QStringList Series() const;
+  QStringList Families(const QString &series) const;
+  QStringList Packages(const QString &series, const QString &family) const;
+  // Devices sorted by name, empty arguments match everything
+  std::vector<int> Devices(const QString &series = {},
+                           const QString &family = {},
+                           const QString &package = {}) const;
+
+ private:
+  int intern(const QString &str);
+  static uint64_t key(int series, int family = -1, int package = -1);
+
+  QString m_error;
+  std::vector<Device> m_devices;
+  QStringList m_resourceTypes;
+  QStringList m_strings;
+  QHash<QString, int> m_stringIds;
+  QHash<QString, std::vector<int>> m_byName;
+  // series -> families, series/family -> packages in file order
+  std::map<int, std::vector<int>> m_families;
+  std::map<uint64_t, std::vector<int>> m_packages;
+  // series[/family[/package]] -> devices sorted by name
+  std::map<uint64_t, std::vector<int>> m_index;
+};
+
+/*!
+ * \brief The DeviceFilter class narrows the devices of a catalog by any
+ * number of columns. Series, family and package match exactly through the
+ * catalog index, the other columns by case insensitive substring. Typing
+ * more characters only rescans the current result. The filter shares the
+ * catalog its device indices refer to.
+ */
+class DeviceFilter {
+ public:
+  explicit DeviceFilter(std::shared_ptr<const DeviceCatalog> catalog);
+
+  const DeviceCatalog &Catalog() const { return *m_catalog; }
+
+  // Empty text removes the filter of the column
+  void SetFilter(int column, const QString &text);
+  void Reset();
+  const std::vector<int> &Devices() const { return m_devices; }
+
+ private:
+  bool matches(int device) const;
+  void rebuild();
+
+  std::shared_ptr<const DeviceCatalog> m_catalog;
+  std::map<int, QString> m_filters;
+  std::vector<int> m_devices;
+};
+
+}  // namespace FOEDAG
+#endif  // DEVICE_CATALOG_H
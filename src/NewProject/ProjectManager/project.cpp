@@ -19,6 +19,7 @@ void Project::InitProject() {
   m_mapProjectRun.clear();
   qDeleteAll(m_mapProjectFileset);
   m_mapProjectFileset.clear();
+  emit projectReset();
 }
 
 QString Project::projectName() const { return m_projectName; }
@@ -66,6 +67,20 @@ int Project::setProjectFileset(const ProjectFileSet &projectFileset) {
       ret = 1;
     } else {
       m_mapProjectFileset.insert(pf->getSetName(), pf);
+      const QString name = pf->getSetName();
+      connect(pf, &ProjectFileSet::fileAdded, this,
+              [this, name](const QString &file) {
+                emit fileAdded(name, file);
+              });
+      connect(pf, &ProjectFileSet::fileRemoved, this,
+              [this, name](const QString &file) {
+                emit fileRemoved(name, file);
+              });
+      connect(pf, &ProjectFileSet::optionChanged, this,
+              [this, name](const QString &key) {
+                emit fileSetOptionChanged(name, key);
+              });
+      emit fileSetAdded(name);
     }
   } else {
     ret = -1;
@@ -80,6 +95,7 @@ void Project::deleteProjectFileset(const QString &strName) {
     proFileSet = iter.value();
     delete proFileSet;
     m_mapProjectFileset.erase(iter);
+    emit fileSetRemoved(strName);
   }
 }
 
@@ -45,6 +45,14 @@ class Project : public QObject {
  signals:
   void projectPathChanged();
   void saveFile();
+  // Fine grained changes of the file sets, for views that update
+  // incrementally. projectReset() is emitted when all file sets are dropped.
+  void projectReset();
+  void fileSetAdded(const QString &strName);
+  void fileSetRemoved(const QString &strName);
+  void fileAdded(const QString &strFileSet, const QString &strFilePath);
+  void fileRemoved(const QString &strFileSet, const QString &strFilePath);
+  void fileSetOptionChanged(const QString &strFileSet, const QString &strKey);
 
  private:
   QString m_projectName;
@@ -39,6 +39,7 @@ QString ProjectFileSet::getDefaultUnitName() const {
 void ProjectFileSet::addFile(const QString &strFileName,
                              const QString &strFilePath) {
   m_mapFiles.push_back(std::make_pair(strFileName, strFilePath));
+  emit fileAdded(strFilePath);
 }
 
 void ProjectFileSet::addFiles(const QStringList &commands,
@@ -82,6 +83,7 @@ void ProjectFileSet::deleteFile(const QString &strFileName) {
         break;
       }
     }
+    emit fileRemoved(file);
   }
 }
 
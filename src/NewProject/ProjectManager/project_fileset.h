@@ -39,6 +39,11 @@ class ProjectFileSet : public ProjectOption {
 
   const std::vector<std::pair<QStringList, QStringList>> &getLibraries() const;
 
+ signals:
+  // Emitted with the file path of the changed entry of getMapFiles()
+  void fileAdded(const QString &strFilePath);
+  void fileRemoved(const QString &strFilePath);
+
  private:
   QString m_setName;
   QString m_setType;
@@ -16,7 +16,10 @@ ProjectOption &ProjectOption::operator=(const ProjectOption &other) {
 }
 
 void ProjectOption::setOption(const QString &strKey, const QString &strValue) {
+  auto iter = m_mapOption.find(strKey);
+  if (iter != m_mapOption.end() && iter.value() == strValue) return;
   m_mapOption[strKey] = strValue;
+  emit optionChanged(strKey);
 }
 
 QString ProjectOption::getOption(QString strKey) {
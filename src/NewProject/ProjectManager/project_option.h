@@ -18,6 +18,9 @@ class ProjectOption : public QObject {
 
   QMap<QString, QString> getMapOption() const;
 
+ signals:
+  void optionChanged(const QString &strKey);
+
  private:
   QMap<QString, QString> m_mapOption;
 };
@@ -14,7 +14,9 @@
 using namespace FOEDAG;
 
 devicePlannerForm::devicePlannerForm(QWidget *parent)
-    : QWidget(parent), ui(new Ui::devicePlannerForm) {
+    : QWidget(parent),
+      ui(new Ui::devicePlannerForm),
+      m_filter(Config::Instance()->catalog()) {
   ui->setupUi(this);
   ui->m_labelTitle->setText(tr("Select Target Device"));
   ui->m_labelDetail->setText(
@@ -47,7 +49,14 @@ devicePlannerForm::devicePlannerForm(QWidget *parent)
   m_tableView->setModel(m_model);
   m_tableView->setSelectionModel(m_selectmodel);
 
+  m_nameFilter = new QLineEdit(this);
+  m_nameFilter->setPlaceholderText(tr("Filter by name"));
+  m_nameFilter->setClearButtonEnabled(true);
+  connect(m_nameFilter, &QLineEdit::textChanged, this,
+          &devicePlannerForm::onNameFilterChanged);
+
   QVBoxLayout *vbox = new QVBoxLayout(ui->m_frame);
+  vbox->addWidget(m_nameFilter);
   vbox->addWidget(m_tableView);
   vbox->setContentsMargins(0, 0, 0, 0);
   vbox->setSpacing(1);
@@ -65,6 +74,8 @@ devicePlannerForm::devicePlannerForm(QWidget *parent)
                            std::string("device.xml");
   QString devicexml = devicefile.c_str();
   if (0 == Config::Instance()->InitConfig(devicexml)) {
+    // The form keeps this snapshot, its rows refer to it
+    m_filter = DeviceFilter{Config::Instance()->catalog()};
     InitSeriesComboBox();
   }
 }
@@ -129,13 +140,18 @@ void devicePlannerForm::onPackagetextChanged(const QString &arg1) {
   UpdateDeviceTableView();
 }
 
+void devicePlannerForm::onNameFilterChanged(const QString &text) {
+  m_filter.SetFilter(DeviceCatalog::Name, text);
+  FillDeviceTableView();
+}
+
 void devicePlannerForm::InitSeriesComboBox() {
   disconnect(ui->m_comboBoxSeries, &QComboBox::currentTextChanged, this,
              &devicePlannerForm::onSeriestextChanged);
 
   ui->m_comboBoxSeries->clear();
 
-  QList<QString> lisSeries = Config::Instance()->getSerieslist();
+  QList<QString> lisSeries = m_filter.Catalog().Series();
   for (int i = 0; i < lisSeries.size(); ++i) {
     ui->m_comboBoxSeries->addItem(lisSeries[i]);
   }
@@ -146,7 +162,7 @@ void devicePlannerForm::InitSeriesComboBox() {
 }
 
 void devicePlannerForm::InitDeviceTableViewHead() {
-  QList<QString> listHead = Config::Instance()->getDeviceItem();
+  QList<QString> listHead = m_filter.Catalog().Columns();
   for (int i = 0; i < listHead.size(); ++i) {
     m_model->setHorizontalHeaderItem(i, new QStandardItem(listHead.at(i)));
   }
@@ -159,7 +175,7 @@ void devicePlannerForm::UpdateFamilyComboBox() {
   ui->m_comboBoxFamily->clear();
 
   QList<QString> lisFamily =
-      Config::Instance()->getFamilylist(ui->m_comboBoxSeries->currentText());
+      m_filter.Catalog().Families(ui->m_comboBoxSeries->currentText());
   for (int i = 0; i < lisFamily.size(); ++i) {
     ui->m_comboBoxFamily->addItem(lisFamily[i]);
   }
@@ -175,7 +191,7 @@ void devicePlannerForm::UpdatePackageComboBox() {
 
   ui->m_comboBoxPackage->clear();
 
-  QList<QString> lisPackage = Config::Instance()->getPackagelist(
+  QList<QString> lisPackage = m_filter.Catalog().Packages(
       ui->m_comboBoxSeries->currentText(), ui->m_comboBoxFamily->currentText());
   for (int i = 0; i < lisPackage.size(); ++i) {
     ui->m_comboBoxPackage->addItem(lisPackage[i]);
@@ -187,24 +203,28 @@ void devicePlannerForm::UpdatePackageComboBox() {
 }
 
 void devicePlannerForm::UpdateDeviceTableView() {
+  const DeviceCatalog &catalog = m_filter.Catalog();
+  m_filter.SetFilter(catalog.SeriesColumn(),
+                     ui->m_comboBoxSeries->currentText());
+  m_filter.SetFilter(catalog.FamilyColumn(),
+                     ui->m_comboBoxFamily->currentText());
+  m_filter.SetFilter(catalog.PackageColumn(),
+                     ui->m_comboBoxPackage->currentText());
+  FillDeviceTableView();
+}
+
+void devicePlannerForm::FillDeviceTableView() {
+  const DeviceCatalog &catalog = m_filter.Catalog();
   m_model->clear();
   InitDeviceTableViewHead();
-  QList<QStringList> listDevice = Config::Instance()->getDevicelist(
-      ui->m_comboBoxSeries->currentText(), ui->m_comboBoxFamily->currentText(),
-      ui->m_comboBoxPackage->currentText());
-  for (int i = 0; i < listDevice.count(); ++i) {
-    int rows = m_model->rowCount();
+  for (int device : m_filter.Devices()) {
     QList<QStandardItem *> items;
-    QStandardItem *item = nullptr;
-
-    QList<QString> listDev = listDevice.at(i);
-    foreach (QString strItem, listDev) {
-      item = new QStandardItem(strItem);
+    for (const QString &strItem : catalog.Row(device)) {
+      QStandardItem *item = new QStandardItem(strItem);
       item->setTextAlignment(Qt::AlignCenter);
       items.append(item);
     }
-
-    m_model->insertRow(rows, items);
+    m_model->appendRow(items);
   }
   UpdateSelection(m_selectmodel->model()->index(0, 0));
 }
@@ -1,9 +1,11 @@
 #ifndef DEVICEPLANNERFORM_H
 #define DEVICEPLANNERFORM_H
+#include <QLineEdit>
 #include <QStandardItemModel>
 #include <QTableView>
 #include <QWidget>
 
+#include "ProjectManager/device_catalog.h"
 #include "SettingsGuiInterface.h"
 
 namespace Ui {
@@ -26,6 +28,7 @@ class devicePlannerForm : public QWidget, public SettingsGuiInterface {
   void onSeriestextChanged(const QString &arg1);
   void onFamilytextChanged(const QString &arg1);
   void onPackagetextChanged(const QString &arg1);
+  void onNameFilterChanged(const QString &text);
 
  private:
   Ui::devicePlannerForm *ui;
@@ -33,12 +36,15 @@ class devicePlannerForm : public QWidget, public SettingsGuiInterface {
   QTableView *m_tableView;
   QStandardItemModel *m_model;
   QItemSelectionModel *m_selectmodel;
+  QLineEdit *m_nameFilter;
+  DeviceFilter m_filter;
 
   void InitSeriesComboBox();
   void InitDeviceTableViewHead();
   void UpdateFamilyComboBox();
   void UpdatePackageComboBox();
   void UpdateDeviceTableView();
+  void FillDeviceTableView();
   void UpdateSelection(const QModelIndex &index);
 };
 }  // namespace FOEDAG
@@ -68,7 +68,8 @@ newProjectDialog::newProjectDialog(QWidget *parent)
   ui->m_tabWidget->tabBar()->setStyle(new CustomTabStyle);
   connect(ui->m_tabWidget, &QTabWidget::currentChanged, this,
           &newProjectDialog::updateSummaryPage);
-  Reset();
+  // Pages are created by Reset() or on the first show. Device planner reads
+  // the device list, keep it out of the main window startup.
 
   m_projectManager = new ProjectManager(this);
 }
@@ -91,6 +92,7 @@ QString newProjectDialog::getProject() {
 
 void newProjectDialog::Reset(Mode mode) {
   m_mode = mode;
+  m_formsCreated = true;
   m_index = INDEX_LOCATION;
   m_skipSources = false;
   ui->m_tabWidget->clear();
@@ -105,6 +107,11 @@ void newProjectDialog::Reset(Mode mode) {
 
 Mode newProjectDialog::GetMode() const { return m_mode; }
 
+void newProjectDialog::showEvent(QShowEvent *event) {
+  if (!m_formsCreated) Reset();
+  QDialog::showEvent(event);
+}
+
 void newProjectDialog::SetPageActive(FormIndex index) {
   if (m_tabIndexes.contains(index)) {
     ui->m_tabWidget->setCurrentIndex(m_tabIndexes.value(index));
@@ -52,6 +52,9 @@ class newProjectDialog : public QDialog {
   Mode GetMode() const;
   void SetPageActive(FormIndex index);
 
+ protected:
+  void showEvent(QShowEvent* event) override;
+
  private slots:
   void updateSummaryPage();
   void on_buttonBox_accepted();
@@ -77,6 +80,7 @@ class newProjectDialog : public QDialog {
 
   ProjectManager* m_projectManager;
   bool m_skipSources{false};
+  bool m_formsCreated{false};
   void UpdateDialogView(Mode mode = NewProject);
   void ResetToNewProject();
   void ResetToProjectSettings();
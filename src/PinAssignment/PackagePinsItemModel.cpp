@@ -0,0 +1,569 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "PackagePinsItemModel.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "PinAssignmentDelegate.h"
+#include "PinsBaseModel.h"
+
+namespace FOEDAG {
+
+// Pin data columns follow the ports column
+constexpr PinData DataColumns[]{RefClock,  Bank,      ALT,         DebugMode,
+                                ScanMode,  MbistMode, Type,        Dir,
+                                Voltage,   PowerPad,  Discription, Voltage2,
+                                RefClock};
+
+// Internal id of the index is the id of its parent node: RootId for
+// "All Pins", TopId for banks, FirstBankId + bank for pins and
+// FirstBankId + bank count + pin for the assignment lines.
+constexpr quintptr RootId{0};
+constexpr quintptr TopId{1};
+constexpr quintptr FirstBankId{2};
+
+PackagePinsItemModel::PackagePinsItemModel(PinsBaseModel *model,
+                                           QObject *parent)
+    : QAbstractItemModel(parent),
+      m_model(model),
+      m_maxRows{model->packagePinModel()->internalPinMax()},
+      m_addIcon{":/images/add.png"},
+      m_removeIcon{":/images/minus.png"} {
+  const auto &banks = model->packagePinModel()->pinData();
+  for (int bank = 0; bank < banks.count(); bank++) {
+    m_bankOffset.append(m_pins.count());
+    const auto &pins = banks.at(bank).pinData;
+    for (int row = 0; row < pins.count(); row++) {
+      m_pinIndex.insert(pins.at(row).data.value(PinName), m_pins.count());
+      m_pins.append(PinItem{bank, row, {QString{}}});
+    }
+  }
+  m_fetched.fill(false, banks.count());
+
+  connect(model->packagePinModel(), &PackagePinsModel::modeHasChanged, this,
+          &PackagePinsItemModel::modeChanged);
+  connect(model->packagePinModel(), &PackagePinsModel::internalPinHasChanged,
+          this, &PackagePinsItemModel::internalPinChanged);
+  connect(model, &PinsBaseModel::portAssignmentChanged, this,
+          &PackagePinsItemModel::portAssignmentChanged);
+  connect(model, &PinsBaseModel::portAssignmentsChanged, this,
+          &PackagePinsItemModel::portAssignmentsChanged);
+}
+
+QModelIndex PackagePinsItemModel::index(int row, int column,
+                                        const QModelIndex &parent) const {
+  if (!hasIndex(row, column, parent)) return QModelIndex{};
+  if (!parent.isValid()) return createIndex(row, column, RootId);
+  const quintptr id = parent.internalId();
+  if (id == RootId) return createIndex(row, column, TopId);
+  if (id == TopId) return createIndex(row, column, FirstBankId + parent.row());
+  const quintptr firstPinId = FirstBankId + m_bankOffset.count();
+  return createIndex(row, column, firstPinId + pinFromIndex(parent));
+}
+
+QModelIndex PackagePinsItemModel::parent(const QModelIndex &index) const {
+  if (!index.isValid()) return QModelIndex{};
+  const quintptr id = index.internalId();
+  if (id == RootId) return QModelIndex{};
+  if (id == TopId) return createIndex(0, 0, RootId);
+  if (isBankId(id)) return createIndex(id - FirstBankId, 0, TopId);
+  return pinIndex(id - FirstBankId - m_bankOffset.count());
+}
+
+int PackagePinsItemModel::rowCount(const QModelIndex &parent) const {
+  if (!parent.isValid()) return 1;
+  if (parent.column() != 0) return 0;
+  const quintptr id = parent.internalId();
+  if (id == RootId) return m_bankOffset.count();
+  if (id == TopId) {
+    if (!m_fetched.at(parent.row())) return 0;
+    const auto &banks = m_model->packagePinModel()->pinData();
+    return banks.at(parent.row()).pinData.count();
+  }
+  if (isBankId(id)) {
+    const PinItem &item = m_pins.at(pinFromIndex(parent));
+    return item.split ? item.ports.count() : 0;
+  }
+  return 0;
+}
+
+int PackagePinsItemModel::columnCount(const QModelIndex &) const {
+  return m_model->packagePinModel()->header().count();
+}
+
+bool PackagePinsItemModel::hasChildren(const QModelIndex &parent) const {
+  if (parent.isValid() && parent.column() == 0 &&
+      parent.internalId() == TopId) {
+    const auto &banks = m_model->packagePinModel()->pinData();
+    return !banks.at(parent.row()).pinData.isEmpty();
+  }
+  return rowCount(parent) > 0;
+}
+
+bool PackagePinsItemModel::canFetchMore(const QModelIndex &parent) const {
+  return parent.isValid() && parent.internalId() == TopId &&
+         !m_fetched.at(parent.row());
+}
+
+void PackagePinsItemModel::fetchMore(const QModelIndex &parent) {
+  if (!canFetchMore(parent)) return;
+  const auto &banks = m_model->packagePinModel()->pinData();
+  const int count = banks.at(parent.row()).pinData.count();
+  if (count == 0) {
+    m_fetched[parent.row()] = true;
+    return;
+  }
+  beginInsertRows(parent, 0, count - 1);
+  m_fetched[parent.row()] = true;
+  endInsertRows();
+}
+
+QVariant PackagePinsItemModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid()) return QVariant{};
+  const quintptr id = index.internalId();
+  const int column = index.column();
+  if (id == RootId || id == TopId) {
+    if (role != Qt::DisplayRole) return QVariant{};
+    if (id == RootId)
+      return (column == NameCol) ? QString{"All Pins"} : QVariant{};
+    const auto &bank = m_model->packagePinModel()->pinData().at(index.row());
+    if (column == NameCol) return bank.name;
+    if (column == AvailCol) return QString::number(bank.pinData.count());
+    return QVariant{};
+  }
+
+  int pin{pinFromIndex(index)};
+  int line{0};
+  const bool assignment = lineFromIndex(index, pin, line);
+  switch (role) {
+    case Qt::DecorationRole:
+      if (column != NameCol) return QVariant{};
+      if (isPinId(id)) return m_removeIcon;
+      return canAddLine(pin) ? m_addIcon : QVariant{};
+    case Qt::DisplayRole:
+    case Qt::EditRole: {
+      if (column == NameCol) return pinName(pin);
+      if (column > InternalPinCol) {
+        const size_t dataIndex = column - PortsCol - 1;
+        if (isPinId(id) || dataIndex >= std::size(DataColumns))
+          return QVariant{};
+        return pinData(pin).value(DataColumns[dataIndex]);
+      }
+      if (!assignment) return QVariant{};
+      const QString &port = m_pins.at(pin).ports.at(line);
+      if (column == PortsCol) return port;
+      if (port.isEmpty()) return QVariant{};
+      if (column == ModeCol)
+        return m_model->packagePinModel()->getMode(pinName(pin));
+      if (column == InternalPinCol)
+        return m_model->packagePinModel()->internalPin(port);
+      return QVariant{};
+    }
+    case ChoicesRole:
+      return assignment ? choices(pin, line, column) : QStringList{};
+    case SearchRole:
+      return column == PortsCol;
+  }
+  return QVariant{};
+}
+
+bool PackagePinsItemModel::setData(const QModelIndex &index,
+                                   const QVariant &value, int role) {
+  int pin{0};
+  int line{0};
+  if (role != Qt::EditRole || !lineFromIndex(index, pin, line)) return false;
+  if (!isEditable(pin, line, index.column())) return false;
+  const QString text = value.toString();
+  switch (index.column()) {
+    case PortsCol:
+      assign(pin, line, text);
+      return true;
+    case ModeCol:
+      m_model->packagePinModel()->updateMode(pinName(pin), text);
+      break;
+    case InternalPinCol:
+      m_model->packagePinModel()->updateInternalPin(
+          m_pins.at(pin).ports.at(line), text);
+      break;
+    default:
+      return false;
+  }
+  emit selectionHasChanged();
+  return true;
+}
+
+Qt::ItemFlags PackagePinsItemModel::flags(const QModelIndex &index) const {
+  Qt::ItemFlags flags = QAbstractItemModel::flags(index);
+  int pin{0};
+  int line{0};
+  if (lineFromIndex(index, pin, line) && isEditable(pin, line, index.column()))
+    flags |= Qt::ItemIsEditable;
+  return flags;
+}
+
+QVariant PackagePinsItemModel::headerData(int section,
+                                          Qt::Orientation orientation,
+                                          int role) const {
+  if (orientation != Qt::Horizontal) return QVariant{};
+  for (const auto &h : m_model->packagePinModel()->header()) {
+    if (h.id != section) continue;
+    if (role == Qt::DisplayRole) return h.name;
+    if (role == Qt::ToolTipRole) return h.description;
+  }
+  return QVariant{};
+}
+
+void PackagePinsItemModel::setPort(const QString &pin, const QString &port,
+                                   int row) {
+  if (pin.isEmpty() || row < 0) return;
+  const int index = m_pinIndex.value(pin, -1);
+  if (index == -1) return;
+  ensureLines(index, row + 1);
+  assign(index, row, port);
+}
+
+void PackagePinsItemModel::setMode(const QString &pin, const QString &mode) {
+  const int index = m_pinIndex.value(pin, -1);
+  if (index == -1) return;
+  const auto &ports = m_pins.at(index).ports;
+  for (int line = 0; line < ports.count(); line++) {
+    if (!isEditable(index, line, ModeCol)) continue;
+    if (choices(index, line, ModeCol).contains(mode)) {
+      m_model->packagePinModel()->updateMode(pin, mode);
+      emit selectionHasChanged();
+    }
+    break;
+  }
+}
+
+void PackagePinsItemModel::setInternalPin(const QString &port,
+                                          const QString &intPin) {
+  auto location = m_portLocation.constFind(port);
+  if (location == m_portLocation.constEnd()) return;
+  const auto [pin, line] = *location;
+  if (!isEditable(pin, line, InternalPinCol)) return;
+  if (choices(pin, line, InternalPinCol).contains(intPin)) {
+    m_model->packagePinModel()->updateInternalPin(port, intPin);
+    emit selectionHasChanged();
+  }
+}
+
+bool PackagePinsItemModel::addLine(const QModelIndex &index) {
+  const int pin = pinFromIndex(index);
+  if (pin == -1 || isPinId(index.internalId()) || !canAddLine(pin))
+    return false;
+  if (m_pins.at(pin).split)
+    ensureLines(pin, m_pins.at(pin).ports.count() + 1);
+  else
+    setSplit(pin, true);
+  const QModelIndex name = pinIndex(pin, NameCol);
+  emit dataChanged(name, name, {Qt::DecorationRole});
+  return true;
+}
+
+void PackagePinsItemModel::removeLine(const QModelIndex &index) {
+  int pin{0};
+  int line{0};
+  if (!isPinId(index.internalId()) || !lineFromIndex(index, pin, line)) return;
+  PinItem &item = m_pins[pin];
+  if (item.ports.count() == 1) {
+    setSplit(pin, false);  // last line moves back to the pin
+  } else {
+    const QString name = pinName(pin);
+    const QString port = item.ports.at(line);
+    m_blockUpdate = true;
+    m_model->beginUpdate();
+    if (!port.isEmpty()) {
+      m_portLocation.remove(port);
+      if (!m_model->packagePinModel()->internalPin(port).isEmpty())
+        m_model->packagePinModel()->updateInternalPin(port, QString{});
+      m_model->remove(port, name, line);
+    }
+    beginRemoveRows(pinIndex(pin), line, line);
+    item.ports.removeAt(line);
+    endRemoveRows();
+    // following lines moved up, keep assignment index in sync
+    for (int i = line; i < item.ports.count(); i++) {
+      const QString &p = item.ports.at(i);
+      if (p.isEmpty()) continue;
+      m_portLocation.insert(p, {pin, i});
+      m_model->update(p, name, i);
+    }
+    m_model->endUpdate();
+    m_blockUpdate = false;
+    if (!hasPorts(pin) &&
+        !m_model->packagePinModel()->getMode(name).isEmpty())
+      m_model->packagePinModel()->updateMode(name, QString{});
+    emit selectionHasChanged();
+  }
+  const QModelIndex name = pinIndex(pin, NameCol);
+  emit dataChanged(name, name, {Qt::DecorationRole});
+}
+
+void PackagePinsItemModel::clear() {
+  beginResetModel();
+  m_blockUpdate = true;
+  m_model->beginUpdate();
+  auto packagePinModel = m_model->packagePinModel();
+  const auto ports = m_model->pinMap().keys();
+  for (const auto &port : ports) {
+    if (!packagePinModel->internalPin(port).isEmpty())
+      packagePinModel->updateInternalPin(port, QString{});
+    m_model->update(port, QString{}, -1);
+  }
+  const auto pins = packagePinModel->modeMap().keys();
+  for (const auto &pin : pins) packagePinModel->updateMode(pin, QString{});
+  for (auto &item : m_pins) {
+    item.ports = QStringList{QString{}};
+    item.split = false;
+  }
+  m_portLocation.clear();
+  m_model->endUpdate();
+  m_blockUpdate = false;
+  endResetModel();
+}
+
+void PackagePinsItemModel::modeChanged(const QString &pin, const QString &) {
+  if (m_blockUpdate) return;
+  const int index = m_pinIndex.value(pin, -1);
+  if (index == -1) return;
+  for (int line = 0; line < m_pins.at(index).ports.count(); line++)
+    updateLine(index, line);
+}
+
+void PackagePinsItemModel::internalPinChanged(const QString &port,
+                                              const QString &) {
+  if (m_blockUpdate) return;
+  auto location = m_portLocation.constFind(port);
+  if (location != m_portLocation.constEnd())
+    updateLine(location->pin, location->line);
+}
+
+void PackagePinsItemModel::portAssignmentChanged(const QString &port,
+                                                 const QString &, int) {
+  if (!m_blockUpdate) syncPort(port);
+}
+
+void PackagePinsItemModel::portAssignmentsChanged(const QStringList &ports) {
+  if (m_blockUpdate) return;
+  for (const auto &port : ports) syncPort(port);
+}
+
+bool PackagePinsItemModel::isBankId(quintptr id) const {
+  return id >= FirstBankId && id < FirstBankId + m_bankOffset.count();
+}
+
+bool PackagePinsItemModel::isPinId(quintptr id) const {
+  return id >= FirstBankId + m_bankOffset.count();
+}
+
+int PackagePinsItemModel::pinFromIndex(const QModelIndex &index) const {
+  const quintptr id = index.internalId();
+  if (isBankId(id)) return m_bankOffset.at(id - FirstBankId) + index.row();
+  if (isPinId(id)) return id - FirstBankId - m_bankOffset.count();
+  return -1;
+}
+
+bool PackagePinsItemModel::lineFromIndex(const QModelIndex &index, int &pin,
+                                         int &line) const {
+  if (!index.isValid()) return false;
+  const quintptr id = index.internalId();
+  if (isBankId(id)) {
+    pin = pinFromIndex(index);
+    line = 0;
+    return !m_pins.at(pin).split;
+  }
+  if (isPinId(id)) {
+    pin = pinFromIndex(index);
+    line = index.row();
+    return true;
+  }
+  return false;
+}
+
+QModelIndex PackagePinsItemModel::pinIndex(int pin, int column) const {
+  const PinItem &item = m_pins.at(pin);
+  if (!m_fetched.at(item.bank)) return QModelIndex{};
+  return createIndex(item.row, column, FirstBankId + item.bank);
+}
+
+QModelIndex PackagePinsItemModel::lineIndex(int pin, int line,
+                                            int column) const {
+  if (!m_pins.at(pin).split)
+    return (line == 0) ? pinIndex(pin, column) : QModelIndex{};
+  if (!pinIndex(pin).isValid()) return QModelIndex{};
+  return createIndex(line, column,
+                     FirstBankId + m_bankOffset.count() + pin);
+}
+
+const QStringList &PackagePinsItemModel::pinData(int pin) const {
+  const PinItem &item = m_pins.at(pin);
+  const auto &banks = m_model->packagePinModel()->pinData();
+  return banks.at(item.bank).pinData.at(item.row).data;
+}
+
+QString PackagePinsItemModel::pinName(int pin) const {
+  return pinData(pin).value(PinName);
+}
+
+bool PackagePinsItemModel::canAddLine(int pin) const {
+  const PinItem &item = m_pins.at(pin);
+  return !item.split || item.ports.count() < m_maxRows;
+}
+
+bool PackagePinsItemModel::isEditable(int pin, int line, int column) const {
+  const QString &port = m_pins.at(pin).ports.at(line);
+  switch (column) {
+    case PortsCol:
+      return true;
+    case ModeCol:
+      return !port.isEmpty();
+    case InternalPinCol:
+      return !port.isEmpty() &&
+             !m_model->packagePinModel()->getMode(pinName(pin)).isEmpty();
+  }
+  return false;
+}
+
+QStringList PackagePinsItemModel::choices(int pin, int line,
+                                          int column) const {
+  auto packagePinModel = m_model->packagePinModel();
+  const QString &port = m_pins.at(pin).ports.at(line);
+  switch (column) {
+    case PortsCol:
+      return m_model->portsModel()->listModel()->stringList();
+    case ModeCol: {
+      const bool output = m_model->portsModel()->GetPort(port).dir == "Output";
+      return output ? packagePinModel->modeModelTx()->stringList()
+                    : packagePinModel->modeModelRx()->stringList();
+    }
+    case InternalPinCol: {
+      const QString name = pinName(pin);
+      QStringList list{{""}};
+      list.append(packagePinModel->GetInternalPinsList(
+          name, packagePinModel->getMode(name),
+          packagePinModel->internalPin(port)));
+      return list;
+    }
+  }
+  return QStringList{};
+}
+
+bool PackagePinsItemModel::hasPorts(int pin) const {
+  for (const auto &port : m_pins.at(pin).ports)
+    if (!port.isEmpty()) return true;
+  return false;
+}
+
+void PackagePinsItemModel::syncPort(const QString &port) {
+  // changed from outside (e.g. ports table), follow the base model
+  auto location = m_portLocation.constFind(port);
+  const auto assignment = m_model->pinMap().constFind(port);
+  int pin{-1};
+  int line{0};
+  if (assignment != m_model->pinMap().constEnd()) {
+    pin = m_pinIndex.value(assignment->first, -1);
+    line = std::max(0, assignment->second);
+  }
+  if (location != m_portLocation.constEnd()) {
+    if (location->pin == pin && location->line == line) return;
+    place(location->pin, location->line, QString{});
+  }
+  if (pin == -1) return;
+  ensureLines(pin, line + 1);
+  place(pin, line, port);
+}
+
+void PackagePinsItemModel::assign(int pin, int line, const QString &port) {
+  const QString prevPort = m_pins.at(pin).ports.at(line);
+  if (prevPort == port) return;
+  // port can be assigned only once
+  auto location = m_portLocation.constFind(port);
+  if (!port.isEmpty() && location != m_portLocation.constEnd()) {
+    const Location other = *location;
+    assign(other.pin, other.line, QString{});
+  }
+
+  auto packagePinModel = m_model->packagePinModel();
+  const QString name = pinName(pin);
+  place(pin, line, port);
+  m_blockUpdate = true;
+  if (!prevPort.isEmpty()) {
+    if (!packagePinModel->internalPin(prevPort).isEmpty())
+      packagePinModel->updateInternalPin(prevPort, QString{});
+    m_model->update(prevPort, QString{}, line);
+  }
+  m_model->update(port, name, line);
+  m_blockUpdate = false;
+  if (!hasPorts(pin) && !packagePinModel->getMode(name).isEmpty())
+    packagePinModel->updateMode(name, QString{});
+  emit selectionHasChanged();
+}
+
+void PackagePinsItemModel::place(int pin, int line, const QString &port) {
+  QString &current = m_pins[pin].ports[line];
+  auto location = m_portLocation.find(current);
+  if (location != m_portLocation.end() && location->pin == pin &&
+      location->line == line)
+    m_portLocation.erase(location);
+  current = port;
+  if (!port.isEmpty()) m_portLocation.insert(port, {pin, line});
+  updateLine(pin, line);
+}
+
+void PackagePinsItemModel::ensureLines(int pin, int count) {
+  if (count > 1) setSplit(pin, true);
+  PinItem &item = m_pins[pin];
+  if (item.ports.count() >= count) return;
+  const QModelIndex parent = pinIndex(pin);
+  if (parent.isValid()) beginInsertRows(parent, item.ports.count(), count - 1);
+  while (item.ports.count() < count) item.ports.append(QString{});
+  if (parent.isValid()) endInsertRows();
+}
+
+void PackagePinsItemModel::setSplit(int pin, bool split) {
+  PinItem &item = m_pins[pin];
+  if (item.split == split) return;
+  const QModelIndex parent = pinIndex(pin);
+  if (parent.isValid()) {
+    if (split)
+      beginInsertRows(parent, 0, item.ports.count() - 1);
+    else
+      beginRemoveRows(parent, 0, item.ports.count() - 1);
+  }
+  item.split = split;
+  if (parent.isValid()) {
+    if (split)
+      endInsertRows();
+    else
+      endRemoveRows();
+    emit dataChanged(pinIndex(pin, NameCol), pinIndex(pin, InternalPinCol));
+  }
+}
+
+void PackagePinsItemModel::updateLine(int pin, int line) {
+  const QModelIndex first = lineIndex(pin, line, PortsCol);
+  if (first.isValid())
+    emit dataChanged(first, lineIndex(pin, line, InternalPinCol));
+}
+
+}  // namespace FOEDAG
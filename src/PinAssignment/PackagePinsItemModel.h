@@ -0,0 +1,127 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QIcon>
+#include <QVector>
+
+namespace FOEDAG {
+
+class PinsBaseModel;
+
+/*!
+ * \brief The PackagePinsItemModel class
+ * Tree model of the package pin table: All Pins -> banks -> pins -> extra
+ * port assignment lines. Pin data is read from PackagePinsModel on demand and
+ * only port assignments are kept here. Pins of the bank are exposed when the
+ * bank is expanded for the first time.
+ */
+class PackagePinsItemModel : public QAbstractItemModel {
+  Q_OBJECT
+ public:
+  static constexpr int NameCol{0};
+  static constexpr int AvailCol{1};
+  static constexpr int PortsCol{2};
+  static constexpr int ModeCol{3};
+  static constexpr int InternalPinCol{4};
+
+  PackagePinsItemModel(PinsBaseModel *model, QObject *parent = nullptr);
+
+  QModelIndex index(int row, int column,
+                    const QModelIndex &parent = QModelIndex()) const override;
+  QModelIndex parent(const QModelIndex &index) const override;
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+  bool canFetchMore(const QModelIndex &parent) const override;
+  void fetchMore(const QModelIndex &parent) override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  bool setData(const QModelIndex &index, const QVariant &value,
+               int role = Qt::EditRole) override;
+  Qt::ItemFlags flags(const QModelIndex &index) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+
+  void setPort(const QString &pin, const QString &port, int row);
+  void setMode(const QString &pin, const QString &mode);
+  void setInternalPin(const QString &port, const QString &intPin);
+  bool addLine(const QModelIndex &index);
+  void removeLine(const QModelIndex &index);
+  void clear();
+
+ signals:
+  void selectionHasChanged();
+
+ private slots:
+  void modeChanged(const QString &pin, const QString &mode);
+  void internalPinChanged(const QString &port, const QString &intPin);
+  void portAssignmentChanged(const QString &port, const QString &pin, int row);
+  void portAssignmentsChanged(const QStringList &ports);
+
+ private:
+  struct PinItem {
+    int bank;
+    int row;
+    QStringList ports;  // one per assignment line
+    bool split{false};  // lines are shown as children of the pin
+  };
+  struct Location {
+    int pin;
+    int line;
+  };
+
+  bool isBankId(quintptr id) const;
+  bool isPinId(quintptr id) const;
+  int pinFromIndex(const QModelIndex &index) const;
+  bool lineFromIndex(const QModelIndex &index, int &pin, int &line) const;
+  QModelIndex pinIndex(int pin, int column = 0) const;
+  QModelIndex lineIndex(int pin, int line, int column) const;
+  const QStringList &pinData(int pin) const;
+  QString pinName(int pin) const;
+  bool canAddLine(int pin) const;
+  bool isEditable(int pin, int line, int column) const;
+  QStringList choices(int pin, int line, int column) const;
+  bool hasPorts(int pin) const;
+
+  void syncPort(const QString &port);
+  void assign(int pin, int line, const QString &port);
+  void place(int pin, int line, const QString &port);
+  void ensureLines(int pin, int count);
+  void setSplit(int pin, bool split);
+  void updateLine(int pin, int line);
+
+ private:
+  PinsBaseModel *m_model{nullptr};
+  const int m_maxRows{};
+  QVector<PinItem> m_pins;
+  QVector<int> m_bankOffset;  // index in m_pins of the first pin of the bank
+  QVector<bool> m_fetched;
+  QHash<QString, int> m_pinIndex;
+  QHash<QString, Location> m_portLocation;
+  QIcon m_addIcon;
+  QIcon m_removeIcon;
+  bool m_blockUpdate{false};
+};
+
+}  // namespace FOEDAG
@@ -46,6 +46,17 @@ void PackagePinsModel::updateMode(const QString &pin, const QString &mode) {
     m_modeMap.insert(pin, mode);
     if (currentMode != mode) emit modeHasChanged(pin, mode);
   }
+  // internal pins are available per mode, drop the ones not valid anymore
+  if (m_baseModel) {
+    const auto available =
+        m_internalPinsData.value(pin).value(m_modes.value(mode));
+    const auto ports = m_baseModel->getPort(pin);
+    for (const auto &port : ports) {
+      const auto intPin = m_internalPinMap.value(port);
+      if (!intPin.isEmpty() && (mode.isEmpty() || !available.contains(intPin)))
+        updateInternalPin(port, QString{});
+    }
+  }
 }
 
 QString PackagePinsModel::getMode(const QString &pin) const {
@@ -113,7 +113,7 @@ class PackagePinsModel : public QObject {
   QMap<QString, QString> m_internalPinMap;
   QMap<QString, int> m_modes;
   InternalPins m_internalPinsData;  // <PinName, <ModeId, InternalPins>>
-  PinsBaseModel *m_baseModel;
+  PinsBaseModel *m_baseModel{nullptr};
 };
 
 }  // namespace FOEDAG
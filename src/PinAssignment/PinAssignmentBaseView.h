@@ -20,35 +20,25 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
-#include <QSet>
-#include <QTreeWidget>
+#include <QTreeView>
 
-class QComboBox;
 namespace FOEDAG {
 
 class PinsBaseModel;
+class PinAssignmentDelegate;
 
 /*!
  * \brief The PinAssignmentBaseView class
  * The implemenation provide common funtionality to Package pin table and Ports
- * table.
+ * table. Cells are edited with combo box created by PinAssignmentDelegate.
  */
-class PinAssignmentBaseView : public QTreeWidget {
+class PinAssignmentBaseView : public QTreeView {
  public:
   PinAssignmentBaseView(PinsBaseModel *model, QWidget *parent = nullptr);
-  ~PinAssignmentBaseView();
-
- protected:
-  void removeDuplications(const QString &text, QComboBox *current);
-  QModelIndexList match(const QString &text) const;
-  QModelIndexList indexFromText(QTreeWidgetItem *i, const QString &text) const;
-  void updateInternalPinSelection(const QString &pin, QComboBox *combo);
 
  protected:
   PinsBaseModel *m_model{nullptr};
-  QMap<QComboBox *, QModelIndex> m_allCombo;
-  bool m_blockUpdate{false};
-  QMap<QString, QSet<QComboBox *>> m_intPins;
+  PinAssignmentDelegate *m_delegate{nullptr};
 };
 
 }  // namespace FOEDAG
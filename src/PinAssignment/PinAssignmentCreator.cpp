@@ -148,6 +148,7 @@ void PinAssignmentCreator::parseConstraints(const QStringList &commands,
   // port is selected.
   QVector<QStringList> internalPins;
   QMap<QString, int> indx{};
+  m_baseModel->beginUpdate();
   for (const auto &cmd : commands) {
     if (cmd.startsWith("set_pin_loc")) {
       auto list = QtUtils::StringSplit(cmd, ' ');
@@ -168,6 +169,7 @@ void PinAssignmentCreator::parseConstraints(const QStringList &commands,
   for (const auto &intPins : internalPins) {
     packagePins->SetInternalPin(intPins.at(1), intPins.at(3));
   }
+  m_baseModel->endUpdate();
 }
 
 QString PinAssignmentCreator::searchPortsFile(const QString &projectPath) {
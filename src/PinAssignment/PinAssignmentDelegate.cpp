@@ -0,0 +1,96 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "PinAssignmentDelegate.h"
+
+#include <QApplication>
+#include <QComboBox>
+#include <QCompleter>
+#include <QMouseEvent>
+#include <QStringListModel>
+
+namespace FOEDAG {
+
+PinAssignmentDelegate::PinAssignmentDelegate(QObject *parent)
+    : QStyledItemDelegate(parent) {}
+
+QWidget *PinAssignmentDelegate::createEditor(QWidget *parent,
+                                             const QStyleOptionViewItem &,
+                                             const QModelIndex &index) const {
+  auto combo = new QComboBox{parent};
+  combo->setAutoFillBackground(true);
+  combo->setModel(
+      new QStringListModel{index.data(ChoicesRole).toStringList(), combo});
+  if (index.data(SearchRole).toBool()) {
+    combo->setEditable(true);
+    combo->setInsertPolicy(QComboBox::NoInsert);
+    auto completer{new QCompleter{combo->model(), combo}};
+    completer->setFilterMode(Qt::MatchContains);
+    combo->setCompleter(completer);
+  }
+  // apply selection immediately, as it was with the combo box in the cell
+  connect(combo, QOverload<int>::of(&QComboBox::activated), this,
+          [this, combo]() {
+            emit const_cast<PinAssignmentDelegate *>(this)->commitData(combo);
+          });
+  return combo;
+}
+
+void PinAssignmentDelegate::setEditorData(QWidget *editor,
+                                          const QModelIndex &index) const {
+  auto combo = qobject_cast<QComboBox *>(editor);
+  if (!combo) return;
+  const int row = combo->findText(index.data(Qt::EditRole).toString());
+  combo->setCurrentIndex(row);
+}
+
+void PinAssignmentDelegate::setModelData(QWidget *editor,
+                                         QAbstractItemModel *model,
+                                         const QModelIndex &index) const {
+  auto combo = qobject_cast<QComboBox *>(editor);
+  if (!combo) return;
+  const QString text = combo->currentText();
+  if (combo->findText(text) == -1) return;  // typed text is not an item
+  if (text != index.data(Qt::EditRole).toString())
+    model->setData(index, text, Qt::EditRole);
+}
+
+bool PinAssignmentDelegate::editorEvent(QEvent *event,
+                                        QAbstractItemModel *model,
+                                        const QStyleOptionViewItem &option,
+                                        const QModelIndex &index) {
+  if (event->type() == QEvent::MouseButtonRelease &&
+      !index.data(Qt::DecorationRole).isNull()) {
+    QStyleOptionViewItem opt{option};
+    initStyleOption(&opt, index);
+    const QStyle *style =
+        opt.widget ? opt.widget->style() : QApplication::style();
+    const QRect button =
+        style->subElementRect(QStyle::SE_ItemViewItemDecoration, &opt,
+                              opt.widget);
+    if (button.contains(static_cast<QMouseEvent *>(event)->pos())) {
+      emit buttonClicked(index);
+      return true;
+    }
+  }
+  return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
+
+}  // namespace FOEDAG
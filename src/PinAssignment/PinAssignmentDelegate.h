@@ -0,0 +1,57 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <QStyledItemDelegate>
+
+namespace FOEDAG {
+
+// Roles used by the pin assignment item models to set up the cell editor
+enum PinAssignmentRole {
+  ChoicesRole = Qt::UserRole + 1,  // QStringList of the combo box items
+  SearchRole,  // bool, the combo box is editable and filters its items
+};
+
+/*!
+ * \brief The PinAssignmentDelegate class
+ * Creates combo box editor only for the cell being edited. Cells with
+ * decoration act as a button and emit buttonClicked().
+ */
+class PinAssignmentDelegate : public QStyledItemDelegate {
+  Q_OBJECT
+ public:
+  explicit PinAssignmentDelegate(QObject *parent = nullptr);
+  QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                        const QModelIndex &index) const override;
+  void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+  void setModelData(QWidget *editor, QAbstractItemModel *model,
+                    const QModelIndex &index) const override;
+
+ signals:
+  void buttonClicked(const QModelIndex &index);
+
+ protected:
+  bool editorEvent(QEvent *event, QAbstractItemModel *model,
+                   const QStyleOptionViewItem &option,
+                   const QModelIndex &index) override;
+};
+
+}  // namespace FOEDAG
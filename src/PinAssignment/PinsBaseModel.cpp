@@ -25,51 +25,57 @@ namespace FOEDAG {
 PinsBaseModel::PinsBaseModel(QObject *parent) : QObject(parent) {}
 
 bool PinsBaseModel::exists(const QString &port, const QString &pin) const {
-  for (auto it = m_pinsMap.constBegin(); it != m_pinsMap.constEnd(); ++it) {
-    if (it.key() == port && it.value().first == pin) return true;
-  }
-  return false;
+  auto it = m_pinsMap.constFind(port);
+  return it != m_pinsMap.constEnd() && it.value().first == pin;
 }
 
 void PinsBaseModel::update(const QString &port, const QString &pin, int index) {
   if (port.isEmpty()) return;
   if (pin.isEmpty()) {
     auto values = m_pinsMap.value(port);
-    m_pinsMap.remove(port);
-    emit portAssignmentChanged(port, values.first, values.second);
+    erase(port);
+    notify(port, values.first, values.second);
   } else {
     auto pinPair = m_pinsMap.value(port);
     bool changed = (pinPair.first != pin || pinPair.second != index);
-    m_pinsMap.insert(port, std::make_pair(pin, index));
-    if (changed) emit portAssignmentChanged(port, pin, index);
+    if (changed) {
+      erase(port);
+      insert(port, pin, index);
+      notify(port, pin, index);
+    }
   }
 }
 
 void PinsBaseModel::remove(const QString &port, const QString &pin, int index) {
-  m_pinsMap.remove(port);
-  emit portAssignmentChanged(port, QString{}, index);
+  erase(port);
+  notify(port, QString{}, index);
 }
 
 QStringList PinsBaseModel::getPort(const QString &pin) const {
-  QStringList ports;
-  for (auto it{m_pinsMap.begin()}; it != m_pinsMap.end(); ++it) {
-    if (it.value().first == pin) ports.append(it.key());
-  }
-  return ports;
+  auto it = m_pinPorts.constFind(pin);
+  return (it != m_pinPorts.constEnd()) ? it.value().keys() : QStringList{};
 }
 
 int PinsBaseModel::getIndex(const QString &pin) const {
-  QVector<int> indexes;
-  for (auto it{m_pinsMap.begin()}; it != m_pinsMap.end(); ++it) {
-    if (it.value().first == pin) {
-      indexes.append(it.value().second);
-    }
+  // first index not used by the pin
+  int index{0};
+  const auto indexes = m_pinIndexes.value(pin);
+  for (auto it{indexes.constBegin()}; it != indexes.constEnd(); ++it) {
+    if (it.key() < index) continue;
+    if (it.key() != index) break;
+    index++;
   }
-  std::sort(indexes.begin(), indexes.end());
-  for (int i = 0; i < indexes.count(); i++) {
-    if (i != indexes.at(i)) return i;
-  }
-  return indexes.count();
+  return index;
+}
+
+void PinsBaseModel::beginUpdate() { m_updateLevel++; }
+
+void PinsBaseModel::endUpdate() {
+  if (m_updateLevel == 0 || --m_updateLevel != 0) return;
+  if (m_changedPorts.isEmpty()) return;
+  const QStringList ports = m_changedPorts.values();
+  m_changedPorts.clear();
+  emit portAssignmentsChanged(ports);
 }
 
 PackagePinsModel *PinsBaseModel::packagePinModel() const {
@@ -90,4 +96,38 @@ const QMap<QString, std::pair<QString, int> > &PinsBaseModel::pinMap() const {
   return m_pinsMap;
 }
 
+void PinsBaseModel::insert(const QString &port, const QString &pin,
+                           int index) {
+  m_pinsMap.insert(port, std::make_pair(pin, index));
+  m_pinPorts[pin].insert(port, index);
+  m_pinIndexes[pin][index]++;
+}
+
+void PinsBaseModel::erase(const QString &port) {
+  auto it = m_pinsMap.find(port);
+  if (it == m_pinsMap.end()) return;
+  const auto [pin, index] = it.value();
+  m_pinsMap.erase(it);
+  auto ports = m_pinPorts.find(pin);
+  if (ports != m_pinPorts.end()) {
+    ports.value().remove(port);
+    if (ports.value().isEmpty()) m_pinPorts.erase(ports);
+  }
+  auto indexes = m_pinIndexes.find(pin);
+  if (indexes != m_pinIndexes.end()) {
+    auto used = indexes.value().find(index);
+    if (used != indexes.value().end() && --used.value() == 0)
+      indexes.value().erase(used);
+    if (indexes.value().isEmpty()) m_pinIndexes.erase(indexes);
+  }
+}
+
+void PinsBaseModel::notify(const QString &port, const QString &pin,
+                           int row) {
+  if (m_updateLevel != 0)
+    m_changedPorts.insert(port);
+  else
+    emit portAssignmentChanged(port, pin, row);
+}
+
 }  // namespace FOEDAG
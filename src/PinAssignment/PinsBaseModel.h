@@ -19,7 +19,9 @@ You should have received a copy of the GNU General Public License
 along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
+#include <QHash>
 #include <QObject>
+#include <QSet>
 #include <QStringList>
 #include <QVector>
 
@@ -40,6 +42,14 @@ class PinsBaseModel : public QObject {
   QStringList getPort(const QString &pin) const;
   int getIndex(const QString &pin) const;
 
+  /*!
+   * \brief beginUpdate/endUpdate group several update() and remove() calls.
+   * Single portAssignmentsChanged() signal is emitted by the outermost
+   * endUpdate() instead of portAssignmentChanged() per port.
+   */
+  void beginUpdate();
+  void endUpdate();
+
   PackagePinsModel *packagePinModel() const;
   void setPackagePinModel(PackagePinsModel *newPackagePinModel);
 
@@ -50,9 +60,21 @@ class PinsBaseModel : public QObject {
 
  signals:
   void portAssignmentChanged(const QString &port, const QString &pin, int row);
+  void portAssignmentsChanged(const QStringList &ports);
+
+ private:
+  void insert(const QString &port, const QString &pin, int index);
+  void erase(const QString &port);
+  void notify(const QString &port, const QString &pin, int row);
 
  private:
   QMap<QString, std::pair<QString, int>> m_pinsMap;  // key - port, value - pin
+  // reverse index, key - pin, value - ports with their index
+  QHash<QString, QMap<QString, int>> m_pinPorts;
+  // key - pin, value - used indexes and how many ports use them
+  QHash<QString, QMap<int, int>> m_pinIndexes;
+  int m_updateLevel{0};
+  QSet<QString> m_changedPorts;
   PackagePinsModel *m_packagePinModel;
   PortsModel *m_portsModel;
 };
@@ -0,0 +1,296 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "PortsItemModel.h"
+
+#include "PinAssignmentDelegate.h"
+#include "PinsBaseModel.h"
+
+namespace FOEDAG {
+
+// Internal id of the index is the id of its parent node: RootId for
+// "Design ports", TopId for ports and buses, FirstItemId + bus row for the
+// bus ports.
+constexpr quintptr RootId{0};
+constexpr quintptr TopId{1};
+constexpr quintptr FirstItemId{2};
+
+PortsItemModel::PortsItemModel(PinsBaseModel *model, QObject *parent)
+    : QAbstractItemModel(parent), m_model(model) {
+  const auto &groups = model->portsModel()->ports();
+  for (int group = 0; group < groups.count(); group++) {
+    const auto &ports = groups.at(group).ports;
+    for (int p = 0; p < ports.count(); p++) {
+      m_portIndex.insert(ports.at(p).name, m_topLevel.count());
+      m_topLevel.append(std::make_pair(group, p));
+    }
+  }
+  connect(model->packagePinModel(), &PackagePinsModel::modeHasChanged, this,
+          &PortsItemModel::modeChanged);
+  connect(model->packagePinModel(), &PackagePinsModel::internalPinHasChanged,
+          this, &PortsItemModel::internalPinChanged);
+  connect(model, &PinsBaseModel::portAssignmentChanged, this,
+          &PortsItemModel::portAssignmentChanged);
+  connect(model, &PinsBaseModel::portAssignmentsChanged, this,
+          &PortsItemModel::portAssignmentsChanged);
+}
+
+QModelIndex PortsItemModel::index(int row, int column,
+                                  const QModelIndex &parent) const {
+  if (!hasIndex(row, column, parent)) return QModelIndex{};
+  if (!parent.isValid()) return createIndex(row, column, RootId);
+  if (parent.internalId() == RootId) return createIndex(row, column, TopId);
+  return createIndex(row, column, FirstItemId + parent.row());
+}
+
+QModelIndex PortsItemModel::parent(const QModelIndex &index) const {
+  if (!index.isValid()) return QModelIndex{};
+  const quintptr id = index.internalId();
+  if (id == RootId) return QModelIndex{};
+  if (id == TopId) return createIndex(0, 0, RootId);
+  return createIndex(id - FirstItemId, 0, TopId);
+}
+
+int PortsItemModel::rowCount(const QModelIndex &parent) const {
+  if (!parent.isValid()) return 1;
+  if (parent.column() != 0) return 0;
+  if (parent.internalId() == RootId) return m_topLevel.count();
+  if (parent.internalId() == TopId)
+    return topLevelPort(parent.row()).busWidth();
+  return 0;
+}
+
+int PortsItemModel::columnCount(const QModelIndex &) const {
+  return m_model->portsModel()->headerList().count();
+}
+
+QVariant PortsItemModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid()) return QVariant{};
+  const int column = index.column();
+  if (index.internalId() == RootId) {
+    if (role == Qt::DisplayRole && column == PortName)
+      return QString{"Design ports"};
+    return QVariant{};
+  }
+
+  const IOPort port = this->port(index);
+  if (port.isBus) {
+    if (role == Qt::DisplayRole && column == PortName) return port.name;
+    return QVariant{};
+  }
+  switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole: {
+      if (column == PortName) return port.name;
+      if (column == DirCol) return port.dir;
+      if (column == TypeCol) return port.type;
+      const QString packagePin = pin(port);
+      if (column == PackagePinCol) return packagePin;
+      if (packagePin.isEmpty()) return QVariant{};
+      if (column == ModeCol)
+        return m_model->packagePinModel()->getMode(packagePin);
+      if (column == InternalPinsCol)
+        return m_model->packagePinModel()->internalPin(port.name);
+      return QVariant{};
+    }
+    case ChoicesRole:
+      return choices(port, column);
+    case SearchRole:
+      return column == PackagePinCol;
+  }
+  return QVariant{};
+}
+
+bool PortsItemModel::setData(const QModelIndex &index, const QVariant &value,
+                             int role) {
+  if (role != Qt::EditRole || !index.isValid()) return false;
+  if (index.internalId() == RootId) return false;
+  const IOPort port = this->port(index);
+  if (!isEditable(port, index.column())) return false;
+  const QString text = value.toString();
+  switch (index.column()) {
+    case PackagePinCol:
+      setPin(port.name, text);
+      return true;
+    case ModeCol:
+      m_model->packagePinModel()->updateMode(pin(port), text);
+      break;
+    case InternalPinsCol:
+      m_model->packagePinModel()->updateInternalPin(port.name, text);
+      break;
+    default:
+      return false;
+  }
+  emit selectionHasChanged();
+  return true;
+}
+
+Qt::ItemFlags PortsItemModel::flags(const QModelIndex &index) const {
+  Qt::ItemFlags flags = QAbstractItemModel::flags(index);
+  if (index.isValid() && index.internalId() != RootId &&
+      isEditable(port(index), index.column()))
+    flags |= Qt::ItemIsEditable;
+  return flags;
+}
+
+QVariant PortsItemModel::headerData(int section, Qt::Orientation orientation,
+                                    int role) const {
+  if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+    return m_model->portsModel()->headerList().value(section);
+  return QVariant{};
+}
+
+void PortsItemModel::setPin(const QString &port, const QString &pin) {
+  const IOPort ioPort = m_model->portsModel()->GetPort(port);
+  if (ioPort.name.isEmpty() || ioPort.isBus) return;
+  auto packagePinModel = m_model->packagePinModel();
+  const QString prevPin = m_model->pinMap().value(port).first;
+  if (prevPin == pin) return;
+  m_model->beginUpdate();
+  // package pin selected here is used by this port only
+  if (!pin.isEmpty()) {
+    const auto ports = m_model->getPort(pin);
+    for (const auto &p : ports) {
+      if (!packagePinModel->internalPin(p).isEmpty())
+        packagePinModel->updateInternalPin(p, QString{});
+      m_model->update(p, QString{}, -1);
+    }
+  }
+  if (!packagePinModel->internalPin(port).isEmpty())
+    packagePinModel->updateInternalPin(port, QString{});
+  m_model->update(port, pin, pin.isEmpty() ? -1 : m_model->getIndex(pin));
+  m_model->endUpdate();
+  if (!prevPin.isEmpty() && m_model->getPort(prevPin).isEmpty() &&
+      !packagePinModel->getMode(prevPin).isEmpty())
+    packagePinModel->updateMode(prevPin, QString{});
+  emit selectionHasChanged();
+}
+
+void PortsItemModel::clear() {
+  beginResetModel();
+  m_blockUpdate = true;
+  m_model->beginUpdate();
+  auto packagePinModel = m_model->packagePinModel();
+  const auto ports = m_model->pinMap().keys();
+  for (const auto &port : ports) {
+    if (!packagePinModel->internalPin(port).isEmpty())
+      packagePinModel->updateInternalPin(port, QString{});
+    m_model->update(port, QString{}, -1);
+  }
+  const auto pins = packagePinModel->modeMap().keys();
+  for (const auto &pin : pins) packagePinModel->updateMode(pin, QString{});
+  m_model->endUpdate();
+  m_blockUpdate = false;
+  endResetModel();
+}
+
+void PortsItemModel::modeChanged(const QString &pin, const QString &) {
+  if (m_blockUpdate || pin.isEmpty()) return;
+  const auto ports = m_model->getPort(pin);
+  for (const auto &port : ports) updatePort(port);
+}
+
+void PortsItemModel::internalPinChanged(const QString &port, const QString &) {
+  if (!m_blockUpdate) updatePort(port);
+}
+
+void PortsItemModel::portAssignmentChanged(const QString &port,
+                                           const QString &, int) {
+  if (!m_blockUpdate) updatePort(port);
+}
+
+void PortsItemModel::portAssignmentsChanged(const QStringList &ports) {
+  if (m_blockUpdate) return;
+  for (const auto &port : ports) updatePort(port);
+}
+
+const IOPort &PortsItemModel::topLevelPort(int row) const {
+  const auto &item = m_topLevel.at(row);
+  return m_model->portsModel()->ports().at(item.first).ports.at(item.second);
+}
+
+IOPort PortsItemModel::port(const QModelIndex &index) const {
+  const quintptr id = index.internalId();
+  if (id == TopId) return topLevelPort(index.row());
+  return topLevelPort(id - FirstItemId).busPort(index.row());
+}
+
+QModelIndex PortsItemModel::indexFromPort(const QString &port,
+                                          int column) const {
+  auto it = m_portIndex.constFind(port);
+  if (it != m_portIndex.constEnd()) return createIndex(*it, column, TopId);
+  QString bus;
+  int bit{0};
+  if (!PortsModel::SplitBusName(port, bus, bit)) return QModelIndex{};
+  it = m_portIndex.constFind(bus);
+  if (it == m_portIndex.constEnd()) return QModelIndex{};
+  const int row = topLevelPort(*it).busIndex(bit);
+  if (row == -1) return QModelIndex{};
+  return createIndex(row, column, FirstItemId + *it);
+}
+
+QString PortsItemModel::pin(const IOPort &port) const {
+  return m_model->pinMap().value(port.name).first;
+}
+
+bool PortsItemModel::isEditable(const IOPort &port, int column) const {
+  if (port.isBus) return false;
+  switch (column) {
+    case PackagePinCol:
+      return true;
+    case ModeCol:
+      return !pin(port).isEmpty();
+    case InternalPinsCol: {
+      const QString packagePin = pin(port);
+      return !packagePin.isEmpty() &&
+             !m_model->packagePinModel()->getMode(packagePin).isEmpty();
+    }
+  }
+  return false;
+}
+
+QStringList PortsItemModel::choices(const IOPort &port, int column) const {
+  auto packagePinModel = m_model->packagePinModel();
+  switch (column) {
+    case PackagePinCol:
+      return packagePinModel->listModel()->stringList();
+    case ModeCol:
+      return (port.dir == "Output")
+                 ? packagePinModel->modeModelTx()->stringList()
+                 : packagePinModel->modeModelRx()->stringList();
+    case InternalPinsCol: {
+      const QString packagePin = pin(port);
+      QStringList list{{""}};
+      list.append(packagePinModel->GetInternalPinsList(
+          packagePin, packagePinModel->getMode(packagePin),
+          packagePinModel->internalPin(port.name)));
+      return list;
+    }
+  }
+  return QStringList{};
+}
+
+void PortsItemModel::updatePort(const QString &port) {
+  const QModelIndex first = indexFromPort(port, PackagePinCol);
+  if (!first.isValid()) return;
+  emit dataChanged(first, indexFromPort(port, InternalPinsCol));
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,92 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QVector>
+
+#include "PortsModel.h"
+
+namespace FOEDAG {
+
+class PinsBaseModel;
+
+/*!
+ * \brief The PortsItemModel class
+ * Tree model of the ports table: Design ports -> ports and buses -> bus
+ * ports. Only top level ports are stored, bus ports and assignments are
+ * created on demand.
+ */
+class PortsItemModel : public QAbstractItemModel {
+  Q_OBJECT
+ public:
+  static constexpr int PortName{0};
+  static constexpr int DirCol{1};
+  static constexpr int PackagePinCol{2};
+  static constexpr int ModeCol{3};
+  static constexpr int InternalPinsCol{4};
+  static constexpr int TypeCol{5};
+
+  PortsItemModel(PinsBaseModel *model, QObject *parent = nullptr);
+
+  QModelIndex index(int row, int column,
+                    const QModelIndex &parent = QModelIndex()) const override;
+  QModelIndex parent(const QModelIndex &index) const override;
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  bool setData(const QModelIndex &index, const QVariant &value,
+               int role = Qt::EditRole) override;
+  Qt::ItemFlags flags(const QModelIndex &index) const override;
+  QVariant headerData(int section, Qt::Orientation orientation,
+                      int role = Qt::DisplayRole) const override;
+
+  void setPin(const QString &port, const QString &pin);
+  void clear();
+
+ signals:
+  void selectionHasChanged();
+
+ private slots:
+  void modeChanged(const QString &pin, const QString &mode);
+  void internalPinChanged(const QString &port, const QString &intPin);
+  void portAssignmentChanged(const QString &port, const QString &pin, int row);
+  void portAssignmentsChanged(const QStringList &ports);
+
+ private:
+  const IOPort &topLevelPort(int row) const;
+  IOPort port(const QModelIndex &index) const;
+  QModelIndex indexFromPort(const QString &port, int column) const;
+  QString pin(const IOPort &port) const;
+  bool isEditable(const IOPort &port, int column) const;
+  QStringList choices(const IOPort &port, int column) const;
+  void updatePort(const QString &port);
+
+ private:
+  PinsBaseModel *m_model{nullptr};
+  QVector<std::pair<int, int>> m_topLevel;  // group, port
+  QHash<QString, int> m_portIndex;          // top level port name, row
+  bool m_blockUpdate{false};
+};
+
+}  // namespace FOEDAG
@@ -21,6 +21,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "PortsLoader.h"
 
 #include <QFile>
+#include <map>
+#include <unordered_map>
 
 #include "nlohmann_json/json.hpp"
 using json = nlohmann::ordered_json;
@@ -36,52 +38,43 @@ std::pair<bool, QString> PortsLoader::load(const QString &file) {
   if (!f.open(QFile::ReadOnly))
     return std::make_pair(false, QString("Can't open file %1").arg(file));
 
-  QString content = f.readAll();
+  const QByteArray content = f.readAll();
   json jsonObject;
   try {
-    jsonObject = json::parse(content.toStdString());
+    jsonObject = json::parse(content.constBegin(), content.constEnd());
   } catch (json::parse_error &e) {
     const QString error =
         QString("Json Error: %1\nFile: %2\nByte position of error: %3")
             .arg(e.what(), file, QString::number(e.byte));
     return std::make_pair(false, error);
   }
+  // direction, type and range are shared by many ports, keep one copy
+  std::unordered_map<std::string, QString> strings;
+  auto intern = [&strings](const std::string &str) -> const QString & {
+    auto it = strings.find(str);
+    if (it == strings.end())
+      it = strings.emplace(str, QString::fromStdString(str)).first;
+    return it->second;
+  };
+  std::map<std::pair<int, int>, QString> ranges;
   for (auto p{jsonObject.cbegin()}; p != jsonObject.cend(); ++p) {
     IOPortGroup group;
-    auto ports = p->at("ports");
-    group.ports.reserve(ports.size());
+    const auto &ports = p->at("ports");
+    group.ports.reserve(static_cast<int>(ports.size()));
     for (auto it{ports.cbegin()}; it != ports.cend(); ++it) {
-      const auto range = it->at("range");
-      const int msb = range["msb"];
-      const int lsb = range["lsb"];
+      const auto &range = it->at("range");
+      const int msb = range.at("msb");
+      const int lsb = range.at("lsb");
+      QString &rangeStr = ranges[std::make_pair(msb, lsb)];
+      if (rangeStr.isNull())
+        rangeStr = QString("Msb: %1, lsb: %2")
+                       .arg(QString::number(msb), QString::number(lsb));
 
-      IOPort ioport{QString::fromStdString(it->at("name")),
-                    QString::fromStdString(it->at("direction")),
-                    QString(),
-                    QString::fromStdString(it->at("type")),
-                    QString("Msb: %1, lsb: %2")
-                        .arg(QString::number(msb), QString::number(lsb)),
-                    (msb != lsb),
-                    {}};
-      if (ioport.isBus) {
-        const int step = msb > lsb ? -1 : 1;
-        const int end = lsb + step;
-        ioport.ports.reserve(std::abs(msb - lsb) + 1);
-        for (int i{msb}; i != end; i += step) {
-          const IOPort port{
-              QString("%1[%2]").arg(QString::fromStdString(it->at("name")),
-                                    QString::number(i)),
-              QString::fromStdString(it->at("direction")),
-              QString(),
-              QString::fromStdString(it->at("type")),
-              QString("Msb: %1, lsb: %2")
-                  .arg(QString::number(msb), QString::number(lsb)),
-              false,
-              {}};
-          ioport.ports.append(port);
-        }
-      }
-      group.ports.append(ioport);
+      group.ports.append(IOPort{
+          QString::fromStdString(it->at("name").get_ref<const std::string &>()),
+          intern(it->at("direction").get_ref<const std::string &>()),
+          QString(), intern(it->at("type").get_ref<const std::string &>()),
+          rangeStr, (msb != lsb), msb, lsb});
     }
     m_model->append(group);
   }
@@ -29,34 +29,85 @@ QStringList PortsModel::headerList() const {
   return {"Name", "Dir", "Package Pin", "Mode", "Internal pins", "Type"};
 }
 
-void PortsModel::append(const IOPortGroup &p) { m_ioPorts.append(p); }
+void PortsModel::append(const IOPortGroup &p) {
+  const int group = m_ioPorts.count();
+  for (int i = 0; i < p.ports.count(); i++)
+    m_portIndex.insert(p.ports.at(i).name, std::make_pair(group, i));
+  m_ioPorts.append(p);
+}
 
 const QVector<IOPortGroup> &PortsModel::ports() const { return m_ioPorts; }
 
 void PortsModel::initListModel() {
-  QStringList portsList;
-  portsList.append(QString());
-  for (const auto &group : qAsConst(m_ioPorts))
-    for (const auto &p : qAsConst(group.ports)) {
-      if (p.isBus) {
-        for (const auto &sub : p.ports) portsList.append(sub.name);
-      } else {
-        portsList.append(p.name);
-      }
-    };
-  m_model->setStringList(portsList);
+  // list holds every bus port, build it when someone needs it
+  m_listModelValid = false;
 }
 
 IOPort PortsModel::GetPort(const QString &portName) const {
-  for (const auto &group : m_ioPorts) {
-    auto iter = std::find_if(
-        group.ports.begin(), group.ports.end(),
-        [&portName](const IOPort &p) { return p.name == portName; });
-    if (iter != group.ports.end()) return (*iter);
+  auto it = m_portIndex.constFind(portName);
+  if (it != m_portIndex.constEnd())
+    return m_ioPorts.at(it->first).ports.at(it->second);
+  QString bus;
+  int bit{0};
+  if (SplitBusName(portName, bus, bit)) {
+    it = m_portIndex.constFind(bus);
+    if (it != m_portIndex.constEnd()) {
+      const IOPort &port = m_ioPorts.at(it->first).ports.at(it->second);
+      const int index = port.busIndex(bit);
+      if (index != -1) return port.busPort(index);
+    }
   }
   return IOPort{};
 }
 
-QStringListModel *PortsModel::listModel() const { return m_model; }
+bool PortsModel::SplitBusName(const QString &portName, QString &bus,
+                              int &bit) {
+  if (!portName.endsWith(']')) return false;
+  const int open = portName.lastIndexOf('[');
+  if (open <= 0) return false;
+  bool ok{false};
+  bit = portName.midRef(open + 1, portName.size() - open - 2).toInt(&ok);
+  if (ok) bus = portName.left(open);
+  return ok;
+}
+
+QStringListModel *PortsModel::listModel() const {
+  if (!m_listModelValid) {
+    QStringList portsList;
+    portsList.append(QString());
+    for (const auto &group : qAsConst(m_ioPorts))
+      for (const auto &p : qAsConst(group.ports)) {
+        if (p.isBus) {
+          for (int i = 0; i < p.busWidth(); i++)
+            portsList.append(p.busPort(i).name);
+        } else {
+          portsList.append(p.name);
+        }
+      }
+    m_model->setStringList(portsList);
+    m_listModelValid = true;
+  }
+  return m_model;
+}
+
+int IOPort::busWidth() const {
+  return isBus ? std::abs(msb - lsb) + 1 : 0;
+}
+
+IOPort IOPort::busPort(int index) const {
+  const int bit = (msb > lsb) ? msb - index : msb + index;
+  return IOPort{QString("%1[%2]").arg(name, QString::number(bit)),
+                dir,
+                QString(),
+                type,
+                range,
+                false};
+}
+
+int IOPort::busIndex(int bit) const {
+  if (!isBus) return -1;
+  const int index = (msb > lsb) ? msb - bit : bit - msb;
+  return (index >= 0 && index < busWidth()) ? index : -1;
+}
 
 }  // namespace FOEDAG
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <QHash>
 #include <QObject>
 #include <QStringList>
 #include <QStringListModel>
@@ -34,7 +35,13 @@ struct IOPort {
   QString type;
   QString range;
   bool isBus;
-  QVector<IOPort> ports;
+  int msb{0};
+  int lsb{0};
+
+  // Bus ports are not stored, they are created on demand from msb to lsb
+  int busWidth() const;
+  IOPort busPort(int index) const;
+  int busIndex(int bit) const;  // -1 if bit is out of range
 };
 
 struct IOPortGroup {
@@ -51,12 +58,15 @@ class PortsModel : public QObject {
   const QVector<IOPortGroup> &ports() const;
   void initListModel();
   IOPort GetPort(const QString &portName) const;
+  static bool SplitBusName(const QString &portName, QString &bus, int &bit);
 
   QStringListModel *listModel() const;
 
  private:
   QVector<IOPortGroup> m_ioPorts;
+  QHash<QString, std::pair<int, int>> m_portIndex;  // group, port
   QStringListModel *m_model;
+  mutable bool m_listModelValid{true};
 };
 
 }  // namespace FOEDAG
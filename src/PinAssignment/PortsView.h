@@ -22,10 +22,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "PinAssignmentBaseView.h"
 
-class QComboBox;
 namespace FOEDAG {
 
-struct IOPort;
+class PortsItemModel;
 class PortsView : public PinAssignmentBaseView {
   Q_OBJECT
  public:
@@ -37,18 +36,10 @@ class PortsView : public PinAssignmentBaseView {
   void selectionHasChanged();
 
  private:
-  void packagePinSelectionHasChanged(const QModelIndex &index);
-  void insertTableItem(QTreeWidgetItem *parent, const IOPort &port);
-  void modeSelectionHasChanged(const QModelIndex &index);
-  void internalPinSelectionHasChanged(const QModelIndex &index);
-  void updateModeCombo(const QString &port, const QModelIndex &index);
-  void updateIntPinCombo(const QString &mode, const QModelIndex &index);
-  QString getPinSelection(const QModelIndex &index) const;
-
- private slots:
-  void modeChanged(const QString &pin, const QString &mode);
-  void intPinChanged(const QString &port, const QString &intPin);
-  void portAssignmentChanged(const QString &port, const QString &pin, int row);
+  void expandTopLevel();
+
+ private:
+  PortsItemModel *m_itemModel{nullptr};
 };
 
 }  // namespace FOEDAG
@@ -0,0 +1,164 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "hierarchy_model.h"
+
+#include <algorithm>
+
+#include "Compiler/CompilerDefines.h"
+#include "Utils/FileUtils.h"
+
+namespace FOEDAG {
+
+struct HierarchyModel::Node {
+  uint32_t module{0};
+  // Instance in the parent module, nullptr for a top module
+  const DesignHierarchy::Instance *instance{nullptr};
+  Node *parent{nullptr};
+  int row{0};
+  // Children created so far, the others are still to be fetched
+  std::vector<std::unique_ptr<Node>> children;
+};
+
+HierarchyModel::HierarchyModel(QObject *parent)
+    : QAbstractItemModel(parent), m_root(std::make_unique<Node>()) {}
+
+HierarchyModel::~HierarchyModel() = default;
+
+QModelIndex HierarchyModel::index(int row, int column,
+                                  const QModelIndex &parent) const {
+  Node *node = nodeOf(parent);
+  if (column != 0 || row < 0 || row >= static_cast<int>(node->children.size()))
+    return {};
+  return createIndex(row, column, node->children[row].get());
+}
+
+QModelIndex HierarchyModel::parent(const QModelIndex &child) const {
+  if (!child.isValid()) return {};
+  Node *parent = nodeOf(child)->parent;
+  if (!parent || parent == m_root.get()) return {};
+  return createIndex(parent->row, 0, parent);
+}
+
+int HierarchyModel::rowCount(const QModelIndex &parent) const {
+  if (parent.column() > 0) return 0;
+  return static_cast<int>(nodeOf(parent)->children.size());
+}
+
+int HierarchyModel::columnCount(const QModelIndex &parent) const { return 1; }
+
+bool HierarchyModel::hasChildren(const QModelIndex &parent) const {
+  return childCount(nodeOf(parent)) > 0;
+}
+
+bool HierarchyModel::canFetchMore(const QModelIndex &parent) const {
+  const Node *node = nodeOf(parent);
+  return static_cast<int>(node->children.size()) < childCount(node);
+}
+
+void HierarchyModel::fetchMore(const QModelIndex &parent) {
+  Node *node = nodeOf(parent);
+  const int first = static_cast<int>(node->children.size());
+  const int last = std::min(first + FetchBatch, childCount(node)) - 1;
+  if (last < first) return;
+  const auto &module = m_hierarchy.GetModule(node->module);
+  const DesignHierarchy::Instance *instances = m_hierarchy.Instances(module);
+  beginInsertRows(parent, first, last);
+  for (int row = first; row <= last; row++) {
+    auto child = std::make_unique<Node>();
+    child->instance = &instances[row];
+    child->module = child->instance->module;
+    child->parent = node;
+    child->row = row;
+    node->children.push_back(std::move(child));
+  }
+  endInsertRows();
+}
+
+QVariant HierarchyModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid()) return {};
+  const Node *node = nodeOf(index);
+  const auto &module = m_hierarchy.GetModule(node->module);
+  auto text = [this](uint32_t id) {
+    const std::string_view name = m_hierarchy.Name(id);
+    return QString::fromUtf8(name.data(), static_cast<int>(name.size()));
+  };
+  const DesignHierarchy::Instance *instance = node->instance;
+  switch (role) {
+    case Qt::DisplayRole:
+      if (!instance) return text(module.name);
+      return QString{"%1 (%2)"}.arg(text(instance->name), text(module.name));
+    case Qt::ToolTipRole:
+      return QString{"%1:%2"}.arg(text(module.file)).arg(module.line);
+    case FileRole:
+      return text(module.file);
+    case LineRole:
+      return module.line;
+    case InstanceFileRole:
+      return text(instance ? instance->file : module.file);
+    case InstanceLineRole:
+      return instance ? instance->line : module.line;
+    default:
+      break;
+  }
+  return {};
+}
+
+bool HierarchyModel::reload(const QString &projectPath) {
+  const std::filesystem::path path = projectPath.toStdString();
+  const std::filesystem::path index = path / HIER_INDEX;
+  std::string error;
+  const bool updated = DesignHierarchy::Update(path / HIER_INFO, index, error);
+  // Keep the expanded items while the index is the same
+  if (updated && m_hierarchy.IsOpen() && m_hierarchy.File() == index &&
+      m_hierarchy.Stamp() == FileUtils::Stamp(index))
+    return true;
+
+  beginResetModel();
+  m_root = std::make_unique<Node>();
+  m_error.clear();
+  if (!updated || !m_hierarchy.Open(index)) {
+    if (error.empty()) error = m_hierarchy.LastError();
+    m_error = QString::fromStdString(error);
+  } else {
+    const auto &tops = m_hierarchy.Tops();
+    for (size_t row = 0; row < tops.size(); row++) {
+      auto top = std::make_unique<Node>();
+      top->module = tops[row];
+      top->parent = m_root.get();
+      top->row = static_cast<int>(row);
+      m_root->children.push_back(std::move(top));
+    }
+  }
+  endResetModel();
+  return m_error.isEmpty();
+}
+
+HierarchyModel::Node *HierarchyModel::nodeOf(const QModelIndex &index) const {
+  if (!index.isValid()) return m_root.get();
+  return static_cast<Node *>(index.internalPointer());
+}
+
+int HierarchyModel::childCount(const Node *node) const {
+  if (node == m_root.get()) return static_cast<int>(node->children.size());
+  return static_cast<int>(m_hierarchy.GetModule(node->module).instanceCount);
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,82 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <QAbstractItemModel>
+#include <memory>
+#include <vector>
+
+#include "Compiler/DesignHierarchy.h"
+
+namespace FOEDAG {
+
+/*!
+ * \brief The HierarchyModel class shows the elaborated design hierarchy of
+ * the last analysis: top modules and their instances.
+ *
+ * Items are created when their parent is expanded (canFetchMore/fetchMore),
+ * by batches, so opening a design with a large instance tree only costs the
+ * rows on screen.
+ */
+class HierarchyModel : public QAbstractItemModel {
+  Q_OBJECT
+
+ public:
+  // Module definition
+  static constexpr int FileRole{Qt::UserRole + 1};
+  static constexpr int LineRole{Qt::UserRole + 2};
+  // Instantiation, same as the definition for a top module
+  static constexpr int InstanceFileRole{Qt::UserRole + 3};
+  static constexpr int InstanceLineRole{Qt::UserRole + 4};
+  static constexpr int FetchBatch{500};
+
+  explicit HierarchyModel(QObject *parent = nullptr);
+  ~HierarchyModel() override;
+
+  QModelIndex index(int row, int column,
+                    const QModelIndex &parent = QModelIndex()) const override;
+  QModelIndex parent(const QModelIndex &child) const override;
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+  bool canFetchMore(const QModelIndex &parent) const override;
+  void fetchMore(const QModelIndex &parent) override;
+
+  /*!
+   * \brief reload reads the hierarchy index of the project in \a projectPath.
+   * \return false if the design was not analyzed, see lastError()
+   */
+  bool reload(const QString &projectPath);
+  const QString &lastError() const { return m_error; }
+
+ private:
+  struct Node;
+
+  Node *nodeOf(const QModelIndex &index) const;
+  int childCount(const Node *node) const;
+
+  DesignHierarchy m_hierarchy;
+  std::unique_ptr<Node> m_root;
+  QString m_error;
+};
+
+}  // namespace FOEDAG
@@ -1,27 +1,24 @@
 #include "sources_form.h"
 
 #include <QDebug>
-#include <QDir>
-#include <QDirIterator>
-#include <QFileInfo>
 #include <QMenu>
 #include <QMessageBox>
 #include <QTextStream>
 #include <algorithm>
 
 #include "Main/Foedag.h"
-#include "Utils/FileUtils.h"
 #include "tcl_command_integration.h"
 #include "ui_sources_form.h"
 
 using namespace FOEDAG;
-static constexpr int SetFileDataRole{Qt::UserRole + 1};
 
 SourcesForm::SourcesForm(QWidget *parent)
     : QWidget(parent), ui(new Ui::SourcesForm) {
   ui->setupUi(this);
 
-  m_treeSrcHierachy = new QTreeWidget(ui->m_tabHierarchy);
+  m_treeSrcHierachy = new QTreeView(ui->m_tabHierarchy);
+  m_treeSrcHierachy->setHeaderHidden(true);
+  m_treeSrcHierachy->setUniformRowHeights(true);
   m_treeSrcHierachy->setSelectionMode(
       QAbstractItemView::SelectionMode::ExtendedSelection);
 
@@ -34,18 +31,55 @@ SourcesForm::SourcesForm(QWidget *parent)
   CreateActions();
 
   m_projManager = new ProjectManager(this);
-
-  connect(m_treeSrcHierachy, SIGNAL(itemPressed(QTreeWidgetItem *, int)), this,
-          SLOT(SlotItempressed(QTreeWidgetItem *, int)));
-  connect(m_treeSrcHierachy, SIGNAL(itemDoubleClicked(QTreeWidgetItem *, int)),
-          this, SLOT(SlotItemDoubleClicked(QTreeWidgetItem *, int)));
-
-  ui->m_tabWidget->removeTab(ui->m_tabWidget->indexOf(ui->tab_2));
+  m_model = new SourcesModel(m_projManager, this);
+  m_treeSrcHierachy->setModel(m_model);
+
+  connect(m_treeSrcHierachy, &QTreeView::pressed, this,
+          &SourcesForm::SlotItempressed);
+  connect(m_treeSrcHierachy, &QTreeView::doubleClicked, this,
+          &SourcesForm::SlotItemDoubleClicked);
+
+  // Elaborated design hierarchy of the last analysis
+  m_treeDesignHierarchy = new QTreeView(ui->tab_2);
+  m_treeDesignHierarchy->setHeaderHidden(true);
+  m_treeDesignHierarchy->setUniformRowHeights(true);
+  m_hierarchyModel = new HierarchyModel(this);
+  m_treeDesignHierarchy->setModel(m_hierarchyModel);
+  m_designHierarchyStatus = new QLabel(ui->tab_2);
+  m_designHierarchyStatus->setWordWrap(true);
+  m_designHierarchyStatus->hide();
+
+  QVBoxLayout *hierBox = new QVBoxLayout();
+  hierBox->addWidget(m_designHierarchyStatus);
+  hierBox->addWidget(m_treeDesignHierarchy);
+  hierBox->setContentsMargins(0, 0, 0, 0);
+  hierBox->setSpacing(0);
+  ui->tab_2->setLayout(hierBox);
+  ui->m_tabWidget->setTabText(ui->m_tabWidget->indexOf(ui->tab_2),
+                              tr("Design Hierarchy"));
+
+  connect(m_treeDesignHierarchy, &QTreeView::pressed, this,
+          &SourcesForm::SlotDesignHierarchyPressed);
+  connect(m_treeDesignHierarchy, &QTreeView::doubleClicked, this,
+          &SourcesForm::SlotGoToDefinition);
 }
 
 SourcesForm::~SourcesForm() { delete ui; }
 
-void SourcesForm::InitSourcesForm() { UpdateSrcHierachyTree(); }
+void SourcesForm::InitSourcesForm() {
+  m_model->reload();
+  // project, groups and IP instances
+  m_treeSrcHierachy->expandToDepth(2);
+  UpdateDesignHierarchy();
+}
+
+void SourcesForm::UpdateDesignHierarchy() {
+  const bool ok = m_hierarchyModel->reload(m_projManager->getProjectPath());
+  m_designHierarchyStatus->setText(m_hierarchyModel->lastError());
+  m_designHierarchyStatus->setVisible(!ok);
+  // top modules
+  if (ok) m_treeDesignHierarchy->expandToDepth(0);
+}
 
 TclCommandIntegration *SourcesForm::createTclCommandIntegarion() {
   return new TclCommandIntegration(m_projManager, this);
@@ -56,29 +90,14 @@ ProjectManager *SourcesForm::ProjManager() { return m_projManager; }
 void SourcesForm::CreateConstraint() { showAddFileDialog(GT_CONSTRAINTS); }
 
 void SourcesForm::SetCurrentFileItem(const QString &strFileName) {
-  QString filename = strFileName.right(strFileName.size() -
-                                       (strFileName.lastIndexOf("/") + 1));
-  QList<QTreeWidgetItem *> listItem = m_treeSrcHierachy->findItems(
-      filename, Qt::MatchContains | Qt::MatchRecursive);
-  foreach (auto item, listItem) {
-    if (item == nullptr) {
-      continue;
-    }
-    QString strItemFileName = (item->data(0, Qt::UserRole)).toString();
-    QString strPath = m_projManager->getProjectPath();
-    if (!strFileName.compare(strItemFileName.replace("$OSRCDIR", strPath))) {
-      m_treeSrcHierachy->setCurrentItem(item);
-      break;
-    }
-  }
+  QModelIndex index = m_model->fileIndex(strFileName);
+  if (index.isValid()) m_treeSrcHierachy->setCurrentIndex(index);
 }
 
-void SourcesForm::SlotItempressed(QTreeWidgetItem *item, int column) {
-  Q_UNUSED(column);
+void SourcesForm::SlotItempressed(const QModelIndex &index) {
   if (qApp->mouseButtons() == Qt::RightButton) {
-    QString strPropertyRole =
-        (item->data(0, Qt::WhatsThisPropertyRole)).toString();
-    QString strName = item->text(0);
+    QString strPropertyRole = index.data(Qt::WhatsThisPropertyRole).toString();
+    QString strName = index.data().toString();
 
     QMenu *menu = new QMenu(m_treeSrcHierachy);
     menu->setMinimumWidth(200);
@@ -183,10 +202,8 @@ void SourcesForm::SlotItempressed(QTreeWidgetItem *item, int column) {
   }
 }
 
-void SourcesForm::SlotItemDoubleClicked(QTreeWidgetItem *item, int column) {
-  Q_UNUSED(column);
-  QString strPropertyRole =
-      (item->data(0, Qt::WhatsThisPropertyRole)).toString();
+void SourcesForm::SlotItemDoubleClicked(const QModelIndex &index) {
+  QString strPropertyRole = index.data(Qt::WhatsThisPropertyRole).toString();
   if (SRC_TREE_DESIGN_FILE_ITEM == strPropertyRole ||
       SRC_TREE_SIM_FILE_ITEM == strPropertyRole ||
       SRC_TREE_CONSTR_FILE_ITEM == strPropertyRole ||
@@ -195,7 +212,37 @@ void SourcesForm::SlotItemDoubleClicked(QTreeWidgetItem *item, int column) {
   }
 }
 
-void SourcesForm::SlotRefreshSourceTree() { UpdateSrcHierachyTree(); }
+void SourcesForm::SlotRefreshSourceTree() { InitSourcesForm(); }
+
+void SourcesForm::SlotDesignHierarchyPressed(const QModelIndex &index) {
+  if (qApp->mouseButtons() != Qt::RightButton) return;
+  QMenu *menu = new QMenu(m_treeDesignHierarchy);
+  menu->setMinimumWidth(200);
+  if (index.isValid()) {
+    menu->addAction(m_actGoToDefinition);
+    menu->addAction(m_actGoToInstance);
+    menu->addSeparator();
+  }
+  menu->addAction(m_actRefreshDesignHierarchy);
+  QPoint p = QCursor::pos();
+  menu->exec(QPoint(p.rx(), p.ry() + 3));
+  menu->deleteLater();
+}
+
+void SourcesForm::SlotGoToDefinition() {
+  QModelIndex index = m_treeDesignHierarchy->currentIndex();
+  if (!index.isValid()) return;
+  emit OpenFileWithLine(index.data(HierarchyModel::FileRole).toString(),
+                        index.data(HierarchyModel::LineRole).toInt());
+}
+
+void SourcesForm::SlotGoToInstance() {
+  QModelIndex index = m_treeDesignHierarchy->currentIndex();
+  if (!index.isValid()) return;
+  emit OpenFileWithLine(
+      index.data(HierarchyModel::InstanceFileRole).toString(),
+      index.data(HierarchyModel::InstanceLineRole).toInt());
+}
 
 void SourcesForm::SlotCreateConstrSet() {
   CreateFileSetDialog *createdialog = new CreateFileSetDialog(this);
@@ -209,7 +256,6 @@ void SourcesForm::SlotCreateConstrSet() {
                                tr("The set name is already exists!"),
                                QMessageBox::Ok);
     } else if (0 == ret) {
-      UpdateSrcHierachyTree();
       m_projManager->FinishedProject();
       break;
     }
@@ -230,7 +276,6 @@ void SourcesForm::SlotCreateSimSet() {
                                tr("The set name is already exists!"),
                                QMessageBox::Ok);
     } else if (0 == ret) {
-      UpdateSrcHierachyTree();
       m_projManager->FinishedProject();
       break;
     }
@@ -240,13 +285,12 @@ void SourcesForm::SlotCreateSimSet() {
 }
 
 void SourcesForm::SlotAddFile() {
-  QTreeWidgetItem *item = m_treeSrcHierachy->currentItem();
-  if (item == nullptr) {
+  QModelIndex index = m_treeSrcHierachy->currentIndex();
+  if (!index.isValid()) {
     return;
   }
 
-  QString strPropertyRole =
-      (item->data(0, Qt::WhatsThisPropertyRole)).toString();
+  QString strPropertyRole = index.data(Qt::WhatsThisPropertyRole).toString();
 
   if (SRC_TREE_DESIGN_SET_ITEM == strPropertyRole ||
       SRC_TREE_DESIGN_TOP_ITEM == strPropertyRole ||
@@ -265,14 +309,13 @@ void SourcesForm::SlotAddFile() {
 
 void SourcesForm::SlotOpenFile() {
   // Get selected file names
-  for (auto item : m_treeSrcHierachy->selectedItems()) {
+  for (const auto &index :
+       m_treeSrcHierachy->selectionModel()->selectedIndexes()) {
     // Using WhatsThis role to ensure selection is a file
     // OpenFile quietly aborts on bad filenames, so this check could be removed
     // if a desired type is being missing
-    if (item->data(0, Qt::WhatsThisPropertyRole)
-            .toString()
-            .contains("fileitem")) {
-      QString strFileName = (item->data(0, Qt::UserRole)).toString();
+    if (index.data(Qt::WhatsThisPropertyRole).toString().contains("fileitem")) {
+      QString strFileName = index.data(Qt::UserRole).toString();
       QString strPath = m_projManager->getProjectPath();
       emit OpenFile(strFileName.replace(PROJECT_OSRCDIR, strPath));
     }
@@ -280,41 +323,40 @@ void SourcesForm::SlotOpenFile() {
 }
 
 void SourcesForm::SlotRemoveFileSet() {
-  QTreeWidgetItem *item = m_treeSrcHierachy->currentItem();
-  if (item == nullptr) {
+  QModelIndex index = m_treeSrcHierachy->currentIndex();
+  if (!index.isValid()) {
     return;
   }
-  QString strName = (item->data(0, Qt::UserRole)).toString();
+  QString strName = index.data(Qt::UserRole).toString();
 
   int ret = m_projManager->deleteFileSet(strName);
   if (0 == ret) {
-    UpdateSrcHierachyTree();
     m_projManager->FinishedProject();
   }
 }
 
 void SourcesForm::SlotRemoveFile() {
   // Get all selections
-  auto selectedItems = m_treeSrcHierachy->selectedItems();
+  auto selectedItems = m_treeSrcHierachy->selectionModel()->selectedIndexes();
   // Use the r-clicked item for determining what item type we are working with
-  QTreeWidgetItem *refItem = m_treeSrcHierachy->currentItem();
-  auto itemType = refItem->data(0, Qt::WhatsThisPropertyRole);
+  QModelIndex refItem = m_treeSrcHierachy->currentIndex();
 
   // Bail on no selection
-  if (refItem == nullptr) return;
+  if (!refItem.isValid()) return;
   if (!selectedItems.count()) return;
+  auto itemType = refItem.data(Qt::WhatsThisPropertyRole);
 
   // Track string names for confirmation dialog
   QStringList files;
   // Store filename/fileset pairs for delete option
   QList<QPair<QString, QVariant>> selections;
-  for (auto item : selectedItems) {
-    auto strFileName = item->text(0);
-    auto fileSet = item->data(0, SetFileDataRole);
+  for (const auto &item : selectedItems) {
+    auto strFileName = item.data().toString();
+    auto fileSet = item.data(SourcesModel::FileSetRole);
     // Only accept files that match the r-clicked item type to avoid acting on
     // un-related selections
-    if ((item->data(0, Qt::WhatsThisPropertyRole) == itemType) &&
-        !fileSet.isNull()) {
+    if ((item.data(Qt::WhatsThisPropertyRole) == itemType) &&
+        !fileSet.toString().isEmpty()) {
       selections.append(qMakePair(strFileName, fileSet));
       files.append(strFileName);
     }
@@ -341,39 +383,34 @@ void SourcesForm::SlotRemoveFile() {
       m_projManager->setCurrentFileSet(selection.second.toString());
       m_projManager->deleteFile(selection.first);
     }
-    UpdateSrcHierachyTree();
     m_projManager->FinishedProject();
   }
 }
 
 void SourcesForm::SlotSetAsTarget() {
-  QTreeWidgetItem *item = m_treeSrcHierachy->currentItem();
-  if (item == nullptr) {
+  QModelIndex index = m_treeSrcHierachy->currentIndex();
+  if (!index.isValid()) {
     return;
   }
-  QString strFileName = item->text(0);
-
-  QTreeWidgetItem *itemparent = item->parent();
-  QString strFileSetName = (itemparent->data(0, Qt::UserRole)).toString();
+  QString strFileName = index.data().toString();
+  QString strFileSetName = index.data(SourcesModel::FileSetRole).toString();
 
   m_projManager->setCurrentFileSet(strFileSetName);
   int ret = m_projManager->setTargetConstrs(strFileName);
   if (0 == ret) {
-    UpdateSrcHierachyTree();
     m_projManager->FinishedProject();
   }
 }
 
 void SourcesForm::SlotSetActive() {
   int ret = 0;
-  QTreeWidgetItem *item = m_treeSrcHierachy->currentItem();
-  if (item == nullptr) {
+  QModelIndex index = m_treeSrcHierachy->currentIndex();
+  if (!index.isValid()) {
     return;
   }
 
-  QString strPropertyRole =
-      (item->data(0, Qt::WhatsThisPropertyRole)).toString();
-  QString strName = (item->data(0, Qt::UserRole)).toString();
+  QString strPropertyRole = index.data(Qt::WhatsThisPropertyRole).toString();
+  QString strName = index.data(Qt::UserRole).toString();
 
   if (SRC_TREE_DESIGN_SET_ITEM == strPropertyRole) {
     ret = m_projManager->setDesignActive(strName);
@@ -386,16 +423,15 @@ void SourcesForm::SlotSetActive() {
   }
 
   if (0 == ret) {
-    UpdateSrcHierachyTree();
     m_projManager->FinishedProject();
   }
 }
 
 void SourcesForm::SlotProperties() {
-  QTreeWidgetItem *item = m_treeSrcHierachy->currentItem();
-  if (item == nullptr) return;
+  QModelIndex index = m_treeSrcHierachy->currentIndex();
+  if (!index.isValid()) return;
 
-  QString strFileName = (item->data(0, Qt::UserRole)).toString();
+  QString strFileName = index.data(Qt::UserRole).toString();
 
   if (!strFileName.isEmpty()) emit ShowProperty(strFileName);
 }
@@ -406,11 +442,11 @@ void SourcesForm::SlotPropertiesTriggered() {
 }
 
 void SourcesForm::SlotReConfigureIp() {
-  QTreeWidgetItem *item = m_treeSrcHierachy->currentItem();
-  if (item == nullptr) {
+  QModelIndex index = m_treeSrcHierachy->currentIndex();
+  if (!index.isValid()) {
     return;
   }
-  std::string moduleName = item->text(0).toStdString();
+  std::string moduleName = index.data().toString().toStdString();
 
   auto instances =
       GlobalSession->GetCompiler()->GetIPGenerator()->IPInstances();
@@ -517,229 +553,44 @@ void SourcesForm::CreateActions() {
   m_actProjectSettings = new QAction(tr("Project settings"), m_treeSrcHierachy);
   connect(m_actProjectSettings, &QAction::triggered, this,
           &SourcesForm::OpenProjectSettings);
+
+  m_actGoToDefinition = new QAction(tr("Go to Definition"), this);
+  connect(m_actGoToDefinition, &QAction::triggered, this,
+          &SourcesForm::SlotGoToDefinition);
+
+  m_actGoToInstance = new QAction(tr("Go to Instantiation"), this);
+  connect(m_actGoToInstance, &QAction::triggered, this,
+          &SourcesForm::SlotGoToInstance);
+
+  m_actRefreshDesignHierarchy = new QAction(tr("Refresh Hierarchy"), this);
+  connect(m_actRefreshDesignHierarchy, &QAction::triggered, this,
+          &SourcesForm::UpdateDesignHierarchy);
 }
 
 void SourcesForm::UpdateSrcHierachyTree() {
-  if (nullptr == m_projManager) return;
-  m_treeSrcHierachy->clear();
-  CreateFolderHierachyTree();
-  m_treeSrcHierachy->setHeaderHidden(true);
-  m_treeSrcHierachy->expandAll();
+  // Files follow the project changes, only IP instances need a refresh
+  if (m_model) m_model->reloadIpInstances();
 }
 
 QAction *SourcesForm::ProjectSettingsActions() const {
   return m_actProjectSettings;
 }
 
-void SourcesForm::CreateFolderHierachyTree() {
-  // Initialize design sources tree
-  QTreeWidgetItem *topItem = new QTreeWidgetItem(m_treeSrcHierachy);
-  const QString topItemName = m_projManager->getProjectName().isEmpty()
-                                  ? "undefined"
-                                  : m_projManager->getProjectName();
-  topItem->setText(0, topItemName);
-  m_treeSrcHierachy->addTopLevelItem(topItem);
-
-  QTreeWidgetItem *topitemDS = new QTreeWidgetItem(topItem);
-  topitemDS->setData(0, Qt::WhatsThisPropertyRole, SRC_TREE_DESIGN_TOP_ITEM);
-
-  QStringList listDesFset = m_projManager->getDesignFileSets();
-  int iFileSum = 0;
-  for (auto &str : listDesFset) {
-    QStringList listDesFile = m_projManager->getDesignFiles(str);
-    QTreeWidgetItem *parentItem{topitemDS};
-    for (auto &strfile : listDesFile) {
-      if (parentItem) {
-        QString filename =
-            strfile.right(strfile.size() - (strfile.lastIndexOf("/") + 1));
-        QTreeWidgetItem *itemf = new QTreeWidgetItem(parentItem);
-        itemf->setText(0, filename);
-        itemf->setData(0, Qt::UserRole, strfile);
-        itemf->setIcon(0, QIcon(":/img/file.png"));
-        itemf->setData(0, Qt::WhatsThisPropertyRole, SRC_TREE_DESIGN_FILE_ITEM);
-        itemf->setData(0, SetFileDataRole, str);
-      }
-    }
-    iFileSum += listDesFile.size();
-  }
-  topitemDS->setText(0, tr("Design Sources") + QString("(%1)").arg(iFileSum));
-
-  // Initialize Constraints sources tree
-  QTreeWidgetItem *topitemCS = new QTreeWidgetItem(topItem);
-  m_treeSrcHierachy->addTopLevelItem(topitemCS);
-  topitemCS->setData(0, Qt::WhatsThisPropertyRole, SRC_TREE_CONSTR_TOP_ITEM);
-
-  QStringList listConstrFset = m_projManager->getConstrFileSets();
-  iFileSum = 0;
-  QTreeWidgetItem *parentItem{topitemCS};
-  for (auto &str : listConstrFset) {
-    QStringList listConstrFile = m_projManager->getConstrFiles(str);
-    QString strTarget = m_projManager->getConstrTargetFile(str);
-    for (auto &strfile : listConstrFile) {
-      if (parentItem) {
-        QString filename =
-            strfile.right(strfile.size() - (strfile.lastIndexOf("/") + 1));
-        QTreeWidgetItem *itemf = new QTreeWidgetItem(parentItem);
-        if (filename == strTarget) {
-          itemf->setText(0, filename + SRC_TREE_FLG_TARGET);
-        } else {
-          itemf->setText(0, filename);
-        }
-        itemf->setData(0, Qt::UserRole, strfile);
-        itemf->setIcon(0, QIcon(":/img/file.png"));
-        itemf->setData(0, Qt::WhatsThisPropertyRole, SRC_TREE_CONSTR_FILE_ITEM);
-        itemf->setData(0, SetFileDataRole, str);
-      }
-    }
-    iFileSum += listConstrFile.size();
-  }
-  topitemCS->setText(0, tr("Constraints") + QString("(%1)").arg(iFileSum));
-
-  // Initialize simulation sources tree
-  QTreeWidgetItem *topitemSS = new QTreeWidgetItem(topItem);
-  m_treeSrcHierachy->addTopLevelItem(topitemSS);
-  topitemSS->setData(0, Qt::WhatsThisPropertyRole, SRC_TREE_SIM_TOP_ITEM);
-
-  QStringList listSimFset = m_projManager->getSimulationFileSets();
-  iFileSum = 0;
-  for (const auto &str : listSimFset) {
-    QStringList listSimFile = m_projManager->getSimulationFiles(str);
-    QTreeWidgetItem *parentItem{topitemSS};
-    for (auto &strfile : listSimFile) {
-      if (parentItem) {
-        QString filename =
-            strfile.right(strfile.size() - (strfile.lastIndexOf("/") + 1));
-        QTreeWidgetItem *itemf = new QTreeWidgetItem(parentItem);
-        itemf->setText(0, filename);
-        itemf->setData(0, Qt::UserRole, strfile);
-        itemf->setIcon(0, QIcon(":/img/file.png"));
-        itemf->setData(0, Qt::WhatsThisPropertyRole, SRC_TREE_SIM_FILE_ITEM);
-        itemf->setData(0, SetFileDataRole, str);
-      }
-    }
-    iFileSum += listSimFile.size();
-  }
-  topitemSS->setText(0,
-                     tr("Simulation Sources") + QString("(%1)").arg(iFileSum));
-
-  // Initialize IP instances tree
-  AddIpInstanceTree(topItem);
-}
-
-void SourcesForm::AddIpInstanceTree(QTreeWidgetItem *topItem) {
-  QTreeWidgetItem *topitemIpInstances = new QTreeWidgetItem(topItem);
-  m_treeSrcHierachy->addTopLevelItem(topitemIpInstances);
-  topitemIpInstances->setData(0, Qt::WhatsThisPropertyRole,
-                              SRC_TREE_IP_TOP_ITEM);
-  int instCount = 0;
-
-  Compiler *compiler = nullptr;
-  IPGenerator *ipGen = nullptr;
-  if (GlobalSession && (compiler = GlobalSession->GetCompiler()) &&
-      (ipGen = compiler->GetIPGenerator())) {
-    QTreeWidgetItem *ipParentItem{topitemIpInstances};
-    for (auto instance : ipGen->IPInstances()) {
-      QString ipName = QString::fromStdString(instance->IPName());
-      QString moduleName = QString::fromStdString(instance->ModuleName());
-
-      // Add Instance moduleName to tree
-      QTreeWidgetItem *itemIp = new QTreeWidgetItem(ipParentItem);
-      itemIp->setText(0, moduleName);
-      itemIp->setData(0, Qt::UserRole, ipName);
-      itemIp->setData(0, Qt::WhatsThisPropertyRole, SRC_TREE_IP_INST_ITEM);
-      itemIp->setData(0, SetFileDataRole, ipName);
-
-      // Get the IP build src directory for this instance
-      auto buildPath = ipGen->GetBuildDir(instance);
-      std::filesystem::path srcDirPath = buildPath / "src";
-      QString srcDirStr =
-          QString::fromStdString(FileUtils::GetFullPath(srcDirPath).string());
-
-      // Grab and add all files from the IP src dir (non-recursive)
-      QDirIterator it(srcDirStr, QDir::Files);
-      while (it.hasNext()) {
-        QFile file(it.next());
-
-        QTreeWidgetItem *itemFile = new QTreeWidgetItem(itemIp);
-        QFileInfo info(file);
-        itemFile->setText(0, info.fileName());
-        itemFile->setData(0, Qt::UserRole, info.absoluteFilePath());
-        itemFile->setIcon(0, QIcon(":/img/file.png"));
-        itemFile->setData(0, Qt::WhatsThisPropertyRole, SRC_TREE_IP_FILE_ITEM);
-        itemFile->setData(0, SetFileDataRole, info.absoluteFilePath());
-        itemFile->setToolTip(0, info.absoluteFilePath());
-      }
-
-      instCount += 1;
-    }
-  }
-  topitemIpInstances->setText(
-      0, tr("IP Instances") + QString("(%1)").arg(instCount));
-}
-
 QStringList SourcesForm::SelectedIpModules() const {
   // Get module names of selected valid items
   QStringList modules{};
-  for (auto item : m_treeSrcHierachy->selectedItems()) {
+  for (const auto &index :
+       m_treeSrcHierachy->selectionModel()->selectedIndexes()) {
     // Ignore non-ip instance types
-    if (item->data(0, Qt::WhatsThisPropertyRole).toString() ==
+    if (index.data(Qt::WhatsThisPropertyRole).toString() ==
         SRC_TREE_IP_INST_ITEM) {
-      QString moduleName = QString::fromStdString(item->text(0).toStdString());
-      modules.append(moduleName);
+      modules.append(index.data().toString());
     }
   }
 
   return modules;
 }
 
-QTreeWidgetItem *SourcesForm::CreateFolderHierachyTree(QTreeWidgetItem *topItem,
-                                                       const QString &path) {
-  if (path.isEmpty()) return nullptr;
-
-  int index = path.indexOf(QDir::separator());
-  if (index == 0) {  // skip first sepertor
-    index = path.indexOf(QDir::separator(), 1);
-  }
-  QString folder = path.mid(0, index);
-  QTreeWidgetItem *itemfolder{ChildByText(topItem, folder)};
-  if (!itemfolder) {
-    itemfolder = new QTreeWidgetItem(topItem);
-    itemfolder->setIcon(0, QIcon(":/images/open-file.png"));
-    itemfolder->setText(0, folder);
-  }
-  if (index != -1)
-    return CreateFolderHierachyTree(itemfolder,
-                                    path.right(path.size() - index - 1));
-  return itemfolder;
-}
-
-QTreeWidgetItem *SourcesForm::CreateParentFolderItem(QTreeWidgetItem *parent,
-                                                     const QString &text) {
-  auto item = new QTreeWidgetItem(parent);
-  item->setIcon(0, QIcon(":/images/open-file.png"));
-  item->setText(0, text);
-  item->setToolTip(0, text);
-  return item;
-}
-
-QTreeWidgetItem *SourcesForm::ChildByText(QTreeWidgetItem *topItem,
-                                          const QString &text) {
-  QTreeWidgetItem *itemfolder{nullptr};
-  for (size_t i = 0; i < topItem->childCount(); i++) {
-    if (topItem->child(i)->text(0) == text) {
-      return topItem->child(i);
-    }
-  }
-  return nullptr;
-}
-
-QString SourcesForm::StripPath(const QString &path) {
-  QString p = path;
-  if (p.startsWith(QDir::separator())) p.remove(0, 1);
-  if (p.endsWith(QDir::separator())) p.remove(p.size() - 1, 1);
-  return p;
-}
-
 void SourcesForm::showAddFileDialog(GridType gridType) {
   AddFileDialog *addFileDialog = new AddFileDialog(this);
   addFileDialog->setSelected(gridType);
@@ -1,29 +1,15 @@
 #ifndef SOURCES_FORM_H
 #define SOURCES_FORM_H
 #include <QAction>
-#include <QTreeWidget>
+#include <QLabel>
+#include <QTreeView>
 #include <QWidget>
 
 #include "NewProject/ProjectManager/project_manager.h"
 #include "add_file_dialog.h"
 #include "create_fileset_dialog.h"
-
-#define SRC_TREE_DESIGN_TOP_ITEM "destopitem"
-#define SRC_TREE_CONSTR_TOP_ITEM "constrtopitem"
-#define SRC_TREE_SIM_TOP_ITEM "simtopitem"
-#define SRC_TREE_IP_TOP_ITEM "iptopitem"
-#define SRC_TREE_DESIGN_SET_ITEM "desfilesetitem"
-#define SRC_TREE_DESIGN_FILE_ITEM "desfileitem"
-#define SRC_TREE_CONSTR_SET_ITEM "constrfilesetitem"
-#define SRC_TREE_CONSTR_FILE_ITEM "constrfileitem"
-#define SRC_TREE_SIM_SET_ITEM "simfilesetitem"
-#define SRC_TREE_SIM_FILE_ITEM "simfileitem"
-#define SRC_TREE_IP_SET_ITEM "ipfilesetitem"
-#define SRC_TREE_IP_INST_ITEM "ipinstitem"
-#define SRC_TREE_IP_FILE_ITEM "ipfileitem"
-
-#define SRC_TREE_FLG_ACTIVE tr(" (Active)")
-#define SRC_TREE_FLG_TARGET tr(" (Target)")
+#include "hierarchy_model.h"
+#include "sources_model.h"
 
 namespace Ui {
 class SourcesForm;
@@ -45,10 +31,13 @@ class SourcesForm : public QWidget {
 
   void CreateConstraint();
   void UpdateSrcHierachyTree();
+  // Reloads the elaborated hierarchy, e.g. after analysis
+  void UpdateDesignHierarchy();
   QAction* ProjectSettingsActions() const;
 
  signals:
   void OpenFile(QString);
+  void OpenFileWithLine(const QString& file, int line);
   void ShowProperty(const QString&);
   void ShowPropertyPanel();
   void CloseProject();
@@ -59,8 +48,8 @@ class SourcesForm : public QWidget {
   void OpenProjectSettings();
 
  private slots:
-  void SlotItempressed(QTreeWidgetItem* item, int column);
-  void SlotItemDoubleClicked(QTreeWidgetItem* item, int column);
+  void SlotItempressed(const QModelIndex& index);
+  void SlotItemDoubleClicked(const QModelIndex& index);
 
   void SetCurrentFileItem(const QString& strFileName);
   void SlotRefreshSourceTree();
@@ -77,11 +66,15 @@ class SourcesForm : public QWidget {
   void SlotReConfigureIp();
   void SlotRemoveIp();
   void SlotDeleteIp();
+  void SlotDesignHierarchyPressed(const QModelIndex& index);
+  void SlotGoToDefinition();
+  void SlotGoToInstance();
 
  private:
   Ui::SourcesForm* ui;
 
-  QTreeWidget* m_treeSrcHierachy;
+  QTreeView* m_treeSrcHierachy;
+  SourcesModel* m_model{nullptr};
   QAction* m_actRefresh;
   QAction* m_actEditConstrsSets;
   QAction* m_actEditSimulSets;
@@ -98,19 +91,17 @@ class SourcesForm : public QWidget {
   QAction* m_actDeleteIp;
   QAction* m_actProjectSettings;
 
+  QTreeView* m_treeDesignHierarchy;
+  QLabel* m_designHierarchyStatus;
+  HierarchyModel* m_hierarchyModel{nullptr};
+  QAction* m_actGoToDefinition;
+  QAction* m_actGoToInstance;
+  QAction* m_actRefreshDesignHierarchy;
+
   ProjectManager* m_projManager;
 
   void CreateActions();
-  void CreateFolderHierachyTree();
-  static QTreeWidgetItem* CreateFolderHierachyTree(QTreeWidgetItem* topItem,
-                                                   const QString& path);
-  static QTreeWidgetItem* CreateParentFolderItem(QTreeWidgetItem* parent,
-                                                 const QString& text);
-  static QTreeWidgetItem* ChildByText(QTreeWidgetItem* topItem,
-                                      const QString& text);
-  static QString StripPath(const QString& path);
   void showAddFileDialog(GridType gridType);
-  void AddIpInstanceTree(QTreeWidgetItem* topItem);
   QStringList SelectedIpModules() const;
 };
 }  // namespace FOEDAG
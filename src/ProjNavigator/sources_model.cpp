@@ -0,0 +1,408 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "sources_model.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QIcon>
+#include <algorithm>
+
+#include "Compiler/Compiler.h"
+#include "IPGenerate/IPGenerator.h"
+#include "Main/Foedag.h"
+#include "NewProject/ProjectManager/project.h"
+#include "NewProject/ProjectManager/project_manager.h"
+#include "Utils/FileUtils.h"
+
+namespace FOEDAG {
+
+struct SourcesModel::Node {
+  QString text;
+  QString data;     // Qt::UserRole: file path or IP name
+  QString fileSet;  // FileSetRole
+  QString kind;     // Qt::WhatsThisPropertyRole, one of SRC_TREE_*
+  bool file{false};
+  Node *parent{nullptr};
+  std::vector<std::unique_ptr<Node>> children;
+  // Children the view knows about, the others are still to be fetched
+  int fetched{0};
+
+  int row() const {
+    if (!parent) return 0;
+    auto itr = std::find_if(parent->children.begin(), parent->children.end(),
+                            [this](const std::unique_ptr<Node> &node) {
+                              return node.get() == this;
+                            });
+    return static_cast<int>(std::distance(parent->children.begin(), itr));
+  }
+};
+
+SourcesModel::SourcesModel(ProjectManager *projManager, QObject *parent)
+    : QAbstractItemModel(parent), m_projManager(projManager) {
+  Project *project = Project::Instance();
+  connect(project, &Project::projectReset, this, &SourcesModel::reload);
+  connect(project, &Project::projectPathChanged, this,
+          &SourcesModel::projectChanged);
+  connect(project, &Project::fileSetAdded, this, &SourcesModel::fileSetAdded);
+  connect(project, &Project::fileSetRemoved, this,
+          &SourcesModel::fileSetRemoved);
+  connect(project, &Project::fileAdded, this, &SourcesModel::fileAdded);
+  connect(project, &Project::fileRemoved, this, &SourcesModel::fileRemoved);
+  connect(project, &Project::fileSetOptionChanged, this,
+          &SourcesModel::fileSetOptionChanged);
+  reload();
+}
+
+SourcesModel::~SourcesModel() = default;
+
+QModelIndex SourcesModel::index(int row, int column,
+                                const QModelIndex &parent) const {
+  Node *node = nodeOf(parent);
+  if (column != 0 || row < 0 || row >= node->fetched) return {};
+  return createIndex(row, column, node->children[row].get());
+}
+
+QModelIndex SourcesModel::parent(const QModelIndex &child) const {
+  if (!child.isValid()) return {};
+  return indexOf(nodeOf(child)->parent);
+}
+
+int SourcesModel::rowCount(const QModelIndex &parent) const {
+  if (parent.column() > 0) return 0;
+  return nodeOf(parent)->fetched;
+}
+
+int SourcesModel::columnCount(const QModelIndex &parent) const { return 1; }
+
+bool SourcesModel::hasChildren(const QModelIndex &parent) const {
+  return !nodeOf(parent)->children.empty();
+}
+
+bool SourcesModel::canFetchMore(const QModelIndex &parent) const {
+  const Node *node = nodeOf(parent);
+  return node->fetched < static_cast<int>(node->children.size());
+}
+
+void SourcesModel::fetchMore(const QModelIndex &parent) {
+  Node *node = nodeOf(parent);
+  fetchUpTo(node, node->fetched + FetchBatch - 1);
+}
+
+QVariant SourcesModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid()) return {};
+  const Node *node = nodeOf(index);
+  switch (role) {
+    case Qt::DisplayRole:
+      if (node->kind == SRC_TREE_CONSTR_FILE_ITEM &&
+          node->text == m_projManager->getConstrTargetFile(node->fileSet))
+        return node->text + SRC_TREE_FLG_TARGET;
+      if (node->parent && node->parent->parent == m_root.get())
+        return QString{"%1(%2)"}.arg(node->text).arg(node->children.size());
+      return node->text;
+    case Qt::DecorationRole:
+      if (node->file) return QIcon(":/img/file.png");
+      break;
+    case Qt::ToolTipRole:
+      if (node->kind == SRC_TREE_IP_FILE_ITEM) return node->data;
+      break;
+    case Qt::UserRole:
+      return node->data;
+    case Qt::WhatsThisPropertyRole:
+      return node->kind;
+    case FileSetRole:
+      return node->fileSet;
+    default:
+      break;
+  }
+  return {};
+}
+
+void SourcesModel::reload() {
+  beginResetModel();
+  m_root = std::make_unique<Node>();
+  auto project = std::make_unique<Node>();
+  project->text = m_projManager->getProjectName().isEmpty()
+                      ? "undefined"
+                      : m_projManager->getProjectName();
+  project->parent = m_root.get();
+
+  const std::vector<std::pair<QString, QString>> groups{
+      {tr("Design Sources"), SRC_TREE_DESIGN_TOP_ITEM},
+      {tr("Constraints"), SRC_TREE_CONSTR_TOP_ITEM},
+      {tr("Simulation Sources"), SRC_TREE_SIM_TOP_ITEM},
+      {tr("IP Instances"), SRC_TREE_IP_TOP_ITEM}};
+  for (const auto &[text, kind] : groups) {
+    auto group = std::make_unique<Node>();
+    group->text = text;
+    group->kind = kind;
+    group->parent = project.get();
+    project->children.push_back(std::move(group));
+  }
+  project->fetched = GroupCount;
+  m_root->children.push_back(std::move(project));
+  m_root->fetched = 1;
+
+  QStringList fileSets = m_projManager->getDesignFileSets();
+  fileSets += m_projManager->getConstrFileSets();
+  fileSets += m_projManager->getSimulationFileSets();
+  for (const auto &fileSet : fileSets) {
+    Node *parent = groupOf(fileSet);
+    for (auto &node : createFiles(fileSet)) {
+      node->parent = parent;
+      parent->children.push_back(std::move(node));
+    }
+  }
+  Node *ips = group(IpInstances);
+  for (auto &node : createIpInstances()) {
+    node->parent = ips;
+    ips->children.push_back(std::move(node));
+  }
+  endResetModel();
+}
+
+void SourcesModel::reloadIpInstances() {
+  Node *ips = group(IpInstances);
+  while (!ips->children.empty())
+    removeChild(ips, static_cast<int>(ips->children.size()) - 1);
+  appendChildren(ips, createIpInstances());
+  groupChanged(ips);
+}
+
+QModelIndex SourcesModel::fileIndex(const QString &filePath) {
+  const QString projectPath = m_projManager->getProjectPath();
+  for (int g = Design; g < GroupCount; g++) {
+    Node *parent = group(static_cast<Group>(g));
+    std::vector<Node *> nodes{parent};
+    if (g == IpInstances) {
+      nodes.clear();
+      for (auto &instance : parent->children) nodes.push_back(instance.get());
+    }
+    for (Node *node : nodes) {
+      for (size_t row = 0; row < node->children.size(); row++) {
+        QString path = node->children[row]->data;
+        if (path.replace(PROJECT_OSRCDIR, projectPath) != filePath) continue;
+        if (node != parent) fetchUpTo(parent, node->row());
+        fetchUpTo(node, static_cast<int>(row));
+        return indexOf(node->children[row].get());
+      }
+    }
+  }
+  return {};
+}
+
+void SourcesModel::projectChanged() {
+  Node *project = m_root->children.front().get();
+  const QString name = m_projManager->getProjectName();
+  project->text = name.isEmpty() ? "undefined" : name;
+  const QModelIndex index = indexOf(project);
+  emit dataChanged(index, index);
+}
+
+void SourcesModel::fileSetAdded(const QString &fileSet) {
+  // the set may come with files, e.g. while a project is loaded
+  Node *parent = groupOf(fileSet);
+  if (!parent) return;
+  appendChildren(parent, createFiles(fileSet));
+  groupChanged(parent);
+}
+
+void SourcesModel::fileSetRemoved(const QString &fileSet) {
+  for (int g = Design; g < IpInstances; g++) {
+    Node *parent = group(static_cast<Group>(g));
+    const size_t count = parent->children.size();
+    for (int row = static_cast<int>(count) - 1; row >= 0; row--)
+      if (parent->children[row]->fileSet == fileSet) removeChild(parent, row);
+    if (parent->children.size() != count) groupChanged(parent);
+  }
+}
+
+void SourcesModel::fileAdded(const QString &fileSet, const QString &filePath) {
+  Node *parent = groupOf(fileSet);
+  if (!parent) return;
+  std::vector<std::unique_ptr<Node>> nodes;
+  nodes.push_back(createFile(parent->kind, fileSet, filePath));
+  appendChildren(parent, std::move(nodes));
+  groupChanged(parent);
+}
+
+void SourcesModel::fileRemoved(const QString &fileSet,
+                               const QString &filePath) {
+  Node *parent = groupOf(fileSet);
+  if (!parent) return;
+  for (size_t row = 0; row < parent->children.size(); row++) {
+    const Node *node = parent->children[row].get();
+    if (node->fileSet == fileSet && node->data == filePath) {
+      removeChild(parent, static_cast<int>(row));
+      groupChanged(parent);
+      return;
+    }
+  }
+}
+
+void SourcesModel::fileSetOptionChanged(const QString &fileSet,
+                                        const QString &key) {
+  // Only the target constraint file is shown in the tree
+  if (key != PROJECT_FILE_CONFIG_TARGET) return;
+  Node *parent = group(Constraints);
+  for (int row = 0; row < parent->fetched; row++) {
+    Node *node = parent->children[row].get();
+    if (node->fileSet != fileSet) continue;
+    const QModelIndex index = indexOf(node);
+    emit dataChanged(index, index, {Qt::DisplayRole});
+  }
+}
+
+SourcesModel::Node *SourcesModel::nodeOf(const QModelIndex &index) const {
+  if (!index.isValid()) return m_root.get();
+  return static_cast<Node *>(index.internalPointer());
+}
+
+QModelIndex SourcesModel::indexOf(Node *node) const {
+  if (!node || node == m_root.get()) return {};
+  return createIndex(node->row(), 0, node);
+}
+
+SourcesModel::Node *SourcesModel::group(Group group) const {
+  return m_root->children.front()->children[group].get();
+}
+
+SourcesModel::Node *SourcesModel::groupOf(const QString &fileSet) const {
+  ProjectFileSet *set = Project::Instance()->getProjectFileset(fileSet);
+  if (!set) return nullptr;
+  const QString type = set->getSetType();
+  if (type == PROJECT_FILE_TYPE_DS) return group(Design);
+  if (type == PROJECT_FILE_TYPE_CS) return group(Constraints);
+  if (type == PROJECT_FILE_TYPE_SS) return group(Simulation);
+  return nullptr;
+}
+
+void SourcesModel::groupChanged(Node *group) {
+  // the group text carries the number of files
+  const QModelIndex index = indexOf(group);
+  emit dataChanged(index, index, {Qt::DisplayRole});
+}
+
+void SourcesModel::appendChildren(Node *parent,
+                                  std::vector<std::unique_ptr<Node>> nodes) {
+  if (nodes.empty()) return;
+  // New rows are only announced when the view has seen all the others,
+  // otherwise they are fetched with them
+  const bool announce =
+      parent->fetched == static_cast<int>(parent->children.size());
+  const int first = static_cast<int>(parent->children.size());
+  const int last = first + static_cast<int>(nodes.size()) - 1;
+  if (announce) beginInsertRows(indexOf(parent), first, last);
+  for (auto &node : nodes) {
+    node->parent = parent;
+    parent->children.push_back(std::move(node));
+  }
+  if (announce) {
+    parent->fetched = last + 1;
+    endInsertRows();
+  }
+}
+
+void SourcesModel::removeChild(Node *parent, int row) {
+  const bool announce = row < parent->fetched;
+  if (announce) beginRemoveRows(indexOf(parent), row, row);
+  parent->children.erase(parent->children.begin() + row);
+  if (announce) {
+    parent->fetched--;
+    endRemoveRows();
+  }
+}
+
+void SourcesModel::fetchUpTo(Node *parent, int row) {
+  row = std::min(row, static_cast<int>(parent->children.size()) - 1);
+  if (row < parent->fetched) return;
+  beginInsertRows(indexOf(parent), parent->fetched, row);
+  parent->fetched = row + 1;
+  endInsertRows();
+}
+
+std::unique_ptr<SourcesModel::Node> SourcesModel::createFile(
+    const QString &kind, const QString &fileSet,
+    const QString &filePath) const {
+  auto node = std::make_unique<Node>();
+  node->text = filePath.mid(filePath.lastIndexOf("/") + 1);
+  node->data = filePath;
+  node->fileSet = fileSet;
+  node->file = true;
+  if (kind == SRC_TREE_DESIGN_TOP_ITEM)
+    node->kind = SRC_TREE_DESIGN_FILE_ITEM;
+  else if (kind == SRC_TREE_CONSTR_TOP_ITEM)
+    node->kind = SRC_TREE_CONSTR_FILE_ITEM;
+  else if (kind == SRC_TREE_SIM_TOP_ITEM)
+    node->kind = SRC_TREE_SIM_FILE_ITEM;
+  else
+    node->kind = SRC_TREE_IP_FILE_ITEM;
+  return node;
+}
+
+std::vector<std::unique_ptr<SourcesModel::Node>> SourcesModel::createFiles(
+    const QString &fileSet) const {
+  std::vector<std::unique_ptr<Node>> nodes;
+  ProjectFileSet *set = Project::Instance()->getProjectFileset(fileSet);
+  Node *parent = groupOf(fileSet);
+  if (!set || !parent) return nodes;
+  nodes.reserve(set->getMapFiles().size());
+  for (const auto &[name, path] : set->getMapFiles())
+    nodes.push_back(createFile(parent->kind, fileSet, path));
+  return nodes;
+}
+
+std::vector<std::unique_ptr<SourcesModel::Node>>
+SourcesModel::createIpInstances() const {
+  std::vector<std::unique_ptr<Node>> nodes;
+  Compiler *compiler = nullptr;
+  IPGenerator *ipGen = nullptr;
+  if (!GlobalSession || !(compiler = GlobalSession->GetCompiler()) ||
+      !(ipGen = compiler->GetIPGenerator()))
+    return nodes;
+  for (auto instance : ipGen->IPInstances()) {
+    const QString ipName = QString::fromStdString(instance->IPName());
+    auto itemIp = std::make_unique<Node>();
+    itemIp->text = QString::fromStdString(instance->ModuleName());
+    itemIp->data = ipName;
+    itemIp->fileSet = ipName;
+    itemIp->kind = SRC_TREE_IP_INST_ITEM;
+
+    // Files of the IP build src directory (non-recursive)
+    std::filesystem::path srcDirPath = ipGen->GetBuildDir(instance) / "src";
+    QDirIterator it(
+        QString::fromStdString(FileUtils::GetFullPath(srcDirPath).string()),
+        QDir::Files);
+    while (it.hasNext()) {
+      QFileInfo info(it.next());
+      auto file =
+          createFile(SRC_TREE_IP_TOP_ITEM, info.absoluteFilePath(),
+                     info.absoluteFilePath());
+      file->parent = itemIp.get();
+      itemIp->children.push_back(std::move(file));
+    }
+    itemIp->fetched = static_cast<int>(itemIp->children.size());
+    nodes.push_back(std::move(itemIp));
+  }
+  return nodes;
+}
+
+}  // namespace FOEDAG
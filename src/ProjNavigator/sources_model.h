@@ -0,0 +1,123 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <QAbstractItemModel>
+#include <memory>
+#include <vector>
+
+#define SRC_TREE_DESIGN_TOP_ITEM "destopitem"
+#define SRC_TREE_CONSTR_TOP_ITEM "constrtopitem"
+#define SRC_TREE_SIM_TOP_ITEM "simtopitem"
+#define SRC_TREE_IP_TOP_ITEM "iptopitem"
+#define SRC_TREE_DESIGN_SET_ITEM "desfilesetitem"
+#define SRC_TREE_DESIGN_FILE_ITEM "desfileitem"
+#define SRC_TREE_CONSTR_SET_ITEM "constrfilesetitem"
+#define SRC_TREE_CONSTR_FILE_ITEM "constrfileitem"
+#define SRC_TREE_SIM_SET_ITEM "simfilesetitem"
+#define SRC_TREE_SIM_FILE_ITEM "simfileitem"
+#define SRC_TREE_IP_SET_ITEM "ipfilesetitem"
+#define SRC_TREE_IP_INST_ITEM "ipinstitem"
+#define SRC_TREE_IP_FILE_ITEM "ipfileitem"
+
+#define SRC_TREE_FLG_ACTIVE tr(" (Active)")
+#define SRC_TREE_FLG_TARGET tr(" (Target)")
+
+namespace FOEDAG {
+
+class ProjectManager;
+
+/*!
+ * \brief The SourcesModel class is the project navigator tree: project, the
+ * design/constraint/simulation/IP groups and their files.
+ *
+ * It follows the fine grained change signals of Project so that adding or
+ * removing files costs time proportional to the change and the view keeps
+ * its expansion state. Files of a group are handed to the view in batches
+ * (canFetchMore/fetchMore) so that large file sets load lazily.
+ */
+class SourcesModel : public QAbstractItemModel {
+  Q_OBJECT
+
+ public:
+  // File set of a file item
+  static constexpr int FileSetRole{Qt::UserRole + 1};
+  static constexpr int FetchBatch{500};
+
+  explicit SourcesModel(ProjectManager *projManager, QObject *parent = nullptr);
+  ~SourcesModel() override;
+
+  QModelIndex index(int row, int column,
+                    const QModelIndex &parent = QModelIndex()) const override;
+  QModelIndex parent(const QModelIndex &child) const override;
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index, int role) const override;
+  bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+  bool canFetchMore(const QModelIndex &parent) const override;
+  void fetchMore(const QModelIndex &parent) override;
+
+  /*!
+   * \brief reload rebuilds the whole tree, e.g. after a project was opened.
+   */
+  void reload();
+  /*!
+   * \brief reloadIpInstances rebuilds the IP instances group only, IP
+   * instances have no change notification.
+   */
+  void reloadIpInstances();
+  /*!
+   * \brief fileIndex returns the item of the file with the given full path,
+   * fetching the rows up to it if needed.
+   */
+  QModelIndex fileIndex(const QString &filePath);
+
+ private slots:
+  void projectChanged();
+  void fileSetAdded(const QString &fileSet);
+  void fileSetRemoved(const QString &fileSet);
+  void fileAdded(const QString &fileSet, const QString &filePath);
+  void fileRemoved(const QString &fileSet, const QString &filePath);
+  void fileSetOptionChanged(const QString &fileSet, const QString &key);
+
+ private:
+  struct Node;
+  enum Group { Design, Constraints, Simulation, IpInstances, GroupCount };
+
+  Node *nodeOf(const QModelIndex &index) const;
+  QModelIndex indexOf(Node *node) const;
+  Node *groupOf(const QString &fileSet) const;
+  Node *group(Group group) const;
+  void groupChanged(Node *group);
+
+  void appendChildren(Node *parent, std::vector<std::unique_ptr<Node>> nodes);
+  void removeChild(Node *parent, int row);
+  void fetchUpTo(Node *parent, int row);
+  std::unique_ptr<Node> createFile(const QString &kind, const QString &fileSet,
+                                   const QString &filePath) const;
+  std::vector<std::unique_ptr<Node>> createFiles(const QString &fileSet) const;
+  std::vector<std::unique_ptr<Node>> createIpInstances() const;
+
+  ProjectManager *m_projManager{nullptr};
+  std::unique_ptr<Node> m_root;
+};
+
+}  // namespace FOEDAG
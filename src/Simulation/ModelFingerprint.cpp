@@ -0,0 +1,152 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "ModelFingerprint.h"
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include "Utils/FileIndex.h"
+#include "Utils/FileUtils.h"
+#include "Utils/StringUtils.h"
+
+namespace fs = std::filesystem;
+
+namespace FOEDAG {
+
+// FNV-1a, stable across runs and platforms
+void ModelFingerprint::Add(std::string_view text) {
+  for (unsigned char c : text) {
+    m_hash ^= c;
+    m_hash *= 1099511628211ULL;
+  }
+  m_hash ^= 0xff;
+  m_hash *= 1099511628211ULL;
+}
+
+void ModelFingerprint::addFile(const fs::path& path) {
+  std::error_code ec;
+  auto size = fs::file_size(path, ec);
+  if (ec) return;
+  Add(path.string());
+  Add(std::to_string(size));
+  Add(std::to_string(FileUtils::Mtime(path)));
+}
+
+static bool IsVerilog(const fs::path& path) {
+  static const std::set<std::string> extensions{
+      ".v", ".sv", ".vh", ".svh", ".vlg", ".verilog", ".inc"};
+  return extensions.count(StringUtils::toLower(path.extension().string()));
+}
+
+void ModelFingerprint::AddCommand(const std::string& command,
+                                  const std::string& includeDirective,
+                                  const fs::path& baseDir) {
+  Add(command);
+  std::vector<std::string> tokens;
+  StringUtils::tokenize(command, " ", tokens);
+  std::vector<fs::path> sources;
+  std::vector<fs::path> includeDirs;
+  for (auto token : tokens) {
+    const bool include = !includeDirective.empty() &&
+                         StringUtils::startsWith(token, includeDirective);
+    if (include) token = token.substr(includeDirective.size());
+    if (token.empty()) continue;
+    fs::path path = token;
+    if (!path.is_absolute()) path = baseDir / path;
+    std::error_code ec;
+    if (fs::is_regular_file(path, ec)) {
+      addFile(path);
+      if (IsVerilog(path)) sources.push_back(path);
+    } else if (fs::is_directory(path, ec)) {
+      if (include) includeDirs.push_back(path);
+      for (const auto& entry : fs::directory_iterator(path, ec)) {
+        if (entry.is_regular_file(ec)) addFile(entry.path());
+      }
+    }
+  }
+  std::set<fs::path> found;
+  for (const auto& source : sources) includes(source, includeDirs, found);
+  // Also covers files that aren't included anymore
+  Add(std::to_string(found.size()));
+  for (const auto& file : found) addFile(file);
+}
+
+std::string ModelFingerprint::Hex() const {
+  std::stringstream stream;
+  stream << std::hex << std::setw(16) << std::setfill('0') << m_hash;
+  return stream.str();
+}
+
+void ModelFingerprint::includes(const fs::path& file,
+                                const std::vector<fs::path>& includeDirs,
+                                std::set<fs::path>& found) {
+  std::vector<fs::path> names;
+  std::ifstream stream(file);
+  std::string line;
+  while (std::getline(stream, line)) {
+    const size_t pos = line.find("`include");
+    if (pos == std::string::npos) continue;
+    const size_t comment = line.find("//");
+    if (comment != std::string::npos && comment < pos) continue;
+    const size_t begin = line.find('"', pos);
+    const size_t end = line.find('"', begin + 1);
+    if (begin == std::string::npos || end == std::string::npos) continue;
+    names.emplace_back(line.substr(begin + 1, end - begin - 1));
+  }
+  stream.close();
+
+  // All the names of the file are resolved in one lookup per directory,
+  // through the file index: include directories are often on NFS
+  std::vector<fs::path> dirs{file.parent_path()};
+  dirs.insert(dirs.end(), includeDirs.begin(), includeDirs.end());
+  std::vector<fs::path> resolved(names.size());
+  for (const auto& dir : dirs) {
+    // "sub/defs.vh" is looked up in dir/sub
+    std::map<fs::path, std::vector<size_t>> roots;
+    for (size_t i = 0; i < names.size(); i++)
+      if (resolved[i].empty())
+        roots[(dir / names[i]).parent_path()].push_back(i);
+    for (const auto& [root, indexes] : roots) {
+      std::vector<std::string> files;
+      for (size_t i : indexes) files.push_back(names[i].filename().string());
+      auto paths = FileIndex::Instance().Find(root, files, false);
+      for (size_t j = 0; j < indexes.size(); j++)
+        if (!paths[j].empty()) resolved[indexes[j]] = paths[j].front();
+    }
+  }
+  for (const auto& path : resolved) {
+    if (path.empty()) continue;
+    const fs::path included = path.lexically_normal();
+    // Already visited, include guards make cycles legal
+    if (found.insert(included).second) includes(included, includeDirs, found);
+  }
+}
+
+std::vector<fs::path> ModelFingerprint::Includes(
+    const fs::path& file, const std::vector<fs::path>& includeDirs) {
+  std::set<fs::path> found;
+  includes(file, includeDirs, found);
+  return {found.begin(), found.end()};
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,70 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The ModelFingerprint class hashes what a simulation model is built
+ * from. It covers the command, the options, and the size and mtime of every
+ * file the command names. It also covers the files in the include
+ * directories the command names, and every file reached through `include,
+ * transitively.
+ */
+class ModelFingerprint {
+ public:
+  void Add(std::string_view text);
+  /*!
+   * \brief AddCommand hashes \p command and the files it names. Tokens
+   * starting with \p includeDirective name include directories. Relative
+   * paths are resolved against \p baseDir.
+   */
+  void AddCommand(const std::string& command,
+                  const std::string& includeDirective,
+                  const std::filesystem::path& baseDir);
+  std::string Hex() const;
+
+  /*!
+   * \brief Includes returns the files `included by \p file, transitively.
+   * A file is looked up next to the file that includes it, then in
+   * \p includeDirs.
+   */
+  static std::vector<std::filesystem::path> Includes(
+      const std::filesystem::path& file,
+      const std::vector<std::filesystem::path>& includeDirs);
+
+ private:
+  void addFile(const std::filesystem::path& path);
+  static void includes(const std::filesystem::path& file,
+                       const std::vector<std::filesystem::path>& includeDirs,
+                       std::set<std::filesystem::path>& found);
+
+  uint64_t m_hash{14695981039346656037ULL};  // FNV-1a
+};
+
+}  // namespace FOEDAG
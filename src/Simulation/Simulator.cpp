@@ -39,11 +39,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <chrono>
 #include <ctime>
 #include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <sstream>
 #include <thread>
 
 #include "Compiler/Compiler.h"
 #include "Compiler/Log.h"
+#include "ModelFingerprint.h"
 #include "NewProject/ProjectManager/project_manager.h"
 #include "Simulator.h"
 #include "Utils/FileUtils.h"
@@ -127,6 +130,90 @@ bool Simulator::RegisterCommands(TclInterpreter* interp) {
     return TCL_ERROR;
   };
   interp->registerCmd("simulation_options", simulation_options, this, 0);
+
+  auto simulation_build_options = [](void* clientData, Tcl_Interp* interp,
+                                     int argc, const char* argv[]) -> int {
+    Simulator* simulator = (Simulator*)clientData;
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      if (arg == "-jobs" && i + 1 < argc) {
+        int jobs = 0;
+        std::string value = argv[++i];
+        auto [ptr, ec] =
+            std::from_chars(value.data(), value.data() + value.size(), jobs);
+        if (ec != std::errc() || jobs < 0) {
+          simulator->ErrorMessage("Invalid number of jobs: " + value);
+          return TCL_ERROR;
+        }
+        simulator->SetSimulationJobs(jobs);
+      } else if (arg == "-objcache" && i + 1 < argc) {
+        simulator->SetObjectCache(argv[++i]);
+      } else if (arg == "-cache" && i + 1 < argc) {
+        std::string value = argv[++i];
+        if (value == "on") {
+          simulator->SetBuildCache(true);
+        } else if (value == "off") {
+          simulator->SetBuildCache(false);
+        } else {
+          simulator->ErrorMessage("Invalid cache mode: " + value);
+          return TCL_ERROR;
+        }
+      } else {
+        simulator->ErrorMessage("Unknown simulation build option: " + arg);
+        return TCL_ERROR;
+      }
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("simulation_build_options", simulation_build_options,
+                      this, 0);
+
+  auto simulation_variant = [](void* clientData, Tcl_Interp* interp, int argc,
+                               const char* argv[]) -> int {
+    Simulator* simulator = (Simulator*)clientData;
+    if (argc < 2) {
+      simulator->ErrorMessage(
+          "Wrong number of arguments: simulation_variant <name> ?<options>? | "
+          "-seeds <count> ?<options>? | -clear");
+      return TCL_ERROR;
+    }
+    std::string first = argv[1];
+    if (first == "-clear") {
+      simulator->ClearRegressionVariants();
+      return TCL_OK;
+    }
+    int optionsStart = 2;
+    int seeds = 0;
+    if (first == "-seeds") {
+      if (argc < 3) {
+        simulator->ErrorMessage("Missing seed count");
+        return TCL_ERROR;
+      }
+      std::string value = argv[2];
+      auto [ptr, ec] =
+          std::from_chars(value.data(), value.data() + value.size(), seeds);
+      if (ec != std::errc() || seeds <= 0) {
+        simulator->ErrorMessage("Invalid seed count: " + value);
+        return TCL_ERROR;
+      }
+      optionsStart = 3;
+    }
+    std::string options;
+    for (int i = optionsStart; i < argc; i++) {
+      options += std::string(argv[i]) + " ";
+    }
+    options = StringUtils::rtrim(options);
+    if (seeds == 0) {
+      simulator->AddRegressionVariant({first, options});
+    } else {
+      for (int seed = 1; seed <= seeds; seed++) {
+        simulator->AddRegressionVariant(
+            {"seed_" + std::to_string(seed), options, seed});
+      }
+    }
+    return TCL_OK;
+  };
+  interp->registerCmd("simulation_variant", simulation_variant, this, 0);
   return ok;
 }
 
@@ -156,6 +243,16 @@ std::string Simulator::GetSimulatorRuntimeOption(SimulatorType type) {
   return "";
 }
 
+uint32_t Simulator::SimulationJobs() const {
+  if (m_jobs != 0) return m_jobs;
+  uint32_t cores = std::thread::hardware_concurrency();
+  return (cores == 0) ? 1 : cores;
+}
+
+void Simulator::AddRegressionVariant(const RegressionVariant& variant) {
+  m_regressionVariants.push_back(variant);
+}
+
 bool Simulator::Simulate(SimulationType action, SimulatorType type,
                          const std::string& wave_file) {
   m_waveFile = wave_file;
@@ -181,6 +278,10 @@ bool Simulator::Simulate(SimulationType action, SimulatorType type,
       return SimulateBitstream(type);
       break;
     }
+    case SimulationType::Regression: {
+      return SimulateRegression(type);
+      break;
+    }
   }
   return false;
 }
@@ -295,6 +396,8 @@ std::filesystem::path Simulator::SimulatorExecPath(SimulatorType type) {
   if (itr != m_simulatorPathMap.end()) {
     return (*itr).second;
   }
+  if (const char* toolsPath = std::getenv("FOEDAG_TOOLS_PATH"))
+    return toolsPath;
   return "";
 }
 
@@ -522,7 +625,30 @@ std::string Simulator::SimulationFileList(SimulatorType type) {
   return fileList;
 }
 
-int Simulator::SimulationJob(SimulatorType type, const std::string& fileList) {
+std::string Simulator::SimulationFingerprint(SimulatorType type,
+                                             const std::string& command) {
+  ModelFingerprint fingerprint;
+  auto itr = m_simulatorElaborationOptionMap.find(type);
+  if (itr != m_simulatorElaborationOptionMap.end())
+    fingerprint.Add(itr->second);
+  fingerprint.Add(m_objcache);
+  fingerprint.AddCommand(command, IncludeDirective(type),
+                         ProjManager()->projectPath());
+  return fingerprint.Hex();
+}
+
+std::filesystem::path Simulator::FingerprintFile(SimulatorType type) const {
+  return std::filesystem::path(ProjManager()->projectPath()) / "obj_dir" /
+         (".foedag_" + m_simulationTop + ".fingerprint");
+}
+
+std::filesystem::path Simulator::SimulationModel(SimulatorType type) const {
+  return std::filesystem::path(ProjManager()->projectPath()) / "obj_dir" /
+         ("V" + m_simulationTop);
+}
+
+int Simulator::SimulationCompile(SimulatorType type,
+                                 const std::string& fileList) {
   if (type == SimulatorType::Verilator) {
     std::string verilator_home = SimulatorExecPath(type).parent_path().string();
     m_compiler->SetEnvironmentVariable("VERILATOR_ROOT", verilator_home);
@@ -535,6 +661,20 @@ int Simulator::SimulationJob(SimulatorType type, const std::string& fileList) {
   if (!GetSimulatorCompileOption(type).empty())
     command += " " + GetSimulatorCompileOption(type);
   command += " " + fileList;
+
+  // Only Verilator builds a standalone model that is worth caching
+  std::string fingerprint;
+  if (type == SimulatorType::Verilator && m_buildCache) {
+    fingerprint = SimulationFingerprint(type, command);
+    std::ifstream stored(FingerprintFile(type));
+    std::string previous;
+    stored >> previous;
+    if (previous == fingerprint && FileUtils::FileExists(SimulationModel(type))) {
+      Message("Simulation model is up to date, skipping compilation");
+      return 0;
+    }
+  }
+
   int status = m_compiler->ExecuteAndMonitorSystemCommand(command);
   if (status) {
     ErrorMessage("Design " + ProjManager()->projectName() +
@@ -545,8 +685,10 @@ int Simulator::SimulationJob(SimulatorType type, const std::string& fileList) {
   // Extra Simulator Model compilation step (Elaboration or C++ compilation)
   switch (type) {
     case SimulatorType::Verilator: {
-      std::string command = "make -j -C obj_dir/ -f V" + m_simulationTop +
-                            ".mk V" + m_simulationTop;
+      std::string command = "make -j" + std::to_string(SimulationJobs());
+      if (!m_objcache.empty()) command += " OBJCACHE=" + m_objcache;
+      command += " -C obj_dir/ -f V" + m_simulationTop + ".mk V" +
+                 m_simulationTop;
       if (!GetSimulatorElaborationOption(type).empty())
         command += " " + GetSimulatorElaborationOption(type);
       status = m_compiler->ExecuteAndMonitorSystemCommand(command);
@@ -555,6 +697,10 @@ int Simulator::SimulationJob(SimulatorType type, const std::string& fileList) {
                      " simulation compilation failed!\n");
         return status;
       }
+      if (!fingerprint.empty()) {
+        std::ofstream stored(FingerprintFile(type));
+        stored << fingerprint << std::endl;
+      }
       break;
     }
     case SimulatorType::GHDL: {
@@ -575,18 +721,75 @@ int Simulator::SimulationJob(SimulatorType type, const std::string& fileList) {
     default:
       break;
   }
+  return status;
+}
+
+int Simulator::SimulationJob(SimulatorType type, const std::string& fileList) {
+  int status = SimulationCompile(type, fileList);
+  if (status) return status;
 
   // Actual simulation
-  command = SimulatorRunCommand(type);
+  std::string command = SimulatorRunCommand(type);
   status = m_compiler->ExecuteAndMonitorSystemCommand(command);
   return status;
 }
 
-bool Simulator::SimulateRTL(SimulatorType type) {
-  if (!ProjManager()->HasDesign() && !m_compiler->CreateDesign("noname"))
-    return false;
-  if (!m_compiler->HasTargetDevice()) return false;
+int Simulator::RunRegressionVariants(SimulatorType type) {
+  const std::filesystem::path projectPath = ProjManager()->projectPath();
+  const std::string waveFile = m_waveFile;
+  std::vector<Compiler::ToolCommand> commands;
+  for (const auto& variant : m_regressionVariants) {
+    std::string options = variant.options;
+    if (variant.seed >= 0) {
+      std::string seed = std::to_string(variant.seed);
+      options += (type == SimulatorType::Verilator)
+                     ? " +verilator+seed+" + seed
+                     : " +seed=" + seed;
+    }
+    // Each variant dumps its own waveform next to the requested one
+    if (!waveFile.empty()) {
+      std::filesystem::path wave = waveFile;
+      m_waveFile =
+          (wave.parent_path() / (wave.stem().string() + "_" + variant.name +
+                                 wave.extension().string()))
+              .string();
+    }
+    std::string command = SimulatorRunCommand(type);
+    if (!options.empty()) command += " " + StringUtils::trim(options);
+    Message("Regression " + variant.name + ": " + command);
+    commands.push_back(
+        {command,
+         (projectPath / (variant.name + "_simulation.log")).string()});
+  }
+  m_waveFile = waveFile;
+  // Admitted, limited and stopped like the other tools of the stage
+  auto results =
+      m_compiler->ExecuteAndMonitorSystemCommands(commands, SimulationJobs());
+
+  // Summary report
+  std::stringstream report;
+  int failures = 0;
+  long long total = 0;
+  report << std::left << std::setw(32) << "Variant" << std::setw(8)
+         << "Status" << "Runtime (ms)" << std::endl;
+  for (size_t i = 0; i < results.size(); i++) {
+    const bool pass = results[i].exitCode == 0;
+    if (!pass) failures++;
+    total += results[i].durationMs;
+    report << std::left << std::setw(32) << m_regressionVariants[i].name
+           << std::setw(8) << (pass ? "PASS" : "FAIL")
+           << results[i].durationMs << std::endl;
+  }
+  report << "Passed: " << results.size() - failures << "/" << results.size()
+         << ", cumulative runtime: " << total << " ms" << std::endl;
+  std::ofstream ofs(projectPath / (ProjManager()->projectName() +
+                                   "_simulation_regression.rpt"));
+  ofs << report.str();
+  Message(report.str());
+  return failures;
+}
 
+std::string Simulator::RTLFileList(SimulatorType type) {
   std::string fileList = SimulationFileList(type);
   bool langDirective = false;
   if (type == SimulatorType::GHDL) {
@@ -605,8 +808,15 @@ bool Simulator::SimulateRTL(SimulatorType type) {
     }
     fileList += lang_file.second + " ";
   }
+  return StringUtils::rtrim(fileList);
+}
+
+bool Simulator::SimulateRTL(SimulatorType type) {
+  if (!ProjManager()->HasDesign() && !m_compiler->CreateDesign("noname"))
+    return false;
+  if (!m_compiler->HasTargetDevice()) return false;
 
-  fileList = StringUtils::rtrim(fileList);
+  std::string fileList = RTLFileList(type);
 
   PERF_LOG("RTL Simulation has started");
   Message("##################################################");
@@ -626,6 +836,40 @@ bool Simulator::SimulateRTL(SimulatorType type) {
   return true;
 }
 
+bool Simulator::SimulateRegression(SimulatorType type) {
+  if (!ProjManager()->HasDesign() && !m_compiler->CreateDesign("noname"))
+    return false;
+  if (!m_compiler->HasTargetDevice()) return false;
+  if (m_regressionVariants.empty()) {
+    ErrorMessage("No regression variants, use simulation_variant first");
+    return false;
+  }
+  if (type != SimulatorType::Verilator && type != SimulatorType::GHDL) {
+    ErrorMessage("Regression is not supported for " + SimulatorName(type));
+    return false;
+  }
+
+  PERF_LOG("RTL Simulation regression has started");
+  Message("##################################################");
+  Message("RTL simulation regression for design: " +
+          ProjManager()->projectName());
+  Message("##################################################");
+
+  int status = SimulationCompile(type, RTLFileList(type));
+  if (status) return false;
+
+  int failures = RunRegressionVariants(type);
+  if (failures) {
+    ErrorMessage("Design " + ProjManager()->projectName() + ": " +
+                 std::to_string(failures) + " regression variant(s) failed!\n");
+    return false;
+  }
+
+  Message("RTL simulation regression for design: " +
+          ProjManager()->projectName() + " had ended");
+  return true;
+}
+
 bool Simulator::SimulateGate(SimulatorType type) {
   if (!ProjManager()->HasDesign() && !m_compiler->CreateDesign("noname"))
     return false;
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef SIMULATOR_H
 #define SIMULATOR_H
 
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <string>
@@ -37,7 +38,7 @@ class Compiler;
 class Simulator {
  public:
   enum class SimulatorType { Verilator, Icarus, GHDL, VCS, Questa, Xcelium };
-  enum class SimulationType { RTL, Gate, PNR, Bitstream };
+  enum class SimulationType { RTL, Gate, PNR, Bitstream, Regression };
   enum class WaveformType { VCD, FST };
 
   // Most common use case, create the compiler in your main
@@ -92,11 +93,34 @@ class Simulator {
   std::string GetSimulatorElaborationOption(SimulatorType type);
   std::string GetSimulatorRuntimeOption(SimulatorType type);
 
+  // Number of parallel jobs used for model builds and regression runs,
+  // 0 means one per available core
+  void SetSimulationJobs(uint32_t jobs) { m_jobs = jobs; }
+  uint32_t SimulationJobs() const;
+  // Reuse a previously built simulation model when its fingerprint matches
+  void SetBuildCache(bool on) { m_buildCache = on; }
+  bool BuildCache() const { return m_buildCache; }
+  // Compiler cache wrapper passed to the model build (ccache, objcache...)
+  void SetObjectCache(const std::string& objcache) { m_objcache = objcache; }
+  const std::string& ObjectCache() const { return m_objcache; }
+
+  struct RegressionVariant {
+    std::string name;
+    std::string options;
+    int seed{-1};
+  };
+  void AddRegressionVariant(const RegressionVariant& variant);
+  void ClearRegressionVariants() { m_regressionVariants.clear(); }
+  const std::vector<RegressionVariant>& RegressionVariants() const {
+    return m_regressionVariants;
+  }
+
  protected:
   virtual bool SimulateRTL(SimulatorType type);
   virtual bool SimulateGate(SimulatorType type);
   virtual bool SimulatePNR(SimulatorType type);
   virtual bool SimulateBitstream(SimulatorType type);
+  virtual bool SimulateRegression(SimulatorType type);
 
   virtual std::string SimulatorName(SimulatorType type);
   virtual std::filesystem::path SimulatorExecPath(SimulatorType type);
@@ -110,6 +134,14 @@ class Simulator {
                                         Design::Language lang);
   virtual std::string SimulationFileList(SimulatorType type);
   virtual int SimulationJob(SimulatorType type, const std::string& file_list);
+  virtual int SimulationCompile(SimulatorType type,
+                                const std::string& file_list);
+  virtual int RunRegressionVariants(SimulatorType type);
+  std::string RTLFileList(SimulatorType type);
+  std::string SimulationFingerprint(SimulatorType type,
+                                    const std::string& command);
+  std::filesystem::path FingerprintFile(SimulatorType type) const;
+  std::filesystem::path SimulationModel(SimulatorType type) const;
   virtual std::string SimulatorRunCommand(SimulatorType type);
   virtual std::string SimulatorCompilationOptions(SimulatorType type);
   class ProjectManager* ProjManager() const;
@@ -133,6 +165,10 @@ class Simulator {
   std::string m_simulationTop;
   std::string m_waveFile;
   WaveformType m_waveType = WaveformType::FST;
+  uint32_t m_jobs = 0;
+  bool m_buildCache = true;
+  std::string m_objcache;
+  std::vector<RegressionVariant> m_regressionVariants;
 };
 
 }  // namespace FOEDAG
@@ -0,0 +1,343 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "WaveformReader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+
+#include "Utils/FileUtils.h"
+#include "Utils/StringUtils.h"
+
+namespace FOEDAG {
+
+static uint64_t UnitToFs(const std::string& unit, bool& ok) {
+  ok = true;
+  if (unit == "s") return 1000000000000000ULL;
+  if (unit == "ms") return 1000000000000ULL;
+  if (unit == "us") return 1000000000ULL;
+  if (unit == "ns") return 1000000ULL;
+  if (unit == "ps") return 1000ULL;
+  if (unit == "fs") return 1ULL;
+  ok = false;
+  return 0;
+}
+
+// The whole of text, false if it isn't a number or doesn't fit
+static bool ToUint64(std::string_view text, uint64_t& value) {
+  const char* end = text.data() + text.size();
+  auto [ptr, ec] = std::from_chars(text.data(), end, value);
+  return ec == std::errc{} && ptr == end && !text.empty();
+}
+
+std::string WaveformReader::Signal::value(size_t index) const {
+  if (real) return reals[index];
+  return values.substr(index * width, width);
+}
+
+void WaveformReader::Signal::append(uint64_t time, std::string&& value) {
+  if (!times.empty()) {
+    const size_t last = times.size() - 1;
+    if (times.back() == time) {
+      // several assignments in the same time step, the last one wins
+      if (last > 0 && this->value(last - 1) == value) {
+        // and takes the signal back where it was, not a transition
+        times.pop_back();
+        if (real)
+          reals.pop_back();
+        else
+          values.resize(last * width);
+      } else if (real) {
+        reals[last] = std::move(value);
+      } else {
+        values.replace(last * width, width, value);
+      }
+      return;
+    }
+    if (this->value(last) == value) return;  // not a transition
+  }
+  times.push_back(time);
+  if (real)
+    reals.push_back(std::move(value));
+  else
+    values += value;
+}
+
+void WaveformReader::clear() {
+  m_open = false;
+  m_error.clear();
+  m_timescaleFs = 1000000;
+  m_endTime = 0;
+  m_signals.clear();
+  m_idCodes.clear();
+  m_names.clear();
+}
+
+bool WaveformReader::Open(const std::filesystem::path& file) {
+  clear();
+  m_file = file;
+  if (StringUtils::toLower(file.extension().string()) == ".fst") {
+    m_error = "FST files must be converted to VCD first (fst2vcd)";
+    return false;
+  }
+  std::ifstream stream(file, std::ios::in | std::ios::binary);
+  if (!stream.good()) {
+    m_error = "Can't open waveform file " + file.string();
+    return false;
+  }
+  m_stamp = FileUtils::Stamp(file);
+  m_open = parse(stream);
+  return m_open;
+}
+
+std::string WaveformReader::normalize(const Signal& signal,
+                                      const std::string& value) const {
+  if (signal.real || value.size() == signal.width) return value;
+  if (value.size() > signal.width)
+    return value.substr(value.size() - signal.width);
+  // VCD left extension rules: x and z extend themselves, anything else is 0
+  char ext = value.empty() ? '0' : std::tolower(value.front());
+  if (ext != 'x' && ext != 'z') ext = '0';
+  return std::string(signal.width - value.size(), ext) + value;
+}
+
+bool WaveformReader::parse(std::istream& stream) {
+  std::vector<std::string> scopes;
+  std::string token;
+  uint64_t time = 0;
+  bool definitions = true;
+
+  auto skipToEnd = [&stream, &token]() {
+    while (stream >> token && token != "$end") {
+    }
+  };
+  auto change = [this, &time](const std::string& id, std::string&& value) {
+    auto itr = m_idCodes.find(id);
+    if (itr == m_idCodes.end()) return;
+    Signal& signal = m_signals[itr->second];
+    signal.append(time, normalize(signal, value));
+  };
+
+  while (stream >> token) {
+    if (definitions) {
+      if (token == "$scope") {
+        std::string type, name;
+        stream >> type >> name;
+        scopes.push_back(name);
+        skipToEnd();
+      } else if (token == "$upscope") {
+        if (!scopes.empty()) scopes.pop_back();
+        skipToEnd();
+      } else if (token == "$var") {
+        std::string type, width, id, name;
+        stream >> type >> width >> id >> name;
+        skipToEnd();  // optional bit range
+        std::string fullName;
+        for (const auto& scope : scopes) fullName += scope + ".";
+        fullName += name;
+        auto itr = m_idCodes.find(id);
+        uint32_t index = 0;
+        if (itr == m_idCodes.end()) {
+          Signal signal;
+          signal.real = (type == "real" || type == "realtime");
+          signal.width =
+              signal.real ? 1 : std::max(1, std::atoi(width.c_str()));
+          index = static_cast<uint32_t>(m_signals.size());
+          m_signals.push_back(std::move(signal));
+          m_idCodes.emplace(id, index);
+        } else {
+          index = itr->second;  // alias of an already declared signal
+        }
+        m_names.emplace(fullName, index);
+      } else if (token == "$timescale") {
+        std::string scale;
+        while (stream >> token && token != "$end") scale += token;
+        size_t pos = 0;
+        while (pos < scale.size() && std::isdigit(scale[pos])) pos++;
+        bool ok = false;
+        uint64_t unit = UnitToFs(scale.substr(pos), ok);
+        uint64_t factor{0};
+        if (!ok || !ToUint64(std::string_view{scale}.substr(0, pos), factor) ||
+            factor == 0 || factor > UINT64_MAX / unit) {
+          m_error = "Invalid timescale: " + scale;
+          return false;
+        }
+        m_timescaleFs = factor * unit;
+      } else if (token == "$enddefinitions") {
+        skipToEnd();
+        definitions = false;
+      } else if (token.front() == '$') {
+        skipToEnd();  // $date, $version, $comment...
+      }
+      continue;
+    }
+
+    const char c = token.front();
+    if (c == '#') {
+      if (!ToUint64(std::string_view{token}.substr(1), time)) {
+        m_error = "Invalid time " + token + " in " + m_file.string();
+        return false;
+      }
+      m_endTime = std::max(m_endTime, time);
+    } else if (c == 'b' || c == 'B' || c == 'r' || c == 'R') {
+      std::string id;
+      stream >> id;
+      change(id, token.substr(1));
+    } else if (c == '$') {
+      if (token == "$comment") skipToEnd();
+      // $dumpvars, $dumpall, $dumpon, $dumpoff and their $end are markers only
+    } else {
+      // scalar change: value immediately followed by the id code
+      change(token.substr(1), std::string(1, std::tolower(c)));
+    }
+  }
+  if (definitions) {
+    m_error = "Missing $enddefinitions in " + m_file.string();
+    return false;
+  }
+  return true;
+}
+
+std::vector<std::string> WaveformReader::Signals() const {
+  std::vector<std::string> signals;
+  signals.reserve(m_names.size());
+  for (const auto& [name, index] : m_names) signals.push_back(name);
+  return signals;
+}
+
+bool WaveformReader::HasSignal(const std::string& name) const {
+  return find(name) != nullptr;
+}
+
+const WaveformReader::Signal* WaveformReader::find(
+    const std::string& name) const {
+  auto itr = m_names.find(name);
+  if (itr != m_names.end()) return &m_signals[itr->second];
+  // Allow a unique hierarchical suffix (e.g. "dut.q" for "tb.dut.q")
+  const Signal* result = nullptr;
+  const std::string suffix = "." + name;
+  for (const auto& [fullName, index] : m_names) {
+    if (StringUtils::endsWith(fullName, suffix)) {
+      if (result) return nullptr;  // ambiguous
+      result = &m_signals[index];
+    }
+  }
+  return result;
+}
+
+bool WaveformReader::ParseTime(const std::string& text, uint64_t& time) const {
+  std::string str = text;
+  str = StringUtils::trim(str);
+  size_t pos = 0;
+  while (pos < str.size() && (std::isdigit(str[pos]) || str[pos] == '.'))
+    pos++;
+  if (pos == 0) return false;
+  double value = 0;
+  try {
+    value = std::stod(str.substr(0, pos));
+  } catch (...) {
+    return false;
+  }
+  std::string unit = str.substr(pos);
+  unit = StringUtils::trim(unit);
+  if (unit.empty()) {
+    time = static_cast<uint64_t>(value);
+    return true;
+  }
+  bool ok = false;
+  uint64_t fs = UnitToFs(unit, ok);
+  if (!ok) return false;
+  time = static_cast<uint64_t>(std::llround(value * fs / m_timescaleFs));
+  return true;
+}
+
+bool WaveformReader::ValueAt(const std::string& name, uint64_t time,
+                             std::string& value) const {
+  const Signal* signal = find(name);
+  if (!signal) return false;
+  auto itr =
+      std::upper_bound(signal->times.begin(), signal->times.end(), time);
+  if (itr == signal->times.begin()) {
+    // not assigned yet
+    value = std::string(signal->real ? 1 : signal->width, 'x');
+    return true;
+  }
+  value = signal->value(std::distance(signal->times.begin(), itr) - 1);
+  return true;
+}
+
+std::vector<WaveformReader::Transition> WaveformReader::Transitions(
+    const std::string& name, uint64_t from, uint64_t to) const {
+  std::vector<Transition> transitions;
+  const Signal* signal = find(name);
+  if (!signal) return transitions;
+  auto first =
+      std::lower_bound(signal->times.begin(), signal->times.end(), from);
+  for (auto itr = first; itr != signal->times.end() && *itr <= to; ++itr) {
+    const size_t index = std::distance(signal->times.begin(), itr);
+    transitions.push_back({*itr, signal->value(index)});
+  }
+  return transitions;
+}
+
+std::vector<WaveformReader::Difference> WaveformReader::Diff(
+    const WaveformReader& a, const WaveformReader& b,
+    const std::vector<std::string>& signals) {
+  std::vector<Difference> differences;
+  std::vector<std::string> names = signals;
+  if (names.empty()) {
+    for (const auto& [name, index] : a.m_names)
+      if (b.m_names.count(name)) names.push_back(name);
+  }
+  for (const auto& name : names) {
+    const Signal* sa = a.find(name);
+    const Signal* sb = b.find(name);
+    if (!sa || !sb) {
+      differences.push_back({name, 0, sa ? "" : "<missing>",
+                             sb ? "" : "<missing>"});
+      continue;
+    }
+    // Walk the union of both transition lists, values only change there
+    size_t i = 0, j = 0;
+    while (i < sa->size() || j < sb->size()) {
+      uint64_t time = 0;
+      if (j >= sb->size() || (i < sa->size() && sa->times[i] <= sb->times[j]))
+        time = sa->times[i];
+      else
+        time = sb->times[j];
+      while (i < sa->size() && sa->times[i] <= time) i++;
+      while (j < sb->size() && sb->times[j] <= time) j++;
+      std::string va =
+          (i == 0) ? std::string(sa->width, 'x') : sa->value(i - 1);
+      std::string vb =
+          (j == 0) ? std::string(sb->width, 'x') : sb->value(j - 1);
+      if (va != vb) {
+        differences.push_back({name, time, va, vb});
+        break;
+      }
+    }
+  }
+  return differences;
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,118 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The WaveformReader class streams a VCD file once and keeps a
+ * compact per-signal transition index so that value/transition queries can be
+ * answered without GTKWave.
+ */
+class WaveformReader {
+ public:
+  struct Transition {
+    uint64_t time;
+    std::string value;
+  };
+  struct Difference {
+    std::string signal;
+    uint64_t time;
+    std::string valueA;
+    std::string valueB;
+  };
+
+  /*!
+   * \brief Open parses the whole file and builds the signal index.
+   * \return false on error, see LastError()
+   */
+  bool Open(const std::filesystem::path& file);
+  bool IsOpen() const { return m_open; }
+  const std::string& LastError() const { return m_error; }
+  const std::filesystem::path& File() const { return m_file; }
+  // FileUtils::Stamp() of the file when it was read
+  const std::string& Stamp() const { return m_stamp; }
+
+  // Full hierarchical names, sorted
+  std::vector<std::string> Signals() const;
+  bool HasSignal(const std::string& name) const;
+  uint64_t EndTime() const { return m_endTime; }
+  // Femtoseconds per time unit of the file
+  uint64_t TimescaleFs() const { return m_timescaleFs; }
+
+  /*!
+   * \brief ParseTime converts "100", "100ns", "1.5 us" to file time units.
+   */
+  bool ParseTime(const std::string& text, uint64_t& time) const;
+
+  bool ValueAt(const std::string& signal, uint64_t time,
+               std::string& value) const;
+  std::vector<Transition> Transitions(const std::string& signal,
+                                      uint64_t from = 0,
+                                      uint64_t to = UINT64_MAX) const;
+
+  /*!
+   * \brief Diff reports the first mismatch of each signal common to both
+   * waveforms (or of the given signals only).
+   */
+  static std::vector<Difference> Diff(
+      const WaveformReader& a, const WaveformReader& b,
+      const std::vector<std::string>& signals = {});
+
+ private:
+  struct Signal {
+    uint32_t width{1};
+    bool real{false};
+    std::vector<uint64_t> times;
+    // Values of fixed width packed one after another, real values are kept
+    // as text in 'reals'
+    std::string values;
+    std::vector<std::string> reals;
+
+    size_t size() const { return times.size(); }
+    std::string value(size_t index) const;
+    void append(uint64_t time, std::string&& value);
+  };
+
+  void clear();
+  bool parse(std::istream& stream);
+  const Signal* find(const std::string& name) const;
+  std::string normalize(const Signal& signal, const std::string& value) const;
+
+  bool m_open{false};
+  std::string m_error;
+  std::filesystem::path m_file;
+  std::string m_stamp;
+  uint64_t m_timescaleFs{1000000};  // 1ns, the VCD default
+  uint64_t m_endTime{0};
+  std::vector<Signal> m_signals;
+  std::unordered_map<std::string, uint32_t> m_idCodes;
+  std::map<std::string, uint32_t> m_names;
+};
+
+}  // namespace FOEDAG
@@ -1,5 +1,11 @@
 #include "editor.h"
 
+#include <QLabel>
+#include <algorithm>
+
+#include "file_change_tracker.h"
+#include "large_file_viewer.h"
+
 using namespace FOEDAG;
 
 #define ERROR_MARKER 4
@@ -11,6 +17,11 @@ Editor::Editor(QString strFileName, int iFileType, QWidget *parent)
   m_toolBar->setIconSize(QSize(32, 32));
   InitToolBar();
 
+  if (QFileInfo{strFileName}.size() >= LargeFileSize) {
+    InitLargeFile();
+    return;
+  }
+
   m_scintilla = new QsciScintilla(this);
   InitScintilla(iFileType);
   SetScintillaText(strFileName);
@@ -35,71 +46,151 @@ Editor::Editor(QString strFileName, int iFileType, QWidget *parent)
 
 QString Editor::getFileName() const { return m_strFileName; }
 
-bool Editor::isModified() const { return m_scintilla->isModified(); }
+bool Editor::isModified() const {
+  return m_scintilla && m_scintilla->isModified();
+}
 
-void Editor::SetFileWatcher(QFileSystemWatcher *watcher) {
-  m_fileWatcher = watcher;
+void Editor::SetChangeTracker(FileChangeTracker *tracker) {
+  m_changeTracker = tracker;
 }
 
 void Editor::FindFirst(const QString &strWord) {
-  m_scintilla->findFirst(strWord, true, true, true, true, false);
+  if (m_largeFile) {
+    m_largeFile->find(strWord, true, m_findCaseSensitive, m_findWholeWord,
+                      m_findWrap);
+    return;
+  }
+  m_scintilla->findFirst(strWord, true, m_findCaseSensitive, m_findWholeWord,
+                         m_findWrap, false);
   m_scintilla->findNext();
 }
 
 void Editor::FindNext(const QString &strWord) {
-  m_scintilla->findFirst(strWord, true, true, true, true);
+  if (m_largeFile) {
+    m_largeFile->find(strWord, false, m_findCaseSensitive, m_findWholeWord,
+                      m_findWrap);
+    return;
+  }
+  m_scintilla->findFirst(strWord, true, m_findCaseSensitive, m_findWholeWord,
+                         m_findWrap);
 }
 
 void Editor::Replace(const QString &strFind, const QString &strDesWord) {
   Q_UNUSED(strFind);
+  if (!m_scintilla) return;  // read-only
   m_scintilla->replace(strDesWord);
 }
 
 void Editor::ReplaceAndFind(const QString &strFind, const QString &strDesWord) {
+  if (!m_scintilla) return;
   m_scintilla->replace(strDesWord);
   m_scintilla->findFirst(strFind, true, true, true, true);
 }
 
 void Editor::ReplaceAll(const QString &strFind, const QString &strDesWord) {
+  if (!m_scintilla) return;
   while (m_scintilla->findFirst(strFind, true, true, true, true)) {
     m_scintilla->replace(strDesWord);
   }
 }
 
 void Editor::markLine(int line) {
-  m_scintilla->markerAdd(line - 1, ERROR_MARKER);
+  if (m_largeFile)
+    m_largeFile->markLine(line);
+  else
+    m_scintilla->markerAdd(line - 1, ERROR_MARKER);
 }
 
-void Editor::clearMarkers() { m_scintilla->markerDeleteAll(ERROR_MARKER); }
+void Editor::clearMarkers() {
+  if (m_largeFile)
+    m_largeFile->clearMarkers();
+  else
+    m_scintilla->markerDeleteAll(ERROR_MARKER);
+}
 
-void Editor::reload() { SetScintillaText(m_strFileName); }
+void Editor::markRemoved() {
+  if (m_scintilla) m_scintilla->setModified(true);
+}
+
+void Editor::reload() {
+  if (m_largeFile) {
+    m_largeFile->reload();
+    return;
+  }
+  QFile file(m_strFileName);
+  if (!file.open(QFile::ReadOnly)) return;
+  const QByteArray data = file.readAll();
+  const int oldLength = m_scintilla->length();
+  QByteArray old = m_scintilla->bytes(0, oldLength);
+  old.chop(1);  // terminating null
+
+  // Only the changed range is replaced so that the markers, folds and the
+  // view of the unchanged lines stay as they are
+  int prefix{0};
+  const int common = (std::min)(old.size(), data.size());
+  while (prefix < common && old.at(prefix) == data.at(prefix)) prefix++;
+  int suffix{0};
+  while (suffix < common - prefix &&
+         old.at(old.size() - 1 - suffix) == data.at(data.size() - 1 - suffix))
+    suffix++;
+  if (prefix == old.size() && prefix == data.size()) {
+    m_scintilla->setModified(false);
+    return;
+  }
+
+  const int firstLine = m_scintilla->firstVisibleLine();
+  const long xOffset =
+      m_scintilla->SendScintilla(QsciScintilla::SCI_GETXOFFSET);
+  int line{0}, index{0};
+  m_scintilla->getCursorPosition(&line, &index);
+
+  const QByteArray replacement =
+      data.mid(prefix, data.size() - suffix - prefix);
+  m_scintilla->SendScintilla(QsciScintilla::SCI_SETTARGETRANGE,
+                             static_cast<unsigned long>(prefix),
+                             static_cast<long>(old.size() - suffix));
+  m_scintilla->SendScintilla(QsciScintilla::SCI_REPLACETARGET,
+                             static_cast<uintptr_t>(replacement.size()),
+                             replacement.constData());
+  // Undoing across a reload would bring back the content of another file
+  m_scintilla->SendScintilla(QsciScintilla::SCI_EMPTYUNDOBUFFER);
+  m_scintilla->setModified(false);
+
+  line = (std::min)(line, m_scintilla->lines() - 1);
+  index = (std::min)(index, m_scintilla->lineLength(line));
+  m_scintilla->setCursorPosition(line, index);
+  m_scintilla->setFirstVisibleLine(firstLine);
+  m_scintilla->SendScintilla(QsciScintilla::SCI_SETXOFFSET,
+                             static_cast<unsigned long>(xOffset));
+}
 
 void Editor::Search() {
   QString strWord = "";
-  if (m_scintilla->hasSelectedText()) {
+  if (m_largeFile) {
+    strWord = m_largeFile->selectedText();
+  } else if (m_scintilla->hasSelectedText()) {
     strWord = m_scintilla->selectedText();
   }
   emit ShowSearchDialog(strWord);
 }
 
 void Editor::Save() {
+  if (!m_scintilla) return;  // read-only
   QFile file(m_strFileName);
   if (!file.open(QFile::WriteOnly)) {
     return;
   }
 
-  // avoid trigger file watching during save
-  m_fileWatcher->removePath(m_strFileName);
   QTextStream out(&file);
   QApplication::setOverrideCursor(Qt::WaitCursor);
   out << m_scintilla->text();
+  out.flush();
+  file.close();
   QApplication::restoreOverrideCursor();
 
   m_scintilla->setModified(false);
-  // QTimer::singleShot is used here to run lambda at the end of the event
-  // queue. We must wait all events because file is saved to device later.
-  QTimer::singleShot(1, this,
-                     [this]() { m_fileWatcher->addPath(m_strFileName); });
+  // The notifications of our own write are dropped as the content matches
+  if (m_changeTracker) m_changeTracker->fileSaved(m_strFileName);
 }
 
 void Editor::Undo() { m_scintilla->undo(); }
@@ -204,6 +295,29 @@ void Editor::InitToolBar() {
   connect(m_actSelect, SIGNAL(triggered()), this, SLOT(SelectAll()));
 }
 
+// Read-only view of a large file: only search and go to line
+void Editor::InitLargeFile() {
+  m_toolBar->clear();
+  m_toolBar->addAction(m_actSearch);
+  m_toolBar->addSeparator();
+  m_largeFile = new LargeFileViewer(this);
+  QAction *goToLine = m_toolBar->addAction(tr("&Go to Line"));
+  goToLine->setShortcut(tr("Ctrl+G"));
+  connect(goToLine, &QAction::triggered, m_largeFile,
+          &LargeFileViewer::goToLineDialog);
+  m_toolBar->addSeparator();
+  m_toolBar->addWidget(new QLabel(
+      tr("Read-only, %1 MB").arg(QFileInfo{m_strFileName}.size() >> 20)));
+  m_largeFile->open(m_strFileName);
+
+  QBoxLayout *box = new QBoxLayout(QBoxLayout::TopToBottom);
+  box->setContentsMargins(0, 0, 0, 0);
+  box->setSpacing(0);
+  box->addWidget(m_toolBar);
+  box->addWidget(m_largeFile);
+  setLayout(box);
+}
+
 void Editor::InitScintilla(int iFileType) {
   QFont font("Arial", 9, QFont::Normal);
   m_scintilla->setFont(font);
@@ -4,7 +4,6 @@
 #include <QApplication>
 #include <QFile>
 #include <QFileInfo>
-#include <QFileSystemWatcher>
 #include <QObject>
 #include <QTextStream>
 #include <QToolBar>
@@ -25,15 +24,21 @@ enum FileType {
   FILE_TYPE_UNKOWN
 };
 
+class FileChangeTracker;
+class LargeFileViewer;
+
 class Editor : public QWidget {
   Q_OBJECT
  public:
+  // From this size on files are shown read-only by a LargeFileViewer
+  static constexpr qint64 LargeFileSize{32 * 1024 * 1024};
+
   explicit Editor(QString strFileName, int iFileType,
                   QWidget* parent = nullptr);
 
   QString getFileName() const;
   bool isModified() const;
-  void SetFileWatcher(QFileSystemWatcher* watcher);
+  void SetChangeTracker(FileChangeTracker* tracker);
 
   void FindFirst(const QString& strWord);
   void FindNext(const QString& strWord);
@@ -43,6 +48,8 @@ class Editor : public QWidget {
   void markLine(int line);
   void clearMarkers();
   void reload();
+  // The file was removed from disk, saving writes it again
+  void markRemoved();
 
  signals:
   void EditorModificationChanged(bool m);
@@ -67,7 +74,12 @@ class Editor : public QWidget {
 
  private:
   QString m_strFileName;
-  QsciScintilla* m_scintilla;
+  QsciScintilla* m_scintilla{nullptr};
+  LargeFileViewer* m_largeFile{nullptr};
+  // Search options, shared by both views
+  bool m_findCaseSensitive{true};
+  bool m_findWholeWord{true};
+  bool m_findWrap{true};
 
   QToolBar* m_toolBar;
   QAction* m_actSearch;
@@ -84,11 +96,12 @@ class Editor : public QWidget {
   QAction* m_actSelect;
 
   void InitToolBar();
+  void InitLargeFile();
   void InitScintilla(int iFileType);
   void SetScintillaText(QString strFileName);
 
   void UpdateToolBarStates();
-  QFileSystemWatcher* m_fileWatcher{nullptr};
+  FileChangeTracker* m_changeTracker{nullptr};
 };
 
 }  // namespace FOEDAG
@@ -0,0 +1,125 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "file_change_tracker.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+
+#include "editor.h"
+
+using namespace FOEDAG;
+
+// Files removed and written again (generated files) are looked for at this
+// pace, they are reported as removed when they aren't back after the retries
+static constexpr int MissingRetryMs{1000};
+static constexpr int MissingRetries{3};
+
+FileChangeTracker::FileChangeTracker(QObject *parent) : QObject(parent) {
+  m_timer.setSingleShot(true);
+  connect(&m_watcher, &QFileSystemWatcher::fileChanged, this,
+          &FileChangeTracker::fileChanged);
+  connect(&m_timer, &QTimer::timeout, this, &FileChangeTracker::flush);
+}
+
+void FileChangeTracker::addFile(const QString &path) {
+  m_signatures.insert(path, signature(path));
+  m_watcher.addPath(path);
+}
+
+void FileChangeTracker::removeFile(const QString &path) {
+  m_signatures.remove(path);
+  m_pending.remove(path);
+  m_missing.remove(path);
+  m_watcher.removePath(path);
+}
+
+void FileChangeTracker::fileSaved(const QString &path) {
+  if (!m_signatures.contains(path)) return;
+  m_signatures.insert(path, signature(path));
+  // Saved again after it was removed
+  if (!m_watcher.files().contains(path)) m_watcher.addPath(path);
+}
+
+void FileChangeTracker::fileChanged(const QString &path) {
+  if (!m_signatures.contains(path)) return;
+  if (m_pending.isEmpty()) m_firstPending.start();
+  m_pending.insert(path);
+  // Restarted on each notification, a flow rewriting many files is
+  // reported once it is done or once the batch waited the maximum delay
+  const qint64 left = m_maxDelay - m_firstPending.elapsed();
+  m_timer.start(static_cast<int>(std::clamp<qint64>(left, 0, m_window)));
+}
+
+void FileChangeTracker::flush() {
+  QStringList changed;
+  QStringList removed;
+  bool missing{false};
+  for (auto itr = m_pending.begin(); itr != m_pending.end();) {
+    const QString path = *itr;
+    if (!QFileInfo::exists(path)) {
+      if (++m_missing[path] <= MissingRetries) {
+        missing = true;
+        ++itr;
+        continue;
+      }
+      itr = m_pending.erase(itr);
+      m_missing.remove(path);
+      removed.append(path);
+      continue;
+    }
+    itr = m_pending.erase(itr);
+    m_missing.remove(path);
+    // The watcher drops files that were removed or replaced
+    if (!m_watcher.files().contains(path)) m_watcher.addPath(path);
+    const QByteArray current = signature(path);
+    if (current == m_signatures.value(path)) continue;  // same content
+    m_signatures.insert(path, current);
+    changed.append(path);
+  }
+  if (missing) m_timer.start(MissingRetryMs);
+  // The files still missing start the next batch
+  if (!m_pending.isEmpty()) m_firstPending.start();
+  if (!changed.isEmpty()) {
+    changed.sort();
+    emit filesChanged(changed);
+  }
+  if (!removed.isEmpty()) {
+    removed.sort();
+    emit filesRemoved(removed);
+  }
+}
+
+// Hash of the content, size and time of the large files which are not read
+QByteArray FileChangeTracker::signature(const QString &path) {
+  const QFileInfo info{path};
+  if (info.size() >= Editor::LargeFileSize) {
+    return QByteArray::number(info.size()) + ':' +
+           QByteArray::number(info.lastModified().toMSecsSinceEpoch());
+  }
+  QFile file{path};
+  if (!file.open(QFile::ReadOnly)) return {};
+  QCryptographicHash hash{QCryptographicHash::Md5};
+  hash.addData(&file);
+  return hash.result();
+}
@@ -0,0 +1,81 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef FILE_CHANGE_TRACKER_H
+#define FILE_CHANGE_TRACKER_H
+
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The FileChangeTracker class watches the files open in the editor
+ * and reports their changes on disk in batches: the notifications are
+ * coalesced over a time window and the files rewritten with the same
+ * content are left out. A removed file is looked for a few times, in case it
+ * is being written again, before it is reported as removed.
+ */
+class FileChangeTracker : public QObject {
+  Q_OBJECT
+ public:
+  explicit FileChangeTracker(QObject *parent = nullptr);
+
+  void addFile(const QString &path);
+  void removeFile(const QString &path);
+  /*!
+   * \brief fileSaved records the content the editor wrote, the changes it
+   * triggers are not reported.
+   */
+  void fileSaved(const QString &path);
+  // Quiet time after the last notification before the batch is reported
+  void setWindow(int msec) { m_window = msec; }
+  int window() const { return m_window; }
+  // Longest wait from the first notification of a batch, so that a file
+  // rewritten without pause is reported all the same
+  void setMaxDelay(int msec) { m_maxDelay = msec; }
+  int maxDelay() const { return m_maxDelay; }
+
+ signals:
+  void filesChanged(const QStringList &paths);
+  void filesRemoved(const QStringList &paths);
+
+ private slots:
+  void fileChanged(const QString &path);
+  void flush();
+
+ private:
+  static QByteArray signature(const QString &path);
+
+  QFileSystemWatcher m_watcher;
+  QTimer m_timer;
+  int m_window{300};
+  int m_maxDelay{2000};
+  QElapsedTimer m_firstPending;
+  QHash<QString, QByteArray> m_signatures;
+  QSet<QString> m_pending;
+  QHash<QString, int> m_missing;  // retries of the removed files
+};
+
+}  // namespace FOEDAG
+#endif  // FILE_CHANGE_TRACKER_H
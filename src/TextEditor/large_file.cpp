@@ -0,0 +1,319 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "large_file.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace FOEDAG {
+
+static bool IsWordChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Read size when scanning
+static constexpr uint64_t Block{64 * 1024};
+static constexpr uint64_t Chunk{1 << 20};
+
+LargeFile::~LargeFile() { Close(); }
+
+bool LargeFile::Open(const std::filesystem::path& file) {
+  Close();
+  m_error.clear();
+  m_file = file;
+#ifdef _WIN32
+  HANDLE handle = CreateFileW(
+      file.c_str(), GENERIC_READ,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    m_error = "Can't open " + file.string();
+    return false;
+  }
+  m_fileHandle = handle;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(handle, &size)) {
+    m_error = "Can't read the size of " + file.string();
+    Close();
+    return false;
+  }
+  m_size = static_cast<uint64_t>(size.QuadPart);
+#else
+  m_fd = open(file.c_str(), O_RDONLY);
+  if (m_fd == -1) {
+    m_error = "Can't open " + file.string() + ": " + strerror(errno);
+    return false;
+  }
+  struct stat info;
+  if (fstat(m_fd, &info) != 0) {
+    m_error = "Can't read the size of " + file.string();
+    Close();
+    return false;
+  }
+  m_size = static_cast<uint64_t>(info.st_size);
+#endif
+  m_open = true;
+  m_checkpoints.assign(1, 0);
+  m_indexer = std::thread{&LargeFile::index, this};
+  return true;
+}
+
+void LargeFile::Close() {
+  m_stop = true;
+  if (m_indexer.joinable()) m_indexer.join();
+  m_stop = false;
+#ifdef _WIN32
+  if (m_fileHandle) CloseHandle(m_fileHandle);
+  m_fileHandle = nullptr;
+#else
+  if (m_fd != -1) close(m_fd);
+  m_fd = -1;
+#endif
+  m_size = 0;
+  m_open = false;
+  m_lineCount = 0;
+  m_indexDone = false;
+  std::lock_guard<std::mutex> lock{m_mutex};
+  m_checkpoints.clear();
+}
+
+// Positional reads, safe from several threads and, unlike a mapping, from
+// the file being truncated meanwhile
+size_t LargeFile::read(uint64_t offset, char* buffer, size_t size) const {
+  size_t done{0};
+  while (done < size) {
+#ifdef _WIN32
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(offset + done);
+    overlapped.OffsetHigh = static_cast<DWORD>((offset + done) >> 32);
+    DWORD count{0};
+    const DWORD wanted = static_cast<DWORD>(
+        (std::min)(size - done, static_cast<size_t>(Chunk)));
+    if (!ReadFile(m_fileHandle, buffer + done, wanted, &count, &overlapped))
+      break;
+#else
+    const ssize_t count = pread(m_fd, buffer + done, size - done,
+                                static_cast<off_t>(offset + done));
+    if (count == -1 && errno == EINTR) continue;
+    if (count == -1) break;
+#endif
+    if (count == 0) break;  // end of file
+    done += count;
+  }
+  return done;
+}
+
+std::string LargeFile::Read(uint64_t offset, size_t size) const {
+  if (!m_open || offset >= m_size) return {};
+  std::string text(
+      static_cast<size_t>((std::min<uint64_t>)(size, m_size - offset)), '\0');
+  text.resize(read(offset, text.data(), text.size()));
+  return text;
+}
+
+void LargeFile::WaitIndex() {
+  if (m_indexer.joinable()) m_indexer.join();
+}
+
+void LargeFile::index() {
+  // Checkpoints are published a chunk at a time, lines once their
+  // checkpoint is
+  std::vector<char> buffer(Chunk);
+  std::vector<uint64_t> checkpoints;
+  uint64_t lines{0};
+  char lastChar{'\n'};
+  for (uint64_t offset = 0; offset < m_size && !m_stop;) {
+    const size_t size =
+        read(offset, buffer.data(), (std::min)(Chunk, m_size - offset));
+    if (size == 0) break;  // shrunk
+    const char* data = buffer.data();
+    const char* last = data + size;
+    checkpoints.clear();
+    for (const char* p = data;
+         (p = static_cast<const char*>(std::memchr(p, '\n', last - p)));) {
+      ++p;
+      if (++lines % LineStride == 0) checkpoints.push_back(offset + (p - data));
+    }
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_checkpoints.insert(m_checkpoints.end(), checkpoints.begin(),
+                           checkpoints.end());
+    }
+    m_lineCount = lines;
+    lastChar = last[-1];
+    offset += size;
+  }
+  if (m_stop) return;
+  // Last line without end of line
+  if (lastChar != '\n') m_lineCount = lines + 1;
+  m_indexDone = true;
+}
+
+uint64_t LargeFile::checkpoint(uint64_t line, uint64_t& first) const {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  const uint64_t index = line / LineStride;
+  if (index >= m_checkpoints.size()) return npos;
+  first = index * LineStride;
+  return m_checkpoints[index];
+}
+
+// Start of the line \a count lines after the one at \a offset
+uint64_t LargeFile::skipLines(uint64_t offset, uint64_t count) const {
+  std::vector<char> buffer(Block);
+  while (count > 0) {
+    if (offset >= m_size) return npos;
+    const size_t size =
+        read(offset, buffer.data(), (std::min)(Block, m_size - offset));
+    if (size == 0) return npos;
+    const char* p = buffer.data();
+    const char* last = p + size;
+    for (const void* eol; count > 0 && (eol = std::memchr(p, '\n', last - p));
+         count--)
+      p = static_cast<const char*>(eol) + 1;
+    offset += (count > 0) ? size : static_cast<size_t>(p - buffer.data());
+  }
+  return offset;
+}
+
+uint64_t LargeFile::LineStart(uint64_t line) const {
+  if (line >= m_lineCount) return npos;
+  uint64_t first{0};
+  const uint64_t offset = checkpoint(line, first);
+  return (offset == npos) ? npos : skipLines(offset, line - first);
+}
+
+std::string LargeFile::Line(uint64_t line, size_t maxLength) const {
+  const uint64_t start = LineStart(line);
+  if (start == npos || start >= m_size) return {};
+  std::string text;
+  bool complete{false};
+  for (uint64_t offset = start; offset < m_size && text.size() <= maxLength;) {
+    const size_t old = text.size();
+    text.resize(old + (std::min)(Block, m_size - offset));
+    const size_t size = read(offset, text.data() + old, text.size() - old);
+    text.resize(old + size);
+    const size_t eol = text.find('\n', old);
+    if (eol != std::string::npos) {
+      text.resize(eol);
+      complete = true;
+      break;
+    }
+    if (size == 0) break;
+    offset += size;
+  }
+  if (complete && !text.empty() && text.back() == '\r') text.pop_back();
+  if (text.size() > maxLength) text.resize(maxLength);
+  return text;
+}
+
+uint64_t LargeFile::LineOf(uint64_t offset) const {
+  if (offset >= m_size) return npos;
+  uint64_t line{0};
+  uint64_t start{0};
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto itr =
+        std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), offset);
+    if (itr == m_checkpoints.begin()) return npos;
+    --itr;
+    line = (itr - m_checkpoints.begin()) * LineStride;
+    start = *itr;
+  }
+  std::vector<char> buffer(Block);
+  while (start < offset) {
+    const size_t size =
+        read(start, buffer.data(), (std::min)(Block, offset - start));
+    if (size == 0) return npos;
+    line += std::count(buffer.data(), buffer.data() + size, '\n');
+    start += size;
+  }
+  return line < m_lineCount ? line : npos;
+}
+
+// Matches lying within [from, to), read a chunk at a time
+uint64_t LargeFile::find(std::string_view text, uint64_t from, uint64_t to,
+                         bool caseSensitive, bool wholeWord,
+                         const std::atomic<bool>* cancel) const {
+  auto lower = [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  };
+  auto hash = [lower](char c) { return std::hash<char>{}(lower(c)); };
+  auto equal = [lower](char a, char b) { return lower(a) == lower(b); };
+  const std::boyer_moore_horspool_searcher exact{text.begin(), text.end()};
+  const std::boyer_moore_horspool_searcher nocase{text.begin(), text.end(),
+                                                  hash, equal};
+  std::string buffer;
+  for (uint64_t start = from; start + text.size() <= to; start += Chunk) {
+    if (cancel && *cancel) break;
+    // Matches starting before last belong to this chunk
+    const uint64_t last = (std::min)(start + Chunk, to - text.size() + 1);
+    // With the characters around them, for whole words
+    const uint64_t begin = start ? start - 1 : 0;
+    const uint64_t end = (std::min)(last + text.size(), m_size);
+    buffer.resize(end - begin);
+    buffer.resize(read(begin, buffer.data(), buffer.size()));
+    const char* data = buffer.data();
+    const char* first = data + (start - begin);
+    const char* stop =
+        data + (std::min)(last - 1 + text.size() - begin,
+                          static_cast<uint64_t>(buffer.size()));
+    while (first < stop) {
+      const char* match = caseSensitive ? std::search(first, stop, exact)
+                                        : std::search(first, stop, nocase);
+      if (match == stop) break;
+      const char* after = match + text.size();
+      const bool atEnd = after == data + buffer.size();
+      if (!wholeWord || ((match == data || !IsWordChar(match[-1])) &&
+                         (atEnd || !IsWordChar(*after))))
+        return begin + (match - data);
+      first = match + 1;
+    }
+    if (buffer.size() < end - begin) break;  // shrunk
+  }
+  return npos;
+}
+
+uint64_t LargeFile::Find(const std::string& text, uint64_t from,
+                         bool caseSensitive, bool wholeWord, bool wrap,
+                         const std::atomic<bool>* cancel) const {
+  if (text.empty() || !m_open) return npos;
+  from = (std::min)(from, m_size);
+  uint64_t offset = find(text, from, m_size, caseSensitive, wholeWord, cancel);
+  if (offset == npos && wrap && from > 0) {
+    // Up to the matches overlapping the start of the first search
+    const uint64_t to = (std::min)(from + text.size() - 1, m_size);
+    offset = find(text, 0, to, caseSensitive, wholeWord, cancel);
+  }
+  return offset;
+}
+
+}  // namespace FOEDAG
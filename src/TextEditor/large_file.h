@@ -0,0 +1,120 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef LARGE_FILE_H
+#define LARGE_FILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The LargeFile class gives read-only access to a file, read by
+ * offset on demand and never held in memory. The line index is built by a
+ * background thread, lines are available as soon as they are indexed. Only
+ * one line start out of LineStride is kept, the others are found by scanning
+ * from it. A file shrinking while open reads as ending early.
+ */
+class LargeFile {
+ public:
+  static constexpr uint64_t npos{UINT64_MAX};
+  static constexpr uint64_t LineStride{16};
+
+  LargeFile() = default;
+  LargeFile(const LargeFile&) = delete;
+  LargeFile& operator=(const LargeFile&) = delete;
+  ~LargeFile();
+
+  /*!
+   * \brief Open opens the file and starts indexing its lines.
+   * \return false on error, see LastError()
+   */
+  bool Open(const std::filesystem::path& file);
+  void Close();
+  bool IsOpen() const { return m_open; }
+  const std::string& LastError() const { return m_error; }
+  const std::filesystem::path& File() const { return m_file; }
+  // Size when opened
+  uint64_t Size() const { return m_size; }
+  // Up to \a size bytes from \a offset, less past the end of the file
+  std::string Read(uint64_t offset, size_t size) const;
+
+  // Lines indexed so far, all the lines once IndexDone()
+  uint64_t LineCount() const { return m_lineCount; }
+  bool IndexDone() const { return m_indexDone; }
+  void WaitIndex();
+
+  /*!
+   * \brief Line returns the first \a maxLength bytes of a line (0-based)
+   * without its end of line, empty if the line is not indexed yet.
+   */
+  std::string Line(uint64_t line, size_t maxLength = SIZE_MAX) const;
+  // Offset of the first byte of a line, npos if not indexed yet
+  uint64_t LineStart(uint64_t line) const;
+  // Line holding the byte at \a offset, npos if not indexed yet
+  uint64_t LineOf(uint64_t offset) const;
+
+  /*!
+   * \brief Find returns the offset of the first occurrence of \a text at or
+   * after \a from, searching again from the start if \a wrap. Setting
+   * \a cancel from another thread stops the search.
+   * \return npos if there is none or the search was canceled
+   */
+  uint64_t Find(const std::string& text, uint64_t from, bool caseSensitive,
+                bool wholeWord, bool wrap,
+                const std::atomic<bool>* cancel = nullptr) const;
+
+ private:
+  void index();
+  size_t read(uint64_t offset, char* buffer, size_t size) const;
+  uint64_t skipLines(uint64_t offset, uint64_t count) const;
+  uint64_t find(std::string_view text, uint64_t from, uint64_t to,
+                bool caseSensitive, bool wholeWord,
+                const std::atomic<bool>* cancel) const;
+  uint64_t checkpoint(uint64_t line, uint64_t& first) const;
+
+  bool m_open{false};
+  std::string m_error;
+  std::filesystem::path m_file;
+  uint64_t m_size{0};
+#ifdef _WIN32
+  void* m_fileHandle{nullptr};
+#else
+  int m_fd{-1};
+#endif
+
+  std::thread m_indexer;
+  std::atomic<bool> m_stop{false};
+  std::atomic<bool> m_indexDone{false};
+  std::atomic<uint64_t> m_lineCount{0};
+  // Start of every LineStride-th line, guarded by m_mutex
+  mutable std::mutex m_mutex;
+  std::vector<uint64_t> m_checkpoints;
+};
+
+}  // namespace FOEDAG
+#endif  // LARGE_FILE_H
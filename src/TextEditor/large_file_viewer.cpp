@@ -0,0 +1,325 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "large_file_viewer.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QFontDatabase>
+#include <QInputDialog>
+#include <QKeyEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <climits>
+
+using namespace FOEDAG;
+
+// Longest part of a line drawn, past it the line is cut
+static constexpr int MaxColumns{4096};
+
+LargeFileViewer::LargeFileViewer(QWidget *parent)
+    : QAbstractScrollArea(parent) {
+  setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+  setFocusPolicy(Qt::StrongFocus);
+  m_indexTimer.setInterval(200);
+  connect(&m_indexTimer, &QTimer::timeout, this,
+          &LargeFileViewer::indexProgress);
+}
+
+LargeFileViewer::~LargeFileViewer() { cancelFind(); }
+
+bool LargeFileViewer::open(const QString &fileName) {
+  cancelFind();
+  m_fileName = fileName;
+  m_match = LargeFile::npos;
+  m_matchPending = false;
+  m_columns = 0;
+  const bool ok = m_file.Open(fileName.toStdString());
+  // Lines come as the index grows
+  m_indexTimer.start();
+  updateScrollBars();
+  viewport()->update();
+  return ok;
+}
+
+void LargeFileViewer::reload() {
+  const uint64_t current = m_currentLine;
+  open(m_fileName);
+  m_pendingLine = current;
+}
+
+void LargeFileViewer::goToLine(int line) {
+  if (line < 1) return;
+  const uint64_t index = line - 1;
+  if (index < m_file.LineCount()) {
+    setCurrentLine(index);
+  } else if (!m_file.IndexDone()) {
+    m_pendingLine = index;
+  } else if (m_file.LineCount() > 0) {
+    setCurrentLine(m_file.LineCount() - 1);
+  }
+}
+
+void LargeFileViewer::markLine(int line) {
+  if (line < 1) return;
+  m_markers.insert(line - 1);
+  goToLine(line);
+  viewport()->update();
+}
+
+void LargeFileViewer::clearMarkers() {
+  m_markers.clear();
+  viewport()->update();
+}
+
+void LargeFileViewer::find(const QString &text, bool fromStart,
+                           bool caseSensitive, bool wholeWord, bool wrap) {
+  uint64_t from{0};
+  if (!fromStart) {
+    from = (m_match != LargeFile::npos) ? m_match + 1
+                                        : m_file.LineStart(m_currentLine);
+    if (from == LargeFile::npos) from = 0;
+  }
+  cancelFind();
+  const std::string word = text.toStdString();
+  const uint64_t search = m_search;
+  // Scanning gigabytes takes seconds, keep the GUI responsive
+  m_finder = std::thread{[=]() {
+    const uint64_t match = m_file.Find(word, from, caseSensitive, wholeWord,
+                                       wrap, &m_cancelFind);
+    if (m_cancelFind) return;
+    QMetaObject::invokeMethod(
+        this,
+        [=]() { found(search, match, static_cast<int>(word.size())); },
+        Qt::QueuedConnection);
+  }};
+}
+
+void LargeFileViewer::found(uint64_t search, uint64_t match, int length) {
+  if (search != m_search) return;  // canceled
+  if (m_finder.joinable()) m_finder.join();
+  m_match = match;
+  m_matchLength = length;
+  if (m_match == LargeFile::npos) {
+    QApplication::beep();
+    viewport()->update();
+    return;
+  }
+  m_matchPending = !showMatch();
+}
+
+void LargeFileViewer::cancelFind() {
+  m_cancelFind = true;
+  if (m_finder.joinable()) m_finder.join();
+  m_cancelFind = false;
+  m_search++;
+}
+
+// Positions on the match, false while its line is not indexed yet
+bool LargeFileViewer::showMatch() {
+  const uint64_t line = m_file.LineOf(m_match);
+  if (line == LargeFile::npos) return false;
+  setCurrentLine(line);
+  // Horizontally too
+  const int column = static_cast<int>((std::min)(
+      m_match - m_file.LineStart(line), static_cast<uint64_t>(MaxColumns)));
+  const size_t length = m_file.Line(line, MaxColumns).size();
+  m_columns = (std::max)(m_columns, static_cast<int>(length));
+  updateScrollBars();
+  QScrollBar *bar = horizontalScrollBar();
+  if (column < bar->value() ||
+      column + m_matchLength > bar->value() + bar->pageStep())
+    bar->setValue((std::max)(0, column - bar->pageStep() / 4));
+  viewport()->update();
+  return true;
+}
+
+QString LargeFileViewer::selectedText() const {
+  if (m_match == LargeFile::npos) return {};
+  const std::string text = m_file.Read(m_match, m_matchLength);
+  return QString::fromStdString(text);
+}
+
+void LargeFileViewer::goToLineDialog() {
+  bool ok{false};
+  const int count =
+      static_cast<int>((std::min)(m_file.LineCount(), uint64_t{INT_MAX}));
+  const int line = QInputDialog::getInt(
+      this, tr("Go to Line"), tr("Line (1 - %1):").arg(count),
+      static_cast<int>(m_currentLine + 1), 1, (std::max)(count, 1), 1, &ok);
+  if (ok) goToLine(line);
+}
+
+void LargeFileViewer::indexProgress() {
+  if (m_file.IndexDone()) m_indexTimer.stop();
+  updateScrollBars();
+  if (m_pendingLine != LargeFile::npos &&
+      (m_pendingLine < m_file.LineCount() || m_file.IndexDone())) {
+    const uint64_t line = m_pendingLine;
+    m_pendingLine = LargeFile::npos;
+    goToLine(static_cast<int>(line + 1));
+  }
+  if (m_matchPending) m_matchPending = !showMatch();
+  viewport()->update();
+}
+
+int LargeFileViewer::lineHeight() const { return fontMetrics().height(); }
+
+int LargeFileViewer::visibleLines() const {
+  return (std::max)(1, viewport()->height() / lineHeight());
+}
+
+int LargeFileViewer::gutterWidth() const {
+  const int digits =
+      QString::number(static_cast<qulonglong>(m_file.LineCount())).size();
+  // line numbers and the marker
+  return fontMetrics().horizontalAdvance(QLatin1Char('9')) * (digits + 1) +
+         lineHeight();
+}
+
+void LargeFileViewer::updateScrollBars() {
+  const uint64_t lines = m_file.LineCount();
+  const int page = visibleLines();
+  QScrollBar *vertical = verticalScrollBar();
+  vertical->setPageStep(page);
+  vertical->setRange(
+      0, static_cast<int>((std::min)(
+             lines > static_cast<uint64_t>(page) ? lines - page : 0,
+             uint64_t{INT_MAX})));
+  const int charWidth = fontMetrics().horizontalAdvance(QLatin1Char('0'));
+  const int columns = (viewport()->width() - gutterWidth()) / charWidth;
+  horizontalScrollBar()->setPageStep(columns);
+  horizontalScrollBar()->setRange(0, (std::max)(0, m_columns - columns));
+}
+
+void LargeFileViewer::setCurrentLine(uint64_t line) {
+  m_currentLine = line;
+  const uint64_t first = verticalScrollBar()->value();
+  const int page = visibleLines();
+  if (line < first || line >= first + page)
+    verticalScrollBar()->setValue(static_cast<int>(
+        (std::min)(line > static_cast<uint64_t>(page / 2) ? line - page / 2 : 0,
+                   uint64_t{INT_MAX})));
+  viewport()->update();
+}
+
+void LargeFileViewer::paintEvent(QPaintEvent *) {
+  QPainter painter(viewport());
+  const QFontMetrics metrics = fontMetrics();
+  const int height = lineHeight();
+  const int charWidth = metrics.horizontalAdvance(QLatin1Char('0'));
+  const int gutter = gutterWidth();
+  const int width = viewport()->width();
+  const uint64_t first = verticalScrollBar()->value();
+  const size_t firstColumn = horizontalScrollBar()->value();
+  const size_t columns = (width - gutter) / charWidth + 1;
+  const uint64_t matchLine =
+      (m_match != LargeFile::npos) ? m_file.LineOf(m_match) : LargeFile::npos;
+
+  painter.fillRect(viewport()->rect(), palette().base());
+  painter.fillRect(0, 0, gutter, viewport()->height(), palette().window());
+  int widest = m_columns;
+  for (int row = 0; row <= visibleLines(); row++) {
+    const uint64_t line = first + row;
+    if (line >= m_file.LineCount()) break;
+    const int y = row * height;
+    if (line == m_currentLine)
+      painter.fillRect(gutter, y, width - gutter, height, Qt::lightGray);
+    if (m_markers.count(line)) {
+      painter.setBrush(Qt::red);
+      painter.setPen(Qt::NoPen);
+      painter.drawEllipse(2, y + 2, height - 4, height - 4);
+    }
+    painter.setPen(palette().color(QPalette::WindowText));
+    painter.drawText(QRect(0, y, gutter - charWidth / 2, height),
+                     Qt::AlignRight | Qt::AlignVCenter,
+                     QString::number(static_cast<qulonglong>(line + 1)));
+
+    const std::string text = m_file.Line(line, MaxColumns + columns);
+    widest = (std::max)(
+        widest, static_cast<int>((std::min)(text.size(), size_t{MaxColumns})));
+    if (line == matchLine) {
+      const int column =
+          static_cast<int>(m_match - m_file.LineStart(line) - firstColumn);
+      painter.fillRect(gutter + column * charWidth, y,
+                       m_matchLength * charWidth, height, Qt::yellow);
+    }
+    if (firstColumn >= text.size() || firstColumn >= size_t{MaxColumns})
+      continue;
+    QString str = QString::fromUtf8(
+        text.data() + firstColumn,
+        static_cast<int>((std::min)(text.size() - firstColumn, columns)));
+    str.replace(QLatin1Char('\t'), QLatin1Char(' '));
+    painter.setPen(palette().color(QPalette::Text));
+    painter.drawText(gutter, y + metrics.ascent(), str);
+  }
+  if (!m_file.IndexDone()) {
+    painter.setPen(palette().color(QPalette::Disabled, QPalette::Text));
+    painter.drawText(viewport()->rect().adjusted(0, 0, -charWidth, 0),
+                     Qt::AlignRight | Qt::AlignBottom,
+                     tr("Indexing lines... %1")
+                         .arg(static_cast<qulonglong>(m_file.LineCount())));
+  }
+  if (widest != m_columns) {
+    m_columns = widest;
+    updateScrollBars();
+  }
+}
+
+void LargeFileViewer::resizeEvent(QResizeEvent *event) {
+  QAbstractScrollArea::resizeEvent(event);
+  updateScrollBars();
+}
+
+void LargeFileViewer::keyPressEvent(QKeyEvent *event) {
+  const uint64_t lines = m_file.LineCount();
+  if (lines == 0) return QAbstractScrollArea::keyPressEvent(event);
+  const uint64_t page = visibleLines();
+  if (event->matches(QKeySequence::Copy)) {
+    QString text = selectedText();
+    if (text.isEmpty())
+      text = QString::fromStdString(m_file.Line(m_currentLine));
+    QApplication::clipboard()->setText(text);
+  } else if (event->matches(QKeySequence::MoveToPreviousLine)) {
+    if (m_currentLine > 0) setCurrentLine(m_currentLine - 1);
+  } else if (event->matches(QKeySequence::MoveToNextLine)) {
+    setCurrentLine((std::min)(m_currentLine + 1, lines - 1));
+  } else if (event->matches(QKeySequence::MoveToPreviousPage)) {
+    setCurrentLine(m_currentLine > page ? m_currentLine - page : 0);
+  } else if (event->matches(QKeySequence::MoveToNextPage)) {
+    setCurrentLine((std::min)(m_currentLine + page, lines - 1));
+  } else if (event->matches(QKeySequence::MoveToStartOfDocument)) {
+    setCurrentLine(0);
+  } else if (event->matches(QKeySequence::MoveToEndOfDocument)) {
+    setCurrentLine(lines - 1);
+  } else if (event->key() == Qt::Key_G &&
+             event->modifiers() == Qt::ControlModifier) {
+    goToLineDialog();
+  } else {
+    QAbstractScrollArea::keyPressEvent(event);
+  }
+}
+
+void LargeFileViewer::mousePressEvent(QMouseEvent *event) {
+  const uint64_t line =
+      verticalScrollBar()->value() + event->pos().y() / lineHeight();
+  if (line < m_file.LineCount()) setCurrentLine(line);
+  QAbstractScrollArea::mousePressEvent(event);
+}
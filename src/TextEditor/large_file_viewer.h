@@ -0,0 +1,103 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef LARGE_FILE_VIEWER_H
+#define LARGE_FILE_VIEWER_H
+
+#include <QAbstractScrollArea>
+#include <QTimer>
+#include <atomic>
+#include <set>
+#include <thread>
+
+#include "large_file.h"
+
+namespace FOEDAG {
+
+/*!
+ * \brief The LargeFileViewer class shows a file too large for the editor
+ * (netlists, routing logs), read-only. The file is read on demand, not
+ * loaded, and only the lines in the window are drawn. Searches run in a
+ * worker thread. Lines are 1-based in the API.
+ */
+class LargeFileViewer : public QAbstractScrollArea {
+  Q_OBJECT
+ public:
+  explicit LargeFileViewer(QWidget *parent = nullptr);
+  ~LargeFileViewer() override;
+
+  bool open(const QString &fileName);
+  void reload();
+  QString fileName() const { return m_fileName; }
+
+  void goToLine(int line);
+  void markLine(int line);
+  void clearMarkers();
+  /*!
+   * \brief find starts searching the next occurrence of \a text after the
+   * current one, from the top of the file if \a fromStart. The match is
+   * selected once found, a new search cancels the running one.
+   */
+  void find(const QString &text, bool fromStart, bool caseSensitive,
+            bool wholeWord, bool wrap);
+  QString selectedText() const;
+
+ public slots:
+  void goToLineDialog();
+
+ protected:
+  void paintEvent(QPaintEvent *event) override;
+  void resizeEvent(QResizeEvent *event) override;
+  void keyPressEvent(QKeyEvent *event) override;
+  void mousePressEvent(QMouseEvent *event) override;
+
+ private slots:
+  void indexProgress();
+
+ private:
+  int lineHeight() const;
+  int visibleLines() const;
+  int gutterWidth() const;
+  void updateScrollBars();
+  void setCurrentLine(uint64_t line);
+  bool showMatch();
+  void found(uint64_t search, uint64_t match, int length);
+  void cancelFind();
+
+  QString m_fileName;
+  LargeFile m_file;
+  QTimer m_indexTimer;
+  std::set<uint64_t> m_markers;
+  uint64_t m_currentLine{0};
+  // Line to show once indexed, 0-based
+  uint64_t m_pendingLine{LargeFile::npos};
+  uint64_t m_match{LargeFile::npos};
+  int m_matchLength{0};
+  bool m_matchPending{false};  // line of the match not indexed yet
+  int m_columns{0};  // widest line drawn so far
+
+  std::thread m_finder;
+  std::atomic<bool> m_cancelFind{false};
+  // Tells the result of the latest search from the canceled ones
+  uint64_t m_search{0};
+};
+
+}  // namespace FOEDAG
+#endif  // LARGE_FILE_VIEWER_H
@@ -2,6 +2,7 @@
 
 #include <QMessageBox>
 #include <QPainter>
+#include <QPointer>
 #include <QStyleOption>
 
 using namespace FOEDAG;
@@ -46,8 +47,10 @@ void TextEditorForm::InitForm() {
 
   initForm = true;
 
-  connect(&m_fileWatcher, &QFileSystemWatcher::fileChanged, this,
-          &TextEditorForm::fileModifiedOnDisk);
+  connect(&m_changeTracker, &FileChangeTracker::filesChanged, this,
+          &TextEditorForm::filesModifiedOnDisk);
+  connect(&m_changeTracker, &FileChangeTracker::filesRemoved, this,
+          &TextEditorForm::filesRemovedFromDisk);
 }
 
 int TextEditorForm::OpenFile(const QString &strFileName) {
@@ -97,8 +100,8 @@ int TextEditorForm::OpenFile(const QString &strFileName) {
   pair.first = index;
   pair.second = editor;
   m_map_file_tabIndex_editor.insert(strFileName, pair);
-  m_fileWatcher.addPath(strFileName);
-  editor->SetFileWatcher(&m_fileWatcher);
+  m_changeTracker.addFile(strFileName);
+  editor->SetChangeTracker(&m_changeTracker);
 
   return ret;
 }
@@ -141,8 +144,8 @@ void TextEditorForm::SlotTabCloseRequested(int index) {
 
   auto iter = m_map_file_tabIndex_editor.find(tabItem->getFileName());
   if (iter != m_map_file_tabIndex_editor.end()) {
+    m_changeTracker.removeFile(iter.key());
     m_map_file_tabIndex_editor.erase(iter);
-    m_fileWatcher.removePath(iter.key());
   }
   // Removes the tab at position index from this stack of widgets.
   // The page widget itself is not deleted.
@@ -214,23 +217,58 @@ void TextEditorForm::SlotReplaceAll(const QString &strFindWord,
   }
 }
 
-void TextEditorForm::fileModifiedOnDisk(const QString &path) {
-  auto editorPair = m_map_file_tabIndex_editor.value(path, {0, nullptr});
-  auto editor{editorPair.second};
-  if (editor) {
-    // Here we need add path again since file descriptor might be closed by
-    // other application and file watcher doesn't track this file anymore. If
-    // path has already added - nothing happened.
-    m_fileWatcher.addPath(path);
-    if (editor->isModified()) {
-      const QFileInfo info{path};
-      auto res = QMessageBox::question(
-          this, "File changed",
-          QString{
-              "The file %1 has been changed on disk. Do you want to reload it?"}
-              .arg(info.fileName()));
-      if (res == QMessageBox::No) return;
+// Files not edited are reloaded, the user reviews the others in one go
+void TextEditorForm::filesModifiedOnDisk(const QStringList &paths) {
+  m_changedFiles.append(paths);
+  if (m_reviewing) return;  // after the current review
+  m_reviewing = true;
+  while (!m_changedFiles.isEmpty()) {
+    QStringList changed;
+    changed.swap(m_changedFiles);
+    changed.removeDuplicates();
+    // box.exec() below runs an event loop that may close tabs
+    QVector<QPointer<Editor>> edited;
+    for (const QString &path : changed) {
+      auto editor = m_map_file_tabIndex_editor.value(path, {0, nullptr}).second;
+      if (!editor) continue;
+      if (editor->isModified())
+        edited.append(editor);
+      else
+        editor->reload();
     }
-    editor->reload();
+    if (edited.isEmpty()) continue;
+
+    QString question;
+    if (edited.size() == 1) {
+      const QFileInfo info{edited.first()->getFileName()};
+      question = QString{
+          "The file %1 has been changed on disk. Do you want to reload it?"}
+                     .arg(info.fileName());
+    } else {
+      question = QString{
+          "%1 files with unsaved changes have been changed on disk. Do you "
+          "want to reload them?"}
+                     .arg(edited.size());
+    }
+    QMessageBox box{QMessageBox::Question, "File changed", question,
+                    QMessageBox::Yes | QMessageBox::No, this};
+    if (edited.size() > 1) {
+      QStringList files;
+      for (auto editor : edited) files.append(editor->getFileName());
+      box.setDetailedText(files.join('\n'));
+    }
+    if (box.exec() != QMessageBox::Yes) continue;
+    for (const auto &editor : edited) {
+      // the tab has been closed meanwhile
+      if (editor) editor->reload();
+    }
+  }
+  m_reviewing = false;
+}
+
+void TextEditorForm::filesRemovedFromDisk(const QStringList &paths) {
+  for (const QString &path : paths) {
+    auto editor = m_map_file_tabIndex_editor.value(path, {0, nullptr}).second;
+    if (editor) editor->markRemoved();
   }
 }
@@ -1,11 +1,11 @@
 #ifndef TEXT_EDITOR_FORM_H
 #define TEXT_EDITOR_FORM_H
 
-#include <QFileSystemWatcher>
 #include <QTabWidget>
 #include <QWidget>
 
 #include "editor.h"
+#include "file_change_tracker.h"
 #include "search_dialog.h"
 
 namespace FOEDAG {
@@ -39,14 +39,18 @@ class TextEditorForm : public QWidget {
   void SlotReplaceAndFind(const QString &strFindWord,
                           const QString &strDesWord);
   void SlotReplaceAll(const QString &strFindWord, const QString &strDesWord);
-  void fileModifiedOnDisk(const QString &path);
+  void filesModifiedOnDisk(const QStringList &paths);
+  void filesRemovedFromDisk(const QStringList &paths);
 
  private:
   QTabWidget *m_tab_editor;
   QMap<QString, QPair<int, Editor *>> m_map_file_tabIndex_editor;
 
   SearchDialog *m_searchDialog;
-  QFileSystemWatcher m_fileWatcher;
+  FileChangeTracker m_changeTracker;
+  // Files changed while the user reviews others
+  QStringList m_changedFiles;
+  bool m_reviewing{false};
 };
 }  // namespace FOEDAG
 #endif  // TEXT_EDITOR_FORM_H
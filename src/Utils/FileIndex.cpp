@@ -0,0 +1,465 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "FileIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <set>
+#include <thread>
+
+#include "Utils/StringUtils.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+using namespace FOEDAG;
+namespace fs = std::filesystem;
+
+static int64_t DirMtime(const fs::path& dir) {
+  std::error_code ec;
+  const auto time = fs::last_write_time(dir, ec);
+  return ec ? -1 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+static bool IsUnder(const std::string& path, const std::string& dir) {
+  return path.compare(0, dir.size(), dir) == 0 &&
+         (path.size() == dir.size() || dir.empty() ||
+          path[dir.size()] == fs::path::preferred_separator);
+}
+
+// Splits [0, count) over the threads
+template <typename Func>
+static void Parallel(size_t count, unsigned int threads, Func func) {
+  threads = static_cast<unsigned int>((std::min)(count, size_t{threads}));
+  if (threads <= 1) {
+    func(0, count);
+    return;
+  }
+  std::vector<std::thread> workers;
+  const size_t chunk = (count + threads - 1) / threads;
+  for (size_t begin = 0; begin < count; begin += chunk)
+    workers.emplace_back(func, begin, (std::min)(begin + chunk, count));
+  for (auto& worker : workers) worker.join();
+}
+
+FileIndex& FileIndex::Instance() {
+  static FileIndex index;
+  return index;
+}
+
+FileIndex::FileIndex() {
+#ifdef __linux__
+  m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+  if (const char* cache = std::getenv(CacheVariable)) {
+    m_cacheFile = cache;
+    Load(m_cacheFile);
+  }
+}
+
+FileIndex::~FileIndex() {
+  if (!m_cacheFile.empty()) Save(m_cacheFile);
+#ifdef __linux__
+  if (m_inotify >= 0) close(m_inotify);
+#endif
+}
+
+std::vector<FileIndex::Paths> FileIndex::Find(
+    const fs::path& root, const std::vector<std::string>& names,
+    bool recursive, bool caseInsensitive) {
+  std::vector<Paths> results(names.size());
+  std::error_code ec;
+  if (!fs::is_directory(root, ec)) return results;
+  std::lock_guard<std::mutex> lock{m_mutex};
+  const uint64_t scans = m_scans;
+  Tree* found = &tree(root, recursive);
+  auto lookup = [&]() {
+    const auto& map = caseInsensitive ? found->lowerNames : found->names;
+    bool missed{false};
+    for (size_t i = 0; i < names.size(); i++) {
+      results[i].clear();
+      auto itr = map.find(caseInsensitive ? StringUtils::toLower(names[i])
+                                          : names[i]);
+      if (itr == map.end()) {
+        missed = true;
+        continue;
+      }
+      for (uint32_t file : itr->second)
+        results[i].push_back(found->files[file]);
+    }
+    return missed;
+  };
+  // Without inotify a file created since the last check is missed, the
+  // directory mtimes tell without waiting for MaxAge()
+  if (lookup() && scans == m_scans && !found->watched && !upToDate(*found)) {
+    found->dirty = true;
+    found = &tree(root, recursive);
+    lookup();
+  }
+  return results;
+}
+
+fs::path FileIndex::FindFirst(const fs::path& root, const std::string& name) {
+  std::error_code ec;
+  if (!fs::is_directory(root, ec)) return {};
+  bool indexed{false};
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const std::string key = normalize(root);
+    // Looked up again: the root is worth an index
+    indexed = m_trees.count(Key{key, true}) != 0 ||
+              !m_walked.insert(key).second;
+  }
+  if (indexed) {
+    auto found = Find(root, {name});
+    return found.front().empty() ? fs::path{} : found.front().front();
+  }
+  // Breadth first, a level at a time, ordered as the index
+  std::vector<fs::path> level{normalize(root)};
+  std::set<std::string> linked;
+  while (!level.empty()) {
+    std::vector<fs::path> next;
+    fs::path match;
+    for (const auto& dir : level) {
+      for (fs::directory_iterator itr{dir, ec}, end; !ec && itr != end;
+           itr.increment(ec)) {
+        std::error_code entryEc;
+        if (itr->is_directory(entryEc)) {
+          if (itr->is_symlink(entryEc)) {
+            std::error_code linkEc;
+            const std::string target =
+                fs::canonical(itr->path(), linkEc).string();
+            if (linkEc) continue;
+            const std::string current = fs::canonical(dir, linkEc).string();
+            if (!linkEc && IsUnder(current, target)) continue;
+            if (!linked.insert(target).second) continue;
+          }
+          next.push_back(itr->path());
+        } else if (itr->path().filename() == name &&
+                   itr->is_regular_file(entryEc) &&
+                   (match.empty() || itr->path() < match)) {
+          match = itr->path();
+        }
+      }
+      ec.clear();
+    }
+    if (!match.empty()) return match;
+    level = std::move(next);
+  }
+  return {};
+}
+
+void FileIndex::Invalidate(const fs::path& root) {
+  std::lock_guard<std::mutex> lock{m_mutex};
+  const std::string prefix = root.empty() ? std::string{} : normalize(root);
+  for (auto itr = m_trees.begin(); itr != m_trees.end();) {
+    if (IsUnder(itr->first.first, prefix)) {
+      unwatch(itr->first, itr->second);
+      itr = m_trees.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+}
+
+// Relative roots would name other trees after a change of directory
+std::string FileIndex::normalize(const fs::path& root) {
+  std::error_code ec;
+  fs::path path = fs::absolute(root, ec);
+  if (ec) path = root;
+  path = path.lexically_normal();
+  // "dir/" and "dir" are the same tree
+  if (!path.has_filename() && path.has_relative_path())
+    path = path.parent_path();
+  return path.string();
+}
+
+FileIndex::Tree& FileIndex::tree(const fs::path& root, bool recursive) {
+  readEvents();
+  const Key key{normalize(root), recursive};
+  auto itr = m_trees.find(key);
+  if (itr == m_trees.end()) {
+    itr = m_trees.emplace(key, Tree{}).first;
+    itr->second.root = key.first;
+    itr->second.recursive = recursive;
+    itr->second.dirty = true;
+  }
+  Tree& tree = itr->second;
+  const auto now = std::chrono::steady_clock::now();
+  // Loaded trees have never been checked
+  if (!tree.dirty && (tree.checked == std::chrono::steady_clock::time_point{} ||
+                      now - tree.checked >= m_maxAge))
+    tree.dirty = !upToDate(tree);
+  if (tree.dirty) {
+    unwatch(key, tree);
+    scan(tree);
+    index(tree);
+    watch(key, tree);
+  }
+  tree.checked = now;
+  return tree;
+}
+
+unsigned int FileIndex::threadCount() const {
+  const unsigned int threads =
+      m_threads ? m_threads : std::thread::hardware_concurrency();
+  return (std::max)(1u, threads);
+}
+
+// Directories are listed by a pool of threads sharing a queue
+void FileIndex::scan(Tree& tree) {
+  m_scans++;
+  tree.dirty = false;
+  tree.dirs.clear();
+  tree.files.clear();
+  struct Result {
+    std::vector<std::pair<std::string, int64_t>> dirs;
+    std::vector<fs::path> files;
+  };
+  const unsigned int threads = threadCount();
+  std::vector<Result> results(tree.recursive ? threads : 1);
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<fs::path> queue{tree.root};
+  std::set<std::string> linked;  // targets of the directory links followed
+  size_t busy{0};
+
+  auto worker = [&](Result& result) {
+    std::unique_lock<std::mutex> lock{mutex};
+    while (true) {
+      cv.wait(lock, [&]() { return !queue.empty() || busy == 0; });
+      if (queue.empty()) return;
+      const fs::path dir = std::move(queue.front());
+      queue.pop_front();
+      busy++;
+      lock.unlock();
+
+      result.dirs.emplace_back(dir.string(), DirMtime(dir));
+      std::vector<fs::path> subdirs;
+      std::vector<fs::path> links;
+      std::error_code ec;
+      for (fs::directory_iterator itr{dir, ec}, end; !ec && itr != end;
+           itr.increment(ec)) {
+        std::error_code entryEc;
+        if (itr->is_directory(entryEc)) {
+          if (!tree.recursive) continue;
+          if (itr->is_symlink(entryEc))
+            links.push_back(itr->path());
+          else
+            subdirs.push_back(itr->path());
+        } else if (itr->is_regular_file(entryEc)) {
+          result.files.push_back(itr->path());
+        }
+      }
+      // A link may point to a directory listed already, or to a parent
+      for (const auto& link : links) {
+        std::error_code linkEc;
+        const std::string target = fs::canonical(link, linkEc).string();
+        if (linkEc) continue;
+        const std::string current = fs::canonical(dir, linkEc).string();
+        if (!linkEc && IsUnder(current, target)) continue;
+        lock.lock();
+        const bool added = linked.insert(target).second;
+        lock.unlock();
+        if (added) subdirs.push_back(link);
+      }
+
+      lock.lock();
+      busy--;
+      for (auto& subdir : subdirs) queue.push_back(std::move(subdir));
+      cv.notify_all();
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < results.size(); i++)
+    workers.emplace_back(worker, std::ref(results[i]));
+  worker(results[0]);
+  for (auto& thread : workers) thread.join();
+
+  for (auto& result : results) {
+    tree.dirs.insert(tree.dirs.end(), result.dirs.begin(), result.dirs.end());
+    tree.files.insert(tree.files.end(), result.files.begin(),
+                      result.files.end());
+  }
+}
+
+// The mtime of a directory changes when an entry is added, removed or
+// renamed in it
+bool FileIndex::upToDate(const Tree& tree) const {
+  std::atomic<bool> changed{false};
+  Parallel(tree.dirs.size(), threadCount(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end && !changed; i++)
+      if (DirMtime(tree.dirs[i].first) != tree.dirs[i].second) changed = true;
+  });
+  return !changed && !tree.dirs.empty();
+}
+
+void FileIndex::index(Tree& tree) {
+  auto depth = [](const fs::path& path) {
+    return std::distance(path.begin(), path.end());
+  };
+  std::sort(tree.files.begin(), tree.files.end(),
+            [&depth](const fs::path& a, const fs::path& b) {
+              const auto da = depth(a), db = depth(b);
+              return da != db ? da < db : a < b;
+            });
+  tree.names.clear();
+  tree.lowerNames.clear();
+  for (uint32_t i = 0; i < tree.files.size(); i++) {
+    const std::string name = tree.files[i].filename().string();
+    tree.names[name].push_back(i);
+    tree.lowerNames[StringUtils::toLower(name)].push_back(i);
+  }
+}
+
+void FileIndex::watch(const Key& key, Tree& tree) {
+  tree.watched = false;
+#ifdef __linux__
+  if (m_inotify < 0 || !m_notify) return;
+  constexpr uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                            IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+  for (const auto& dir : tree.dirs) {
+    const int wd = inotify_add_watch(m_inotify, dir.first.c_str(), mask);
+    // Out of watches (fs.inotify.max_user_watches), the mtimes still tell
+    if (wd < 0) break;
+    tree.watches.push_back(wd);
+    m_watches[wd].push_back(key);
+  }
+  tree.watched = tree.watches.size() == tree.dirs.size();
+#else
+  (void)key;
+  (void)tree;
+#endif
+}
+
+void FileIndex::unwatch(const Key& key, Tree& tree) {
+#ifdef __linux__
+  for (int wd : tree.watches) {
+    auto itr = m_watches.find(wd);
+    if (itr == m_watches.end()) continue;
+    auto& keys = itr->second;
+    keys.erase(std::remove(keys.begin(), keys.end(), key), keys.end());
+    // The same directory may be watched for another tree
+    if (keys.empty()) {
+      inotify_rm_watch(m_inotify, wd);
+      m_watches.erase(itr);
+    }
+  }
+#else
+  (void)key;
+#endif
+  tree.watches.clear();
+  tree.watched = false;
+}
+
+void FileIndex::readEvents() {
+#ifdef __linux__
+  if (m_inotify < 0) return;
+  alignas(inotify_event) char buffer[16384];
+  while (true) {
+    const ssize_t size = read(m_inotify, buffer, sizeof(buffer));
+    if (size <= 0) break;  // EAGAIN, nothing more
+    for (ssize_t offset = 0; offset < size;) {
+      const auto* event = reinterpret_cast<inotify_event*>(buffer + offset);
+      offset += sizeof(inotify_event) + event->len;
+      if (event->mask & IN_Q_OVERFLOW) {
+        for (auto& [key, tree] : m_trees) tree.dirty = true;
+        continue;
+      }
+      auto itr = m_watches.find(event->wd);
+      if (itr == m_watches.end()) continue;
+      for (const Key& key : itr->second) {
+        auto tree = m_trees.find(key);
+        if (tree != m_trees.end()) tree->second.dirty = true;
+      }
+      // The kernel dropped the watch, the directory is gone
+      if (event->mask & IN_IGNORED) m_watches.erase(itr);
+    }
+  }
+#endif
+}
+
+// tree <recursive> <root>, then d <mtime> <dir> and f <file> lines
+bool FileIndex::Load(const fs::path& file) {
+  std::ifstream stream{file};
+  if (!stream.good()) return false;
+  std::string line;
+  if (!std::getline(stream, line) || line != "# FileIndex 1") return false;
+  std::lock_guard<std::mutex> lock{m_mutex};
+  Tree* tree{nullptr};
+  std::vector<Tree*> loaded;
+  while (std::getline(stream, line)) {
+    if (line.compare(0, 5, "tree ") == 0 && line.size() > 7) {
+      const Key key{line.substr(7), line[5] == '1'};
+      auto itr = m_trees.find(key);
+      if (itr != m_trees.end()) unwatch(key, itr->second);
+      tree = &m_trees[key];
+      *tree = Tree{};
+      tree->root = key.first;
+      tree->recursive = key.second;
+      loaded.push_back(tree);
+      // Checked against the directories on first use
+    } else if (tree && line.compare(0, 2, "d ") == 0) {
+      const size_t space = line.find(' ', 2);
+      if (space == std::string::npos) continue;
+      tree->dirs.emplace_back(line.substr(space + 1),
+                              std::strtoll(line.c_str() + 2, nullptr, 10));
+    } else if (tree && line.compare(0, 2, "f ") == 0) {
+      tree->files.emplace_back(line.substr(2));
+    }
+  }
+  for (Tree* tree : loaded) {
+    index(*tree);
+    if (tree->dirs.empty()) tree->dirty = true;
+  }
+  return true;
+}
+
+bool FileIndex::Save(const fs::path& file) const {
+  const fs::path temp = file.string() + ".tmp";
+  {
+    std::ofstream stream{temp};
+    if (!stream.good()) return false;
+    stream << "# FileIndex 1\n";
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (const auto& [key, tree] : m_trees) {
+      if (tree.dirty) continue;
+      stream << "tree " << (tree.recursive ? '1' : '0') << ' ' << tree.root
+             << '\n';
+      for (const auto& [dir, mtime] : tree.dirs)
+        stream << "d " << mtime << ' ' << dir << '\n';
+      for (const auto& path : tree.files)
+        stream << "f " << path.string() << '\n';
+    }
+    if (!stream.good()) return false;
+  }
+  std::error_code ec;
+  fs::rename(temp, file, ec);  // readers never see a partial file
+  return !ec;
+}
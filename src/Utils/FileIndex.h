@@ -0,0 +1,128 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The FileIndex class resolves file names under directory trees from
+ * an in-memory index instead of walking the trees on every lookup. A tree is
+ * listed by several threads at once, and the mtimes of its directories are
+ * kept. It is listed again when inotify reports a change (Linux). It is also
+ * listed again when the directory mtimes changed, which is checked once the
+ * index is older than MaxAge() (remote changes on NFS aren't notified), or
+ * on a miss in a tree that inotify doesn't fully cover. Trees are keyed by
+ * absolute path.
+ */
+class FileIndex {
+ public:
+  // Cache file loaded by Instance() and saved at exit when set
+  static constexpr const char* CacheVariable{"FOEDAG_FILE_INDEX"};
+  using Paths = std::vector<std::filesystem::path>;
+
+  static FileIndex& Instance();
+  FileIndex();
+  ~FileIndex();
+  FileIndex(const FileIndex&) = delete;
+  FileIndex& operator=(const FileIndex&) = delete;
+
+  /*!
+   * \brief Find returns, for each of \p names, the regular files with that
+   * name under \p root (directly in it when not \p recursive), shallowest
+   * first. Symbolic links to directories are followed.
+   */
+  std::vector<Paths> Find(const std::filesystem::path& root,
+                          const std::vector<std::string>& names,
+                          bool recursive = true, bool caseInsensitive = false);
+  /*!
+   * \brief FindFirst returns the shallowest regular file named \p name under
+   * \p root, empty if there is none. The first lookup under a root walks it
+   * up to the first match, so one-off lookups in large trees don't pay for a
+   * full listing. The next ones index the tree and answer from the index.
+   */
+  std::filesystem::path FindFirst(const std::filesystem::path& root,
+                                  const std::string& name);
+  // Forgets the trees under \p root, all of them when empty
+  void Invalidate(const std::filesystem::path& root = {});
+
+  void SetMaxAge(std::chrono::milliseconds age) { m_maxAge = age; }
+  std::chrono::milliseconds MaxAge() const { return m_maxAge; }
+  void SetThreads(unsigned int threads) { m_threads = threads; }
+  // Off, changes are only seen through the directory mtimes
+  void SetNotify(bool notify) { m_notify = notify; }
+  // Number of tree listings so far
+  uint64_t Scans() const { return m_scans; }
+
+  bool Load(const std::filesystem::path& file);
+  bool Save(const std::filesystem::path& file) const;
+
+ private:
+  struct Tree {
+    std::string root;
+    bool recursive{true};
+    std::chrono::steady_clock::time_point checked;
+    // Directory and mtime
+    std::vector<std::pair<std::string, int64_t>> dirs;
+    // Shallowest first
+    std::vector<std::filesystem::path> files;
+    std::unordered_map<std::string, std::vector<uint32_t>> names;
+    std::unordered_map<std::string, std::vector<uint32_t>> lowerNames;
+    std::vector<int> watches;
+    // Every directory is watched, a miss can be trusted
+    bool watched{false};
+    bool dirty{false};
+  };
+  using Key = std::pair<std::string, bool>;
+
+  static std::string normalize(const std::filesystem::path& root);
+  Tree& tree(const std::filesystem::path& root, bool recursive);
+  void scan(Tree& tree);
+  bool upToDate(const Tree& tree) const;
+  void index(Tree& tree);
+  void watch(const Key& key, Tree& tree);
+  void unwatch(const Key& key, Tree& tree);
+  void readEvents();
+  unsigned int threadCount() const;
+
+  mutable std::mutex m_mutex;
+  std::map<Key, Tree> m_trees;
+  // Roots FindFirst() walked once
+  std::set<std::string> m_walked;
+  std::chrono::milliseconds m_maxAge{10000};
+  unsigned int m_threads{0};  // hardware concurrency
+  bool m_notify{true};
+  uint64_t m_scans{0};
+  int m_inotify{-1};
+  std::unordered_map<int, std::vector<Key>> m_watches;
+  std::filesystem::path m_cacheFile;
+};
+
+}  // namespace FOEDAG
@@ -37,6 +37,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <sstream>
 #include <string>
 
+#include "Utils/FileIndex.h"
 #include "Utils/StringUtils.h"
 
 namespace FOEDAG {
@@ -154,22 +155,8 @@ std::filesystem::path FileUtils::LocateExecFile(
 // filename. Partial matches and directory matches are not returned.
 std::filesystem::path FileUtils::LocateFileRecursive(
     const std::filesystem::path& searchPath, const std::string filename) {
-  std::filesystem::path result{};
-  if (FileUtils::FileExists(searchPath)) {
-    // Recursively search searchPath
-    for (const std::filesystem::path& entry :
-         std::filesystem::recursive_directory_iterator(
-             searchPath,
-             std::filesystem::directory_options::follow_directory_symlink)) {
-      // If this is a file and the filename matches exactly
-      if (FileIsRegular(entry) && entry.filename() == filename) {
-        result = entry;
-        break;
-      }
-    }
-  }
-
-  return result;
+  // Walked up to the first match the first time, indexed from then on
+  return FileIndex::Instance().FindFirst(searchPath, filename);
 }
 
 // This will search the given paths (non-recursively) for a child file.
@@ -179,30 +166,10 @@ std::vector<std::filesystem::path> FileUtils::FindFileInDirs(
     const std::vector<std::filesystem::path>& searchPaths,
     bool caseInsensitive) {
   std::vector<std::filesystem::path> results{};
-  for (auto path : searchPaths) {
-    // Make sure search path is valid
-    if (FileUtils::FileExists(path)) {
-      // Iterate through files in path
-      for (const std::filesystem::path& entry :
-           std::filesystem::directory_iterator(
-               path,
-               std::filesystem::directory_options::follow_directory_symlink)) {
-        // Ensure this is a file
-        if (FileUtils::FileIsRegular(entry)) {
-          std::string entryName = entry.filename().string();
-          std::string searchName = filename;
-          if (caseInsensitive) {
-            // Convert both names to lowercase to ignore case
-            entryName = StringUtils::toLower(entryName);
-            searchName = StringUtils::toLower(searchName);
-          }
-          // Record the file on match
-          if (entryName == searchName) {
-            results.push_back(entry);
-          }
-        }
-      }
-    }
+  for (const auto& path : searchPaths) {
+    auto found =
+        FileIndex::Instance().Find(path, {filename}, false, caseInsensitive);
+    results.insert(results.end(), found.front().begin(), found.front().end());
   }
   return results;
 }
@@ -248,6 +215,16 @@ time_t FileUtils::Mtime(const std::filesystem::path& path) {
   return statbuf.st_mtime;
 }
 
+std::string FileUtils::Stamp(const std::filesystem::path& path) {
+  std::error_code ec;
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) return {};
+  const auto time = std::filesystem::last_write_time(path, ec);
+  if (ec) return {};
+  return std::to_string(size) + ":" +
+         std::to_string(time.time_since_epoch().count());
+}
+
 bool FileUtils::IsUptoDate(const std::string& sourceFile,
                            const std::string& outputFile) {
   time_t time_output = -1;
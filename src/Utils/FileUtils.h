@@ -66,6 +66,10 @@ class FileUtils final {
                                   std::ostream* result);
 
   static time_t Mtime(const std::filesystem::path& path);
+  // Size and last write time at the file system resolution, empty if the
+  // file can't be read. Unlike Mtime(), it changes for a rewrite within the
+  // same second
+  static std::string Stamp(const std::filesystem::path& path);
 
   static bool IsUptoDate(const std::string& sourceFile,
                          const std::string& outputFile);
@@ -0,0 +1,208 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "HostAdmission.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#if (defined(_MSC_VER) || defined(__CYGWIN__))
+#define NOMINMAX  // prevent error with std::max
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+namespace FOEDAG {
+
+static constexpr const char* LockFile{"admission.lock"};
+static constexpr const char* LedgerFile{"admission.jobs"};
+
+static int64_t ProcessId() {
+#if (defined(_MSC_VER) || defined(__CYGWIN__))
+  return GetCurrentProcessId();
+#else
+  return getpid();
+#endif
+}
+
+static bool IsAlive(int64_t pid) {
+#if (defined(_MSC_VER) || defined(__CYGWIN__))
+  return true;
+#else
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+// Exclusive lock of the admission directory, held while the ledger is used
+class HostAdmission::Lock {
+ public:
+  explicit Lock(const std::filesystem::path& dir) {
+#if !(defined(_MSC_VER) || defined(__CYGWIN__))
+    m_fd = open((dir / LockFile).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if (m_fd != -1 && flock(m_fd, LOCK_EX) != 0) {
+      close(m_fd);
+      m_fd = -1;
+    }
+#endif
+  }
+  ~Lock() {
+#if !(defined(_MSC_VER) || defined(__CYGWIN__))
+    if (m_fd != -1) close(m_fd);  // releases the lock
+#endif
+  }
+  bool IsLocked() const { return m_fd != -1; }
+
+ private:
+  int m_fd{-1};
+};
+
+bool HostAdmission::Configure(const std::filesystem::path& dir,
+                              unsigned int capacityMb) {
+  m_error.clear();
+  m_dir.clear();
+  if (dir.empty()) return true;
+#if (defined(_MSC_VER) || defined(__CYGWIN__))
+  m_error = "Host admission control is not supported on this platform";
+  return false;
+#else
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (!std::filesystem::is_directory(dir)) {
+    m_error = "Can't create admission directory " + dir.string();
+    return false;
+  }
+  if (!Lock{dir}.IsLocked()) {
+    m_error = "Can't lock " + (dir / LockFile).string();
+    return false;
+  }
+  m_dir = dir;
+  m_capacity = capacityMb ? capacityMb : PhysicalMemoryMb();
+  return true;
+#endif
+}
+
+std::vector<HostAdmission::Job> HostAdmission::readLedger() const {
+  std::vector<Job> jobs;
+  std::ifstream stream{m_dir / LedgerFile};
+  std::string line;
+  while (std::getline(stream, line)) {
+    std::istringstream fields{line};
+    Job job;
+    if (fields >> job.pid >> job.ticket >> job.weightMb && IsAlive(job.pid))
+      jobs.push_back(job);
+  }
+  return jobs;
+}
+
+bool HostAdmission::writeLedger(const std::vector<Job>& jobs) {
+  // Replaced as a whole so that a crash can't leave half a ledger
+  const std::filesystem::path file = m_dir / LedgerFile;
+  std::filesystem::path temp = file;
+  temp += "." + std::to_string(ProcessId());
+  {
+    std::ofstream stream{temp, std::ios::trunc};
+    for (const auto& job : jobs)
+      stream << job.pid << " " << job.ticket << " " << job.weightMb << "\n";
+    if (!stream.good()) {
+      m_error = "Can't write " + temp.string();
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(temp, file, ec);
+  if (ec) {
+    m_error = "Can't write " + file.string() + ": " + ec.message();
+    return false;
+  }
+  return true;
+}
+
+uint64_t HostAdmission::Acquire(
+    unsigned int weightMb, const std::function<bool()>& cancelled,
+    const std::function<void(unsigned int)>& waiting) {
+  static std::atomic<uint64_t> lastTicket{0};
+  if (!IsEnabled()) return 0;
+  const Job job{ProcessId(), ++lastTicket, weightMb};
+  bool notified{false};
+  while (!cancelled || !cancelled()) {
+    unsigned int used{0};
+    {
+      Lock lock{m_dir};
+      if (!lock.IsLocked()) {
+        m_error = "Can't lock " + (m_dir / LockFile).string();
+        return 0;
+      }
+      auto jobs = readLedger();
+      for (const auto& running : jobs) used += running.weightMb;
+      if (jobs.empty() || used + weightMb <= m_capacity) {
+        jobs.push_back(job);
+        return writeLedger(jobs) ? job.ticket : 0;
+      }
+    }
+    if (!notified && waiting) waiting(used);
+    notified = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds{m_pollMs});
+  }
+  return 0;
+}
+
+void HostAdmission::Release(uint64_t ticket) {
+  if (!IsEnabled() || ticket == 0) return;
+  Lock lock{m_dir};
+  if (!lock.IsLocked()) return;
+  auto jobs = readLedger();
+  const int64_t pid = ProcessId();
+  jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+                            [pid, ticket](const Job& job) {
+                              return job.pid == pid && job.ticket == ticket;
+                            }),
+             jobs.end());
+  writeLedger(jobs);
+}
+
+std::vector<HostAdmission::Job> HostAdmission::Jobs() {
+  if (!IsEnabled()) return {};
+  Lock lock{m_dir};
+  return readLedger();
+}
+
+unsigned int HostAdmission::PhysicalMemoryMb() {
+#if (defined(_MSC_VER) || defined(__CYGWIN__))
+  MEMORYSTATUSEX status;
+  status.dwLength = sizeof(status);
+  GlobalMemoryStatusEx(&status);
+  return static_cast<unsigned int>(status.ullTotalPhys / (1024 * 1024));
+#else
+  const uint64_t pages = sysconf(_SC_PHYS_PAGES);
+  const uint64_t pageSize = sysconf(_SC_PAGESIZE);
+  return static_cast<unsigned int>(pages * pageSize / (1024 * 1024));
+#endif
+}
+
+}  // namespace FOEDAG
@@ -0,0 +1,85 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace FOEDAG {
+
+/*!
+ * \brief The HostAdmission class queues tool launches until the memory they
+ * are expected to use fits on the host. Every process sharing the admission
+ * directory takes part: the running jobs are kept in a ledger file guarded
+ * by a lock file, and jobs of processes that died are dropped from it.
+ */
+class HostAdmission {
+ public:
+  struct Job {
+    int64_t pid{0};
+    uint64_t ticket{0};
+    unsigned int weightMb{0};
+  };
+  // Directory used when FOEDAG_ADMISSION_DIR is set
+  static constexpr const char* DirVariable{"FOEDAG_ADMISSION_DIR"};
+
+  /*!
+   * \brief Configure enables the admission control. \a capacityMb of 0 uses
+   * the physical memory of the host. An empty \a dir disables it.
+   */
+  bool Configure(const std::filesystem::path& dir, unsigned int capacityMb);
+  bool IsEnabled() const { return !m_dir.empty(); }
+  const std::filesystem::path& Dir() const { return m_dir; }
+  unsigned int Capacity() const { return m_capacity; }
+  const std::string& LastError() const { return m_error; }
+  void PollInterval(unsigned int ms) { m_pollMs = ms; }
+
+  /*!
+   * \brief Acquire blocks until a job of \a weightMb fits in the capacity.
+   * A job is always admitted when nothing else runs, however heavy.
+   * \a waiting is called once with the memory in use if the job has to wait.
+   * \return the ticket to release, 0 if \a cancelled or on error
+   */
+  uint64_t Acquire(unsigned int weightMb,
+                   const std::function<bool()>& cancelled = {},
+                   const std::function<void(unsigned int)>& waiting = {});
+  void Release(uint64_t ticket);
+
+  // Jobs admitted by all the processes sharing the directory
+  std::vector<Job> Jobs();
+
+  static unsigned int PhysicalMemoryMb();
+
+ private:
+  class Lock;
+  std::vector<Job> readLedger() const;
+  bool writeLedger(const std::vector<Job>& jobs);
+
+  std::filesystem::path m_dir;
+  unsigned int m_capacity{0};
+  unsigned int m_pollMs{500};
+  std::string m_error;
+};
+
+}  // namespace FOEDAG
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "ProcessUtils.h"
 
+#include <algorithm>
 #include <string>
 #if (defined(_MSC_VER) || defined(__CYGWIN__))
 #define NOMINMAX  // prevent error with std::max
@@ -27,11 +28,191 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 // include order metters
 #include <psapi.h>
 #else
+#include <sched.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <filesystem>
 #include <fstream>
+#include <sstream>
 #endif
 
+#include "StringUtils.h"
+
 namespace FOEDAG {
 
+// Memory of the whole process group is sampled every that many samples
+static constexpr unsigned int GroupMemoryPeriod{50};
+
+static bool ToInt(const std::string& text, int& value) {
+  try {
+    size_t pos = 0;
+    value = std::stoi(text, &pos);
+    return pos == text.size();
+  } catch (...) {
+    return false;
+  }
+}
+
+bool ResourceLimits::IsEmpty() const {
+  return memoryMb == 0 && cpus.empty() && nice == 0 && ioniceClass == 0 &&
+         timeoutSec == 0;
+}
+
+bool ResourceLimits::Parse(const std::vector<std::string>& args,
+                           std::string& error) {
+  for (size_t i = 0; i < args.size(); i++) {
+    const std::string& option = args[i];
+    if (i + 1 == args.size()) {
+      error = "Missing value of " + option;
+      return false;
+    }
+    const std::string& value = args[++i];
+    int number{0};
+    if (option == "-memory" || option == "-timeout") {
+      if (!ToInt(value, number) || number < 0) {
+        error = "Invalid " + option + " value: " + value;
+        return false;
+      }
+      (option == "-memory" ? memoryMb : timeoutSec) = number;
+    } else if (option == "-nice") {
+      if (!ToInt(value, number) || number < -20 || number > 19) {
+        error = "Invalid -nice value, expected -20..19: " + value;
+        return false;
+      }
+      nice = number;
+    } else if (option == "-cpus") {
+      // "0-3,6"
+      std::vector<int> list;
+      std::vector<std::string> ranges;
+      StringUtils::tokenize(value, ",", ranges);
+      for (const auto& range : ranges) {
+        const size_t dash = range.find('-');
+        int first{0}, last{0};
+        if (!ToInt(range.substr(0, dash), first) ||
+            !ToInt(dash == std::string::npos ? range : range.substr(dash + 1),
+                   last) ||
+            first < 0 || last < first) {
+          error = "Invalid -cpus value: " + value;
+          return false;
+        }
+        for (int cpu = first; cpu <= last; cpu++) list.push_back(cpu);
+      }
+      std::sort(list.begin(), list.end());
+      list.erase(std::unique(list.begin(), list.end()), list.end());
+      cpus = list;
+    } else if (option == "-ionice") {
+      // "<class>[:<level>]", class 0 restores the default
+      const size_t colon = value.find(':');
+      int ioClass{0}, level{4};
+      if (!ToInt(value.substr(0, colon), ioClass) || ioClass < 0 ||
+          ioClass > 3 ||
+          (colon != std::string::npos &&
+           (!ToInt(value.substr(colon + 1), level) || level < 0 ||
+            level > 7))) {
+        error = "Invalid -ionice value, expected <class>[:<level>]: " + value;
+        return false;
+      }
+      ioniceClass = ioClass;
+      ioniceLevel = level;
+    } else {
+      error = "Unknown option " + option;
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string ResourceLimits::ToString() const {
+  std::string str;
+  if (memoryMb) str += " -memory " + std::to_string(memoryMb);
+  if (!cpus.empty()) {
+    std::string list;
+    for (size_t i = 0; i < cpus.size(); i++) {
+      size_t last = i;
+      while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1)
+        last++;
+      if (!list.empty()) list += ",";
+      list += std::to_string(cpus[i]);
+      if (last != i) list += "-" + std::to_string(cpus[last]);
+      i = last;
+    }
+    str += " -cpus " + list;
+  }
+  if (nice) str += " -nice " + std::to_string(nice);
+  if (ioniceClass)
+    str += " -ionice " + std::to_string(ioniceClass) + ":" +
+           std::to_string(ioniceLevel);
+  if (timeoutSec) str += " -timeout " + std::to_string(timeoutSec);
+  return str.empty() ? str : str.substr(1);
+}
+
+void ProcessUtils::SetupChild(const ResourceLimits& limits) {
+#if !(defined(_MSC_VER) || defined(__CYGWIN__))
+  // Own process group, so that the tool and all its children can be stopped
+  // together
+  setpgid(0, 0);
+  if (limits.nice) setpriority(PRIO_PROCESS, 0, limits.nice);
+#ifdef __linux__
+  if (!limits.cpus.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : limits.cpus)
+      if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+  }
+  if (limits.ioniceClass) {
+    // IOPRIO_PRIO_VALUE(class, data), IOPRIO_WHO_PROCESS
+    const int ioprio = (limits.ioniceClass << 13) | limits.ioniceLevel;
+    syscall(SYS_ioprio_set, 1, 0, ioprio);
+  }
+#endif
+#endif
+}
+
+bool ProcessUtils::SignalGroup(int64_t groupId, bool force) {
+#if (defined(_MSC_VER) || defined(__CYGWIN__))
+  return false;
+#else
+  if (groupId <= 0) return false;
+  return kill(-static_cast<pid_t>(groupId), force ? SIGKILL : SIGTERM) == 0;
+#endif
+}
+
+ProcessUtils::uint ProcessUtils::GroupMemory(int64_t groupId) {
+#if (defined(_MSC_VER) || defined(__CYGWIN__))
+  return 0;
+#else
+  static const long pageKib = sysconf(_SC_PAGESIZE) / 1024;
+  uint64_t total{0};
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator{"/proc", ec}) {
+    const std::string name = entry.path().filename().string();
+    if (name.empty() || !std::isdigit(name.front())) continue;
+    std::ifstream stream{entry.path() / "stat"};
+    std::string stat;
+    if (!std::getline(stream, stat)) continue;
+    // The command name may hold spaces, fields are counted after it
+    const size_t end = stat.rfind(')');
+    if (end == std::string::npos) continue;
+    std::istringstream fields{stat.substr(end + 1)};
+    std::string field;
+    int64_t pgrp{0};
+    uint64_t rss{0};
+    // state ppid pgrp ... rss is the 22nd field after the name
+    for (int i = 1; i <= 22 && fields >> field; i++) {
+      if (i == 3) pgrp = std::atoll(field.c_str());
+      if (i == 22) rss = std::strtoull(field.c_str(), nullptr, 10);
+    }
+    if (pgrp == groupId) total += rss * pageKib;
+  }
+  return static_cast<uint>(std::min<uint64_t>(total, UINT32_MAX));
+#endif
+}
+
 ProcessUtils::~ProcessUtils() { cleanup(); }
 
 ProcessUtils::uint ProcessUtils::Utilization() const {
@@ -71,10 +252,19 @@ void process_mem_usage(int64_t processId, const char *proccessIdStr,
 void ProcessUtils::Start(int64_t processId) {
   auto start = [processId, this]() {
     auto str = ("/proc/" + std::to_string(processId) + "/stat");
+    uint samples{0};
     while (!m_stop) {
       double vm;
       process_mem_usage(processId, str.c_str(), vm);
       m_vm = std::max(m_vm, vm);
+      if (samples++ % GroupMemoryPeriod == 0) {
+        const uint group = GroupMemory(processId);
+        m_groupPeak = std::max(m_groupPeak, group);
+        if (m_memoryLimit && !m_memoryLimitHit && group > m_memoryLimit) {
+          m_memoryLimitHit = true;
+          SignalGroup(processId, true);
+        }
+      }
 
       std::chrono::milliseconds dura(m_frequency);
       std::this_thread::sleep_for(dura);
@@ -20,21 +20,77 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace FOEDAG {
 
+/*!
+ * \brief The ResourceLimits struct bounds the resources of a tool process and
+ * of every process it starts.
+ */
+struct ResourceLimits {
+  unsigned int memoryMb{0};  // resident memory of the process group
+  std::vector<int> cpus;     // CPU affinity
+  int nice{0};
+  int ioniceClass{0};  // 1: realtime, 2: best-effort, 3: idle
+  int ioniceLevel{4};  // 0 (highest) .. 7, realtime and best-effort only
+  unsigned int timeoutSec{0};  // wall clock
+
+  bool IsEmpty() const;
+  /*!
+   * \brief Parse reads "-memory <MB> -cpus <list> -nice <n>
+   * -ionice <class>[:<level>] -timeout <sec>" options. 0 or an empty CPU
+   * list means unlimited. Options not given keep their current value.
+   */
+  bool Parse(const std::vector<std::string>& args, std::string& error);
+  std::string ToString() const;
+};
+
 class ProcessUtils {
  public:
   ProcessUtils() = default;
   ~ProcessUtils();
   using uint = unsigned int;
 
+  /*!
+   * \brief SetupChild runs in the child process between fork and exec. It
+   * makes the child the leader of a new process group and applies the CPU
+   * affinity and priorities of \a limits. Async-signal-safe.
+   */
+  static void SetupChild(const ResourceLimits& limits);
+  /*!
+   * \brief SignalGroup terminates (or kills, if \a force) every process of
+   * the group led by \a groupId.
+   */
+  static bool SignalGroup(int64_t groupId, bool force);
+  /*!
+   * \brief GroupMemory
+   * \return resident memory in kiB of all the processes of the group.
+   */
+  static uint GroupMemory(int64_t groupId);
+
+  /*!
+   * \brief MemoryLimit kills the process group started by Start() once its
+   * resident memory exceeds \a kib. 0 disables the limit.
+   */
+  void MemoryLimit(uint kib) { m_memoryLimit = kib; }
+  bool MemoryLimitHit() const { return m_memoryLimitHit; }
+
   /*!
    * \brief Utilization
    * \return max usage of virtual memory in kiB.
    */
   uint Utilization() const;
+  /*!
+   * \brief GroupPeak
+   * \return max resident memory in kiB of the process group started by
+   * Start(), sampled every few measurements.
+   */
+  uint GroupPeak() const { return m_groupPeak; }
 
   /*!
    * \brief Period sets the frequency of measurment
@@ -48,6 +104,9 @@ class ProcessUtils {
 
   uint m_max_utiliation{0};
   uint m_frequency{10};
+  uint m_memoryLimit{0};
+  uint m_groupPeak{0};
+  std::atomic<bool> m_memoryLimitHit{false};
   bool m_stop{false};
   std::thread *m_thread{nullptr};
   double m_vm{0};
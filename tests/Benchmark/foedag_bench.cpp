@@ -0,0 +1,356 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// foedag_bench runs the test designs through the whole Tcl flow several times
+// and reports, as JSON, how the wall time splits between the external tools
+// and FOEDAG itself (script generation, file checks, log parsing, reports,
+// project creation and save).
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Compiler/QorDatabase.h"
+#include "Utils/StringUtils.h"
+#include "nlohmann_json/json.hpp"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace FOEDAG;
+using json = nlohmann::ordered_json;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Options {
+  fs::path foedag{"build/bin/foedag"};
+  fs::path testcases{"tests/Testcases"};
+  fs::path work{"bench_work"};
+  fs::path out;
+  fs::path baseline;
+  double threshold{10};  // percent
+  std::vector<std::string> designs{"aes_decrypt_fpga", "bgm", "oneff",
+                                   "trivial"};
+  int iterations{5};
+  std::vector<std::string> foedagArgs;
+};
+
+// Timings of one run in ms
+struct Sample {
+  double wall{0};
+  double stages{0};  // inside the flow commands
+  double tool{0};    // inside the external tools
+  std::map<std::string, std::map<std::string, double>> stageMetrics;
+};
+
+void usage() {
+  std::cout
+      << "Usage: foedag_bench [options] [-- <foedag arguments>]\n"
+         "  --foedag <binary>       foedag executable (build/bin/foedag)\n"
+         "  --testcases <dir>       designs directory (tests/Testcases)\n"
+         "  --designs <a,b|all>     designs to run "
+         "(aes_decrypt_fpga,bgm,oneff,trivial)\n"
+         "  --iterations <n>        runs per design (5)\n"
+         "  --work <dir>            scratch directory (bench_work)\n"
+         "  --out <file>            JSON results, stdout by default\n"
+         "  --baseline <file>       fails if the FOEDAG overhead of a design "
+         "grew\n"
+         "  --threshold <percent>   allowed overhead growth (10)\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg{argv[i]};
+    if (arg == "--") {
+      opt.foedagArgs.assign(argv + i + 1, argv + argc);
+      return true;
+    }
+    if (arg == "-h" || arg == "--help" || i + 1 == argc) return false;
+    const std::string value{argv[++i]};
+    if (arg == "--foedag") {
+      opt.foedag = value;
+    } else if (arg == "--testcases") {
+      opt.testcases = value;
+    } else if (arg == "--designs") {
+      opt.designs.clear();
+      if (value != "all") StringUtils::tokenize(value, ",", opt.designs);
+    } else if (arg == "--iterations") {
+      const char* end = value.data() + value.size();
+      auto [ptr, ec] = std::from_chars(value.data(), end, opt.iterations);
+      if (ec != std::errc{} || ptr != end || opt.iterations < 1) {
+        std::cerr << "Invalid --iterations: " << value << std::endl;
+        return false;
+      }
+    } else if (arg == "--work") {
+      opt.work = value;
+    } else if (arg == "--out") {
+      opt.out = value;
+    } else if (arg == "--baseline") {
+      opt.baseline = value;
+    } else if (arg == "--threshold") {
+      char* end = nullptr;
+      opt.threshold = std::strtod(value.c_str(), &end);
+      if (value.empty() || *end != '\0' || !std::isfinite(opt.threshold) ||
+          opt.threshold < 0) {
+        std::cerr << "Invalid --threshold: " << value << std::endl;
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The flow script of a design is the one creating the project
+fs::path flowScript(const fs::path& dir, std::string& error) {
+  std::vector<fs::path> scripts;
+  std::error_code ec;
+  for (fs::directory_iterator itr{dir, ec}, end; !ec && itr != end;
+       itr.increment(ec))
+    if (itr->path().extension() == ".tcl") scripts.push_back(itr->path());
+  if (ec) {
+    error = "can't read " + dir.string() + ": " + ec.message();
+    return {};
+  }
+  std::sort(scripts.begin(), scripts.end());
+  for (const auto& script : scripts) {
+    std::ifstream stream{script};
+    std::string content{std::istreambuf_iterator<char>{stream}, {}};
+    if (content.find("create_design") != std::string::npos) return script;
+  }
+  return {};
+}
+
+// Runs foedag in \a dir, output goes to bench.log
+int runFoedag(const Options& opt, const fs::path& script, const fs::path& dir) {
+#ifdef _WIN32
+  std::cerr << "foedag_bench is not supported on Windows" << std::endl;
+  return -1;
+#else
+  std::vector<std::string> args{opt.foedag.string(), "--batch", "--script",
+                                script.string()};
+  args.insert(args.end(), opt.foedagArgs.begin(), opt.foedagArgs.end());
+  std::vector<char*> argv;
+  for (auto& arg : args) argv.push_back(arg.data());
+  argv.push_back(nullptr);
+  const std::string log = (dir / "bench.log").string();
+  pid_t pid = fork();
+  if (pid == 0) {
+    if (chdir(dir.c_str()) != 0) _exit(127);
+    int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd != -1) {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+    // Every run records its stage timings in its own QoR database
+    setenv("FOEDAG_QOR_DIR", dir.c_str(), 1);
+    execv(argv[0], argv.data());
+    _exit(127);
+  }
+  int status{0};
+  if (pid == -1 || waitpid(pid, &status, 0) != pid) return -1;
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+}
+
+double median(std::vector<double> values) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  const size_t middle = values.size() / 2;
+  return (values.size() % 2) ? values[middle]
+                             : (values[middle - 1] + values[middle]) / 2;
+}
+
+json stats(const std::vector<double>& values) {
+  if (values.empty()) return json::object();
+  return {{"median", median(values)},
+          {"min", *std::min_element(values.begin(), values.end())},
+          {"max", *std::max_element(values.begin(), values.end())}};
+}
+
+json benchDesign(const Options& opt, const std::string& design) {
+  json result;
+  std::string error;
+  const fs::path script = flowScript(opt.testcases / design, error);
+  if (script.empty()) {
+    result["error"] = error.empty() ? "no flow script in " +
+                                          (opt.testcases / design).string()
+                                    : error;
+    return result;
+  }
+  result["script"] = script.string();
+  std::vector<Sample> samples;
+  int failures{0};
+  for (int i = 0; i < opt.iterations; i++) {
+    const fs::path dir = fs::absolute(opt.work / design / std::to_string(i));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto start = std::chrono::steady_clock::now();
+    const int status = runFoedag(opt, fs::absolute(script), dir);
+    auto end = std::chrono::steady_clock::now();
+    if (status != 0) {
+      std::cerr << design << " run " << i << " failed, see "
+                << (dir / "bench.log").string() << std::endl;
+      failures++;
+      continue;
+    }
+    Sample sample;
+    sample.wall =
+        std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
+            .count();
+    QorDatabase db;
+    db.Open(dir / QorDatabase::DefaultFile);
+    for (const auto& record : db.Records()) {
+      auto& metrics = sample.stageMetrics[record.stage];
+      for (const auto& [metric, value] : record.metrics) {
+        if (metric == "runtime_ms" || metric == "_tool_ms" ||
+            metric == "_setup_ms" || metric == "_wrapup_ms")
+          metrics[metric] += value;
+      }
+      auto runtime = record.metrics.find("runtime_ms");
+      auto tool = record.metrics.find("_tool_ms");
+      const double stageMs =
+          (runtime != record.metrics.end()) ? runtime->second : 0;
+      const double toolMs = (tool != record.metrics.end()) ? tool->second : 0;
+      metrics["overhead_ms"] += stageMs - toolMs;
+      sample.stages += stageMs;
+      sample.tool += toolMs;
+    }
+    samples.push_back(sample);
+  }
+
+  std::vector<double> wall, tool, overhead, session;
+  std::map<std::string, std::map<std::string, std::vector<double>>> stages;
+  for (const auto& sample : samples) {
+    wall.push_back(sample.wall);
+    tool.push_back(sample.tool);
+    overhead.push_back(sample.wall - sample.tool);
+    // startup, project creation and save, Tcl outside the flow commands
+    session.push_back(sample.wall - sample.stages);
+    for (const auto& [stage, metrics] : sample.stageMetrics)
+      for (const auto& [metric, value] : metrics)
+        stages[stage][metric].push_back(value);
+  }
+  result["runs"] = samples.size();
+  result["failures"] = failures;
+  result["wall_ms"] = stats(wall);
+  result["tool_ms"] = stats(tool);
+  result["overhead_ms"] = stats(overhead);
+  result["session_ms"] = stats(session);
+  json& stageResults = result["stages"] = json::object();
+  for (const auto& [stage, metrics] : stages) {
+    for (const auto& [metric, values] : metrics) {
+      std::string name = metric;
+      if (!name.empty() && name.front() == '_') name.erase(0, 1);
+      stageResults[stage][name] = median(values);
+    }
+  }
+  return result;
+}
+
+// Number of designs whose median overhead grew past the threshold
+int compareBaseline(const Options& opt, const json& results) {
+  std::ifstream stream{opt.baseline};
+  json baseline = json::parse(stream, nullptr, false);
+  if (baseline.is_discarded()) {
+    std::cerr << "Can't read baseline " << opt.baseline.string() << std::endl;
+    return 1;
+  }
+  int regressions{0};
+  for (const auto& [design, result] : results["designs"].items()) {
+    const auto& base = baseline["designs"][design]["overhead_ms"];
+    if (!base.contains("median") || !result["overhead_ms"].contains("median"))
+      continue;
+    const double before = base["median"].get<double>();
+    const double after = result["overhead_ms"]["median"].get<double>();
+    const double percent = before ? (after - before) / before * 100 : 0;
+    std::cerr << design << ": FOEDAG overhead " << before << " -> " << after
+              << " ms (" << percent << "%)";
+    if (percent > opt.threshold) {
+      std::cerr << " REGRESSION";
+      regressions++;
+    }
+    std::cerr << std::endl;
+  }
+  return regressions;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    usage();
+    return 1;
+  }
+  if (opt.designs.empty()) {
+    std::error_code ec;
+    for (fs::directory_iterator itr{opt.testcases, ec}, end;
+         !ec && itr != end; itr.increment(ec)) {
+      std::error_code entryError;
+      std::string error;
+      if (itr->is_directory(entryError) &&
+          !flowScript(itr->path(), error).empty())
+        opt.designs.push_back(itr->path().filename().string());
+    }
+    if (ec) {
+      std::cerr << "Can't read " << opt.testcases.string() << ": "
+                << ec.message() << std::endl;
+      return 1;
+    }
+    std::sort(opt.designs.begin(), opt.designs.end());
+  }
+  opt.foedag = fs::absolute(opt.foedag);
+
+  json results;
+  results["foedag"] = opt.foedag.string();
+  results["iterations"] = opt.iterations;
+  json& designs = results["designs"] = json::object();
+  int failures{0};
+  for (const auto& design : opt.designs) {
+    std::cerr << "Running " << design << "..." << std::endl;
+    designs[design] = benchDesign(opt, design);
+    if (designs[design].contains("error") ||
+        designs[design]["failures"].get<int>() > 0)
+      failures++;
+  }
+
+  if (opt.out.empty()) {
+    std::cout << results.dump(2) << std::endl;
+  } else {
+    std::ofstream{opt.out} << results.dump(2) << std::endl;
+  }
+  int regressions = opt.baseline.empty() ? 0 : compareBaseline(opt, results);
+  return (failures || regressions) ? 1 : 0;
+}
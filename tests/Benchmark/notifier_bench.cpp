@@ -0,0 +1,299 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// notifier_bench measures the Tcl/Qt event loop integration the GUI runs on
+// (src/Main/qttclnotifier.cpp): how long a file event, a Tcl timer and an
+// event queued by another thread (end of an -async flow job) take to be
+// dispatched, and how often the event loop wakes up while idle. Results are
+// JSON, latencies in microseconds.
+
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Main/qttclnotifier.hpp"
+#include "nlohmann_json/json.hpp"
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using json = nlohmann::ordered_json;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Options {
+  int iterations{1000};
+  int idleSeconds{2};
+  std::string out;
+};
+
+// Between two posts from the other thread, long enough for the event loop to
+// block again so that its wakeup is part of the latency
+constexpr std::chrono::microseconds Gap{200};
+
+void usage() {
+  std::cout << "Usage: notifier_bench [options]\n"
+               "  --iterations <n>        events per measure (1000)\n"
+               "  --idle <seconds>        idle measure duration (2)\n"
+               "  --out <file>            JSON results, stdout by default\n";
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg{argv[i]};
+    if (arg == "-h" || arg == "--help" || i + 1 == argc) return false;
+    const std::string value{argv[++i]};
+    if (arg == "--iterations") {
+      opt.iterations = std::max(1, std::atoi(value.c_str()));
+    } else if (arg == "--idle") {
+      opt.idleSeconds = std::max(1, std::atoi(value.c_str()));
+    } else if (arg == "--out") {
+      opt.out = value;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+double sinceUs(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+json stats(std::vector<double> values) {
+  if (values.empty()) return json::object();
+  std::sort(values.begin(), values.end());
+  auto at = [&values](double quantile) {
+    return values[static_cast<size_t>(quantile * (values.size() - 1))];
+  };
+  return {{"median", at(0.5)}, {"p99", at(0.99)}, {"max", values.back()}};
+}
+
+// Counts the wakeups of the event loop of the GUI thread while alive
+class WakeupCounter {
+ public:
+  WakeupCounter() {
+    m_connection = QObject::connect(QAbstractEventDispatcher::instance(),
+                                    &QAbstractEventDispatcher::awake,
+                                    [this]() { m_wakeups++; });
+  }
+  ~WakeupCounter() { QObject::disconnect(m_connection); }
+  int wakeups() const { return m_wakeups; }
+
+ private:
+  QMetaObject::Connection m_connection;
+  int m_wakeups{0};
+};
+
+// Events received on the GUI thread, sent by a thread waiting for each one
+struct Received {
+  int expected{0};
+  std::atomic<int> count{0};
+  std::vector<double> latencies;
+
+  void add(Clock::time_point sent) {
+    latencies.push_back(sinceUs(sent));
+    if (++count == expected) QCoreApplication::quit();
+  }
+  void waitFor(int index) const {
+    while (count <= index) std::this_thread::sleep_for(Gap / 4);
+  }
+};
+
+// Runs the event loop, \a post runs on another thread once the loop started
+json runLoop(Received& received, const std::function<void()>& post) {
+  std::thread sender;
+  WakeupCounter counter;
+  QTimer::singleShot(0, [&sender, &post]() { sender = std::thread{post}; });
+  QCoreApplication::exec();
+  sender.join();
+  json result = stats(received.latencies);
+  result["wakeups_per_event"] =
+      static_cast<double>(counter.wakeups()) / received.expected;
+  return result;
+}
+
+// Another thread writes timestamps to a pipe watched by a Tcl file handler
+json fileEvents(int iterations) {
+#ifdef _WIN32
+  return {{"error", "not supported on Windows"}};
+#else
+  int fds[2];
+  if (pipe(fds) != 0) return {{"error", "pipe failed"}};
+  struct FileReceived : Received {
+    int fd{-1};
+  } received;
+  received.expected = iterations;
+  received.fd = fds[0];
+  Tcl_CreateFileHandler(
+      fds[0], TCL_READABLE,
+      [](ClientData clientData, int) {
+        FileReceived* received = (FileReceived*)clientData;
+        Clock::time_point sent;
+        if (read(received->fd, &sent, sizeof(sent)) == sizeof(sent))
+          received->add(sent);
+      },
+      &received);
+  json result = runLoop(received, [&received, &fds, iterations]() {
+    for (int i = 0; i < iterations; i++) {
+      const Clock::time_point sent = Clock::now();
+      if (write(fds[1], &sent, sizeof(sent)) != sizeof(sent)) break;
+      received.waitFor(i);
+      std::this_thread::sleep_for(Gap);
+    }
+  });
+  Tcl_DeleteFileHandler(fds[0]);
+  close(fds[0]);
+  close(fds[1]);
+  return result;
+#endif
+}
+
+// Tcl timers of 1 ms re-armed from their handler, latency is the lateness
+json timers(int iterations) {
+  struct TimerReceived : Received {
+    Clock::time_point due;
+  } received;
+  received.expected = iterations;
+  static Tcl_TimerProc* onTimer = [](ClientData clientData) {
+    TimerReceived* received = (TimerReceived*)clientData;
+    received->add(received->due);
+    if (received->count == received->expected) return;
+    received->due = Clock::now() + std::chrono::milliseconds{1};
+    Tcl_CreateTimerHandler(1, onTimer, received);
+  };
+  WakeupCounter counter;
+  received.due = Clock::now() + std::chrono::milliseconds{1};
+  Tcl_CreateTimerHandler(1, onTimer, &received);
+  QCoreApplication::exec();
+  json result = stats(received.latencies);
+  result["wakeups_per_event"] =
+      static_cast<double>(counter.wakeups()) / received.expected;
+  return result;
+}
+
+struct AlertEvent {
+  Tcl_Event header;  // must be first, Tcl frees the event through it
+  Clock::time_point sent;
+  Received* received;
+};
+
+void queueAlert(Tcl_ThreadId thread, Received* received) {
+  AlertEvent* event = (AlertEvent*)ckalloc(sizeof(AlertEvent));
+  event->header.proc = [](Tcl_Event* event, int) -> int {
+    AlertEvent* alert = (AlertEvent*)event;
+    alert->received->add(alert->sent);
+    return 1;
+  };
+  event->sent = Clock::now();
+  event->received = received;
+  Tcl_ThreadQueueEvent(thread, &event->header, TCL_QUEUE_TAIL);
+  Tcl_ThreadAlert(thread);
+}
+
+// Another thread queues Tcl events to the GUI thread and alerts it, one at a
+// time or in bursts
+json alerts(int iterations, int burst) {
+  const Tcl_ThreadId thread = Tcl_GetCurrentThread();
+  Received received;
+  received.expected = iterations * burst;
+  return runLoop(received, [&received, thread, iterations, burst]() {
+    for (int i = 0; i < iterations; i++) {
+      for (int j = 0; j < burst; j++) queueAlert(thread, &received);
+      received.waitFor((i + 1) * burst - 1);
+      std::this_thread::sleep_for(Gap);
+    }
+  });
+}
+
+// What the console has while waiting for input: a file handler and a Tcl
+// timer far away
+json idle(int seconds) {
+  json result{{"seconds", seconds}};
+#ifndef _WIN32
+  int fds[2];
+  if (pipe(fds) != 0) return {{"error", "pipe failed"}};
+  Tcl_CreateFileHandler(
+      fds[0], TCL_READABLE, [](ClientData, int) {}, nullptr);
+#endif
+  Tcl_TimerToken timer =
+      Tcl_CreateTimerHandler(3600 * 1000, [](ClientData) {}, nullptr);
+  WakeupCounter counter;
+  const std::clock_t cpu = std::clock();
+  QTimer::singleShot(seconds * 1000, &QCoreApplication::quit);
+  QCoreApplication::exec();
+  result["wakeups_per_s"] = static_cast<double>(counter.wakeups()) / seconds;
+  result["cpu_ms"] =
+      static_cast<double>(std::clock() - cpu) * 1000 / CLOCKS_PER_SEC;
+  Tcl_DeleteTimerHandler(timer);
+#ifndef _WIN32
+  Tcl_DeleteFileHandler(fds[0]);
+  close(fds[0]);
+  close(fds[1]);
+#endif
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseArgs(argc, argv, opt)) {
+    usage();
+    return 1;
+  }
+  QCoreApplication app{argc, argv};
+  Tcl_FindExecutable(argv[0]);
+  Tcl_Interp* interp = Tcl_CreateInterp();
+  QtTclNotify::QtTclNotifier::setup();  // Registers notifier with Tcl
+
+  json results;
+  results["iterations"] = opt.iterations;
+  std::cerr << "File events..." << std::endl;
+  results["file_event_us"] = fileEvents(opt.iterations);
+  std::cerr << "Timers..." << std::endl;
+  results["timer_lateness_us"] = timers(opt.iterations);
+  std::cerr << "Thread alerts..." << std::endl;
+  results["alert_us"] = alerts(opt.iterations, 1);
+  results["alert_burst_us"] = alerts(opt.iterations / 10 + 1, 100);
+  std::cerr << "Idle..." << std::endl;
+  results["idle"] = idle(opt.idleSeconds);
+  Tcl_DeleteInterp(interp);
+
+  if (opt.out.empty()) {
+    std::cout << results.dump(2) << std::endl;
+  } else {
+    std::ofstream{opt.out} << results.dump(2) << std::endl;
+  }
+  return 0;
+}
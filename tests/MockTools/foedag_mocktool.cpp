@@ -0,0 +1,701 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// foedag_mocktool stands in for the external tools of the flow (yosys, vpr,
+// pin_c, openfpga, sta, analyze, verilator and the LiteX generators) so that
+// the log, console, report and process handling can be exercised and stressed
+// without the real tools. The persona is taken from the name the binary is
+// invoked with (the build installs copies under the tool names in
+// bin/mock_tools) or from --mock-persona <name>.
+//
+// Every persona prints a log shaped like the real tool (with the progress
+// markers and the statistics the report managers and the QoR database look
+// for), writes plausible artifacts and can be tuned with environment
+// variables, FOEDAG_MOCK_<PERSONA>_<KEY> taking precedence over
+// FOEDAG_MOCK_<KEY>:
+//   LINES     filler log lines (100)
+//   BYTES     filler log volume instead of LINES, K/M/G suffixes allowed
+//   RATE      lines per second, 0 is as fast as possible (0)
+//   BURST     lines written back to back before throttling/switching (1)
+//   STDERR    fraction of the bursts sent to stderr (0)
+//   MEMORY    MB allocated and touched before logging (0)
+//   CPU       ms of busy loop before exiting (0)
+//   SLEEP     ms of idle time before exiting (0)
+//   CHILDREN  helper processes that live as long as the tool (0)
+//   EXIT      exit code (0)
+//   CRASH     signal raised instead of exiting (0)
+//   ARTIFACTS 0 to skip writing the output files (1)
+//   RECORD    file the command lines are appended to
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nlohmann_json/json.hpp"
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Config {
+  uint64_t lines{100};
+  uint64_t bytes{0};
+  double rate{0};
+  uint64_t burst{1};
+  double stderrRatio{0};
+  uint64_t memoryMb{0};
+  uint64_t cpuMs{0};
+  uint64_t sleepMs{0};
+  int children{0};
+  int exitCode{0};
+  int crash{0};
+  bool artifacts{true};
+  std::string record;
+};
+
+// Value of FOEDAG_MOCK_<PERSONA>_<key> or FOEDAG_MOCK_<key>
+std::string env(const std::string& persona, const std::string& key) {
+  std::string name = "FOEDAG_MOCK_" + persona + "_" + key;
+  std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+    return c == '-' ? '_' : static_cast<char>(std::toupper(c));
+  });
+  if (const char* value = std::getenv(name.c_str())) return value;
+  if (const char* value = std::getenv(("FOEDAG_MOCK_" + key).c_str()))
+    return value;
+  return {};
+}
+
+// "10G", "512k", "1000"
+uint64_t parseSize(const std::string& text) {
+  char* end = nullptr;
+  double value = std::strtod(text.c_str(), &end);
+  switch (std::toupper(*end)) {
+    case 'K':
+      value *= 1024;
+      break;
+    case 'M':
+      value *= 1024 * 1024;
+      break;
+    case 'G':
+      value *= 1024.0 * 1024 * 1024;
+      break;
+  }
+  return value > 0 ? static_cast<uint64_t>(value) : 0;
+}
+
+Config readConfig(const std::string& persona) {
+  Config config;
+  auto get = [&persona](const char* key, auto& value, auto convert) {
+    const std::string text = env(persona, key);
+    if (!text.empty()) value = convert(text);
+  };
+  auto toU64 = [](const std::string& s) { return std::stoull(s); };
+  auto toInt = [](const std::string& s) { return std::stoi(s); };
+  auto toDouble = [](const std::string& s) { return std::stod(s); };
+  get("LINES", config.lines, toU64);
+  get("BYTES", config.bytes, parseSize);
+  get("RATE", config.rate, toDouble);
+  get("BURST", config.burst, toU64);
+  get("STDERR", config.stderrRatio, toDouble);
+  get("MEMORY", config.memoryMb, toU64);
+  get("CPU", config.cpuMs, toU64);
+  get("SLEEP", config.sleepMs, toU64);
+  get("CHILDREN", config.children, toInt);
+  get("EXIT", config.exitCode, toInt);
+  get("CRASH", config.crash, toInt);
+  get("ARTIFACTS", config.artifacts, [](const std::string& s) {
+    return s != "0";
+  });
+  config.record = env(persona, "RECORD");
+  config.burst = std::max<uint64_t>(config.burst, 1);
+  return config;
+}
+
+class Mock {
+ public:
+  Mock(const std::string& program, const std::string& persona,
+       std::vector<std::string> args)
+      : m_program(program), m_persona(persona), m_args(std::move(args)) {
+    m_config = readConfig(persona);
+    std::setvbuf(stdout, nullptr, _IOFBF, 1 << 20);
+  }
+
+  int run();
+
+ private:
+  // Logging
+  void out(const std::string& text) { write(text, false); }
+  void err(const std::string& text) { write(text, true); }
+  void write(const std::string& text, bool error) {
+    std::FILE* stream = error ? stderr : stdout;
+    std::fwrite(text.data(), 1, text.size(), stream);
+    std::fputc('\n', stream);
+  }
+  // Writes the configured volume of lines produced by \a line
+  template <typename Line>
+  void filler(Line line);
+
+  // Arguments
+  bool hasArg(const std::string& arg) const {
+    return std::find(m_args.begin(), m_args.end(), arg) != m_args.end();
+  }
+  std::string argValue(const std::string& arg) const {
+    auto itr = std::find(m_args.begin(), m_args.end(), arg);
+    if (itr == m_args.end() || ++itr == m_args.end()) return {};
+    return *itr;
+  }
+  void artifact(const fs::path& file, const std::string& content) const {
+    if (!m_config.artifacts || file.empty()) return;
+    if (file.has_parent_path()) fs::create_directories(file.parent_path());
+    std::ofstream stream{file};
+    stream << content;
+  }
+
+  void record() const;
+  void useResources();
+  void spawnChildren();
+  void reapChildren();
+
+  // Personas
+  int yosys(bool analyze);
+  int vpr();
+  int pinc();
+  int openfpga();
+  int sta();
+  int verilator();
+  int simulation();
+  int litex();
+
+  void resourceUsage();
+  void timingReport(const fs::path& file, const std::string& type,
+                    int paths) const;
+
+  std::string m_program;
+  std::string m_persona;
+  std::vector<std::string> m_args;
+  Config m_config;
+  std::vector<char> m_memory;
+#ifndef _WIN32
+  std::vector<pid_t> m_children;
+#endif
+};
+
+template <typename Line>
+void Mock::filler(Line line) {
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  const uint64_t lines = m_config.bytes ? UINT64_MAX : m_config.lines;
+  uint64_t bytes = 0;
+  double errorShare = 0;
+  for (uint64_t i = 0; i < lines && (!m_config.bytes || bytes < m_config.bytes);
+       i += m_config.burst) {
+    // Whole bursts go to the same stream, the way tools dump a stack of
+    // warnings at once
+    errorShare += m_config.stderrRatio;
+    const bool error = errorShare >= 1;
+    if (error) errorShare -= 1;
+    for (uint64_t j = i; j < i + m_config.burst && j < lines; j++) {
+      const std::string text = line(j);
+      write(text, error);
+      bytes += text.size() + 1;
+      if (m_config.bytes && bytes >= m_config.bytes) break;
+    }
+    if (m_config.rate > 0) {
+      std::fflush(stdout);
+      const auto due =
+          start + std::chrono::microseconds(static_cast<int64_t>(
+                      (i + m_config.burst) * 1e6 / m_config.rate));
+      std::this_thread::sleep_until(due);
+    }
+  }
+  std::fflush(stdout);
+}
+
+void Mock::record() const {
+  if (m_config.record.empty()) return;
+  std::ofstream stream{m_config.record, std::ios::app};
+  stream << m_persona;
+  for (const auto& arg : m_args) stream << " " << arg;
+  stream << std::endl;
+}
+
+void Mock::useResources() {
+  if (m_config.memoryMb) {
+    // Touch every page so that the memory is resident, not only reserved
+    m_memory.resize(m_config.memoryMb * 1024 * 1024);
+    for (size_t i = 0; i < m_memory.size(); i += 4096) m_memory[i] = 1;
+  }
+}
+
+void Mock::spawnChildren() {
+#ifndef _WIN32
+  for (int i = 0; i < m_config.children; i++) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      // Like a tool helper, lives until it gets killed
+      while (true) pause();
+    }
+    if (pid > 0) m_children.push_back(pid);
+  }
+#endif
+}
+
+void Mock::reapChildren() {
+#ifndef _WIN32
+  for (pid_t pid : m_children) {
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+  }
+  m_children.clear();
+#endif
+}
+
+int Mock::run() {
+  record();
+  useResources();
+  spawnChildren();
+  int status = 0;
+  if (m_persona == "yosys")
+    status = yosys(false);
+  else if (m_persona == "analyze")
+    status = yosys(true);
+  else if (m_persona == "vpr")
+    status = vpr();
+  else if (m_persona == "pin_c")
+    status = pinc();
+  else if (m_persona == "openfpga")
+    status = openfpga();
+  else if (m_persona == "sta")
+    status = sta();
+  else if (m_persona == "verilator")
+    status = verilator();
+  else if (m_persona == "simulation")
+    status = simulation();
+  else if (m_persona == "litex")
+    status = litex();
+  else
+    filler([](uint64_t i) { return "mock output line " + std::to_string(i); });
+
+  if (m_config.cpuMs) {
+    const auto end = std::chrono::steady_clock::now() +
+                     std::chrono::milliseconds(m_config.cpuMs);
+    volatile uint64_t sink = 0;
+    while (std::chrono::steady_clock::now() < end)
+      for (int i = 0; i < 100000; i++) sink = sink + i;
+  }
+  if (m_config.sleepMs)
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_config.sleepMs));
+  std::fflush(stdout);
+  std::fflush(stderr);
+  reapChildren();
+  if (m_config.crash) std::raise(m_config.crash);
+  if (m_config.exitCode) return m_config.exitCode;
+  return status;
+}
+
+// Yosys and the Verific based analyzer: "-s <script>" / "-f <script>"
+int Mock::yosys(bool analyze) {
+  const std::string script = argValue(analyze ? "-f" : "-s");
+  std::ifstream stream{script};
+  if (!script.empty() && !stream.good()) {
+    err("ERROR: Can't open script file `" + script + "' for reading");
+    return 1;
+  }
+  out("");
+  out(" /----------------------------------------------------------------\\");
+  out(" |  yosys -- Yosys Open SYnthesis Suite (FOEDAG mock)              |");
+  out(" \\----------------------------------------------------------------/");
+  out("");
+  out("-- Executing script file `" + script + "' --");
+  static const std::vector<std::string> passes{
+      "HIERARCHY", "PROC", "FLATTEN", "OPT_EXPR", "OPT_CLEAN", "TECHMAP",
+      "ABC",       "OPT",  "CHECK",   "STAT"};
+  filler([](uint64_t i) {
+    if (i % 20 == 0) {
+      const uint64_t step = i / 20 + 1;
+      return std::to_string(step) + ". Executing " +
+             passes[step % passes.size()] + " pass.";
+    }
+    return "Creating $and cell `$auto$mock.v:" + std::to_string(i) +
+           "$" + std::to_string(i * 7) + "'.";
+  });
+
+  // Netlists requested by the script
+  std::string line, top{"top"};
+  while (std::getline(stream, line)) {
+    std::istringstream command{line};
+    std::string name, token, file;
+    command >> name;
+    if (name == "-top") command >> top;
+    if (name.rfind("write_", 0) != 0) continue;
+    while (command >> token) file = token;
+    if (name == "write_blif" || name == "write_eblif")
+      artifact(file,
+               ".model top\n.inputs a clk\n.outputs q\n.names a n\n1 1\n"
+               ".latch n q re clk 0\n.end\n");
+    else if (name == "write_verilog")
+      artifact(file,
+               "module top(input a, input clk, output reg q);\n"
+               "  always @(posedge clk) q <= a;\nendmodule\n");
+    else if (name == "write_edif")
+      artifact(file, "(edif top (edifVersion 2 0 0))\n");
+    else if (name == "write_json")
+      artifact(file, "{\"modules\": {}}\n");
+  }
+  if (analyze) {
+    artifact("port_info.json", "[]\n");
+    artifact("hier_info.json", "{\"hierTree\": [{\"topModule\": \"" + top +
+                                   "\", \"moduleInsts\": []}]}\n");
+  }
+
+  out("");
+  out("Printing statistics.");
+  out("");
+  out("=== top ===");
+  out("");
+  out("   Number of wires:                 42");
+  out("   Number of wire bits:            128");
+  out("   Number of public wires:          12");
+  out("   Number of cells:                 60");
+  out("     $lut                           40");
+  out("     $_DFF_P_                       20");
+  out("");
+  out("DE: Max Lvl = 3.0  Avg Lvl = 2.1");
+  out("");
+  out("End of script. Logfile hash: 0123456789, CPU: user 0.10s system 0.01s");
+  return 0;
+}
+
+void Mock::resourceUsage() {
+  out("Resource usage...");
+  out("\tNetlist");
+  out("\t\t12\tblocks of type: io");
+  out("\tArchitecture");
+  out("\t\t256\tblocks of type: io");
+  out("\tNetlist");
+  out("\t\t6\tblocks of type: clb");
+  out("\tArchitecture");
+  out("\t\t64\tblocks of type: clb");
+  out("");
+  out("Circuit Statistics:");
+  out("  Blocks: 18");
+  out("    .input :       4");
+  out("    .output:       8");
+  out("    6-LUT  :      40");
+  out("  Nets  : 44");
+  out("");
+}
+
+void Mock::timingReport(const fs::path& file, const std::string& type,
+                        int paths) const {
+  std::ostringstream report;
+  for (int i = 1; i <= paths; i++) {
+    const std::string from = "q_reg" + std::to_string(i);
+    const std::string to = "q_reg" + std::to_string(i + 1);
+    const double slack = 2.0 - 0.01 * i;
+    char slackText[32];
+    std::snprintf(slackText, sizeof(slackText), "%.3f", slack);
+    report << "#Path " << i << "\n"
+           << "Startpoint: " << from << ".Q[0] (dffsre clocked by clk)\n"
+           << "Endpoint  : " << to << ".D[0] (dffsre clocked by clk)\n"
+           << "Path Type : " << type << "\n\n"
+           << "Point                                                      "
+              "       Incr      Path\n"
+           << "-----------------------------------------------------------"
+              "---------------------\n"
+           << "clock clk (rise edge)                                      "
+              "      0.000     0.000\n"
+           << from << ".Q[0] (dffsre) [clock-to-output]                  "
+              "      0.500     0.500\n"
+           << "data arrival time                                          "
+              "                0.500\n"
+           << "-----------------------------------------------------------"
+              "---------------------\n"
+           << "slack (" << (slack < 0 ? "VIOLATED" : "MET")
+           << ")                                                    "
+           << slackText << "\n\n\n";
+  }
+  artifact(file, report.str());
+}
+
+// vpr <arch> <netlist> [--pack|--place|--route|--analysis] ...
+int Mock::vpr() {
+  if (m_args.size() < 2) {
+    err("Error 1: Missing architecture file and circuit name");
+    return 1;
+  }
+  const fs::path netlist{m_args[1]};
+  const std::string name =
+      netlist.stem().string().substr(0, netlist.stem().string().find('.'));
+  const bool pack = hasArg("--pack");
+  const bool place = hasArg("--place");
+  const bool route = hasArg("--route");
+  const bool analysis = hasArg("--analysis");
+  const bool all = !pack && !place && !route && !analysis;
+  out("VPR FPGA Placement and Routing. (FOEDAG mock)");
+  out("Architecture file: " + m_args[0]);
+  out("Circuit name: " + name);
+  out("");
+  resourceUsage();
+
+  auto file = [this, &name](const std::string& option,
+                            const std::string& extension) {
+    const std::string value = argValue(option);
+    return value.empty() ? fs::path{name + extension} : fs::path{value};
+  };
+  if (pack || all) artifact(file("--net_file", ".net"), "<block/>\n");
+  if (place || all) {
+    out("---- ------ ------- ------- ------- ------- ------- ------ -----");
+    filler([](uint64_t i) {
+      char row[128];
+      std::snprintf(row, sizeof(row),
+                    "%4llu %6.1f %7.1e %7.4f %7.2f %7.3f %7.4f %6.3f %5.2f",
+                    static_cast<unsigned long long>(i + 1), 0.1 * i,
+                    1.0 / (i + 1), 0.98, 120.0 - 0.01 * i, 4.1, 0.95,
+                    0.44, 12.0);
+      return std::string{row};
+    });
+    out("Placement estimated critical path delay (least slack): 4.1 ns, "
+        "Fmax: 243.9 MHz");
+    out("Placement estimated setup Total Negative Slack (sTNS): 0 ns");
+    artifact(file("--place_file", ".place"),
+             "Netlist_File: " + name + ".net\n#block name\tx\ty\tsubblk\n");
+  }
+  if (route || all) {
+    out("---- ------ ------- ------- -------- ------- ------- -------");
+    filler([](uint64_t i) {
+      char row[128];
+      std::snprintf(row, sizeof(row),
+                    "%4llu %6.1f %7.2f %7llu %8.3f %7.3f %7.3f %7.1f",
+                    static_cast<unsigned long long>(i + 1), 0.2 * i, 1.0,
+                    static_cast<unsigned long long>(1000 - i % 1000), 4.5,
+                    0.0, 0.0, 222.2);
+      return std::string{row};
+    });
+    out("Total wirelength: 1234, average net length: 5.2");
+    out("Final critical path delay (least slack): 4.5 ns, Fmax: 222.2 MHz");
+    artifact(file("--route_file", ".route"), "Array size: 10 x 10 logic "
+                                             "blocks.\n");
+  }
+  if (analysis || all) {
+    out("Final critical path delay (least slack): 4.5 ns, Fmax: 222.2 MHz");
+    int paths = 100;
+    const std::string count = env(m_persona, "PATHS");
+    if (!count.empty()) paths = std::stoi(count);
+    timingReport("report_timing.setup.rpt", "setup", paths);
+    timingReport("report_timing.hold.rpt", "hold", paths);
+  }
+  if (argValue("--gen_post_synthesis_netlist") == "on") {
+    artifact(name + "_post_synthesis.v", "module top(); endmodule\n");
+    artifact(name + "_post_synthesis.sdf", "(DELAYFILE)\n");
+  }
+  out("VPR succeeded");
+  return 0;
+}
+
+// pin_c --xml <map> --csv <pins> --pcf <pcf> --blif <netlist> --output <file>
+int Mock::pinc() {
+  const std::string output = argValue("--output");
+  if (output.empty()) {
+    err("ERROR: missing --output");
+    return 1;
+  }
+  out("pin_c (FOEDAG mock)");
+  filler([](uint64_t i) {
+    return "  pin " + std::to_string(i) + " placed at (" +
+           std::to_string(i % 16) + "," + std::to_string(i / 16) + ")";
+  });
+  artifact(output,
+           "#Block Name   x   y   subblk\n"
+           "#----------   --  --  ------\n"
+           "a             0   1   0\n"
+           "q             0   2   0\n");
+  return 0;
+}
+
+// openfpga -batch -f <script>
+int Mock::openfpga() {
+  const std::string script = argValue("-f");
+  std::ifstream stream{script};
+  if (!stream.good()) {
+    err("Error: Can't open " + script);
+    return 1;
+  }
+  out("OpenFPGA (FOEDAG mock)");
+  std::string line;
+  std::vector<std::string> files;
+  while (std::getline(stream, line)) {
+    std::istringstream command{line};
+    std::string token;
+    if (!(command >> token) || token.front() == '#') continue;
+    out("Command line to execute: " + line);
+    while (command >> token)
+      if (token == "--file" && command >> token) files.push_back(token);
+  }
+  filler([](uint64_t i) {
+    return "Building fabric bitstream for block " + std::to_string(i) +
+           "...Done";
+  });
+  for (const auto& file : files) {
+    std::string bits;
+    for (int i = 0; i < 64; i++) bits += (i % 3) ? "0\n" : "1\n";
+    artifact(file, bits);
+  }
+  out("Thank you for using OpenFPGA!");
+  return 0;
+}
+
+int Mock::sta() {
+  out("OpenSTA (FOEDAG mock)");
+  filler([](uint64_t i) {
+    std::ostringstream path;
+    path << "Startpoint: in" << i << " (input port clocked by clk)\n"
+         << "Endpoint: q_reg" << i
+         << " (rising edge-triggered flip-flop clocked by clk)\n"
+         << "Path Group: clk\nPath Type: max\n\n"
+         << "           1.20   data arrival time\n"
+         << "           0.30   data required time\n"
+         << "           0.90   slack (MET)\n";
+    return path.str();
+  });
+  return 0;
+}
+
+// verilator ... --top-module <top> ...: creates the model makefile, the
+// model itself is a copy of the mock playing the "simulation" persona
+int Mock::verilator() {
+  std::string top = argValue("--top-module");
+  if (top.empty()) top = "top";
+  out("- V e r i l a t i o n (FOEDAG mock)");
+  filler([](uint64_t i) {
+    return "- Verilator: Walking module " + std::to_string(i);
+  });
+  std::error_code ec;
+  fs::path self = fs::read_symlink("/proc/self/exe", ec);
+  if (self.empty()) self = fs::absolute(m_program);
+  artifact(fs::path{"obj_dir"} / ("V" + top + ".mk"),
+           "V" + top + ":\n\tcp '" + self.string() + "' V" + top +
+               "\n\nclean:\n\trm -f V" + top + "\n");
+  out("- Verilator: Built from 0.1 MB sources in 2 modules");
+  return 0;
+}
+
+int Mock::simulation() {
+  out("Simulation model (FOEDAG mock)");
+  filler([](uint64_t i) {
+    return "[" + std::to_string(i * 10) + "] tick";
+  });
+  out("- " + std::string{"$finish"} + " called");
+  return 0;
+}
+
+// python <generator.py> --build --json <file>: the LiteX IP generators
+int Mock::litex() {
+  const std::string json = argValue("--json");
+  if (json.empty()) {
+    err("usage: <generator.py> --build --json <file>");
+    return 2;
+  }
+  std::ifstream stream{json};
+  nlohmann::json config;
+  try {
+    stream >> config;
+  } catch (const std::exception& e) {
+    err(std::string{"json.decoder.JSONDecodeError: "} + e.what());
+    return 1;
+  }
+  const fs::path buildDir = config.value("build_dir", std::string{"."});
+  const std::string buildName = config.value("build_name", std::string{"ip"});
+  out("INFO:LiteX:Building " + buildName + " (FOEDAG mock)");
+  filler([](uint64_t i) {
+    return "INFO:SoC:Adding CSR " + std::to_string(i) + "...";
+  });
+  artifact(buildDir / buildName / "src" / (buildName + ".v"),
+           "module " + buildName + "(); endmodule\n");
+  return 0;
+}
+
+std::string personaOf(const std::string& program) {
+  std::string name = fs::path{program}.stem().string();
+  if (name == "python" || name == "python3") return "litex";
+  // Verilator models are named V<top>
+  if (name.size() > 1 && name.front() == 'V') return "simulation";
+  return name;
+}
+
+// Runs the real \a tool found in PATH once the mock directory is removed
+int delegate(const std::string& tool, char** argv) {
+#ifdef _WIN32
+  std::cerr << tool << " delegation is not supported on Windows" << std::endl;
+  return 127;
+#else
+  std::error_code ec;
+  fs::path self = fs::read_symlink("/proc/self/exe", ec).parent_path();
+  if (self.empty()) self = fs::canonical(fs::path{argv[0]}.parent_path(), ec);
+  std::string path;
+  std::istringstream dirs{std::getenv("PATH") ? std::getenv("PATH") : ""};
+  std::string dir;
+  while (std::getline(dirs, dir, ':')) {
+    if (fs::canonical(dir, ec) == self) continue;
+    path += (path.empty() ? "" : ":") + dir;
+  }
+  setenv("PATH", path.c_str(), 1);
+  argv[0] = const_cast<char*>(tool.c_str());
+  execvp(argv[0], argv);
+  std::cerr << "Can't run " << tool << ": " << std::strerror(errno)
+            << std::endl;
+  return 127;
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::string> args{argv + 1, argv + argc};
+  std::string persona = personaOf(argv[0]);
+  if (args.size() >= 2 && args[0] == "--mock-persona") {
+    persona = args[1];
+    args.erase(args.begin(), args.begin() + 2);
+  }
+  if (persona == "litex") {
+    // Catalog queries need the real generators, only builds are mocked
+    if (std::find(args.begin(), args.end(), "--json-template") != args.end())
+      return delegate("python3", argv);
+    if (!args.empty() && fs::path{args[0]}.extension() == ".py")
+      args.erase(args.begin());  // the generator script
+  }
+  return Mock{argv[0], persona, std::move(args)}.run();
+}
@@ -0,0 +1,75 @@
+#Copyright 2021 The Foedag team
+
+#GPL License
+
+#Copyright (c) 2021 The Open-Source FPGA Foundation
+
+#This program is free software: you can redistribute it and/or modify
+#it under the terms of the GNU General Public License as published by
+#the Free Software Foundation, either version 3 of the License, or
+#(at your option) any later version.
+
+#This program is distributed in the hope that it will be useful,
+#but WITHOUT ANY WARRANTY; without even the implied warranty of
+#MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#GNU General Public License for more details.
+
+#You should have received a copy of the GNU General Public License
+#along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Runs the flow with the stand-ins of bin/mock_tools:
+# FOEDAG_TOOLS_PATH=build/bin/mock_tools foedag --batch --compiler openfpga \
+#   --script tests/TestBatch/test_mock_tools.tcl
+if { ![info exists ::env(FOEDAG_TOOLS_PATH)] } {
+  puts "SKIPPED: FOEDAG_TOOLS_PATH is not set"
+  exit 0
+}
+
+set record [file normalize mock_tools.record]
+file delete -force $record
+set ::env(FOEDAG_MOCK_RECORD) $record
+# Enough volume and stderr bursts to exercise the console and log handling
+set ::env(FOEDAG_MOCK_LINES) 200000
+set ::env(FOEDAG_MOCK_BURST) 100
+set ::env(FOEDAG_MOCK_STDERR) 0.2
+set ::env(FOEDAG_MOCK_MEMORY) 64
+
+create_design mock_tools
+architecture ../../Arch/k6_frac_N10_tileable_40nm.xml ../../Arch/k6_N10_40nm_openfpga.xml
+set_top_module top
+add_design_file ../Testcases/oneff/oneff.v
+add_constraint_file ../Testcases/oneff/oneff.sdc
+synth
+packing
+place
+route
+sta
+bitstream
+
+set fp [open $record r]
+set calls [read $fp]
+close $fp
+foreach tool {yosys vpr openfpga} {
+  if { ![regexp "(^|\n)$tool " $calls] } {
+    puts "TEST FAILED: $tool was not called"
+    exit 1
+  }
+}
+foreach report {synthesis.rpt placement.rpt routing.rpt
+                report_timing.setup.rpt fabric_bitstream.bit} {
+  if { ![file exists mock_tools/$report] } {
+    puts "TEST FAILED: missing $report"
+    exit 1
+  }
+}
+
+# A failing tool fails the stage
+set ::env(FOEDAG_MOCK_VPR_EXIT) 2
+if { ![catch {route clean; route}] } {
+  puts "TEST FAILED: route succeeded with a failing vpr"
+  exit 1
+}
+unset ::env(FOEDAG_MOCK_VPR_EXIT)
+
+puts "TEST PASSED"
+exit 0
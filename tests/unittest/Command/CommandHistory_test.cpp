@@ -0,0 +1,162 @@
+/*
+Copyright 2021 The Foedag team
+
+GPL License
+
+Copyright (c) 2021 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Command/CommandHistory.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+
+using namespace FOEDAG;
+
+namespace {
+std::filesystem::path historyFile(const std::string& name) {
+  return TestDir("history") / name;
+}
+
+uint64_t append(CommandHistory& history, const std::string& command,
+                int code = 0) {
+  auto pending = history.Start();
+  return history.Finish(pending, command, code);
+}
+}  // namespace
+
+TEST(CommandHistory, Persistent) {
+  auto file = historyFile("history_persistent.log");
+  {
+    CommandHistory history{file};
+    ASSERT_TRUE(history.Open());
+    history.SetStateProvider([]() { return std::string{"abc"}; });
+    EXPECT_EQ(append(history, "create_design test"), 1);
+    EXPECT_EQ(append(history, "puts \"a\tb\nc\\\\\"", 1), 2);
+  }
+  CommandHistory history{file};
+  ASSERT_TRUE(history.Open());
+  ASSERT_EQ(history.Entries().size(), 2);
+  const auto* entry = history.Find(2);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->command, "puts \"a\tb\nc\\\\\"");
+  EXPECT_EQ(entry->code, 1);
+  EXPECT_EQ(entry->state, "abc");
+  EXPECT_GT(entry->time, 0);
+  EXPECT_EQ(append(history, "synth"), 3);
+}
+
+TEST(CommandHistory, TornTail) {
+  auto file = historyFile("history_torn.log");
+  {
+    CommandHistory history{file};
+    ASSERT_TRUE(history.Open());
+    append(history, "analyze");
+    append(history, "synth");
+  }
+  const auto size = std::filesystem::file_size(file);
+  {
+    std::ofstream stream(file, std::ios::app | std::ios::binary);
+    stream << "0123abcd 3\t17";  // crash in the middle of a write
+  }
+  CommandHistory history{file};
+  ASSERT_TRUE(history.Open());
+  EXPECT_EQ(history.Entries().size(), 2);
+  EXPECT_EQ(std::filesystem::file_size(file), size);
+  EXPECT_EQ(append(history, "place"), 3);
+}
+
+TEST(CommandHistory, CorruptedEntry) {
+  auto file = historyFile("history_corrupted.log");
+  {
+    CommandHistory history{file};
+    ASSERT_TRUE(history.Open());
+    append(history, "analyze");
+    append(history, "synth");
+  }
+  {
+    std::fstream stream(file,
+                        std::ios::in | std::ios::out | std::ios::binary);
+    stream.seekp(-3, std::ios::end);
+    stream << "X";  // "synth" -> "syXth"
+  }
+  CommandHistory history{file};
+  ASSERT_TRUE(history.Open());
+  ASSERT_EQ(history.Entries().size(), 1);
+  EXPECT_EQ(history.Entries().front().command, "analyze");
+}
+
+TEST(CommandHistory, SharedFile) {
+  auto file = historyFile("history_shared.log");
+  CommandHistory first{file};
+  CommandHistory second{file};
+  ASSERT_TRUE(first.Open());
+  ASSERT_TRUE(second.Open());
+  EXPECT_EQ(append(first, "analyze"), 1);
+  EXPECT_EQ(append(second, "synth"), 2);
+  EXPECT_EQ(append(first, "packing"), 3);
+  ASSERT_EQ(first.Entries().size(), 3);
+  EXPECT_EQ(first.Entries()[1].command, "synth");
+
+  CommandHistory history{file};
+  ASSERT_TRUE(history.Open());
+  ASSERT_EQ(history.Entries().size(), 3);
+  EXPECT_EQ(history.Find(3)->command, "packing");
+}
+
+TEST(CommandHistory, Search) {
+  CommandHistory history{historyFile("history_search.log")};
+  ASSERT_TRUE(history.Open());
+  append(history, "synth");
+  append(history, "place");
+  append(history, "synth clean");
+  auto found = history.Search("synth");
+  ASSERT_EQ(found.size(), 2);
+  EXPECT_EQ(found.at(0)->id, 3);
+  EXPECT_EQ(found.at(1)->id, 1);
+  EXPECT_EQ(history.Search("synth", 1).size(), 1);
+  EXPECT_EQ(history.Search("p?ace").size(), 1);
+  EXPECT_EQ(history.Search("th*n").size(), 1);
+  EXPECT_TRUE(history.Search("route").empty());
+}
+
+TEST(CommandHistory, Script) {
+  CommandHistory history{historyFile("history_script.log")};
+  ASSERT_TRUE(history.Open());
+  append(history, "create_design d");
+  append(history, "add_design_file missing.v", 1);
+  append(history, "history_find synth");
+  append(history, "synth");
+  append(history, "place");
+  EXPECT_EQ(CommandHistory::Script(history.Range(1, 4)),
+            "# Replay of the command history 1-4\n"
+            "# Project state: \n"
+            "create_design d\n"
+            "synth\n");
+  EXPECT_EQ(history.Range(5, 10).size(), 1);
+}
+
+TEST(CommandHistory, Nested) {
+  CommandHistory history{historyFile("history_nested.log")};
+  ASSERT_TRUE(history.Open());
+  auto outer = history.Start();
+  EXPECT_EQ(append(history, "synth"), 0);
+  EXPECT_EQ(history.Finish(outer, "run_flow", 0), 1);
+  ASSERT_EQ(history.Entries().size(), 1);
+  EXPECT_EQ(history.Entries().front().command, "run_flow");
+}
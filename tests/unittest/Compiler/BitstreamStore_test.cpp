@@ -0,0 +1,191 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Compiler/BitstreamStore.h"
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+namespace fs = std::filesystem;
+
+namespace {
+void writeFile(const fs::path& path, const std::string& content) {
+  std::ofstream stream(path, std::ios::binary);
+  stream << content;
+}
+
+BitstreamStore::Build build(const std::string& option) {
+  BitstreamStore::Build build;
+  build.design = "top";
+  build.device = "dev";
+  build.tools = {{"openfpga", "1.2"}};
+  build.options = {{"script", option}};
+  build.sources = {{"top_post_synth.route", "abcd"}};
+  return build;
+}
+
+const char* architecture = R"(
+<bitstream_block name="fpga_top" hierarchy_level="0">
+  <bitstream_block name="grid_clb_1__1_" hierarchy_level="1">
+    <bitstream_block name="mem" hierarchy_level="2">
+      <bitstream>
+        <bit memory_port="mem_out[0]" value="%1"/>
+        <bit memory_port="mem_out[1]" value="1"/>
+      </bitstream>
+    </bitstream_block>
+  </bitstream_block>
+  <bitstream_block name="sb_0__0_" hierarchy_level="1">
+    <bitstream>
+      <bit memory_port="mem_out[0]" value="%2"/>
+    </bitstream>
+  </bitstream_block>
+</bitstream_block>
+)";
+
+std::string tiles(char first, char second) {
+  std::string text = architecture;
+  text.replace(text.find("%1"), 2, 1, first);
+  text.replace(text.find("%2"), 2, 1, second);
+  return text;
+}
+}  // namespace
+
+TEST(BitstreamStore, StoreAndRestore) {
+  const auto run = TestDir("bitstream_store_run");
+  const auto dir = TestDir("bitstream_store");
+  writeFile(run / "fabric_bitstream.bit", "// header\n0\n1\n1\n");
+  writeFile(run / "PinMapping.xml", "<io_mapping/>\n");
+  BitstreamStore store;
+  ASSERT_TRUE(store.Open(dir));
+  auto first = build("a");
+  ASSERT_TRUE(store.Store(first, run, {"fabric_bitstream.bit",
+                                       "PinMapping.xml", "missing.xml"}));
+  EXPECT_EQ(first.id, BitstreamStore::Id(build("a")));
+  EXPECT_NE(first.id, BitstreamStore::Id(build("b")));
+  ASSERT_EQ(first.outputs.size(), 2);
+  EXPECT_TRUE(store.Contains(first.id));
+
+  // The same outputs are stored once
+  auto second = build("b");
+  ASSERT_TRUE(store.Store(second, run, {"fabric_bitstream.bit"}));
+  EXPECT_EQ(second.outputs[0].object, first.outputs[0].object);
+
+  BitstreamStore::Build found;
+  ASSERT_TRUE(store.Find(first.id.substr(0, 8), found));
+  EXPECT_EQ(found.id, first.id);
+  EXPECT_EQ(found.tools, first.tools);
+  EXPECT_EQ(found.options, first.options);
+  EXPECT_EQ(found.sources, first.sources);
+  EXPECT_EQ(store.Builds().size(), 2);
+  EXPECT_FALSE(store.Find("", found));
+  EXPECT_FALSE(store.Find("xyz", found));
+
+  fs::remove(run / "fabric_bitstream.bit");
+  ASSERT_TRUE(store.Restore(found, run));
+  std::ifstream restored(run / "fabric_bitstream.bit");
+  std::string content((std::istreambuf_iterator<char>(restored)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_EQ(content, "// header\n0\n1\n1\n");
+}
+
+TEST(BitstreamStore, ConcurrentStores) {
+  // Runs archiving the same outputs at once
+  const auto run = TestDir("bitstream_concurrent_run");
+  const auto dir = TestDir("bitstream_concurrent");
+  writeFile(run / "fabric_bitstream.bit", "// header\n0\n1\n");
+  std::vector<std::thread> threads;
+  std::atomic<int> stored{0};
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      BitstreamStore store;
+      if (!store.Open(dir)) return;
+      for (int j = 0; j < 10; j++) {
+        auto same = build("a");
+        if (store.Store(same, run, {"fabric_bitstream.bit"})) stored++;
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(stored, 40);
+  for (const auto& entry : fs::recursive_directory_iterator(dir))
+    EXPECT_NE(entry.path().extension(), ".tmp") << entry.path();
+}
+
+TEST(BitstreamStore, DiffPlainText) {
+  auto diff = BitstreamStore::DiffData(
+      "fabric_bitstream.bit", "// a\n0\n1\n1\n0\n", "// b\n0\n0\n1\n1\n");
+  EXPECT_FALSE(diff.identical);
+  EXPECT_EQ(diff.sizeA, 4);
+  EXPECT_EQ(diff.differing, 2);
+  EXPECT_EQ(diff.offsets, (std::vector<uint64_t>{1, 3}));
+  EXPECT_TRUE(diff.regions.empty());
+
+  // frame based: "<address> <data>"
+  diff = BitstreamStore::DiffData("fabric_bitstream.bit", "00 0110\n01 1111\n",
+                                  "00 0110\n01 1011\n10 1\n");
+  EXPECT_EQ(diff.differing, 2);
+  EXPECT_EQ(diff.regions, (std::vector<std::pair<std::string, uint64_t>>{
+                              {"01", 1}, {"10", 1}}));
+}
+
+TEST(BitstreamStore, DiffLongChain) {
+  std::string a, b;
+  for (int i = 0; i < 200; i++) a += (i % 3) ? "1\n" : "0\n";
+  b = a;
+  b[2 * 130] = (b[2 * 130] == '1') ? '0' : '1';
+  auto diff = BitstreamStore::DiffData("fabric_bitstream.bit", a, b);
+  EXPECT_EQ(diff.differing, 1);
+  EXPECT_EQ(diff.offsets, (std::vector<uint64_t>{130}));
+  EXPECT_TRUE(BitstreamStore::DiffData("fabric_bitstream.bit", a, a).identical);
+}
+
+TEST(BitstreamStore, DiffTiles) {
+  auto diff = BitstreamStore::DiffData("fabric_independent_bitstream.xml",
+                                       tiles('0', '0'), tiles('1', '0'));
+  EXPECT_EQ(diff.sizeA, 3);
+  EXPECT_EQ(diff.differing, 1);
+  EXPECT_EQ(diff.regions, (std::vector<std::pair<std::string, uint64_t>>{
+                              {"grid_clb_1__1_", 1}}));
+}
+
+TEST(BitstreamStore, DiffBuilds) {
+  const auto run = TestDir("bitstream_diff_run");
+  BitstreamStore store;
+  ASSERT_TRUE(store.Open(TestDir("bitstream_diff")));
+  writeFile(run / "fabric_bitstream.bit", "0\n1\n");
+  writeFile(run / "PinMapping.xml", "<io_mapping/>\n");
+  auto a = build("a");
+  ASSERT_TRUE(store.Store(a, run, {"fabric_bitstream.bit", "PinMapping.xml"}));
+  writeFile(run / "fabric_bitstream.bit", "1\n1\n");
+  auto b = build("b");
+  ASSERT_TRUE(store.Store(b, run, {"fabric_bitstream.bit", "PinMapping.xml"}));
+
+  std::vector<BitstreamStore::Difference> differences;
+  ASSERT_TRUE(store.Diff(a, b, differences));
+  ASSERT_EQ(differences.size(), 2);
+  EXPECT_EQ(differences[0].output, "fabric_bitstream.bit");
+  EXPECT_EQ(differences[0].differing, 1);
+  EXPECT_TRUE(differences[1].identical);
+}
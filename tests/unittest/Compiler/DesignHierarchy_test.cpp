@@ -0,0 +1,159 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Compiler/DesignHierarchy.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+
+namespace {
+const char* hierInfo = R"({
+  "fileIDs": {"1": "/src/top.v", "2": "/src/core.v"},
+  "hierTree": [
+    {"topModule": "top", "file": "1", "line": 1,
+     "ports": [{"name": "clk", "direction": "Input",
+                "range": {"msb": 0, "lsb": 0}},
+               {"name": "q", "direction": "Output",
+                "range": {"msb": 7, "lsb": 0}}],
+     "moduleInsts": [{"instName": "u_core0", "module": "core", "line": 10},
+                     {"instName": "u_core1", "module": "core", "line": 11}]}
+  ],
+  "modules": {
+    "core": {"file": "2", "line": 3,
+             "ports": [{"name": "d", "direction": "input"}],
+             "moduleInsts": [{"instName": "u_alu", "module": "alu",
+                              "file": "2", "line": "20"}]}
+  }
+})";
+
+std::filesystem::path buildIndex(const std::string& name,
+                                 const std::string& content) {
+  auto dir = TestDir("hierarchy");
+  auto json = dir / (name + ".json");
+  std::ofstream{json} << content;
+  auto index = dir / (name + ".idx");
+  std::string error;
+  EXPECT_TRUE(DesignHierarchy::Build(json, index, error)) << error;
+  return index;
+}
+}  // namespace
+
+TEST(DesignHierarchy, Open) {
+  DesignHierarchy hierarchy;
+  ASSERT_TRUE(hierarchy.Open(buildIndex("hier_open", hierInfo)));
+  ASSERT_EQ(hierarchy.Tops().size(), 1);
+  // top, core and the undefined alu
+  EXPECT_EQ(hierarchy.ModuleCount(), 3);
+  const auto& top = hierarchy.GetModule(hierarchy.Tops().front());
+  EXPECT_EQ(hierarchy.Name(top.name), "top");
+  EXPECT_EQ(hierarchy.Name(top.file), "/src/top.v");
+  EXPECT_EQ(top.line, 1);
+  ASSERT_EQ(top.portCount, 2);
+  const auto* ports = hierarchy.Ports(top);
+  EXPECT_EQ(hierarchy.Name(ports[1].name), "q");
+  EXPECT_EQ(ports[1].direction, DesignHierarchy::Direction::Output);
+  EXPECT_EQ(ports[1].msb, 7);
+  ASSERT_EQ(top.instanceCount, 2);
+  const auto& instance = hierarchy.Instances(top)[1];
+  EXPECT_EQ(hierarchy.Name(instance.name), "u_core1");
+  EXPECT_EQ(hierarchy.Name(instance.file), "/src/top.v");
+  EXPECT_EQ(instance.line, 11);
+  EXPECT_EQ(instance.module, hierarchy.FindModule("core"));
+}
+
+TEST(DesignHierarchy, Update) {
+  auto dir = TestDir("hierarchy");
+  auto json = dir / "hier_update.json";
+  auto index = dir / "hier_update.idx";
+  std::ofstream{json} << hierInfo;
+  std::string error;
+  ASSERT_TRUE(DesignHierarchy::Update(json, index, error)) << error;
+  // Analysis rerun right away, within the same second
+  std::string renamed{hierInfo};
+  renamed.replace(renamed.find("\"top\""), 5, "\"chip\"");
+  std::ofstream{json} << renamed;
+  ASSERT_TRUE(DesignHierarchy::Update(json, index, error)) << error;
+  DesignHierarchy hierarchy;
+  ASSERT_TRUE(hierarchy.Open(index));
+  EXPECT_FALSE(hierarchy.Stamp().empty());
+  ASSERT_EQ(hierarchy.Tops().size(), 1);
+  EXPECT_EQ(hierarchy.Name(hierarchy.GetModule(hierarchy.Tops().front()).name),
+            "chip");
+}
+
+TEST(DesignHierarchy, Resolve) {
+  DesignHierarchy hierarchy;
+  ASSERT_TRUE(hierarchy.Open(buildIndex("hier_resolve", hierInfo)));
+  uint32_t module{0};
+  const DesignHierarchy::Instance* instance{nullptr};
+  EXPECT_TRUE(hierarchy.Resolve("top", module, &instance));
+  EXPECT_EQ(instance, nullptr);
+  EXPECT_TRUE(hierarchy.Resolve("top.u_core1.u_alu", module, &instance));
+  ASSERT_NE(instance, nullptr);
+  EXPECT_EQ(hierarchy.Name(hierarchy.GetModule(module).name), "alu");
+  EXPECT_EQ(hierarchy.Name(instance->file), "/src/core.v");
+  EXPECT_EQ(instance->line, 20);
+  EXPECT_FALSE(hierarchy.Resolve("top.u_core2", module));
+  EXPECT_FALSE(hierarchy.Resolve("unknown", module));
+  // core is a module, not a top
+  EXPECT_FALSE(hierarchy.Resolve("core.u_alu", module));
+}
+
+TEST(DesignHierarchy, Find) {
+  DesignHierarchy hierarchy;
+  ASSERT_TRUE(hierarchy.Open(buildIndex("hier_find", hierInfo)));
+  EXPECT_EQ(hierarchy.Find("*u_alu", 10),
+            (std::vector<std::string>{"top.u_core0.u_alu",
+                                      "top.u_core1.u_alu"}));
+  EXPECT_EQ(hierarchy.Find("*", 2).size(), 2);
+  EXPECT_EQ(hierarchy.Find("core", 10, true),
+            (std::vector<std::string>{"top.u_core0", "top.u_core1"}));
+}
+
+TEST(DesignHierarchy, TreeOnly) {
+  // No module table, the instance tree defines the modules
+  DesignHierarchy hierarchy;
+  ASSERT_TRUE(hierarchy.Open(buildIndex("hier_tree", R"({"hierTree": [
+    {"topModule": "top", "moduleInsts": [
+      {"instName": "u_a", "module": "a", "file": "a.v", "line": 4,
+       "moduleInsts": [{"instName": "u_b", "module": "b", "line": 9}]}]}]})")));
+  uint32_t module{0};
+  const DesignHierarchy::Instance* instance{nullptr};
+  EXPECT_TRUE(hierarchy.Resolve("top.u_a.u_b", module, &instance));
+  EXPECT_EQ(hierarchy.Name(instance->file), "a.v");
+}
+
+TEST(DesignHierarchy, Invalid) {
+  auto dir = TestDir("hierarchy");
+  std::ofstream{dir / "hier_invalid.json"} << "[1, 2";
+  std::string error;
+  EXPECT_FALSE(DesignHierarchy::Build(dir / "hier_invalid.json",
+                                      dir / "hier_invalid.idx", error));
+  EXPECT_FALSE(error.empty());
+
+  std::ofstream{dir / "hier_invalid.idx"} << "FHIX garbage";
+  DesignHierarchy hierarchy;
+  EXPECT_FALSE(hierarchy.Open(dir / "hier_invalid.idx"));
+  EXPECT_FALSE(hierarchy.LastError().empty());
+}
@@ -0,0 +1,191 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Compiler/FlowJobs.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+
+#include "Compiler/Compiler.h"
+#include "Tcl/TclInterpreter.h"
+#include "gtest/gtest.h"
+using namespace FOEDAG;
+
+namespace {
+// Collects the end of jobs and lets the test wait for them
+class Events {
+ public:
+  FlowJobs::Done done() {
+    return [this](uint32_t id, FlowJobs::Status status) {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_ended.emplace_back(id, status);
+      m_changed.notify_all();
+    };
+  }
+  std::vector<std::pair<uint32_t, FlowJobs::Status>> wait(size_t count) {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_changed.wait(lock, [this, count]() { return m_ended.size() >= count; });
+    return m_ended;
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::condition_variable m_changed;
+  std::vector<std::pair<uint32_t, FlowJobs::Status>> m_ended;
+};
+
+// Analysis that takes \a ticks * 10 ms unless it is stopped
+class SlowCompiler : public Compiler {
+ public:
+  using Compiler::Compiler;
+  std::atomic_int ticks{10};
+  std::atomic_int analyzed{0};
+
+ protected:
+  bool Analyze() override {
+    for (int i = 0; i < ticks && !m_stop; i++)
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    if (m_stop) return false;
+    analyzed++;
+    return true;
+  }
+};
+}  // namespace
+
+TEST(FlowJobs, RunInOrder) {
+  Events events;
+  FlowJobs jobs{events.done()};
+  std::vector<int> order;
+  bool onFlowThread{false};
+  const uint32_t first = jobs.Submit("synth", [&]() {
+    order.push_back(1);
+    onFlowThread = FlowJobs::OnFlowThread();
+    return true;
+  });
+  const uint32_t second = jobs.Submit("packing", [&]() {
+    order.push_back(2);
+    return false;
+  });
+  EXPECT_NE(first, second);
+  auto ended = events.wait(2);
+  EXPECT_EQ(order, (std::vector<int>{1, 2}));
+  EXPECT_TRUE(onFlowThread);
+  EXPECT_FALSE(FlowJobs::OnFlowThread());
+  ASSERT_EQ(ended.size(), 2);
+  EXPECT_EQ(ended[0], std::make_pair(first, FlowJobs::Status::Succeeded));
+  EXPECT_EQ(ended[1], std::make_pair(second, FlowJobs::Status::Failed));
+
+  FlowJobs::Job job;
+  ASSERT_TRUE(jobs.Find(second, job));
+  EXPECT_EQ(job.name, "packing");
+  EXPECT_EQ(job.status, FlowJobs::Status::Failed);
+  EXPECT_FALSE(jobs.Find(100, job));
+  EXPECT_EQ(jobs.Jobs().size(), 2);
+}
+
+TEST(FlowJobs, Cancel) {
+  Events events;
+  FlowJobs jobs{events.done()};
+  std::mutex gate;
+  std::unique_lock<std::mutex> closed{gate};
+  std::atomic_bool started{false};
+  std::atomic_bool requested{false};
+  const uint32_t running = jobs.Submit("route", [&]() {
+    started = true;
+    std::unique_lock<std::mutex> lock{gate};  // until the test opens it
+    requested = jobs.CancelRequested();
+    return true;
+  });
+  bool ran{false};
+  const uint32_t queued = jobs.Submit("sta", [&]() { return ran = true; });
+  while (!started) std::this_thread::yield();
+  EXPECT_TRUE(jobs.Busy());
+
+  FlowJobs::Status status;
+  ASSERT_TRUE(jobs.Cancel(queued, status));
+  EXPECT_EQ(status, FlowJobs::Status::Queued);
+  ASSERT_TRUE(jobs.Cancel(running, status));
+  EXPECT_EQ(status, FlowJobs::Status::Running);
+  closed.unlock();
+
+  auto ended = events.wait(2);
+  EXPECT_EQ(ended[0], std::make_pair(queued, FlowJobs::Status::Cancelled));
+  EXPECT_EQ(ended[1], std::make_pair(running, FlowJobs::Status::Cancelled));
+  EXPECT_FALSE(ran);
+  EXPECT_TRUE(requested);
+  EXPECT_FALSE(jobs.CancelRequested());
+  EXPECT_FALSE(jobs.Cancel(100, status));
+}
+
+TEST(FlowJobs, DestructorCancelsQueued) {
+  Events events;
+  std::atomic_int count{0};
+  {
+    FlowJobs jobs{events.done()};
+    jobs.Submit("a", [&]() {
+      // long enough for the destructor to drop the queued job
+      std::this_thread::sleep_for(std::chrono::milliseconds{100});
+      return ++count > 0;
+    });
+    jobs.Submit("b", [&]() { return ++count > 0; });
+    while (jobs.Jobs().front().status != FlowJobs::Status::Running)
+      std::this_thread::yield();
+  }
+  EXPECT_EQ(count, 1);
+  auto ended = events.wait(2);
+  ASSERT_EQ(ended.size(), 2);
+  EXPECT_EQ(ended[0].second, FlowJobs::Status::Succeeded);
+  EXPECT_EQ(ended[1].second, FlowJobs::Status::Cancelled);
+}
+
+TEST(FlowJobs, TclCommands) {
+  TclInterpreter interp;
+  std::ostringstream out;
+  SlowCompiler compiler{&interp, &out};
+  compiler.SetErrStream(&out);
+  compiler.RegisterCommands(&interp, true);
+
+  interp.evalCmd("set id [analyze -async]");
+  EXPECT_EQ(interp.evalCmd("job_wait $id"), "ok");
+  EXPECT_EQ(compiler.analyzed, 1);
+
+  // Cancelled before, or while, the flow thread starts it: it never runs
+  // to the end even though Compile() starts with a clean stop flag
+  compiler.ticks = 100;
+  interp.evalCmd("set slow [analyze -async]; job_cancel $slow");
+  EXPECT_EQ(interp.evalCmd("job_wait $slow"), "cancelled");
+  EXPECT_EQ(compiler.analyzed, 1);
+
+  // A queued job is dropped, the running one is stopped
+  interp.evalCmd("set a [analyze -async]; set b [analyze -async]");
+  EXPECT_EQ(interp.evalCmd("job_status $b"), "queued");
+  interp.evalCmd("job_cancel -all");
+  EXPECT_EQ(interp.evalCmd("job_wait $a $b"), "cancelled cancelled");
+  EXPECT_EQ(compiler.analyzed, 1);
+
+  // The next job runs as usual
+  compiler.ticks = 1;
+  EXPECT_EQ(interp.evalCmd("job_wait [analyze -async]"), "ok");
+  EXPECT_EQ(compiler.analyzed, 2);
+}
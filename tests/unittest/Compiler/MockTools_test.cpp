@@ -0,0 +1,128 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+
+#include "Compiler/ProgressEstimator.h"
+#include "Compiler/QorDatabase.h"
+#include "Utils/ProcessUtils.h"
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+using namespace FOEDAG;
+
+#ifndef _WIN32
+namespace {
+// Output of the stand-in for \a tool, run in a scratch directory
+std::string runMock(const std::string& tool, const std::string& args,
+                    int* status = nullptr, bool withStderr = true) {
+  const auto dir = TestDir("mock_tools");
+  const std::string command = "cd " + dir.string() + " && " + MOCK_TOOLS_DIR +
+                              "/" + tool + " " + args +
+                              (withStderr ? " 2>&1" : " 2>/dev/null");
+  std::string output;
+  FILE* pipe = popen(command.c_str(), "r");
+  if (!pipe) return output;
+  char buffer[4096];
+  size_t size = 0;
+  while ((size = fread(buffer, 1, sizeof(buffer), pipe)) > 0)
+    output.append(buffer, size);
+  const int result = pclose(pipe);
+  if (status) *status = WIFEXITED(result) ? WEXITSTATUS(result) : -1;
+  return output;
+}
+}  // namespace
+
+TEST(MockTools, YosysStatistics) {
+  setenv("FOEDAG_MOCK_LINES", "100", 1);
+  std::istringstream log{runMock("yosys", "")};
+  QorDatabase::Metrics metrics;
+  QorDatabase::ParseLog(log, metrics);
+  EXPECT_EQ(metrics["cells"], 60);
+  EXPECT_EQ(metrics["luts"], 40);
+  EXPECT_EQ(metrics["ffs"], 20);
+  unsetenv("FOEDAG_MOCK_LINES");
+}
+
+TEST(MockTools, VprProgressAndQor) {
+  setenv("FOEDAG_MOCK_VPR_LINES", "25", 1);
+  const std::string output = runMock("vpr", "arch.xml top.blif --route");
+  std::istringstream log{output};
+  QorDatabase::Metrics metrics;
+  QorDatabase::ParseLog(log, metrics);
+  EXPECT_DOUBLE_EQ(metrics["cpd_ns"], 4.5);
+  EXPECT_DOUBLE_EQ(metrics["fmax_mhz"], 222.2);
+  EXPECT_DOUBLE_EQ(metrics["wirelength"], 1234);
+
+  std::istringstream lines{output};
+  std::string line;
+  int markers = 0;
+  while (std::getline(lines, line))
+    markers += ProgressEstimator::IsMarker("route", line);
+  EXPECT_EQ(markers, 25);
+  unsetenv("FOEDAG_MOCK_VPR_LINES");
+}
+
+TEST(MockTools, ExitCodeAndStderr) {
+  setenv("FOEDAG_MOCK_PIN_C_EXIT", "3", 1);
+  setenv("FOEDAG_MOCK_STDERR", "1", 1);
+  setenv("FOEDAG_MOCK_LINES", "10", 1);
+  int status = 0;
+  runMock("pin_c", "--output pins.place", &status);
+  EXPECT_EQ(status, 3);
+  // the filler lines all went to stderr
+  std::string output = runMock("pin_c", "--output pins.place", nullptr, false);
+  EXPECT_EQ(output.find("  pin 0 placed"), std::string::npos);
+  output = runMock("pin_c", "--output pins.place");
+  EXPECT_NE(output.find("  pin 0 placed"), std::string::npos);
+  unsetenv("FOEDAG_MOCK_PIN_C_EXIT");
+  unsetenv("FOEDAG_MOCK_STDERR");
+  unsetenv("FOEDAG_MOCK_LINES");
+}
+
+TEST(MockTools, GroupMemory) {
+  pid_t child = fork();
+  ASSERT_NE(child, -1);
+  if (child == 0) {
+    ProcessUtils::SetupChild({});
+    setenv("FOEDAG_MOCK_MEMORY", "32", 1);
+    setenv("FOEDAG_MOCK_CHILDREN", "1", 1);
+    setenv("FOEDAG_MOCK_SLEEP", "10000", 1);
+    setenv("FOEDAG_MOCK_LINES", "0", 1);
+    const std::string tool = std::string{MOCK_TOOLS_DIR} + "/sta";
+    execl(tool.c_str(), tool.c_str(), nullptr);
+    _exit(127);
+  }
+  // the stand-in holds 32 MB once it is running
+  for (int i = 0; i < 200 && ProcessUtils::GroupMemory(child) < 32 * 1024; i++)
+    usleep(10000);
+  EXPECT_GE(ProcessUtils::GroupMemory(child), 32 * 1024);
+  EXPECT_TRUE(ProcessUtils::SignalGroup(child, true));
+  waitpid(child, nullptr, 0);
+}
+#endif
@@ -0,0 +1,129 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Compiler/ProgressEstimator.h"
+
+#include <cstring>
+
+#include "Compiler/QorDatabase.h"
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+
+namespace {
+class ProgressEstimatorTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    estimator.SetClock([this]() { return now; });
+  }
+  void output(const std::string& text) {
+    estimator.Output(text.c_str(), text.size());
+  }
+
+  int64_t now{0};
+  ProgressEstimator estimator;
+};
+
+QorDatabase history(const std::string& name) {
+  auto path = TestDir("progress") / name;
+  QorDatabase db;
+  db.Open(path);
+  for (int run = 0; run < 3; run++) {
+    const std::string id = std::to_string(run);
+    db.Append({id, run, "synthesize", {{"runtime_ms", 10000}}, "top"});
+    db.Append({id, run, "route", {{"runtime_ms", 30000}, {"_markers", 10}},
+               "top"});
+    // another design sharing the database
+    db.Append({id, run, "route", {{"runtime_ms", 90000}}, "other"});
+  }
+  return db;
+}
+}  // namespace
+
+TEST_F(ProgressEstimatorTest, NoHistory) {
+  estimator.Plan({"synthesize", "route"});
+  EXPECT_EQ(estimator.EtaMs(), -1);
+  EXPECT_DOUBLE_EQ(estimator.Percent(), 0);
+  estimator.StageStarted("synthesize");
+  estimator.StageFinished();
+  // default weights: synthesize 20, route 30
+  EXPECT_DOUBLE_EQ(estimator.Percent(), 40);
+}
+
+TEST_F(ProgressEstimatorTest, TimeBased) {
+  estimator.Learn(history("progress_time.jsonl"), "top");
+  estimator.Plan({"synthesize", "route"});
+  EXPECT_EQ(estimator.EtaMs(), 40000);
+  estimator.StageStarted("synthesize");
+  now = 5000;
+  EXPECT_DOUBLE_EQ(estimator.StagePercent(), 50);
+  EXPECT_DOUBLE_EQ(estimator.Percent(), 12.5);
+  EXPECT_EQ(estimator.EtaMs(), 35000);
+  // longer than it used to take: never reported as done
+  now = 20000;
+  EXPECT_DOUBLE_EQ(estimator.StagePercent(), 99);
+  EXPECT_EQ(estimator.EtaMs(), 30000);
+  estimator.StageFinished();
+  EXPECT_DOUBLE_EQ(estimator.Percent(), 25);
+}
+
+TEST_F(ProgressEstimatorTest, Markers) {
+  estimator.Learn(history("progress_markers.jsonl"), "top");
+  estimator.Plan({"route"});
+  estimator.StageStarted("route");
+  now = 1000;
+  output("Routing...\n  1    0.1     0.0    0 2345 ");
+  output("   12  0.95\n   2    0.2     0.0    0 ");
+  EXPECT_EQ(estimator.Markers(), 1);
+  output("2000   10  0.96\n");
+  EXPECT_EQ(estimator.Markers(), 2);
+  now = 10000;
+  EXPECT_DOUBLE_EQ(estimator.StagePercent(), 20);
+  // extrapolated from the markers: 10s for 20%
+  EXPECT_EQ(estimator.EtaMs(), 40000);
+}
+
+TEST_F(ProgressEstimatorTest, SkippedStages) {
+  estimator.Plan({"synthesize", "packing", "route"});
+  EXPECT_TRUE(estimator.IsPlanned("packing"));
+  estimator.StageStarted("route");
+  EXPECT_FALSE(estimator.IsPlanned("packing"));
+  estimator.StageFinished();
+  EXPECT_DOUBLE_EQ(estimator.Percent(), 100);
+}
+
+TEST(ProgressEstimator, IsMarker) {
+  EXPECT_TRUE(ProgressEstimator::IsMarker(
+      "synthesize", "2.3. Executing PROC pass (convert processes)."));
+  EXPECT_FALSE(
+      ProgressEstimator::IsMarker("synthesize", "Executing PROC pass."));
+  EXPECT_TRUE(ProgressEstimator::IsMarker(
+      "place", "     3   0.0 1.7e+01   0.9986  2.3e+03   12.0   0.01"));
+  EXPECT_FALSE(
+      ProgressEstimator::IsMarker("place", "   12 blocks of type: io"));
+  EXPECT_FALSE(ProgressEstimator::IsMarker("sta", "1 2 3 4 5 6"));
+}
+
+TEST(ProgressEstimator, FormatDuration) {
+  EXPECT_EQ(ProgressEstimator::FormatDuration(42000), "42s");
+  EXPECT_EQ(ProgressEstimator::FormatDuration(125000), "2m 5s");
+  EXPECT_EQ(ProgressEstimator::FormatDuration(3 * 3600000 + 60000), "3h 1m");
+}
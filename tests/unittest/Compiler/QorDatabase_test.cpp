@@ -0,0 +1,146 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Compiler/QorDatabase.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+
+namespace {
+std::filesystem::path freshDb(const std::string& name) {
+  return TestDir("qor") / name;
+}
+}  // namespace
+
+TEST(QorDatabase, AppendAndReopen) {
+  auto path = freshDb("qor_append.jsonl");
+  QorDatabase db;
+  EXPECT_TRUE(db.Open(path));
+  EXPECT_TRUE(db.Records().empty());
+  EXPECT_TRUE(db.Append({"r1", 1, "synthesis", {{"luts", 100}}}));
+  EXPECT_TRUE(db.Append({"r1", 2, "routing", {{"fmax_mhz", 200}}}));
+  EXPECT_TRUE(db.Append({"r2", 3, "synthesis", {{"luts", 110}}}));
+  {
+    // a torn line of an interrupted writer is skipped
+    std::ofstream stream(path, std::ios::app);
+    stream << "{\"run\":\"r3\",\"sta";
+  }
+
+  db.Append({"r2", 4, "routing", {{"fmax_mhz", 210}}, "top"});
+
+  QorDatabase other;
+  EXPECT_TRUE(other.Open(path));
+  ASSERT_EQ(other.Records().size(), 4);
+  EXPECT_EQ(other.Records().back().design, "top");
+  EXPECT_EQ(other.Runs(), (std::vector<std::string>{"r1", "r2"}));
+  auto metrics = other.RunMetrics("r1");
+  ASSERT_EQ(metrics.size(), 2);
+  EXPECT_DOUBLE_EQ(metrics["routing"]["fmax_mhz"], 200);
+}
+
+TEST(QorDatabase, Compare) {
+  auto path = freshDb("qor_compare.jsonl");
+  QorDatabase db;
+  db.Open(path);
+  db.Append({"a", 1, "synthesis", {{"luts", 100}, {"runtime_ms", 1000}}});
+  db.Append({"a", 2, "routing", {{"fmax_mhz", 200}, {"_markers", 10}}});
+  db.Append({"b", 3, "synthesis", {{"luts", 104}, {"runtime_ms", 1500}}});
+  db.Append({"b", 4, "routing", {{"fmax_mhz", 180}, {"_markers", 20}}});
+
+  auto deltas = db.Compare("a", "b");
+  ASSERT_EQ(deltas.size(), 3);
+  std::map<std::string, QorDatabase::Delta> byMetric;
+  for (const auto& delta : deltas) byMetric[delta.metric] = delta;
+  EXPECT_DOUBLE_EQ(byMetric["luts"].percent, 4.0);
+  EXPECT_FALSE(byMetric["luts"].regression);
+  EXPECT_DOUBLE_EQ(byMetric["runtime_ms"].percent, 50.0);
+  EXPECT_TRUE(byMetric["runtime_ms"].regression);
+  EXPECT_DOUBLE_EQ(byMetric["fmax_mhz"].percent, -10.0);
+  EXPECT_TRUE(byMetric["fmax_mhz"].regression);
+
+  // an improvement is never a regression
+  for (const auto& delta : db.Compare("b", "a"))
+    EXPECT_FALSE(delta.regression) << delta.metric;
+}
+
+TEST(QorDatabase, Thresholds) {
+  auto path = freshDb("qor_thresholds.jsonl");
+  QorDatabase db;
+  db.Open(path);
+  db.Append({"a", 1, "synthesis", {{"luts", 100}}});
+  db.Append({"b", 2, "synthesis", {{"luts", 104}}});
+  EXPECT_DOUBLE_EQ(db.Threshold("luts"), QorDatabase::DefaultThreshold);
+  EXPECT_TRUE(db.SetThreshold("luts", 2));
+  ASSERT_EQ(db.Compare("a", "b").size(), 1);
+  EXPECT_TRUE(db.Compare("a", "b").front().regression);
+
+  QorDatabase other;
+  other.Open(path);
+  EXPECT_DOUBLE_EQ(other.Threshold("luts"), 2);
+  EXPECT_EQ(other.Records().size(), 2);
+}
+
+TEST(QorDatabase, Trend) {
+  auto path = freshDb("qor_trend.jsonl");
+  QorDatabase db;
+  db.Open(path);
+  db.Append({"a", 1, "routing", {{"fmax_mhz", 200}}});
+  db.Append({"b", 2, "routing", {{"fmax_mhz", 190}}});
+  db.Append({"b", 3, "routing", {{"fmax_mhz", 195}}});
+  db.Append({"c", 4, "synthesis", {{"luts", 10}}});
+  auto trend = db.Trend("routing", "fmax_mhz");
+  ASSERT_EQ(trend.size(), 2);
+  EXPECT_EQ(trend.at(1).first, "b");
+  EXPECT_DOUBLE_EQ(trend.at(1).second, 195);
+}
+
+TEST(QorDatabase, ParseLog) {
+  std::istringstream yosys{R"(
+=== top ===
+
+   Number of wires:                 30
+   Number of cells:                 21
+     $lut                           12
+     dffsre                          8
+     $_DFF_P_                        1
+
+End of script.
+)"};
+  QorDatabase::Metrics metrics;
+  QorDatabase::ParseLog(yosys, metrics);
+  EXPECT_DOUBLE_EQ(metrics["cells"], 21);
+  EXPECT_DOUBLE_EQ(metrics["luts"], 12);
+  EXPECT_DOUBLE_EQ(metrics["ffs"], 9);
+
+  std::istringstream vpr{
+      "Total wirelength: 1234, average net length: 5.5\n"
+      "Final critical path delay (least slack): 5.125 ns, Fmax: 195.122 "
+      "MHz\n"};
+  metrics.clear();
+  QorDatabase::ParseLog(vpr, metrics);
+  EXPECT_DOUBLE_EQ(metrics["wirelength"], 1234);
+  EXPECT_DOUBLE_EQ(metrics["cpd_ns"], 5.125);
+  EXPECT_DOUBLE_EQ(metrics["fmax_mhz"], 195.122);
+}
@@ -0,0 +1,190 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Compiler/TimingPathDatabase.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+
+namespace {
+const char* vprPath = R"(#Path %ID%
+Startpoint: %FROM%.Q[0] (dffsre clocked by clk)
+Endpoint  : %TO%.D[0] (dffsre clocked by clk)
+Path Type : setup
+
+Point                                                             Incr      Path
+--------------------------------------------------------------------------------
+clock clk (rise edge)                                            0.000     0.000
+clock source latency                                             0.000     0.000
+%FROM%.C[0] (dffsre)                                             0.000     0.000
+%FROM%.Q[0] (dffsre) [clock-to-output]                           0.500     0.500
+| (inter-block routing)                                          1.250     1.750
+%TO%.D[0] (dffsre)                                               0.000     1.750
+data arrival time                                                          1.750
+
+clock clk (rise edge)                                            1.500     1.500
+data required time                                                         1.500
+--------------------------------------------------------------------------------
+data required time                                                         1.500
+data arrival time                                                         -1.750
+--------------------------------------------------------------------------------
+slack (%STATUS%)                                                    %SLACK%
+
+
+)";
+
+const char* staReport = R"(Startpoint: a (input port clocked by clk)
+Endpoint: q_reg (rising edge-triggered flip-flop clocked by clk2)
+Path Group: clk2
+Path Type: min
+
+  Delay    Time   Description
+---------------------------------------------------------
+   0.00    0.00   clock clk (rise edge)
+   1.00    1.00 v input external delay
+   0.20    1.20 v q_reg/D (DFF)
+           1.20   data arrival time
+
+   0.30    0.30   library hold time
+           0.30   data required time
+---------------------------------------------------------
+           0.30   data required time
+          -1.20   data arrival time
+---------------------------------------------------------
+           0.90   slack (MET)
+)";
+
+std::string replace(std::string text, const std::string& from,
+                    const std::string& to) {
+  for (size_t pos = text.find(from); pos != std::string::npos;
+       pos = text.find(from, pos + to.size()))
+    text.replace(pos, from.size(), to);
+  return text;
+}
+
+std::string vpr(int id, const std::string& from, const std::string& to,
+                const std::string& slack) {
+  std::string path = replace(vprPath, "%ID%", std::to_string(id));
+  path = replace(path, "%FROM%", from);
+  path = replace(path, "%TO%", to);
+  path = replace(path, "%STATUS%", slack[0] == '-' ? "VIOLATED" : "MET");
+  return replace(path, "%SLACK%", slack);
+}
+
+std::filesystem::path write(const std::string& name,
+                            const std::string& content) {
+  auto path = TestDir("timing") / name;
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+  return path;
+}
+}  // namespace
+
+TEST(TimingPathDatabase, OpenVpr) {
+  TimingPathDatabase db;
+  auto file = write("report_timing.setup.rpt",
+                    vpr(1, "a", "b", "-0.250") + vpr(2, "c", "d", "0.125") +
+                        vpr(3, "e", "d", "-1.000"));
+  ASSERT_TRUE(db.Open(file));
+  ASSERT_EQ(db.Size(), 3);
+  const auto& path = db.At(0);
+  EXPECT_EQ(db.Name(path.startpoint), "a.Q[0]");
+  EXPECT_EQ(db.Name(path.endpoint), "b.D[0]");
+  EXPECT_EQ(db.Name(path.startClock), "clk");
+  EXPECT_EQ(db.Name(path.endClock), "clk");
+  EXPECT_DOUBLE_EQ(path.slack, -0.25);
+  EXPECT_EQ(path.check, TimingPathDatabase::Check::Setup);
+}
+
+TEST(TimingPathDatabase, OpenMissing) {
+  TimingPathDatabase db;
+  EXPECT_FALSE(db.Open("/no/such/report.rpt"));
+  EXPECT_FALSE(db.LastError().empty());
+}
+
+TEST(TimingPathDatabase, Find) {
+  TimingPathDatabase db;
+  db.Open(write("report_find.setup.rpt",
+                vpr(1, "a", "b", "-0.250") + vpr(2, "c", "d", "0.125") +
+                    vpr(3, "e", "d", "-1.000")));
+  EXPECT_EQ(db.Find({}), (std::vector<uint32_t>{2, 0, 1}));
+
+  TimingPathDatabase::Query query;
+  query.slackLt = 0;
+  EXPECT_EQ(db.Find(query), (std::vector<uint32_t>{2, 0}));
+  query.limit = 1;
+  EXPECT_EQ(db.Find(query), (std::vector<uint32_t>{2}));
+
+  query = {};
+  query.to = "d.*";
+  EXPECT_EQ(db.Find(query), (std::vector<uint32_t>{2, 1}));
+  query.slackGt = -1;
+  EXPECT_EQ(db.Find(query), (std::vector<uint32_t>{1}));
+
+  query = {};
+  query.anyCheck = false;
+  query.check = TimingPathDatabase::Check::Hold;
+  EXPECT_TRUE(db.Find(query).empty());
+}
+
+TEST(TimingPathDatabase, NodesVpr) {
+  TimingPathDatabase db;
+  db.Open(write("report_nodes.setup.rpt",
+                vpr(1, "a", "b", "-0.250") + vpr(2, "c", "d", "0.125")));
+  auto nodes = db.Nodes(1);
+  ASSERT_EQ(nodes.size(), 6);
+  EXPECT_EQ(nodes.at(0).point, "clock clk (rise edge)");
+  EXPECT_EQ(nodes.at(3).point, "c.Q[0] (dffsre) [clock-to-output]");
+  EXPECT_DOUBLE_EQ(nodes.at(4).incr, 1.25);
+  EXPECT_DOUBLE_EQ(nodes.at(5).time, 1.75);
+}
+
+TEST(TimingPathDatabase, OpenSta) {
+  TimingPathDatabase db;
+  ASSERT_TRUE(db.Open(write("opensta.rpt", staReport)));
+  ASSERT_EQ(db.Size(), 1);
+  const auto& path = db.At(0);
+  EXPECT_EQ(db.Name(path.startpoint), "a");
+  EXPECT_EQ(db.Name(path.endpoint), "q_reg");
+  EXPECT_EQ(db.Name(path.endClock), "clk2");
+  EXPECT_EQ(path.check, TimingPathDatabase::Check::Hold);
+  EXPECT_DOUBLE_EQ(path.slack, 0.9);
+
+  TimingPathDatabase::Query query;
+  query.clock = "clk2";
+  EXPECT_EQ(db.Find(query).size(), 1);
+
+  auto nodes = db.Nodes(0);
+  ASSERT_EQ(nodes.size(), 3);
+  EXPECT_EQ(nodes.at(1).point, "input external delay");
+  EXPECT_DOUBLE_EQ(nodes.at(2).time, 1.2);
+}
+
+TEST(TimingPathDatabase, Match) {
+  EXPECT_TRUE(TimingPathDatabase::Match("*", "abc"));
+  EXPECT_TRUE(TimingPathDatabase::Match("a?c", "abc"));
+  EXPECT_TRUE(TimingPathDatabase::Match("*b*", "abc"));
+  EXPECT_FALSE(TimingPathDatabase::Match("a*d", "abc"));
+  EXPECT_TRUE(TimingPathDatabase::Match("u_*/q[*]", "u_core/q[3]"));
+}
@@ -0,0 +1,172 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Main/JobServer.h"
+
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+int connectTo(const std::string& socket) {
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socket.c_str(), sizeof(address.sun_path) - 1);
+  if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) !=
+      0) {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+class JobServerFixture : public testing::Test {
+ protected:
+  void SetUp() override {
+    m_socket = (TestDir("job_server") / "socket").string();
+    m_server = ::fork();
+    if (m_server == 0) {
+      int res{0};
+      {
+        JobServer server{m_socket, 2};
+        // the job "script" is "<exit status> <output>"
+        res = server.Serve([](const std::string& script) {
+          std::istringstream stream{script};
+          int status{0};
+          std::string text;
+          stream >> status >> text;
+          if (text == "slow")
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+          std::cout << text << std::endl;
+          std::cerr << "cwd " << std::filesystem::current_path().string();
+          return status;
+        });
+      }
+      ::_exit(res);
+    }
+    // wait for the server to come up
+    for (int i = 0; i < 100; i++) {
+      std::ostringstream out, err;
+      if (JobServer::Submit(m_socket, ".", "0 ping", out, err) == 0) break;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+  void TearDown() override {
+    EXPECT_TRUE(JobServer::Shutdown(m_socket));
+    int status{0};
+    ::waitpid(m_server, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_FALSE(std::filesystem::exists(m_socket));
+  }
+  std::string m_socket;
+  pid_t m_server{0};
+};
+}  // namespace
+
+TEST_F(JobServerFixture, Submit) {
+  std::ostringstream out, err;
+  const auto dir = TestDir("job_server_cwd");
+  EXPECT_EQ(JobServer::Submit(m_socket, dir.string(), "3 hello", out, err), 3);
+  EXPECT_EQ(out.str(), "hello\n");
+  EXPECT_EQ(err.str(), "cwd " + std::filesystem::canonical(dir).string());
+}
+
+TEST_F(JobServerFixture, InvalidWorkDir) {
+  std::ostringstream out, err;
+  EXPECT_EQ(JobServer::Submit(m_socket, "/not/a/dir", "0 hello", out, err), 1);
+  EXPECT_TRUE(out.str().empty());
+  EXPECT_NE(err.str().find("/not/a/dir"), std::string::npos);
+}
+
+TEST_F(JobServerFixture, StalledClient) {
+  // connected, but the request never ends
+  const int stalled = connectTo(m_socket);
+  ASSERT_NE(stalled, -1);
+  ASSERT_EQ(::write(stalled, "run ", 4), 4);
+  std::ostringstream out, err;
+  EXPECT_EQ(JobServer::Submit(m_socket, ".", "5 other", out, err), 5);
+  EXPECT_EQ(out.str(), "other\n");
+  ::close(stalled);
+}
+
+TEST_F(JobServerFixture, Queued) {
+  // Two job slots, the third job waits for one of them
+  std::vector<std::thread> clients;
+  std::vector<int> status(3, -1);
+  for (size_t i = 0; i < status.size(); i++) {
+    clients.emplace_back([this, &status, i]() {
+      std::ostringstream out, err;
+      status[i] = JobServer::Submit(m_socket, ".", "4 slow", out, err);
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  // The server keeps answering meanwhile
+  const auto start = std::chrono::steady_clock::now();
+  const int client = connectTo(m_socket);
+  ASSERT_NE(client, -1);
+  ASSERT_EQ(::write(client, "bogus\n", 6), 6);
+  ::shutdown(client, SHUT_WR);
+  std::string response;
+  char buffer[256];
+  ssize_t count{0};
+  while ((count = ::read(client, buffer, sizeof(buffer))) > 0)
+    response.append(buffer, count);
+  ::close(client);
+  EXPECT_NE(response.find("Invalid request"), std::string::npos);
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(300));
+  for (auto& client : clients) client.join();
+  EXPECT_EQ(status, (std::vector<int>{4, 4, 4}));
+}
+
+TEST_F(JobServerFixture, AlreadyRunning) {
+  JobServer other{m_socket};
+  EXPECT_FALSE(other.Listen());
+  EXPECT_FALSE(other.LastError().empty());
+}
+#endif
+
+TEST(JobServer, NoServer) {
+  std::ostringstream out, err;
+  std::string error;
+  EXPECT_EQ(JobServer::Submit("/not/a/socket", ".", "0 hello", out, err,
+                              &error),
+            -1);
+  EXPECT_FALSE(error.empty());
+}
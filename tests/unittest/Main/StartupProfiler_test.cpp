@@ -0,0 +1,65 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Main/StartupProfiler.h"
+
+#include <sstream>
+#include <thread>
+
+#include "gtest/gtest.h"
+using namespace FOEDAG;
+
+TEST(StartupProfiler, Disabled) {
+  StartupProfiler profiler;
+  profiler.Mark("phase");
+  EXPECT_FALSE(profiler.Enabled());
+  EXPECT_TRUE(profiler.Phases().empty());
+  std::ostringstream out;
+  profiler.Report(out);
+  EXPECT_TRUE(out.str().empty());
+}
+
+TEST(StartupProfiler, Phases) {
+  StartupProfiler profiler;
+  profiler.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  profiler.Mark("interpreter");
+  profiler.Mark("main window");
+  ASSERT_EQ(profiler.Phases().size(), 2);
+  EXPECT_EQ(profiler.Phases().at(0).name, "interpreter");
+  EXPECT_GE(profiler.Phases().at(0).duration, std::chrono::milliseconds(2));
+  EXPECT_EQ(profiler.Total(), profiler.Phases().at(0).duration +
+                                  profiler.Phases().at(1).duration);
+}
+
+TEST(StartupProfiler, Report) {
+  StartupProfiler profiler;
+  profiler.Start();
+  profiler.Mark("interpreter");
+  profiler.Mark("main window");
+  std::ostringstream out;
+  profiler.Report(out);
+  const std::string report = out.str();
+  EXPECT_EQ(report.find("Startup profile:"), 0);
+  EXPECT_NE(report.find("interpreter"), std::string::npos);
+  EXPECT_NE(report.find("main window"), std::string::npos);
+  EXPECT_LT(report.find("interpreter"), report.find("main window"));
+}
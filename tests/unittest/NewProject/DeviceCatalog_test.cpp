@@ -0,0 +1,159 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "NewProject/ProjectManager/device_catalog.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include "NewProject/ProjectManager/config.h"
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+
+namespace {
+const char *deviceXml = R"(<device_list>
+  <device name="b100" series="s1" family="f1" package="P1" pin_count="100"
+          speedgrade="1" core_voltage="1.1V">
+    <resource type="lut" num="8000"/>
+    <resource type="ff" num="16000"/>
+  </device>
+  <device name="a200" series="s1" family="f1" package="P1" pin_count="200"
+          speedgrade="2" core_voltage="1.1V">
+    <resource type="lut" num="9000"/>
+    <resource type="ff" num="18000"/>
+  </device>
+  <device name="c300" series="s1" family="f0" package="P2" pin_count="300"
+          speedgrade="1" core_voltage="1.2V">
+    <resource type="ff" num="20000"/>
+    <resource type="dsp" num="12"/>
+    <internal type="lut_size" num="6"/>
+    <internal type="synth_type" name="QL"/>
+  </device>
+  <device name="b100" series="s2" family="f2" package="P1" pin_count="100"
+          speedgrade="1" core_voltage="1.1V">
+    <resource type="lut" num="8000"/>
+  </device>
+</device_list>
+)";
+
+QString writeXml(const std::string &name, const std::string &content) {
+  auto path = TestDir("catalog") / name;
+  std::ofstream file(path);
+  file << content;
+  return QString::fromStdString(path.string());
+}
+
+QStringList names(const DeviceCatalog &catalog,
+                  const std::vector<int> &devices) {
+  QStringList result;
+  for (int device : devices) result.append(catalog.GetDevice(device).name);
+  return result;
+}
+}  // namespace
+
+TEST(DeviceCatalog, Load) {
+  DeviceCatalog catalog;
+  ASSERT_EQ(catalog.Load(writeXml("catalog_load.xml", deviceXml)), 0);
+  EXPECT_EQ(catalog.Size(), 4);
+  EXPECT_EQ(catalog.Columns(),
+            (QStringList{"name", "pin_count", "speedgrade", "core_voltage",
+                         "lut", "ff", "dsp", "series", "family", "package"}));
+  // resources by type, missing ones are empty
+  EXPECT_EQ(catalog.Row(2), (QStringList{"c300", "300", "1", "1.2V", "",
+                                         "20000", "12", "s1", "f0", "P2"}));
+  const auto c300 = catalog.DevicesNamed("c300");
+  ASSERT_EQ(c300.size(), 1);
+  const auto &internals = catalog.GetDevice(c300.front()).internals;
+  ASSERT_EQ(internals.size(), 2);
+  EXPECT_EQ(internals.at(0).type, "lut_size");
+  EXPECT_EQ(internals.at(0).num, "6");
+  EXPECT_EQ(internals.at(1).name, "QL");
+  EXPECT_EQ(catalog.DevicesNamed("b100").size(), 2);
+}
+
+TEST(DeviceCatalog, LoadErrors) {
+  DeviceCatalog catalog;
+  EXPECT_EQ(catalog.Load("missing/device.xml"), -1);
+  EXPECT_EQ(catalog.Load(writeXml("catalog_invalid.xml",
+                                  "<device_list><device name=\"a\">")),
+            -2);
+  EXPECT_FALSE(catalog.LastError().isEmpty());
+  EXPECT_EQ(catalog.Size(), 0);
+}
+
+TEST(DeviceCatalog, Index) {
+  DeviceCatalog catalog;
+  ASSERT_EQ(catalog.Load(writeXml("catalog_index.xml", deviceXml)), 0);
+  EXPECT_EQ(catalog.Series(), (QStringList{"s1", "s2"}));
+  EXPECT_EQ(catalog.Families("s1"), (QStringList{"f0", "f1"}));
+  EXPECT_EQ(catalog.Packages("s1", "f1"), QStringList{"P1"});
+  EXPECT_TRUE(catalog.Packages("s1", "f2").isEmpty());
+  EXPECT_EQ(names(catalog, catalog.Devices("s1", "f1", "P1")),
+            (QStringList{"a200", "b100"}));
+  EXPECT_EQ(names(catalog, catalog.Devices()),
+            (QStringList{"a200", "b100", "b100", "c300"}));
+  // not a prefix of the index keys
+  EXPECT_EQ(names(catalog, catalog.Devices({}, {}, "P1")),
+            (QStringList{"a200", "b100", "b100"}));
+  EXPECT_TRUE(catalog.Devices("s3").empty());
+}
+
+TEST(DeviceCatalog, Filter) {
+  auto catalog = std::make_shared<DeviceCatalog>();
+  ASSERT_EQ(catalog->Load(writeXml("catalog_filter.xml", deviceXml)), 0);
+  DeviceFilter filter{catalog};
+  EXPECT_EQ(filter.Devices().size(), 4);
+  filter.SetFilter(catalog->SeriesColumn(), "s1");
+  EXPECT_EQ(names(*catalog, filter.Devices()),
+            (QStringList{"a200", "b100", "c300"}));
+  filter.SetFilter(DeviceCatalog::Name, "B");
+  EXPECT_EQ(names(*catalog, filter.Devices()), QStringList{"b100"});
+  filter.SetFilter(DeviceCatalog::Name, "00");
+  EXPECT_EQ(filter.Devices().size(), 3);
+  filter.SetFilter(DeviceCatalog::FirstResource + 1, "18");  // ff
+  EXPECT_EQ(names(*catalog, filter.Devices()), QStringList{"a200"});
+  filter.SetFilter(catalog->SeriesColumn(), "s2");
+  EXPECT_TRUE(filter.Devices().empty());
+  filter.SetFilter(DeviceCatalog::FirstResource + 1, {});
+  EXPECT_EQ(names(*catalog, filter.Devices()), QStringList{"b100"});
+  filter.Reset();
+  EXPECT_EQ(filter.Devices().size(), 4);
+}
+
+TEST(DeviceCatalog, ConfigSnapshot) {
+  Config config;
+  ASSERT_EQ(config.InitConfig(writeXml("catalog_config.xml", deviceXml)), 0);
+  const auto snapshot = config.catalog();
+  EXPECT_EQ(snapshot->Size(), 4);
+  // A failed load keeps the previous catalog
+  EXPECT_EQ(config.InitConfig(writeXml("catalog_config_bad.xml",
+                                       "<device_list><device name=\"a\">")),
+            -2);
+  EXPECT_EQ(config.catalog(), snapshot);
+  EXPECT_EQ(config.getSerieslist(), (QStringList{"s1", "s2"}));
+  // A new catalog doesn't change the snapshots held
+  ASSERT_EQ(config.InitConfig(writeXml("catalog_config_small.xml",
+                                       "<device_list>\n</device_list>\n")),
+            0);
+  EXPECT_EQ(config.catalog()->Size(), 0);
+  EXPECT_EQ(snapshot->Size(), 4);
+}
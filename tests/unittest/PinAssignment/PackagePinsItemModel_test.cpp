@@ -0,0 +1,132 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PinAssignment/PackagePinsItemModel.h"
+
+#include "PinAssignment/PinAssignmentDelegate.h"
+#include "PinAssignment/PinsBaseModel.h"
+#include "TestLoader.h"
+#include "TestPortsLoader.h"
+#include "gtest/gtest.h"
+using namespace FOEDAG;
+
+class PackagePinsItemModelFixture : public testing::Test {
+ public:
+  PackagePinsItemModelFixture() {
+    baseModel.setPackagePinModel(&packagePinModel);
+    baseModel.setPortsModel(&portsModel);
+    packagePinModel.setBaseModel(&baseModel);
+    TestPortsLoader portsLoader;
+    portsLoader.SetModel(&portsModel);
+    portsLoader.load({});
+    TestLoader loader;
+    loader.setModel(&packagePinModel);
+    loader.loadHeader({});
+    loader.load({});
+  }
+
+  // index of the pin, bank is populated if needed
+  QModelIndex pinIndex(PackagePinsItemModel &model, int row,
+                       int column = 0) {
+    auto bank = model.index(0, 0, model.index(0, 0));
+    if (model.canFetchMore(bank)) model.fetchMore(bank);
+    return model.index(row, column, bank);
+  }
+
+ protected:
+  PackagePinsModel packagePinModel;
+  PortsModel portsModel;
+  PinsBaseModel baseModel;
+};
+
+TEST_F(PackagePinsItemModelFixture, LazyBank) {
+  PackagePinsItemModel model{&baseModel};
+  auto allPins = model.index(0, 0);
+  EXPECT_EQ(model.data(allPins).toString(), "All Pins");
+  ASSERT_EQ(model.rowCount(allPins), 1);
+  auto bank = model.index(0, 0, allPins);
+  EXPECT_EQ(model.rowCount(bank), 0);
+  EXPECT_TRUE(model.hasChildren(bank));
+  EXPECT_TRUE(model.canFetchMore(bank));
+  model.fetchMore(bank);
+  EXPECT_FALSE(model.canFetchMore(bank));
+  ASSERT_EQ(model.rowCount(bank), 3);
+  EXPECT_EQ(model.data(model.index(2, 0, bank)).toString(), "pin3");
+  EXPECT_EQ(model.parent(model.index(2, 0, bank)), bank);
+}
+
+TEST_F(PackagePinsItemModelFixture, SetPort) {
+  PackagePinsItemModel model{&baseModel};
+  model.setPort("pin1", "a", 0);
+  auto portIndex = pinIndex(model, 0, PackagePinsItemModel::PortsCol);
+  EXPECT_EQ(model.data(portIndex).toString(), "a");
+  EXPECT_EQ(baseModel.pinMap().value("a"), std::make_pair(QString{"pin1"}, 0));
+
+  // port is moved to the other pin
+  model.setPort("pin2", "a", 0);
+  EXPECT_TRUE(model.data(portIndex).toString().isEmpty());
+  EXPECT_EQ(baseModel.pinMap().value("a"), std::make_pair(QString{"pin2"}, 0));
+}
+
+TEST_F(PackagePinsItemModelFixture, SetPortSecondRow) {
+  PackagePinsItemModel model{&baseModel};
+  model.setPort("pin1", "a", 0);
+  model.setPort("pin1", "b", 1);
+  auto pin = pinIndex(model, 0);
+  ASSERT_EQ(model.rowCount(pin), 2);
+  auto line = model.index(1, PackagePinsItemModel::PortsCol, pin);
+  EXPECT_EQ(model.data(line).toString(), "b");
+  EXPECT_EQ(baseModel.pinMap().value("b"), std::make_pair(QString{"pin1"}, 1));
+
+  model.removeLine(model.index(0, 0, pin));
+  ASSERT_EQ(model.rowCount(pin), 1);
+  EXPECT_FALSE(baseModel.pinMap().contains("a"));
+  EXPECT_EQ(baseModel.pinMap().value("b"), std::make_pair(QString{"pin1"}, 0));
+}
+
+TEST_F(PackagePinsItemModelFixture, ExternalChange) {
+  PackagePinsItemModel model{&baseModel};
+  baseModel.update("c", "pin3", 0);
+  auto portIndex = pinIndex(model, 2, PackagePinsItemModel::PortsCol);
+  EXPECT_EQ(model.data(portIndex).toString(), "c");
+  baseModel.update("c", QString{}, 0);
+  EXPECT_TRUE(model.data(portIndex).toString().isEmpty());
+}
+
+TEST_F(PackagePinsItemModelFixture, SetMode) {
+  PackagePinsItemModel model{&baseModel};
+  auto modeIndex = pinIndex(model, 2, PackagePinsItemModel::ModeCol);
+  EXPECT_FALSE(model.flags(modeIndex).testFlag(Qt::ItemIsEditable));
+  model.setMode("pin3", "Mode1Rx");
+  EXPECT_TRUE(packagePinModel.getMode("pin3").isEmpty());
+
+  model.setPort("pin3", "c", 0);
+  EXPECT_TRUE(model.flags(modeIndex).testFlag(Qt::ItemIsEditable));
+  EXPECT_TRUE(model.data(modeIndex, ChoicesRole)
+                  .toStringList()
+                  .contains("Mode1Rx"));
+  model.setMode("pin3", "Mode1Rx");
+  EXPECT_EQ(model.data(modeIndex).toString(), "Mode1Rx");
+
+  // mode is released together with the last port
+  model.setPort("pin3", QString{}, 0);
+  EXPECT_TRUE(packagePinModel.getMode("pin3").isEmpty());
+}
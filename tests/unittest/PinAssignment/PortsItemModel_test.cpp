@@ -0,0 +1,82 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PinAssignment/PortsItemModel.h"
+
+#include "PinAssignment/PinAssignmentDelegate.h"
+#include "PinAssignment/PinsBaseModel.h"
+#include "TestLoader.h"
+#include "TestPortsLoader.h"
+#include "gtest/gtest.h"
+using namespace FOEDAG;
+
+class PortsItemModelFixture : public testing::Test {
+ public:
+  PortsItemModelFixture() {
+    baseModel.setPackagePinModel(&packagePinModel);
+    baseModel.setPortsModel(&portsModel);
+    packagePinModel.setBaseModel(&baseModel);
+    TestPortsLoader portsLoader;
+    portsLoader.SetModel(&portsModel);
+    portsLoader.load({});
+    TestLoader loader;
+    loader.setModel(&packagePinModel);
+    loader.loadHeader({});
+    loader.load({});
+  }
+
+ protected:
+  PackagePinsModel packagePinModel;
+  PortsModel portsModel;
+  PinsBaseModel baseModel;
+};
+
+TEST_F(PortsItemModelFixture, Structure) {
+  PortsItemModel model{&baseModel};
+  auto top = model.index(0, 0);
+  EXPECT_EQ(model.data(top).toString(), "Design ports");
+  ASSERT_EQ(model.rowCount(top), 4);
+  auto bus = model.index(3, 0, top);
+  EXPECT_EQ(model.data(bus).toString(), "d");
+  ASSERT_EQ(model.rowCount(bus), 2);
+  auto busPort = model.index(1, 0, bus);
+  EXPECT_EQ(model.data(busPort).toString(), "d[0]");
+  EXPECT_EQ(model.parent(busPort), bus);
+  auto busPin = model.index(3, PortsItemModel::PackagePinCol, top);
+  EXPECT_FALSE(model.flags(busPin).testFlag(Qt::ItemIsEditable));
+}
+
+TEST_F(PortsItemModelFixture, SetPin) {
+  PortsItemModel model{&baseModel};
+  auto top = model.index(0, 0);
+  auto pinIndex = model.index(0, PortsItemModel::PackagePinCol, top);
+  EXPECT_TRUE(model.setData(pinIndex, "pin1"));
+  EXPECT_EQ(model.data(pinIndex).toString(), "pin1");
+  EXPECT_EQ(baseModel.pinMap().value("a"), std::make_pair(QString{"pin1"}, 0));
+
+  // package pin is used by one port only
+  model.setPin("b", "pin1");
+  EXPECT_FALSE(baseModel.pinMap().contains("a"));
+  EXPECT_TRUE(model.data(pinIndex).toString().isEmpty());
+
+  model.clear();
+  EXPECT_TRUE(baseModel.pinMap().isEmpty());
+}
@@ -81,9 +81,9 @@ TEST(PortsLoader, LoadBus) {
   const int portIndex{1};
   auto port = model.ports().at(groupIndex).ports.at(portIndex);
   EXPECT_EQ(port.isBus, true);
-  EXPECT_EQ(port.ports.count(), 5);
-  for (int i = 0; i < port.ports.count(); i++) {
-    auto p = port.ports.at(i);
+  EXPECT_EQ(port.busWidth(), 5);
+  for (int i = 0; i < port.busWidth(); i++) {
+    auto p = port.busPort(i);
     EXPECT_EQ(p.name, QString("out1[%1]").arg(QString::number(4 - i)));
     EXPECT_EQ(p.dir, "Output");
     EXPECT_EQ(p.packagePin, "");
@@ -92,6 +92,21 @@ TEST(PortsLoader, LoadBus) {
   }
 }
 
+TEST(PortsLoader, GetBusPort) {
+  PortsModel model;
+  PortsLoader loader{&model};
+  auto [res, error] = loader.load(":/PinAssignment/ports_test.json");
+  EXPECT_EQ(res, true) << error.toStdString();
+
+  auto port = model.GetPort("out1[3]");
+  EXPECT_EQ(port.name, "out1[3]");
+  EXPECT_EQ(port.dir, "Output");
+  EXPECT_EQ(port.isBus, false);
+  EXPECT_EQ(model.GetPort("out1[5]").name, QString{});
+  EXPECT_EQ(model.GetPort("out1").isBus, true);
+  EXPECT_EQ(model.ports().at(0).ports.at(1).busIndex(3), 1);
+}
+
 TEST(PortsLoader, LoadCorruptedJson) {
   PortsModel model;
   PortsLoader loader{&model};
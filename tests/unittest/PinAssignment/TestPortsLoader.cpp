@@ -40,15 +40,8 @@ std::pair<bool, QString> TestPortsLoader::load(const QString &file) {
                  false, {}};
   group.ports.append(ioport3);
 
-  IOPort bus0{"d[0]", "Input", QString(), "type", QString("Msb: 0, lsb: 0"),
-              false,  {}};
-
-  IOPort bus1{"d[1]", "Input", QString(), "type", QString("Msb: 0, lsb: 0"),
-              false,  {}};
-
-  IOPort ioport4{
-      "d",  "Input",     QString(), "type", QString("Msb: 1, lsb: 0"),
-      true, {bus0, bus1}};
+  IOPort ioport4{"d",  "Input", QString(), "type", QString("Msb: 1, lsb: 0"),
+                 true, 1,       0};
   group.ports.append(ioport4);
 
   m_model->append(group);
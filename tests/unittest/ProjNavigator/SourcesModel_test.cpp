@@ -0,0 +1,105 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ProjNavigator/sources_model.h"
+
+#include "NewProject/ProjectManager/project.h"
+#include "NewProject/ProjectManager/project_manager.h"
+#include "gtest/gtest.h"
+using namespace FOEDAG;
+
+namespace {
+ProjectFileSet *addFileSet(const QString &name, const QString &type) {
+  ProjectFileSet set;
+  set.setSetName(name);
+  set.setSetType(type);
+  Project::Instance()->setProjectFileset(set);
+  return Project::Instance()->getProjectFileset(name);
+}
+}  // namespace
+
+TEST(SourcesModel, IncrementalUpdates) {
+  ProjectManager projManager;
+  Project::Instance()->InitProject();
+  SourcesModel model{&projManager};
+  const QModelIndex project = model.index(0, 0);
+  const QModelIndex design = model.index(0, 0, project);
+  const QModelIndex constr = model.index(1, 0, project);
+  EXPECT_EQ(model.rowCount(project), 4);
+  EXPECT_EQ(design.data().toString(), "Design Sources(0)");
+
+  ProjectFileSet *sources = addFileSet("sources_1", PROJECT_FILE_TYPE_DS);
+  sources->addFile("a.v", "/tmp/a.v");
+  sources->addFile("b.v", "/tmp/b.v");
+  ASSERT_EQ(model.rowCount(design), 2);
+  EXPECT_EQ(design.data().toString(), "Design Sources(2)");
+  const QModelIndex file = model.index(1, 0, design);
+  EXPECT_EQ(file.data(Qt::UserRole).toString(), "/tmp/b.v");
+  EXPECT_EQ(file.data(SourcesModel::FileSetRole).toString(), "sources_1");
+
+  sources->deleteFile("a.v");
+  ASSERT_EQ(model.rowCount(design), 1);
+  EXPECT_EQ(model.index(0, 0, design).data().toString(), "b.v");
+
+  ProjectFileSet *constrs = addFileSet("constrs_1", PROJECT_FILE_TYPE_CS);
+  constrs->addFile("pins.pin", "/tmp/pins.pin");
+  ASSERT_EQ(model.rowCount(constr), 1);
+  constrs->setOption(PROJECT_FILE_CONFIG_TARGET, "pins.pin");
+  EXPECT_EQ(model.index(0, 0, constr).data().toString(),
+            QString{"pins.pin"} + QObject::tr(" (Target)"));
+
+  Project::Instance()->deleteProjectFileset("sources_1");
+  EXPECT_EQ(model.rowCount(design), 0);
+  EXPECT_EQ(design.data().toString(), "Design Sources(0)");
+  Project::Instance()->InitProject();
+}
+
+TEST(SourcesModel, LazyFetch) {
+  ProjectManager projManager;
+  Project::Instance()->InitProject();
+  ProjectFileSet *sources = addFileSet("sources_1", PROJECT_FILE_TYPE_DS);
+  const int count = SourcesModel::FetchBatch * 2 + 1;
+  for (int i = 0; i < count; i++) {
+    const QString name = QString{"f%1.v"}.arg(i);
+    sources->addFile(name, "/tmp/" + name);
+  }
+  SourcesModel model{&projManager};
+  const QModelIndex design = model.index(0, 0, model.index(0, 0));
+  EXPECT_EQ(model.rowCount(design), 0);
+  EXPECT_TRUE(model.hasChildren(design));
+  EXPECT_EQ(design.data().toString(),
+            QString{"Design Sources(%1)"}.arg(count));
+
+  ASSERT_TRUE(model.canFetchMore(design));
+  model.fetchMore(design);
+  EXPECT_EQ(model.rowCount(design), SourcesModel::FetchBatch);
+
+  // Files added behind unfetched rows are picked up by the next fetch
+  sources->addFile("last.v", "/tmp/last.v");
+  EXPECT_EQ(model.rowCount(design), SourcesModel::FetchBatch);
+
+  // Looking up a file fetches up to its row
+  const QModelIndex last = model.fileIndex("/tmp/last.v");
+  ASSERT_TRUE(last.isValid());
+  EXPECT_EQ(model.rowCount(design), count + 1);
+  EXPECT_FALSE(model.canFetchMore(design));
+  Project::Instance()->InitProject();
+}
@@ -24,12 +24,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <QFile>
 #include <QStringList>
 #include <QTextStream>
+#include <filesystem>
 #include <fstream>
 
 #include "Main/Tasks.h"
 #include "Main/WidgetFactory.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "unittest/TestDir.h"
 
 using ::testing::ElementsAre;
 
@@ -264,5 +266,94 @@ TEST(Settings, TclValsInit) {
       << "Ensure the userValue TclExample values are reported";
 }
 
+TEST(Settings, SettingsJsonPtrPaths) {
+  Settings test;
+  test.getJson() = R"(
+    {
+      "Tasks": {
+        "Shown": { "_META_": { "isSetting": true, "hidden": false } },
+        "Hidden": { "_META_": { "isSetting": true } },
+        "a/b": { "_META_": { "isSetting": true, "hidden": false } },
+        "NotSetting": { "_META_": { "isSetting": false } }
+      }
+    }
+    )"_json;
+  EXPECT_EQ(test.getSettingsJsonPtrPaths(),
+            (QStringList{"/Tasks/Shown", "/Tasks/Hidden", "/Tasks/a~1b"}));
+  EXPECT_EQ(test.getSettingsJsonPtrPaths(false),
+            (QStringList{"/Tasks/Shown", "/Tasks/a~1b"}));
+
+  // index follows the changes of the json
+  test.getJson()["Tasks"].erase("Shown");
+  EXPECT_EQ(test.getSettingsJsonPtrPaths(false), QStringList{"/Tasks/a~1b"});
+}
+
+TEST(Settings, ApplyChangedTclVarsOnly) {
+  int calls{0};
+  std::string state;
+  FOEDAG::addTclArgFns("ApplyChangedTest",
+                       {[&calls, &state](const std::string& args) {
+                          calls++;
+                          state = args;
+                        },
+                        [&state]() { return state; }});
+  Settings test;
+  test.getJson() = R"(
+    {
+      "ApplyChangedTest": {
+        "_META_": { "isSetting": true, "tclArgKey": "ApplyChangedTest" },
+        "field": { "widgetType": "input", "arg": "val", "default": "a" }
+      }
+    }
+    )"_json;
+  test.applyTclVars();
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(state, " -val a");
+
+  test.applyTclVars();
+  EXPECT_EQ(calls, 1) << "Nothing changed, setter is not called again";
+
+  test.getJson()["ApplyChangedTest"]["field"]["userValue"] = "b";
+  test.applyTclVars();
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(state, " -val b");
+
+  state = " -val c";  // changed from tcl
+  test.applyTclVars();
+  EXPECT_EQ(calls, 3);
+  EXPECT_EQ(state, " -val b");
+  FOEDAG::clearTclArgFns();
+  FOEDAG::initTclArgFns();
+}
+
+TEST(Settings, Snapshot) {
+  const QString dir =
+      QString::fromStdString(TestDir("settings").string() + "/");
+  const QString settingsFile = dir + "settings_snapshot_test.json";
+  const QString snapshotFile = dir + "settings_snapshot_test.snapshot";
+  QFile::remove(snapshotFile);
+  auto write = [settingsFile](const char* content) {
+    QFile file{settingsFile};
+    file.open(QFile::WriteOnly | QFile::Truncate);
+    file.write(content);
+  };
+  write(R"({"a": 1})");
+
+  Settings test;
+  test.loadSettings({settingsFile}, snapshotFile);
+  EXPECT_EQ(test.getJson(), json::parse(R"({"a": 1})"));
+  EXPECT_TRUE(QFile::exists(snapshotFile));
+
+  Settings fromSnapshot;
+  EXPECT_TRUE(fromSnapshot.loadSnapshot(snapshotFile, {settingsFile}));
+  EXPECT_EQ(fromSnapshot.getJson(), json::parse(R"({"a": 1})"));
+
+  write(R"({"b": 22})");  // size differs, mtime may not
+  Settings outdated;
+  EXPECT_FALSE(outdated.loadSnapshot(snapshotFile, {settingsFile}));
+  outdated.loadSettings({settingsFile}, snapshotFile);
+  EXPECT_EQ(outdated.getJson(), json::parse(R"({"b": 22})"));
+}
+
 }  // namespace
 }  // namespace FOEDAG
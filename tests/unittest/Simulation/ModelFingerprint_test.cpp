@@ -0,0 +1,84 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Simulation/ModelFingerprint.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+namespace fs = std::filesystem;
+
+namespace {
+void write(const fs::path& path, const std::string& text) {
+  std::ofstream stream(path);
+  stream << text;
+}
+
+std::string fingerprint(const fs::path& dir) {
+  ModelFingerprint fingerprint;
+  fingerprint.AddCommand("verilator --cc top.v -Iinc", "-I", dir);
+  return fingerprint.Hex();
+}
+
+fs::path design(const std::string& name) {
+  fs::path dir = TestDir(name);
+  fs::create_directory(dir / "inc");
+  fs::create_directory(dir / "pkg");
+  write(dir / "top.v",
+        "`include \"defs.vh\"\n"
+        "// `include \"commented.vh\"\n"
+        "module top; endmodule\n");
+  write(dir / "inc" / "defs.vh", "`include \"../pkg/types.vh\"\n");
+  write(dir / "pkg" / "types.vh", "`define WIDTH 8\n");
+  return dir;
+}
+}  // namespace
+
+TEST(ModelFingerprint, Includes) {
+  const fs::path dir = design("fingerprint_includes");
+  auto includes = ModelFingerprint::Includes(dir / "top.v", {dir / "inc"});
+  ASSERT_EQ(includes.size(), 2);
+  EXPECT_EQ(includes[0], (dir / "inc" / "defs.vh").lexically_normal());
+  EXPECT_EQ(includes[1], (dir / "pkg" / "types.vh").lexically_normal());
+}
+
+TEST(ModelFingerprint, Hit) {
+  const fs::path dir = design("fingerprint_hit");
+  EXPECT_EQ(fingerprint(dir), fingerprint(dir));
+  EXPECT_EQ(fingerprint(dir).size(), 16);
+}
+
+TEST(ModelFingerprint, IncludedFileInvalidates) {
+  const fs::path dir = design("fingerprint_included");
+  const std::string before = fingerprint(dir);
+  // Only reachable through a nested `include
+  write(dir / "pkg" / "types.vh", "`define WIDTH 16\n`define DEPTH 4\n");
+  EXPECT_NE(before, fingerprint(dir));
+}
+
+TEST(ModelFingerprint, Command) {
+  const fs::path dir = design("fingerprint_command");
+  ModelFingerprint other;
+  other.AddCommand("verilator --cc top.v -Iinc -O3", "-I", dir);
+  EXPECT_NE(fingerprint(dir), other.Hex());
+}
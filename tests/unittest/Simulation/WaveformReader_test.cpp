@@ -0,0 +1,172 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Simulation/WaveformReader.h"
+
+#include <fstream>
+
+#include "Utils/FileUtils.h"
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+
+using namespace FOEDAG;
+
+namespace {
+const char* vcd = R"($date today $end
+$timescale 1ps $end
+$scope module tb $end
+$var wire 1 ! clk $end
+$scope module dut $end
+$var wire 4 " q [3:0] $end
+$upscope $end
+$upscope $end
+$enddefinitions $end
+#0
+$dumpvars
+0!
+bx "
+$end
+#10
+1!
+b1 "
+#20
+0!
+#30
+1!
+b1010 "
+)";
+
+std::filesystem::path writeVcd(const std::string& name,
+                               const std::string& content) {
+  auto path = TestDir("waveform") / name;
+  std::ofstream file(path);
+  file << content;
+  return path;
+}
+}  // namespace
+
+TEST(WaveformReader, Open) {
+  WaveformReader reader;
+  EXPECT_TRUE(reader.Open(writeVcd("reader_open.vcd", vcd)));
+  EXPECT_EQ(reader.Signals(),
+            (std::vector<std::string>{"tb.clk", "tb.dut.q"}));
+  EXPECT_EQ(reader.EndTime(), 30);
+  EXPECT_EQ(reader.TimescaleFs(), 1000);
+}
+
+TEST(WaveformReader, OpenInvalid) {
+  WaveformReader reader;
+  EXPECT_FALSE(reader.Open(writeVcd("reader_invalid.vcd", "#0\n1!\n")));
+  EXPECT_FALSE(reader.LastError().empty());
+}
+
+TEST(WaveformReader, OpenMalformedNumbers) {
+  const std::string header =
+      "$var wire 1 ! clk $end\n$enddefinitions $end\n";
+  WaveformReader reader;
+  EXPECT_FALSE(reader.Open(
+      writeVcd("reader_time.vcd", header + "#0\n1!\n#1x0\n0!\n")));
+  EXPECT_NE(reader.LastError().find("#1x0"), std::string::npos);
+  EXPECT_FALSE(reader.Open(writeVcd(
+      "reader_overflow.vcd", header + "#99999999999999999999999\n0!\n")));
+  EXPECT_FALSE(reader.Open(writeVcd(
+      "reader_timescale.vcd",
+      "$timescale 99999999999999999999999 ps $end\n" + header)));
+  EXPECT_NE(reader.LastError().find("timescale"), std::string::npos);
+}
+
+TEST(WaveformReader, ValueAt) {
+  WaveformReader reader;
+  reader.Open(writeVcd("reader_value.vcd", vcd));
+  std::string value;
+  EXPECT_TRUE(reader.ValueAt("tb.dut.q", 5, value));
+  EXPECT_EQ(value, "xxxx");
+  EXPECT_TRUE(reader.ValueAt("tb.dut.q", 10, value));
+  EXPECT_EQ(value, "0001");
+  // unique suffix lookup
+  EXPECT_TRUE(reader.ValueAt("dut.q", 100, value));
+  EXPECT_EQ(value, "1010");
+  EXPECT_FALSE(reader.ValueAt("tb.unknown", 0, value));
+}
+
+TEST(WaveformReader, Transitions) {
+  WaveformReader reader;
+  reader.Open(writeVcd("reader_transitions.vcd", vcd));
+  auto transitions = reader.Transitions("tb.clk", 10, 20);
+  ASSERT_EQ(transitions.size(), 2);
+  EXPECT_EQ(transitions.at(0).time, 10);
+  EXPECT_EQ(transitions.at(0).value, "1");
+  EXPECT_EQ(transitions.at(1).time, 20);
+  EXPECT_EQ(transitions.at(1).value, "0");
+}
+
+TEST(WaveformReader, SameTimeGlitch) {
+  const std::string header =
+      "$var wire 1 ! clk $end\n$enddefinitions $end\n";
+  WaveformReader reader;
+  ASSERT_TRUE(reader.Open(writeVcd(
+      "reader_glitch.vcd", header + "#0\n0!\n#10\n1!\n0!\n#20\n1!\n")));
+  // 0 -> 1 -> 0 within #10 isn't a transition
+  auto transitions = reader.Transitions("clk");
+  ASSERT_EQ(transitions.size(), 2);
+  EXPECT_EQ(transitions.at(0).time, 0);
+  EXPECT_EQ(transitions.at(1).time, 20);
+  EXPECT_EQ(transitions.at(1).value, "1");
+}
+
+TEST(WaveformReader, Stamp) {
+  auto file = writeVcd("reader_stamp.vcd", vcd);
+  WaveformReader reader;
+  ASSERT_TRUE(reader.Open(file));
+  EXPECT_FALSE(reader.Stamp().empty());
+  {
+    // Rewritten within the same second
+    std::ofstream stream(file, std::ios::app);
+    stream << "#40\n0!\n";
+  }
+  EXPECT_NE(reader.Stamp(), FileUtils::Stamp(file));
+}
+
+TEST(WaveformReader, ParseTime) {
+  WaveformReader reader;
+  reader.Open(writeVcd("reader_time.vcd", vcd));
+  uint64_t time{0};
+  EXPECT_TRUE(reader.ParseTime("25", time));
+  EXPECT_EQ(time, 25);
+  EXPECT_TRUE(reader.ParseTime("0.03ns", time));
+  EXPECT_EQ(time, 30);
+  EXPECT_FALSE(reader.ParseTime("10xs", time));
+}
+
+TEST(WaveformReader, Diff) {
+  std::string other = vcd;
+  other.replace(other.find("b1010"), 5, "b1011");
+  WaveformReader a, b;
+  a.Open(writeVcd("reader_diff_a.vcd", vcd));
+  b.Open(writeVcd("reader_diff_b.vcd", other));
+  EXPECT_TRUE(WaveformReader::Diff(a, a).empty());
+  auto diff = WaveformReader::Diff(a, b);
+  ASSERT_EQ(diff.size(), 1);
+  EXPECT_EQ(diff.at(0).signal, "tb.dut.q");
+  EXPECT_EQ(diff.at(0).time, 30);
+  EXPECT_EQ(diff.at(0).valueA, "1010");
+  EXPECT_EQ(diff.at(0).valueB, "1011");
+}
@@ -0,0 +1,57 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "TestDir.h"
+
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace FOEDAG {
+
+namespace {
+struct Created {
+  std::mutex mutex;
+  std::vector<std::filesystem::path> dirs;
+  ~Created() {
+    std::error_code ec;
+    for (const auto& dir : dirs) std::filesystem::remove_all(dir, ec);
+  }
+};
+}  // namespace
+
+std::filesystem::path TestDir(const std::string& name) {
+  static Created created;
+  static std::mt19937_64 random{std::random_device{}()};
+  std::lock_guard<std::mutex> lock{created.mutex};
+  const auto temp = std::filesystem::temp_directory_path();
+  while (true) {
+    const auto dir = temp / ("foedag_" + name + "_" + std::to_string(random()));
+    std::error_code ec;
+    // Fails when the directory exists already
+    if (std::filesystem::create_directory(dir, ec)) {
+      created.dirs.push_back(dir);
+      return dir;
+    }
+    if (ec && ec != std::errc::file_exists) return dir;
+  }
+}
+
+}  // namespace FOEDAG
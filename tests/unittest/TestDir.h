@@ -0,0 +1,36 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace FOEDAG {
+
+/*!
+ * \brief TestDir creates a new empty directory under the system temp
+ * directory. Its name starts with \p name and is unique to the call, so
+ * parallel test runs and other users never share it. The directories are
+ * removed when the test program exits.
+ */
+std::filesystem::path TestDir(const std::string& name);
+
+}  // namespace FOEDAG
@@ -0,0 +1,127 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TextEditor/file_change_tracker.h"
+
+#include <QEventLoop>
+#include <QTimer>
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+
+using namespace FOEDAG;
+
+namespace {
+void writeFile(const std::filesystem::path& path, const std::string& content) {
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+// Runs the event loop, the watcher and the tracker timers need it
+void wait(int msec) {
+  QEventLoop loop;
+  QTimer::singleShot(msec, &loop, &QEventLoop::quit);
+  loop.exec();
+}
+
+struct Tracked {
+  explicit Tracked(const std::string& name, int window = 100) {
+    file = TestDir("file_change_tracker") / name;
+    writeFile(file, "initial");
+    path = QString::fromStdString(file.string());
+    tracker.setWindow(window);
+    QObject::connect(
+        &tracker, &FileChangeTracker::filesChanged,
+        [this](const QStringList& paths) { changed.append(paths); });
+    QObject::connect(
+        &tracker, &FileChangeTracker::filesRemoved,
+        [this](const QStringList& paths) { removed.append(paths); });
+    tracker.addFile(path);
+  }
+  std::filesystem::path file;
+  QString path;
+  FileChangeTracker tracker;
+  QList<QStringList> changed;
+  QList<QStringList> removed;
+};
+}  // namespace
+
+TEST(FileChangeTracker, Debounce) {
+  Tracked tracked{"debounce.v", 200};
+  writeFile(tracked.file, "first");
+  writeFile(tracked.file, "second");
+  wait(1000);
+  ASSERT_EQ(tracked.changed.size(), 1);
+  EXPECT_EQ(tracked.changed.first(), QStringList{tracked.path});
+}
+
+TEST(FileChangeTracker, MaxDelay) {
+  Tracked tracked{"max_delay.v", 200};
+  tracked.tracker.setMaxDelay(300);
+  // Rewritten more often than the window for a second
+  int count{0};
+  int reported{0};
+  QEventLoop loop;
+  QTimer timer;
+  QObject::connect(&timer, &QTimer::timeout, [&]() {
+    if (++count == 20) {
+      reported = tracked.changed.size();
+      loop.quit();
+      return;
+    }
+    writeFile(tracked.file, std::to_string(count));
+  });
+  timer.start(50);
+  loop.exec();
+  EXPECT_GE(reported, 1);
+}
+
+TEST(FileChangeTracker, SameContent) {
+  Tracked tracked{"same_content.v"};
+  writeFile(tracked.file, "initial");
+  wait(600);
+  EXPECT_TRUE(tracked.changed.isEmpty());
+}
+
+TEST(FileChangeTracker, Saved) {
+  Tracked tracked{"saved.v"};
+  // The editor wrote the file itself
+  writeFile(tracked.file, "edited");
+  tracked.tracker.fileSaved(tracked.path);
+  wait(600);
+  EXPECT_TRUE(tracked.changed.isEmpty());
+
+  writeFile(tracked.file, "edited elsewhere");
+  wait(600);
+  ASSERT_EQ(tracked.changed.size(), 1);
+}
+
+TEST(FileChangeTracker, Removed) {
+  Tracked tracked{"removed.v", 50};
+  std::filesystem::remove(tracked.file);
+  // Looked for a few times a second before it is reported
+  wait(5000);
+  EXPECT_TRUE(tracked.changed.isEmpty());
+  ASSERT_EQ(tracked.removed.size(), 1);
+  EXPECT_EQ(tracked.removed.first(), QStringList{tracked.path});
+}
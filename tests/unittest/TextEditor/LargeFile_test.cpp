@@ -0,0 +1,144 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "TextEditor/large_file.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+
+namespace {
+std::filesystem::path writeFile(const std::string& name,
+                                const std::string& content) {
+  auto path = TestDir("large_file") / name;
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+  return path;
+}
+}  // namespace
+
+TEST(LargeFile, Lines) {
+  LargeFile file;
+  ASSERT_TRUE(file.Open(writeFile("large_lines.txt", "first\r\n\nthird")));
+  file.WaitIndex();
+  EXPECT_TRUE(file.IndexDone());
+  EXPECT_EQ(file.LineCount(), 3);
+  EXPECT_EQ(file.Line(0), "first");
+  EXPECT_EQ(file.Line(1), "");
+  EXPECT_EQ(file.Line(2), "third");
+  EXPECT_EQ(file.Line(3), "");
+  EXPECT_EQ(file.LineStart(2), 8);
+  EXPECT_EQ(file.LineOf(0), 0);
+  EXPECT_EQ(file.LineOf(7), 1);
+  EXPECT_EQ(file.LineOf(12), 2);
+  EXPECT_EQ(file.LineOf(13), LargeFile::npos);
+}
+
+TEST(LargeFile, ManyLines) {
+  // Spans several checkpoints and index chunks
+  std::string content;
+  const uint64_t count = 200000;
+  for (uint64_t i = 0; i < count; i++)
+    content += "line " + std::to_string(i) + "\n";
+  LargeFile file;
+  ASSERT_TRUE(file.Open(writeFile("large_many.txt", content)));
+  file.WaitIndex();
+  EXPECT_EQ(file.LineCount(), count);
+  EXPECT_EQ(file.Line(0), "line 0");
+  EXPECT_EQ(file.Line(17), "line 17");
+  EXPECT_EQ(file.Line(count - 1), "line 199999");
+  const uint64_t offset = file.LineStart(123457);
+  EXPECT_EQ(file.Line(123457), "line 123457");
+  EXPECT_EQ(file.LineOf(offset), 123457);
+  EXPECT_EQ(file.LineOf(offset + 3), 123457);
+}
+
+TEST(LargeFile, Empty) {
+  LargeFile file;
+  ASSERT_TRUE(file.Open(writeFile("large_empty.txt", "")));
+  file.WaitIndex();
+  EXPECT_EQ(file.LineCount(), 0);
+  EXPECT_EQ(file.Line(0), "");
+  EXPECT_EQ(file.Find("a", 0, true, false, true), LargeFile::npos);
+}
+
+TEST(LargeFile, Missing) {
+  LargeFile file;
+  EXPECT_FALSE(file.Open(TestDir("large_file") / "missing.txt"));
+  EXPECT_FALSE(file.LastError().empty());
+}
+
+TEST(LargeFile, Find) {
+  LargeFile file;
+  ASSERT_TRUE(
+      file.Open(writeFile("large_find.txt", "wire clk;\nwire clk_en;\nCLK\n")));
+  file.WaitIndex();
+  EXPECT_EQ(file.Find("clk", 0, true, false, false), 5);
+  EXPECT_EQ(file.Find("clk", 6, true, false, false), 15);
+  // whole word skips clk_en
+  EXPECT_EQ(file.Find("clk", 6, true, true, false), LargeFile::npos);
+  EXPECT_EQ(file.Find("clk", 6, false, true, false), 23);
+  // wraps to the start
+  EXPECT_EQ(file.Find("wire", 11, true, false, true), 0);
+  EXPECT_EQ(file.Find("wire", 11, true, false, false), LargeFile::npos);
+}
+
+TEST(LargeFile, LongLine) {
+  LargeFile file;
+  const std::string line(3 * 64 * 1024, 'x');
+  ASSERT_TRUE(file.Open(writeFile("large_long.txt", line + "\r\nend")));
+  file.WaitIndex();
+  EXPECT_EQ(file.Line(0), line);
+  EXPECT_EQ(file.Line(0, 10), std::string(10, 'x'));
+  EXPECT_EQ(file.Line(1), "end");
+  EXPECT_EQ(file.Read(line.size() + 2, 100), "end");
+}
+
+TEST(LargeFile, FindAcrossChunks) {
+  // The word straddles the second read chunk
+  std::string content(1 << 20, ' ');
+  content.replace(content.size() - 2, 4, "wire");
+  content += " wires";
+  LargeFile file;
+  ASSERT_TRUE(file.Open(writeFile("large_chunks.txt", content)));
+  EXPECT_EQ(file.Find("wire", 0, true, true, false), (1 << 20) - 2);
+  EXPECT_EQ(file.Find("wires", 0, true, true, false), (1 << 20) + 3);
+  std::atomic<bool> cancel{true};
+  EXPECT_EQ(file.Find("wire", 0, true, true, false, &cancel),
+            LargeFile::npos);
+}
+
+TEST(LargeFile, Shrunk) {
+  // Reading past the new end of a mapped file would raise SIGBUS
+  std::string content;
+  for (int i = 0; i < 100000; i++) content += "net " + std::to_string(i) + "\n";
+  const auto path = writeFile("large_shrunk.txt", content);
+  LargeFile file;
+  ASSERT_TRUE(file.Open(path));
+  file.WaitIndex();
+  std::filesystem::resize_file(path, 10);
+  EXPECT_EQ(file.Line(0), "net 0");
+  EXPECT_EQ(file.Line(99999), "");
+  EXPECT_EQ(file.LineOf(content.size() - 1), LargeFile::npos);
+  EXPECT_EQ(file.Find("99999", 0, true, true, true), LargeFile::npos);
+}
@@ -0,0 +1,171 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Utils/FileIndex.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+using namespace FOEDAG;
+namespace fs = std::filesystem;
+
+namespace {
+fs::path indexTree(const std::string& name) {
+  auto dir = TestDir(name);
+  fs::create_directories(dir / "rtl" / "sub");
+  fs::create_directories(dir / "inc");
+  std::ofstream{dir / "top.v"};
+  std::ofstream{dir / "rtl" / "core.v"};
+  std::ofstream{dir / "rtl" / "sub" / "top.v"};
+  std::ofstream{dir / "inc" / "Defs.vh"};
+  return dir;
+}
+}  // namespace
+
+TEST(FileIndex, Find) {
+  const auto dir = indexTree("index_find");
+  FileIndex index;
+  auto found = index.Find(dir, {"top.v", "core.v", "missing.v"});
+  ASSERT_EQ(found.size(), 3);
+  // shallowest first
+  EXPECT_EQ(found[0], (FileIndex::Paths{dir / "top.v",
+                                        dir / "rtl" / "sub" / "top.v"}));
+  EXPECT_EQ(found[1], (FileIndex::Paths{dir / "rtl" / "core.v"}));
+  EXPECT_TRUE(found[2].empty());
+  EXPECT_TRUE(index.Find(dir / "missing", {"top.v"})[0].empty());
+}
+
+TEST(FileIndex, FindOptions) {
+  const auto dir = indexTree("index_options");
+  FileIndex index;
+  EXPECT_TRUE(index.Find(dir / "inc", {"defs.vh"})[0].empty());
+  EXPECT_EQ(index.Find(dir / "inc", {"defs.vh"}, true, true)[0],
+            (FileIndex::Paths{dir / "inc" / "Defs.vh"}));
+  EXPECT_EQ(index.Find(dir, {"top.v"}, false)[0],
+            (FileIndex::Paths{dir / "top.v"}));
+  EXPECT_TRUE(index.Find(dir, {"core.v"}, false)[0].empty());
+}
+
+TEST(FileIndex, Cached) {
+  const auto dir = indexTree("index_cached");
+  FileIndex index;
+  index.Find(dir, {"top.v"});
+  index.Find(dir, {"core.v"});
+  EXPECT_EQ(index.Scans(), 1);
+  index.Invalidate(dir);
+  index.Find(dir, {"top.v"});
+  EXPECT_EQ(index.Scans(), 2);
+}
+
+TEST(FileIndex, Revalidate) {
+  const auto dir = indexTree("index_revalidate");
+  FileIndex index;
+  index.SetMaxAge(std::chrono::milliseconds{0});
+  index.Find(dir, {"new.v"});
+  index.Find(dir, {"new.v"});
+  EXPECT_EQ(index.Scans(), 1);  // directory mtimes unchanged
+  std::ofstream{dir / "rtl" / "new.v"};
+  EXPECT_EQ(index.Find(dir, {"new.v"})[0],
+            (FileIndex::Paths{dir / "rtl" / "new.v"}));
+}
+
+#ifdef __linux__
+TEST(FileIndex, Notified) {
+  const auto dir = indexTree("index_notified");
+  FileIndex index;
+  index.Find(dir, {"new.v"});
+  std::ofstream{dir / "rtl" / "sub" / "new.v"};
+  EXPECT_EQ(index.Find(dir, {"new.v"})[0],
+            (FileIndex::Paths{dir / "rtl" / "sub" / "new.v"}));
+  fs::remove(dir / "rtl" / "sub" / "new.v");
+  EXPECT_TRUE(index.Find(dir, {"new.v"})[0].empty());
+}
+#endif
+
+TEST(FileIndex, SaveLoad) {
+  const auto dir = indexTree("index_save");
+  const auto file = TestDir("index_cache") / "index.txt";
+  {
+    FileIndex index;
+    index.Find(dir, {"top.v"});
+    EXPECT_TRUE(index.Save(file));
+  }
+  FileIndex index;
+  EXPECT_TRUE(index.Load(file));
+  EXPECT_EQ(index.Find(dir, {"core.v"})[0],
+            (FileIndex::Paths{dir / "rtl" / "core.v"}));
+  EXPECT_EQ(index.Scans(), 0);
+  EXPECT_FALSE(index.Load(dir / "top.v"));
+}
+
+TEST(FileIndex, Unnotified) {
+  // A miss checks the directory mtimes right away
+  const auto dir = indexTree("index_unnotified");
+  FileIndex index;
+  index.SetNotify(false);
+  index.SetMaxAge(std::chrono::hours{1});
+  index.Find(dir, {"top.v"});
+  index.Find(dir, {"top.v"});
+  EXPECT_EQ(index.Scans(), 1);
+  std::ofstream{dir / "inc" / "new.vh"};
+  EXPECT_EQ(index.Find(dir, {"new.vh"})[0],
+            (FileIndex::Paths{dir / "inc" / "new.vh"}));
+  EXPECT_EQ(index.Scans(), 2);
+}
+
+TEST(FileIndex, RelativeRoot) {
+  const auto first = indexTree("index_relative_a");
+  const auto second = TestDir("index_relative_b");
+  fs::create_directories(second / "rtl");
+  std::ofstream{second / "rtl" / "core.v"};
+  const auto cwd = fs::current_path();
+  FileIndex index;
+  fs::current_path(first);
+  auto found = index.Find("rtl", {"core.v"})[0];
+  ASSERT_EQ(found.size(), 1);
+  EXPECT_EQ(found[0], first / "rtl" / "core.v");
+  // Another tree for the same relative name
+  fs::current_path(second);
+  found = index.Find("rtl/", {"core.v"})[0];
+  ASSERT_EQ(found.size(), 1);
+  EXPECT_EQ(found[0], second / "rtl" / "core.v");
+  fs::current_path(cwd);
+}
+
+TEST(FileIndex, FindFirst) {
+  const auto dir = indexTree("index_first");
+  FileIndex index;
+  // Walked, not indexed
+  EXPECT_EQ(index.FindFirst(dir / "rtl", "core.v"), dir / "rtl" / "core.v");
+  EXPECT_EQ(index.FindFirst(dir, "top.v"), dir / "top.v");
+  EXPECT_TRUE(index.FindFirst(dir / "missing", "top.v").empty());
+  EXPECT_EQ(index.Scans(), 0);
+  // Looked up again, indexed once
+  EXPECT_EQ(index.FindFirst(dir, "core.v"), dir / "rtl" / "core.v");
+  EXPECT_TRUE(index.FindFirst(dir, "missing.v").empty());
+  EXPECT_EQ(index.FindFirst(dir.string() + "/", "top.v"), dir / "top.v");
+  EXPECT_EQ(index.Scans(), 1);
+  // Indexed by Find
+  index.Find(dir / "rtl", {"core.v"});
+  EXPECT_EQ(index.FindFirst(dir / "rtl", "core.v"), dir / "rtl" / "core.v");
+  EXPECT_EQ(index.Scans(), 2);
+}
@@ -0,0 +1,94 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Utils/HostAdmission.h"
+
+#include <fstream>
+
+#include "gtest/gtest.h"
+#include "unittest/TestDir.h"
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+using namespace FOEDAG;
+
+#ifndef _WIN32
+namespace {
+std::filesystem::path admissionDir(const std::string& name) {
+  // Not created, Configure() does
+  return TestDir(name) / "admission";
+}
+}  // namespace
+
+TEST(HostAdmission, Disabled) {
+  HostAdmission admission;
+  EXPECT_FALSE(admission.IsEnabled());
+  EXPECT_EQ(admission.Acquire(100), 0);
+  EXPECT_TRUE(admission.Jobs().empty());
+}
+
+TEST(HostAdmission, Capacity) {
+  const auto dir = admissionDir("admission_capacity");
+  HostAdmission first, second;
+  ASSERT_TRUE(first.Configure(dir, 100));
+  ASSERT_TRUE(second.Configure(dir, 100));
+  second.PollInterval(1);
+
+  const uint64_t ticket = first.Acquire(60);
+  EXPECT_NE(ticket, 0);
+  EXPECT_EQ(first.Jobs().size(), 1);
+
+  // does not fit until the first job is released
+  int polls{0};
+  unsigned int used{0};
+  EXPECT_EQ(second.Acquire(
+                60, [&polls]() { return ++polls > 3; },
+                [&used](unsigned int inUse) { used = inUse; }),
+            0);
+  EXPECT_EQ(used, 60);
+  EXPECT_NE(second.Acquire(40), 0);
+
+  first.Release(ticket);
+  EXPECT_EQ(first.Jobs().size(), 1);
+  EXPECT_NE(second.Acquire(60), 0);
+  EXPECT_EQ(second.Jobs().size(), 2);
+}
+
+TEST(HostAdmission, HeavyJobRunsAlone) {
+  HostAdmission admission;
+  ASSERT_TRUE(admission.Configure(admissionDir("admission_heavy"), 100));
+  EXPECT_NE(admission.Acquire(500), 0);
+}
+
+TEST(HostAdmission, DeadProcess) {
+  const auto dir = admissionDir("admission_dead");
+  HostAdmission admission;
+  ASSERT_TRUE(admission.Configure(dir, 100));
+  pid_t child = fork();
+  if (child == 0) _exit(0);
+  waitpid(child, nullptr, 0);
+  // a job left behind by a process that died
+  std::ofstream{dir / "admission.jobs"} << child << " 1 100\n";
+  EXPECT_TRUE(admission.Jobs().empty());
+  EXPECT_NE(admission.Acquire(100), 0);
+}
+#endif
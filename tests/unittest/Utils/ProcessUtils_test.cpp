@@ -0,0 +1,119 @@
+/*
+Copyright 2022 The Foedag team
+
+GPL License
+
+Copyright (c) 2022 The Open-Source FPGA Foundation
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Utils/ProcessUtils.h"
+
+#include "gtest/gtest.h"
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+using namespace FOEDAG;
+
+TEST(ResourceLimits, Parse) {
+  ResourceLimits limits;
+  std::string error;
+  EXPECT_TRUE(limits.IsEmpty());
+  EXPECT_TRUE(limits.Parse({"-memory", "4096", "-cpus", "4-6,0,2",
+                            "-nice", "10", "-ionice", "2:7", "-timeout",
+                            "3600"},
+                           error));
+  EXPECT_EQ(limits.memoryMb, 4096);
+  EXPECT_EQ(limits.cpus, (std::vector<int>{0, 2, 4, 5, 6}));
+  EXPECT_EQ(limits.nice, 10);
+  EXPECT_EQ(limits.ioniceClass, 2);
+  EXPECT_EQ(limits.ioniceLevel, 7);
+  EXPECT_EQ(limits.timeoutSec, 3600);
+  EXPECT_EQ(limits.ToString(),
+            "-memory 4096 -cpus 0,2,4-6 -nice 10 -ionice 2:7 -timeout 3600");
+
+  // options not given are kept, 0 removes a limit
+  EXPECT_TRUE(limits.Parse({"-memory", "0"}, error));
+  EXPECT_EQ(limits.memoryMb, 0);
+  EXPECT_EQ(limits.nice, 10);
+}
+
+TEST(ResourceLimits, ParseInvalid) {
+  ResourceLimits limits;
+  std::string error;
+  EXPECT_FALSE(limits.Parse({"-memory"}, error));
+  EXPECT_FALSE(limits.Parse({"-memory", "lots"}, error));
+  EXPECT_FALSE(limits.Parse({"-cpus", "3-1"}, error));
+  EXPECT_FALSE(limits.Parse({"-nice", "42"}, error));
+  EXPECT_FALSE(limits.Parse({"-ionice", "2:9"}, error));
+  EXPECT_FALSE(limits.Parse({"-swap", "1"}, error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_TRUE(limits.IsEmpty());
+}
+
+#ifndef _WIN32
+TEST(ProcessUtils, ProcessGroup) {
+  ResourceLimits limits;
+  limits.nice = 5;
+  pid_t child = fork();
+  ASSERT_NE(child, -1);
+  if (child == 0) {
+    ProcessUtils::SetupChild(limits);
+    // a grandchild that would be orphaned by killing the child only
+    if (fork() == 0) pause();
+    pause();
+    _exit(0);
+  }
+  // wait for the child to become a group leader
+  for (int i = 0; i < 100 && getpgid(child) != child; i++) usleep(10000);
+  EXPECT_EQ(getpgid(child), child);
+  EXPECT_EQ(getpriority(PRIO_PROCESS, child), 5);
+  EXPECT_GT(ProcessUtils::GroupMemory(child), 0);
+
+  EXPECT_TRUE(ProcessUtils::SignalGroup(child, false));
+  int status{0};
+  EXPECT_EQ(waitpid(child, &status, 0), child);
+  EXPECT_TRUE(WIFSIGNALED(status));
+  // the grandchild got the signal too, the group is gone
+  for (int i = 0; i < 100 && ProcessUtils::GroupMemory(child); i++)
+    usleep(10000);
+  EXPECT_EQ(ProcessUtils::GroupMemory(child), 0);
+}
+
+TEST(ProcessUtils, GroupPeak) {
+  pid_t child = fork();
+  ASSERT_NE(child, -1);
+  if (child == 0) {
+    ProcessUtils::SetupChild({});
+    pause();
+    _exit(0);
+  }
+  for (int i = 0; i < 100 && getpgid(child) != child; i++) usleep(10000);
+  ProcessUtils utils;
+  utils.Frequency(1);
+  utils.Start(child);
+  usleep(50000);
+  utils.Stop();
+  // resident memory of the group, not the virtual size of the process
+  EXPECT_GT(utils.GroupPeak(), 0);
+  EXPECT_LE(utils.GroupPeak(), utils.Utilization());
+
+  ProcessUtils::SignalGroup(child, true);
+  int status{0};
+  waitpid(child, &status, 0);
+}
+#endif